@@ -129,7 +129,33 @@ auto Binder::BindIndex(duckdb_libpgquery::PGIndexStmt *stmt) -> std::unique_ptr<
     }
   }
 
-  return std::make_unique<IndexStatement>(stmt->idxname, std::move(table), std::move(cols));
+  // "art" is what the parser fills in without USING
+  auto index_type = IndexType::BPlusTreeIndex;
+  std::string access_method = stmt->accessMethod == nullptr ? "art" : stmt->accessMethod;
+  if (access_method == "blink") {
+    index_type = IndexType::BLinkTreeIndex;
+  } else if (access_method != "art" && access_method != "btree" && access_method != "bplustree") {
+    throw NotImplementedException(fmt::format("index type {} is not supported", access_method));
+  }
+
+  // WITH (fillfactor = n) sets how full the pages of a bulk loaded B+ tree are, like in PostgreSQL
+  int fill_factor = INDEX_FILL_FACTOR;
+  for (auto cell = stmt->options == nullptr ? nullptr : stmt->options->head; cell != nullptr; cell = cell->next) {
+    auto option = reinterpret_cast<duckdb_libpgquery::PGDefElem *>(cell->data.ptr_value);
+    if (std::string(option->defname) != "fillfactor") {
+      throw NotImplementedException(fmt::format("index option {} is not supported", option->defname));
+    }
+    if (option->arg == nullptr || option->arg->type != duckdb_libpgquery::T_PGInteger) {
+      throw bustub::Exception("fillfactor should be an integer");
+    }
+    auto value = reinterpret_cast<duckdb_libpgquery::PGValue *>(option->arg)->val.ival;
+    if (value < 10 || value > 100) {
+      throw bustub::Exception("fillfactor should be between 10 and 100");
+    }
+    fill_factor = static_cast<int>(value);
+  }
+
+  return std::make_unique<IndexStatement>(stmt->idxname, std::move(table), std::move(cols), index_type, fill_factor);
 }
 
 }  // namespace bustub
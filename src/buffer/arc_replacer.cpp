@@ -0,0 +1,177 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// arc_replacer.cpp
+//
+// Identification: src/buffer/arc_replacer.cpp
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "buffer/arc_replacer.h"
+
+#include <algorithm>
+
+#include "common/macros.h"
+
+namespace bustub {
+
+ARCReplacer::ARCReplacer(size_t num_frames)
+    : capacity_(num_frames),
+      lists_(num_frames, 2),
+      page_ids_(num_frames, INVALID_PAGE_ID),
+      is_evictable_(num_frames, false) {}
+
+ARCReplacer::~ARCReplacer() = default;
+
+void ARCReplacer::Resize(size_t num_frames) {
+  std::scoped_lock<std::mutex> lock(latch_);
+  lists_.Resize(num_frames);
+  page_ids_.resize(num_frames, INVALID_PAGE_ID);
+  is_evictable_.resize(num_frames, false);
+  capacity_ = num_frames;
+  target_t1_ = std::min(target_t1_, capacity_);
+  // restore the directory bounds for the new c, forgetting the oldest ghosts first
+  while (b1_.Size() > 0 && lists_.Size(T1) + b1_.Size() > capacity_) {
+    b1_.PopFront();
+  }
+  while (b2_.Size() > 0 && lists_.Size(T1) + lists_.Size(T2) + b1_.Size() + b2_.Size() > 2 * capacity_) {
+    b2_.PopFront();
+  }
+}
+
+auto ARCReplacer::Evict(frame_id_t *frame_id) -> bool {
+  std::scoped_lock<std::mutex> lock(latch_);
+  if (curr_size_ == 0) {
+    return false;
+  }
+
+  const bool t1_first = lists_.Size(T1) > target_t1_;
+  for (size_t list : {t1_first ? T1 : T2, t1_first ? T2 : T1}) {
+    const frame_id_t victim = NextEvictable(lists_.Front(list));
+    if (victim == FrameLists::NO_FRAME) {
+      continue;
+    }
+    if (page_ids_[victim] != INVALID_PAGE_ID) {
+      auto &ghosts = list == T1 ? b1_ : b2_;
+      ghosts.PushBack(page_ids_[victim]);
+      if (ghosts.Size() > capacity_) {
+        ghosts.PopFront();
+      }
+    }
+    Untrack(victim);
+    *frame_id = victim;
+    return true;
+  }
+  UNREACHABLE("an evictable frame must be in one of the lists");
+}
+
+void ARCReplacer::RecordAccess(frame_id_t frame_id) {
+  std::scoped_lock<std::mutex> lock(latch_);
+  BUSTUB_ASSERT(frame_id >= 0 && static_cast<size_t>(frame_id) < capacity_, "frame id is invalid");
+  if (lists_.ListOf(frame_id) == FrameLists::NO_LIST) {
+    lists_.PushBack(T1, frame_id);
+    page_ids_[frame_id] = INVALID_PAGE_ID;
+    return;
+  }
+  // a hit in T1 or T2 makes the page frequent
+  lists_.PushBack(T2, frame_id);
+}
+
+void ARCReplacer::RecordLoad(frame_id_t frame_id, page_id_t page_id) {
+  std::scoped_lock<std::mutex> lock(latch_);
+  BUSTUB_ASSERT(frame_id >= 0 && static_cast<size_t>(frame_id) < capacity_, "frame id is invalid");
+  page_ids_[frame_id] = page_id;
+  const size_t b1_size = b1_.Size();
+  const size_t b2_size = b2_.Size();
+  if (b1_.Erase(page_id)) {
+    // T1 evicted a page that was still needed, give T1 more room
+    target_t1_ = std::min(capacity_, target_t1_ + std::max<size_t>(b2_size / b1_size, 1));
+    lists_.PushBack(T2, frame_id);
+    return;
+  }
+  if (b2_.Erase(page_id)) {
+    // T2 evicted a page that was still needed, give T2 more room
+    target_t1_ -= std::min(target_t1_, std::max<size_t>(b1_size / b2_size, 1));
+    lists_.PushBack(T2, frame_id);
+    return;
+  }
+
+  // a new page, keep the directory (resident pages plus ghosts) within c for L1 and 2c overall
+  if (lists_.Size(T1) + b1_size >= capacity_) {
+    if (b1_size > 0) {
+      b1_.PopFront();
+    }
+  } else if (lists_.Size(T1) + lists_.Size(T2) + b1_size + b2_size >= 2 * capacity_ && b2_size > 0) {
+    b2_.PopFront();
+  }
+  lists_.PushBack(T1, frame_id);
+}
+
+void ARCReplacer::SetEvictable(frame_id_t frame_id, bool set_evictable) {
+  std::scoped_lock<std::mutex> lock(latch_);
+  BUSTUB_ASSERT(frame_id >= 0 && static_cast<size_t>(frame_id) < capacity_, "frame id is invalid");
+  if (lists_.ListOf(frame_id) == FrameLists::NO_LIST || is_evictable_[frame_id] == set_evictable) {
+    return;
+  }
+  is_evictable_[frame_id] = set_evictable;
+  curr_size_ = set_evictable ? curr_size_ + 1 : curr_size_ - 1;
+}
+
+void ARCReplacer::Remove(frame_id_t frame_id) {
+  std::scoped_lock<std::mutex> lock(latch_);
+  BUSTUB_ASSERT(frame_id >= 0 && static_cast<size_t>(frame_id) < capacity_, "frame id is invalid");
+  if (lists_.ListOf(frame_id) == FrameLists::NO_LIST) {
+    return;
+  }
+  BUSTUB_ASSERT(is_evictable_[frame_id], "# Remove a non_evictable frame");
+  Untrack(frame_id);
+}
+
+auto ARCReplacer::Size() -> size_t {
+  std::scoped_lock<std::mutex> lock(latch_);
+  return curr_size_;
+}
+
+auto ARCReplacer::EvictionCandidates(size_t max_count) -> std::vector<frame_id_t> {
+  std::scoped_lock<std::mutex> lock(latch_);
+  std::vector<frame_id_t> candidates;
+  // replay Evict() on cursors; p does not move without loads, but every T1 victim shrinks T1
+  size_t t1_size = lists_.Size(T1);
+  frame_id_t next[2] = {NextEvictable(lists_.Front(T1)), NextEvictable(lists_.Front(T2))};
+  while (candidates.size() < max_count && (next[T1] != FrameLists::NO_FRAME || next[T2] != FrameLists::NO_FRAME)) {
+    size_t list = t1_size > target_t1_ ? T1 : T2;
+    if (next[list] == FrameLists::NO_FRAME) {
+      list = list == T1 ? T2 : T1;
+    }
+    candidates.push_back(next[list]);
+    next[list] = NextEvictable(lists_.Next(next[list]));
+    if (list == T1) {
+      t1_size--;
+    }
+  }
+  return candidates;
+}
+
+auto ARCReplacer::GetTargetT1Size() -> size_t {
+  std::scoped_lock<std::mutex> lock(latch_);
+  return target_t1_;
+}
+
+auto ARCReplacer::NextEvictable(frame_id_t frame_id) const -> frame_id_t {
+  while (frame_id != FrameLists::NO_FRAME && !is_evictable_[frame_id]) {
+    frame_id = lists_.Next(frame_id);
+  }
+  return frame_id;
+}
+
+void ARCReplacer::Untrack(frame_id_t frame_id) {
+  lists_.Erase(frame_id);
+  page_ids_[frame_id] = INVALID_PAGE_ID;
+  is_evictable_[frame_id] = false;
+  curr_size_--;
+}
+
+}  // namespace bustub
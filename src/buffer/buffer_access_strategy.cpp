@@ -0,0 +1,45 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// buffer_access_strategy.cpp
+//
+// Identification: src/buffer/buffer_access_strategy.cpp
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "buffer/buffer_access_strategy.h"
+
+#include "common/macros.h"
+
+namespace bustub {
+
+BufferAccessStrategy::BufferAccessStrategy(BufferAccessType type) : type_(type) {}
+
+auto BufferAccessStrategy::GetRingSize() const -> size_t {
+  switch (type_) {
+    case BufferAccessType::BULK_READ:
+      return BULK_READ_RING_SIZE;
+    case BufferAccessType::BULK_WRITE:
+      return BULK_WRITE_RING_SIZE;
+    case BufferAccessType::NORMAL:
+      break;
+  }
+  return 0;
+}
+
+auto BufferAccessStrategy::GetRing(uint32_t instance_index, size_t ring_size) -> Ring & {
+  BUSTUB_ASSERT(ring_size > 0, "a ring needs at least one slot");
+  if (rings_.size() <= instance_index) {
+    rings_.resize(instance_index + 1);
+  }
+  auto &ring = rings_[instance_index];
+  if (ring.slots_.empty()) {
+    ring.slots_.assign(ring_size, INVALID_PAGE_ID);
+  }
+  return ring;
+}
+
+}  // namespace bustub
@@ -12,168 +12,996 @@
 
 #include "buffer/buffer_pool_manager_instance.h"
 
+#include <algorithm>
+#include <chrono>  // NOLINT
+#include <thread>  // NOLINT
+#include <utility>
+#include <vector>
+
 #include "common/exception.h"
 #include "common/macros.h"
+#include "fmt/format.h"
 
 namespace bustub {
 
 BufferPoolManagerInstance::BufferPoolManagerInstance(size_t pool_size, DiskManager *disk_manager, size_t replacer_k,
-                                                     LogManager *log_manager)
-    : pool_size_(pool_size), disk_manager_(disk_manager), log_manager_(log_manager) {
-  // we allocate a consecutive memory space for the buffer pool
-  pages_ = new Page[pool_size_];
-  page_table_ = new ExtendibleHashTable<page_id_t, frame_id_t>(bucket_size_);
-  replacer_ = new LRUKReplacer(pool_size, replacer_k);
+                                                     LogManager *log_manager, ReplacerPolicy replacer_policy,
+                                                     const FrameArenaOptions &arena_options)
+    : BufferPoolManagerInstance(pool_size, 1, 0, disk_manager, replacer_k, log_manager, replacer_policy,
+                                arena_options) {}
+
+BufferPoolManagerInstance::BufferPoolManagerInstance(size_t pool_size, uint32_t num_instances, uint32_t instance_index,
+                                                     DiskManager *disk_manager, size_t replacer_k,
+                                                     LogManager *log_manager, ReplacerPolicy replacer_policy,
+                                                     const FrameArenaOptions &arena_options)
+    : pool_size_(pool_size),
+      num_instances_(num_instances),
+      instance_index_(instance_index),
+      next_page_id_(static_cast<page_id_t>(instance_index)),
+      disk_manager_(disk_manager),
+      free_space_map_(disk_manager == nullptr ? nullptr : disk_manager->GetFreeSpaceMap()),
+      compressed_cache_(disk_manager == nullptr ? nullptr : disk_manager->GetCompressedCache()),
+      log_manager_(log_manager),
+      replacer_(MakeReplacer(replacer_policy, pool_size, replacer_k)),
+      replacer_k_(replacer_k),
+      arena_(MAX_POOL_SIZE, arena_options) {
+  BUSTUB_ASSERT(num_instances > 0, "If BPI is not part of a pool, then the pool size should just be 1");
+  BUSTUB_ASSERT(
+      instance_index < num_instances,
+      "BPI index cannot be greater than the number of BPIs in the pool. In non-parallel case, index should just be 1.");
+  BUSTUB_ASSERT(pool_size <= MAX_POOL_SIZE, "buffer pool is too large");
+  // frames are allocated in chunks, so that the pool can be resized later
+  chunks_ = std::make_unique<std::atomic<FrameChunk *>[]>(MAX_FRAME_CHUNKS);
+  for (size_t i = 0; i < MAX_FRAME_CHUNKS; ++i) {
+    chunks_[i] = i * FRAME_CHUNK_SIZE < pool_size ? AllocateChunk(i) : nullptr;
+  }
+  access_buffers_ = new AccessBuffer[num_stripes_];
+  hit_path_stripes_ = new HitPathStripe[num_stripes_];
+  page_table_ = new StripedHashTable<page_id_t, frame_id_t>(num_stripes_);
 
   // Initially, every page is in the free list.
   for (size_t i = 0; i < pool_size_; ++i) {
     free_list_.emplace_back(static_cast<int>(i));
   }
+
+  if (free_space_map_ != nullptr) {
+    // the pages of an existing file are allocated already
+    const page_id_t end = free_space_map_->GetEnd();
+    const auto stripes = static_cast<page_id_t>(num_instances);
+    next_page_id_ = end + (static_cast<page_id_t>(instance_index) - end % stripes + stripes) % stripes;
+  }
 }
 
 BufferPoolManagerInstance::~BufferPoolManagerInstance() {
-  delete[] pages_;
+  {
+    std::scoped_lock<std::mutex> lock(prefetch_latch_);
+    stop_prefetch_ = true;
+    prefetch_cv_.notify_all();
+  }
+  if (prefetch_thread_ != nullptr) {
+    prefetch_thread_->join();
+    delete prefetch_thread_;
+  }
+  StopBackgroundFlusher();
+  for (size_t i = 0; i < MAX_FRAME_CHUNKS; ++i) {
+    if (auto *chunk = chunks_[i].load(); chunk != nullptr) {
+      FreeChunk(i, chunk);
+    }
+  }
+  delete[] access_buffers_;
+  delete[] hit_path_stripes_;
   delete page_table_;
-  delete replacer_;
 }
 
-auto BufferPoolManagerInstance::NewPgImp(page_id_t *page_id) -> Page * {
-  std::scoped_lock<std::mutex> lock(latch_);
-  frame_id_t frame_id = -1;
+auto BufferPoolManagerInstance::NewPgImp(page_id_t *page_id) -> Page * { return NewPgStrategyImp(page_id, nullptr); }
 
-  // fetch a frame
-  if (!free_list_.empty()) {
-    frame_id = free_list_.front();
-    free_list_.pop_front();
-  } else if (!replacer_->Evict(&frame_id)) {
+auto BufferPoolManagerInstance::NewPgStrategyImp(page_id_t *page_id, BufferAccessStrategy *strategy) -> Page * {
+  std::unique_lock<std::mutex> lock(latch_);
+  auto *ring = GetRing(strategy);
+  frame_id_t frame_id = -1;
+  if (!AcquireFrame(&frame_id, ring)) {
+    lock.unlock();
+    pin_wait_failures_++;
+    TraceEvent(PageTraceEvent::NEW, INVALID_PAGE_ID, PAGE_TRACE_FAILED);
     return nullptr;
   }
 
-  // fetch the page from frame
-  auto &page = pages_[frame_id];
-  if (page.IsDirty()) {
-    disk_manager_->WritePage(page.page_id_, page.data_);
+  // allocate page
+  bool reused = false;
+  *page_id = AllocatePage(&reused);
+  frame_id_t stale_frame_id = -1;
+  if (reused && page_table_->Find(*page_id, stale_frame_id)) {
+    // a fetch read the freed page back in after its delete; that copy is dead and must not shadow the new page
+    DropStalePage(stale_frame_id, frame_id);
+  }
+  page_id_t victim_page_id = INVALID_PAGE_ID;
+  bool victim_dirty = false;
+  InstallPage(frame_id, *page_id, ring, &victim_page_id, &victim_dirty);
+  // A reused page still holds the page it replaces on disk, so it starts dirty to be zeroed there even if it is evicted
+  // unchanged. A page past the end of the file reads back as zeros without ever being written.
+  PageOf(frame_id).is_dirty_ = reused;
+
+  // write the victim back and zero the frame without blocking the rest of the pool
+  auto &page = PageOf(frame_id);
+  lock.unlock();
+  if (victim_page_id != INVALID_PAGE_ID) {
+    EvictVictim(victim_page_id, victim_dirty, page.data_);
   }
-  page_table_->Remove(page.GetPageId());
+  AttachPageData(frame_id, INVALID_PAGE_ID);
   page.ResetMemory();
-  // allocate page
-  *page_id = AllocatePage();
-  page.pin_count_ = 1;
-  page.page_id_ = *page_id;
-  page.is_dirty_ = false;
-  page_table_->Insert(*page_id, frame_id);
-  replacer_->RecordAccess(frame_id);
-  replacer_->SetEvictable(frame_id, false);
-  return &pages_[frame_id];
+  lock.lock();
+  FinishIo(frame_id, victim_page_id);
+  lock.unlock();
+  TraceEvent(PageTraceEvent::NEW, *page_id, 0);
+  return &page;
 }
 
-auto BufferPoolManagerInstance::FetchPgImp(page_id_t page_id) -> Page * {
-  std::scoped_lock<std::mutex> lock(latch_);
+auto BufferPoolManagerInstance::FetchPgImp(page_id_t page_id) -> Page * { return FetchPgStrategyImp(page_id, nullptr); }
+
+auto BufferPoolManagerInstance::FetchPgStrategyImp(page_id_t page_id, BufferAccessStrategy *strategy) -> Page * {
+  bool hit = false;
+  auto *page = FetchPageUntraced(page_id, strategy, &hit);
+  if (page == nullptr) {
+    pin_wait_failures_++;
+  } else {
+    auto &counters = hit_path_stripes_[static_cast<size_t>(page_id) % num_stripes_];
+    (hit ? counters.hits_ : counters.misses_).fetch_add(1, std::memory_order_relaxed);
+  }
+  TraceEvent(PageTraceEvent::FETCH, page_id,
+             page == nullptr ? PAGE_TRACE_FAILED : static_cast<uint8_t>(hit ? PAGE_TRACE_HIT : 0));
+  return page;
+}
+
+auto BufferPoolManagerInstance::FetchPageUntraced(page_id_t page_id, BufferAccessStrategy *strategy, bool *hit)
+    -> Page * {
+  const bool bulk = strategy != nullptr && strategy->GetType() != BufferAccessType::NORMAL;
+  // fast path: the page is resident, pin it without touching latch_
+  if (auto *page = FetchResident(page_id, !bulk); page != nullptr) {
+    *hit = true;
+    return page;
+  }
+
+  std::unique_lock<std::mutex> lock(latch_);
   frame_id_t frame_id = -1;
-  if (page_table_->Find(page_id, frame_id)) {
-    // found in page table
-    replacer_->RecordAccess(frame_id);
-    replacer_->SetEvictable(frame_id, false);
-    pages_[frame_id].pin_count_++;
-    return &pages_[frame_id];
+  while (true) {
+    if (page_table_->Find(page_id, frame_id)) {
+      // found in page table, but the frame may still be loading it
+      auto &state = StateOf(frame_id);
+      if (!bulk) {
+        replacer_->RecordAccess(frame_id);
+        state.ring_owned_ = false;
+      }
+      replacer_->SetEvictable(frame_id, false);
+      PageOf(frame_id).pin_count_++;
+      state.cv_.wait(lock, [&state] { return !state.in_progress_; });
+      *hit = true;
+      return &PageOf(frame_id);
+    }
+    auto writeback = writeback_.find(page_id);
+    if (writeback == writeback_.end()) {
+      break;
+    }
+    // the page was just evicted and its write-back has not reached the disk yet
+    auto &state = StateOf(writeback->second);
+    state.cv_.wait(lock, [this, page_id] { return writeback_.count(page_id) == 0; });
   }
 
-  // not found, try to pick a frame in freelist or replacer
-  if (!free_list_.empty()) {
-    frame_id = free_list_.front();
-    free_list_.pop_front();
-  } else if (!replacer_->Evict(&frame_id)) {
+  // not found, try to pick a frame in the strategy's ring, the freelist or the replacer
+  auto *ring = GetRing(strategy);
+  if (!AcquireFrame(&frame_id, ring)) {
     return nullptr;
   }
+  page_id_t victim_page_id = INVALID_PAGE_ID;
+  bool victim_dirty = false;
+  InstallPage(frame_id, page_id, ring, &victim_page_id, &victim_dirty);
 
-  auto &page = pages_[frame_id];
-  if (page.is_dirty_) {
-    disk_manager_->WritePage(page.page_id_, page.data_);
+  auto &page = PageOf(frame_id);
+  lock.unlock();
+  if (victim_page_id != INVALID_PAGE_ID) {
+    EvictVictim(victim_page_id, victim_dirty, page.data_);
   }
-  page_table_->Remove(page.page_id_);
-  // page.ResetMemory();
-  page.page_id_ = page_id;
-  page.pin_count_ = 1;
-  page.is_dirty_ = false;
-
-  disk_manager_->ReadPage(page_id, page.data_);
-  page_table_->Insert(page_id, frame_id);
-  replacer_->RecordAccess(frame_id);
-  replacer_->SetEvictable(frame_id, false);
-  return &pages_[frame_id];
+  if (!AttachPageData(frame_id, page_id) && !ReadFromCache(page_id, page.data_)) {
+    ReadFromDisk(page_id, page.data_);
+  }
+  lock.lock();
+  FinishIo(frame_id, victim_page_id);
+  return &page;
 }
 
 auto BufferPoolManagerInstance::UnpinPgImp(page_id_t page_id, bool is_dirty) -> bool {
-  std::scoped_lock<std::mutex> lock(latch_);
+  bool unpinned = UnpinPageUntraced(page_id, is_dirty);
+  TraceEvent(PageTraceEvent::UNPIN, page_id,
+             static_cast<uint8_t>((is_dirty ? PAGE_TRACE_DIRTY : 0) | (unpinned ? 0 : PAGE_TRACE_FAILED)));
+  return unpinned;
+}
+
+auto BufferPoolManagerInstance::UnpinPageUntraced(page_id_t page_id, bool is_dirty) -> bool {
+  HitPathGuard guard(this, page_id);
   frame_id_t frame_id = -1;
   if (!page_table_->Find(page_id, frame_id)) {
     return false;
   }
-  if (pages_[frame_id].pin_count_ == 0) {
+
+  auto &page = PageOf(frame_id);
+  int pin_count = page.pin_count_;
+  if (page.page_id_ != page_id || pin_count <= 0) {
     return false;
   }
-
-  auto &page = pages_[frame_id];
-  --page.pin_count_;
+  // the pin keeps the frame on its mapping, see SetZeroCopyReads()
+  if (is_dirty && page.data_ != arena_.Data(frame_id)) {
+    throw Exception(ExceptionType::INVALID,
+                    fmt::format("page {} is mapped read-only in zero-copy mode and cannot be dirtied", page_id));
+  }
+  // mark the page dirty while it is still pinned, so an evictor can never miss the flag
   if (is_dirty) {
     page.is_dirty_ = is_dirty;
   }
-  if (page.pin_count_ == 0) {
-    replacer_->SetEvictable(frame_id, true);
+  while (!page.pin_count_.compare_exchange_weak(pin_count, pin_count - 1)) {
+    if (pin_count <= 0) {
+      return false;
+    }
+  }
+  if (pin_count == 1) {
+    QueueAccess(frame_id);
   }
   return true;
 }
 
 auto BufferPoolManagerInstance::FlushPgImp(page_id_t page_id) -> bool {
-  std::scoped_lock<std::mutex> lock(latch_);
+  std::unique_lock<std::mutex> lock(latch_);
   frame_id_t frame_id = -1;
   if (page_id == INVALID_PAGE_ID || !page_table_->Find(page_id, frame_id)) {
     return false;
   }
 
-  auto &page = pages_[frame_id];
-  disk_manager_->WritePage(page_id, page.data_);
-  page.is_dirty_ = false;
+  // a frame that is still loading has nothing worth writing yet
+  auto &state = StateOf(frame_id);
+  state.cv_.wait(lock, [&state] { return !state.in_progress_; });
+  // the wait released latch_, so the page may have been evicted or deleted in the meantime
+  if (PageOf(frame_id).page_id_ != page_id) {
+    return false;
+  }
+  FlushFrame(frame_id, &lock);
   return true;
 }
 
 void BufferPoolManagerInstance::FlushAllPgsImp() {
+  std::unique_lock<std::mutex> lock(latch_);
+  FlushFrames(DirtyFrames(), &lock);
+}
+
+auto BufferPoolManagerInstance::PinDirtyPages(std::vector<DiskRequest> *requests) -> std::vector<frame_id_t> {
+  std::scoped_lock<std::mutex> lock(latch_);
+  auto frame_ids = DirtyFrames();
+  const auto start = std::chrono::steady_clock::now();
+  for (auto frame_id : frame_ids) {
+    requests->push_back(PinForFlush(frame_id));
+    requests->back().callback_ = LatencyCallback(true, start);
+  }
+  return frame_ids;
+}
+
+void BufferPoolManagerInstance::UnpinFlushedPages(const std::vector<frame_id_t> &frame_ids) {
   std::scoped_lock<std::mutex> lock(latch_);
+  for (auto frame_id : frame_ids) {
+    ReleasePin(frame_id);
+  }
+}
+
+auto BufferPoolManagerInstance::DirtyFrames() -> std::vector<frame_id_t> {
+  std::vector<frame_id_t> dirty_frames;
   for (size_t i = 0; i < pool_size_; ++i) {
-    auto &page = pages_[i];
-    if (page.page_id_ != INVALID_PAGE_ID && page.is_dirty_) {
-      disk_manager_->WritePage(page.page_id_, page.data_);
-      page.is_dirty_ = false;
+    auto &page = PageOf(i);
+    auto frame_id = static_cast<frame_id_t>(i);
+    if (page.page_id_ != INVALID_PAGE_ID && page.is_dirty_ && !StateOf(frame_id).in_progress_) {
+      dirty_frames.push_back(frame_id);
     }
   }
+  return dirty_frames;
 }
 
 auto BufferPoolManagerInstance::DeletePgImp(page_id_t page_id) -> bool {
-  std::scoped_lock<std::mutex> lock(latch_);
+  bool deleted = DeletePageUntraced(page_id);
+  TraceEvent(PageTraceEvent::DELETE, page_id, deleted ? 0 : PAGE_TRACE_FAILED);
+  return deleted;
+}
+
+auto BufferPoolManagerInstance::DeletePageUntraced(page_id_t page_id) -> bool {
+  std::unique_lock<std::mutex> lock(latch_);
   frame_id_t frame_id = -1;
-  if (!page_table_->Find(page_id, frame_id)) {
-    return true;
+  while (!page_table_->Find(page_id, frame_id)) {
+    auto writeback = writeback_.find(page_id);
+    if (writeback == writeback_.end()) {
+      DeallocatePage(page_id);
+      return true;
+    }
+    // the page was just evicted; freeing it now would let its id be reused before the stale write-back lands, or be
+    // cached again after it was dropped from the compressed cache
+    auto &state = StateOf(writeback->second);
+    state.cv_.wait(lock, [this, page_id] { return writeback_.count(page_id) == 0; });
   }
 
-  auto &page = pages_[frame_id];
-  if (page.pin_count_ > 0) {
+  // claim the frame, this fails if the page is pinned
+  int pin_count = 0;
+  if (!PageOf(frame_id).pin_count_.compare_exchange_strong(pin_count, -1)) {
     return false;
   }
+  FreeClaimedFrame(frame_id);
+  DeallocatePage(page_id);
+  return true;
+}
 
-  page_table_->Remove(page_id);
+void BufferPoolManagerInstance::FreeClaimedFrame(frame_id_t frame_id) {
+  auto &page = PageOf(frame_id);
+  page_table_->Remove(page.page_id_);
+  // the last unpin may not have reached the replacer yet
+  replacer_->SetEvictable(frame_id, true);
   replacer_->Remove(frame_id);
   free_list_.emplace_back(frame_id);
-  if (page.is_dirty_) {
-    disk_manager_->WritePage(page_id, page.data_);
-  }
+  // the contents of a deleted page are dead, a dirty one is dropped without a write
+  AttachPageData(frame_id, INVALID_PAGE_ID);
   page.ResetMemory();
   page.is_dirty_ = false;
   page.page_id_ = INVALID_PAGE_ID;
   page.pin_count_ = 0;
-  DeallocatePage(page_id);
+}
+
+void BufferPoolManagerInstance::DropStalePage(frame_id_t stale_frame_id, frame_id_t frame_id) {
+  auto &page = PageOf(stale_frame_id);
+  if (stale_frame_id == frame_id) {
+    // the stale copy is the victim of the new page: forget it, so that it is neither written back nor cached
+    page_table_->Remove(page.page_id_);
+    page.is_dirty_ = false;
+    page.page_id_ = INVALID_PAGE_ID;
+    return;
+  }
+  int pin_count = 0;
+  const bool claimed = page.pin_count_.compare_exchange_strong(pin_count, -1);
+  BUSTUB_ASSERT(claimed, "a deleted page is still pinned");
+  if (claimed) {
+    FreeClaimedFrame(stale_frame_id);
+  }
+}
+
+auto BufferPoolManagerInstance::FetchResident(page_id_t page_id, bool record_access) -> Page * {
+  HitPathGuard guard(this, page_id);
+  frame_id_t frame_id = -1;
+  if (!page_table_->Find(page_id, frame_id)) {
+    return nullptr;
+  }
+
+  auto &page = PageOf(frame_id);
+  int pin_count = page.pin_count_;
+  do {
+    if (pin_count < 0) {
+      // being evicted or deleted
+      return nullptr;
+    }
+  } while (!page.pin_count_.compare_exchange_weak(pin_count, pin_count + 1));
+
+  // the frame may have been given to another page between the lookup and the pin, or may still be loading
+  auto &state = StateOf(frame_id);
+  if (page.page_id_ != page_id || state.in_progress_) {
+    ReleasePin(frame_id);
+    return nullptr;
+  }
+  if (record_access) {
+    state.pending_accesses_++;
+    // a regular access takes the page away from the ring it was read in for
+    state.ring_owned_ = false;
+  }
+  QueueAccess(frame_id);
+  return &page;
+}
+
+BufferPoolManagerInstance::HitPathGuard::HitPathGuard(BufferPoolManagerInstance *bpm, page_id_t page_id) {
+  auto &stripe = bpm->hit_path_stripes_[static_cast<size_t>(page_id) % bpm->num_stripes_];
+  readers_ = &stripe.readers_[bpm->reader_epoch_.load() & 1];
+  readers_->fetch_add(1);
+}
+
+BufferPoolManagerInstance::HitPathGuard::~HitPathGuard() { readers_->fetch_sub(1); }
+
+void BufferPoolManagerInstance::WaitForHitPathReaders() {
+  // A reader that found a removed page table entry registered before the removal, in either epoch: it loaded the epoch
+  // before or after an earlier flip. Flip twice and let each epoch drain once; new readers only use the other one.
+  for (int phase = 0; phase < 2; ++phase) {
+    const uint32_t old_epoch = reader_epoch_.fetch_xor(1) & 1;
+    for (size_t i = 0; i < num_stripes_; ++i) {
+      while (hit_path_stripes_[i].readers_[old_epoch].load() != 0) {
+        std::this_thread::yield();
+      }
+    }
+  }
+}
+
+auto BufferPoolManagerInstance::SetPoolSize(size_t pool_size) -> size_t {
+  if (pool_size == 0 || pool_size > MAX_POOL_SIZE) {
+    throw Exception(ExceptionType::OUT_OF_RANGE,
+                    fmt::format("buffer pool size must be between 1 and {}", MAX_POOL_SIZE));
+  }
+  std::scoped_lock<std::mutex> resize_lock(resize_latch_);
+  const size_t old_pool_size = pool_size_;
+  if (pool_size < old_pool_size) {
+    return ShrinkPool(pool_size);
+  }
+
+  // allocate the new chunks before taking latch_, nothing can reach them until the frames are in the free list
+  for (size_t i = (old_pool_size + FRAME_CHUNK_SIZE - 1) / FRAME_CHUNK_SIZE; i * FRAME_CHUNK_SIZE < pool_size; ++i) {
+    if (chunks_[i] == nullptr) {
+      chunks_[i] = AllocateChunk(i);
+    }
+  }
+  std::scoped_lock<std::mutex> lock(latch_);
+  replacer_->Resize(pool_size);
+  for (size_t i = old_pool_size; i < pool_size; ++i) {
+    // frames of a chunk that a shrink kept are still claimed, and may have been left queued by their last unpin
+    auto frame_id = static_cast<frame_id_t>(i);
+    StateOf(frame_id).queued_ = false;
+    StateOf(frame_id).pending_accesses_ = 0;
+    PageOf(frame_id).pin_count_ = 0;
+    free_list_.emplace_back(frame_id);
+  }
+  pool_size_ = pool_size;
+  return pool_size;
+}
+
+auto BufferPoolManagerInstance::ShrinkPool(size_t pool_size) -> size_t {
+  std::unique_lock<std::mutex> lock(latch_);
+  const size_t old_pool_size = pool_size_;
+  // write back the dirty pages of the frames to drop first, so that only pages dirtied again are written under latch_
+  std::vector<frame_id_t> dirty_frames;
+  for (size_t i = old_pool_size; i-- > pool_size;) {
+    auto frame_id = static_cast<frame_id_t>(i);
+    auto &page = PageOf(frame_id);
+    if (page.page_id_ != INVALID_PAGE_ID && page.is_dirty_ && page.pin_count_ >= 0 && !StateOf(frame_id).in_progress_) {
+      dirty_frames.push_back(frame_id);
+    }
+  }
+  FlushFrames(dirty_frames, &lock);
+
+  // drain now so the replacer knows which of the frames are evictable; accesses queued by unpins racing with the claims
+  // below are skipped by later drains
+  DrainAccesses();
+  size_t new_pool_size = old_pool_size;
+  while (new_pool_size > pool_size) {
+    auto frame_id = static_cast<frame_id_t>(new_pool_size - 1);
+    auto &page = PageOf(frame_id);
+    if (StateOf(frame_id).in_progress_) {
+      break;
+    }
+    int pin_count = 0;
+    if (page.page_id_ == INVALID_PAGE_ID) {
+      // a free frame, only pinned for a moment by a hit path holding a stale page table entry
+      while (!page.pin_count_.compare_exchange_weak(pin_count, -1)) {
+        pin_count = 0;
+        std::this_thread::yield();
+      }
+    } else {
+      if (!page.pin_count_.compare_exchange_strong(pin_count, -1)) {
+        break;
+      }
+      page_table_->Remove(page.page_id_);
+      replacer_->SetEvictable(frame_id, true);
+      replacer_->Remove(frame_id);
+      if (page.is_dirty_) {
+        dirty_evictions_++;
+      } else {
+        clean_evictions_++;
+      }
+      EvictVictim(page.page_id_, page.is_dirty_, page.data_);
+      page.page_id_ = INVALID_PAGE_ID;
+      page.is_dirty_ = false;
+    }
+    new_pool_size--;
+  }
+  free_list_.remove_if([new_pool_size](frame_id_t frame_id) { return static_cast<size_t>(frame_id) >= new_pool_size; });
+  replacer_->Resize(new_pool_size);
+  pool_size_ = new_pool_size;
+
+  // unpublish the chunks that no longer hold any frame, and free them once no hit path can be using them
+  std::vector<std::pair<size_t, FrameChunk *>> dropped_chunks;
+  for (size_t i = (new_pool_size + FRAME_CHUNK_SIZE - 1) / FRAME_CHUNK_SIZE; i * FRAME_CHUNK_SIZE < old_pool_size;
+       ++i) {
+    dropped_chunks.emplace_back(i, chunks_[i].exchange(nullptr));
+  }
+  lock.unlock();
+  if (!dropped_chunks.empty()) {
+    WaitForHitPathReaders();
+    for (auto [chunk_index, chunk] : dropped_chunks) {
+      FreeChunk(chunk_index, chunk);
+    }
+  }
+  return new_pool_size;
+}
+
+auto BufferPoolManagerInstance::AllocateChunk(size_t chunk_index) -> FrameChunk * {
+  arena_.Commit(chunk_index * FRAME_CHUNK_SIZE, FRAME_CHUNK_SIZE);
+  auto *chunk = new FrameChunk;
+  for (size_t i = 0; i < FRAME_CHUNK_SIZE; ++i) {
+    chunk->pages_[i].data_ = arena_.Data(static_cast<frame_id_t>(chunk_index * FRAME_CHUNK_SIZE + i));
+  }
+  return chunk;
+}
+
+void BufferPoolManagerInstance::FreeChunk(size_t chunk_index, FrameChunk *chunk) {
+  delete chunk;
+  arena_.Decommit(chunk_index * FRAME_CHUNK_SIZE, FRAME_CHUNK_SIZE);
+}
+
+void BufferPoolManagerInstance::ReleasePin(frame_id_t frame_id) {
+  if (--PageOf(frame_id).pin_count_ == 0) {
+    QueueAccess(frame_id);
+  }
+}
+
+void BufferPoolManagerInstance::QueueAccess(frame_id_t frame_id) {
+  if (StateOf(frame_id).queued_.exchange(true)) {
+    return;
+  }
+  auto &buffer = access_buffers_[frame_id % num_stripes_];
+  std::scoped_lock<std::mutex> lock(buffer.latch_);
+  buffer.frames_.push_back(frame_id);
+}
+
+void BufferPoolManagerInstance::DrainAccesses() {
+  std::vector<frame_id_t> frames;
+  for (size_t i = 0; i < num_stripes_; ++i) {
+    std::scoped_lock<std::mutex> lock(access_buffers_[i].latch_);
+    frames.insert(frames.end(), access_buffers_[i].frames_.begin(), access_buffers_[i].frames_.end());
+    access_buffers_[i].frames_.clear();
+  }
+
+  for (auto frame_id : frames) {
+    if (static_cast<size_t>(frame_id) >= pool_size_) {
+      // queued by an unpin that raced with a shrink; the frame may be gone
+      continue;
+    }
+    // dequeue before reading the frame, so that a later touch queues it again
+    auto &state = StateOf(frame_id);
+    state.queued_ = false;
+    const size_t accesses = state.pending_accesses_.exchange(0);
+    auto &page = PageOf(frame_id);
+    if (page.page_id_ == INVALID_PAGE_ID) {
+      continue;
+    }
+    // only the last k accesses matter to the replacer
+    for (size_t i = 0; i < std::min(accesses, replacer_k_); ++i) {
+      replacer_->RecordAccess(frame_id);
+    }
+    replacer_->SetEvictable(frame_id, page.pin_count_ == 0);
+  }
+}
+
+auto BufferPoolManagerInstance::GetRing(BufferAccessStrategy *strategy) -> BufferAccessStrategy::Ring * {
+  if (strategy == nullptr || strategy->GetRingSize() == 0) {
+    return nullptr;
+  }
+  // a ring may never take over more than a small part of the pool
+  const size_t ring_size = std::min(strategy->GetRingSize(), std::max<size_t>(pool_size_ / 8, 1));
+  return &strategy->GetRing(instance_index_, ring_size);
+}
+
+auto BufferPoolManagerInstance::AcquireFrame(frame_id_t *frame_id, BufferAccessStrategy::Ring *ring) -> bool {
+  if (ring != nullptr && RecycleRingFrame(frame_id, ring)) {
+    return true;
+  }
+  if (!free_list_.empty()) {
+    *frame_id = free_list_.front();
+    free_list_.pop_front();
+    // a hit path holding a stale page table entry may pin the free frame for a moment; wait for it to back off
+    auto &page = PageOf(*frame_id);
+    int pin_count = 0;
+    while (!page.pin_count_.compare_exchange_weak(pin_count, -1)) {
+      pin_count = 0;
+      std::this_thread::yield();
+    }
+    return true;
+  }
+
+  DrainAccesses();
+  while (replacer_->Evict(frame_id)) {
+    int pin_count = 0;
+    if (PageOf(*frame_id).pin_count_.compare_exchange_strong(pin_count, -1)) {
+      return true;
+    }
+    // pinned through the hit path since the last drain, keep tracking it until it is unpinned again; to the replacer
+    // this looks like the page coming back right after its eviction
+    replacer_->RecordLoad(*frame_id, PageOf(*frame_id).page_id_);
+  }
+  return false;
+}
+
+auto BufferPoolManagerInstance::RecycleRingFrame(frame_id_t *frame_id, BufferAccessStrategy::Ring *ring) -> bool {
+  const page_id_t page_id = ring->slots_[ring->next_];
+  if (page_id == INVALID_PAGE_ID || !page_table_->Find(page_id, *frame_id) || !StateOf(*frame_id).ring_owned_) {
+    return false;
+  }
+  int pin_count = 0;
+  if (!PageOf(*frame_id).pin_count_.compare_exchange_strong(pin_count, -1)) {
+    return false;
+  }
+  // the frame bypasses Evict(), so drop its history by hand; the last unpin may not have reached the replacer yet
+  replacer_->SetEvictable(*frame_id, true);
+  replacer_->Remove(*frame_id);
   return true;
 }
 
-auto BufferPoolManagerInstance::AllocatePage() -> page_id_t { return next_page_id_++; }
+void BufferPoolManagerInstance::InstallPage(frame_id_t frame_id, page_id_t page_id, BufferAccessStrategy::Ring *ring,
+                                            page_id_t *victim_page_id, bool *victim_dirty) {
+  auto &page = PageOf(frame_id);
+  auto &state = StateOf(frame_id);
+  *victim_page_id = INVALID_PAGE_ID;
+  *victim_dirty = page.is_dirty_;
+  if (page.page_id_ != INVALID_PAGE_ID) {
+    page_table_->Remove(page.page_id_);
+    if (page.is_dirty_ || compressed_cache_ != nullptr) {
+      // a page is only fetched or deleted again once its last write-back is done, see writeback_
+      BUSTUB_ASSERT(writeback_.count(page.page_id_) == 0, "page is written back twice at once");
+      *victim_page_id = page.page_id_;
+      writeback_[page.page_id_] = frame_id;
+    }
+    (page.is_dirty_ ? dirty_evictions_ : clean_evictions_)++;
+  }
+  state.in_progress_ = true;
+  state.pending_accesses_ = 0;
+  state.ring_owned_ = ring != nullptr;
+  if (ring != nullptr) {
+    ring->slots_[ring->next_] = page_id;
+    ring->next_ = (ring->next_ + 1) % ring->slots_.size();
+  }
+  page.page_id_ = page_id;
+  page.is_dirty_ = false;
+  page_table_->Insert(page_id, frame_id);
+  replacer_->RecordLoad(frame_id, page_id);
+  replacer_->SetEvictable(frame_id, false);
+  // publish the frame to the hit path last
+  page.pin_count_ = 1;
+}
+
+void BufferPoolManagerInstance::FinishIo(frame_id_t frame_id, page_id_t victim_page_id) {
+  if (victim_page_id != INVALID_PAGE_ID) {
+    writeback_.erase(victim_page_id);
+  }
+  StateOf(frame_id).in_progress_ = false;
+  StateOf(frame_id).cv_.notify_all();
+}
+
+void BufferPoolManagerInstance::FlushFrame(frame_id_t frame_id, std::unique_lock<std::mutex> *lock) {
+  auto &page = PageOf(frame_id);
+  if (page.pin_count_++ == 0) {
+    replacer_->SetEvictable(frame_id, false);
+  }
+  // clear the flag before writing so that a concurrent modification re-dirties the page
+  page.is_dirty_ = false;
+  const page_id_t page_id = page.page_id_;
+  lock->unlock();
+  WriteToDisk(page_id, page.data_);
+  lock->lock();
+  ReleasePin(frame_id);
+}
+
+void BufferPoolManagerInstance::FlushFrames(const std::vector<frame_id_t> &frame_ids,
+                                            std::unique_lock<std::mutex> *lock) {
+  if (frame_ids.size() <= 1) {
+    if (!frame_ids.empty()) {
+      FlushFrame(frame_ids[0], lock);
+    }
+    return;
+  }
+  std::vector<DiskRequest> requests;
+  requests.reserve(frame_ids.size());
+  for (auto frame_id : frame_ids) {
+    requests.push_back(PinForFlush(frame_id));
+  }
+  // in file order, so that the disk manager can merge adjacent pages and even a plain one writes sequentially
+  std::sort(requests.begin(), requests.end(),
+            [](const DiskRequest &a, const DiskRequest &b) { return a.page_id_ < b.page_id_; });
+  lock->unlock();
+  RunDiskBatch(std::move(requests));
+  lock->lock();
+  for (auto frame_id : frame_ids) {
+    ReleasePin(frame_id);
+  }
+}
+
+auto BufferPoolManagerInstance::PinForFlush(frame_id_t frame_id) -> DiskRequest {
+  auto &page = PageOf(frame_id);
+  if (page.pin_count_++ == 0) {
+    replacer_->SetEvictable(frame_id, false);
+  }
+  // a write to the page while it is being written dirties it again
+  page.is_dirty_ = false;
+  return {true, page.page_id_, page.data_, nullptr};
+}
+
+void BufferPoolManagerInstance::Prefetch(page_id_t page_id, BufferAccessType access_type) {
+  if (page_id < 0 || page_id >= next_page_id_ || page_id % num_instances_ != instance_index_) {
+    return;
+  }
+  frame_id_t frame_id = -1;
+  if (page_table_->Find(page_id, frame_id)) {
+    return;
+  }
+
+  std::scoped_lock<std::mutex> lock(prefetch_latch_);
+  // a full queue means the reads cannot keep up, and older hints are more urgent
+  if (stop_prefetch_ || prefetch_queue_.size() >= pool_size_ || !prefetch_pending_.insert(page_id).second) {
+    return;
+  }
+  prefetch_queue_.emplace_back(page_id, access_type);
+  if (prefetch_thread_ == nullptr) {
+    prefetch_thread_ = new std::thread(&BufferPoolManagerInstance::RunPrefetch, this);
+  }
+  prefetch_cv_.notify_one();
+}
+
+void BufferPoolManagerInstance::RunPrefetch() {
+  std::unique_lock<std::mutex> lock(prefetch_latch_);
+  while (true) {
+    prefetch_cv_.wait(lock, [this] { return stop_prefetch_ || !prefetch_queue_.empty(); });
+    if (stop_prefetch_) {
+      return;
+    }
+    std::vector<std::pair<page_id_t, BufferAccessType>> hints;
+    while (!prefetch_queue_.empty() && hints.size() < PREFETCH_BATCH_SIZE) {
+      hints.push_back(prefetch_queue_.front());
+      prefetch_queue_.pop_front();
+    }
+    lock.unlock();
+    PrefetchBatch(hints);
+    lock.lock();
+    for (const auto &hint : hints) {
+      prefetch_pending_.erase(hint.first);
+    }
+  }
+}
+
+void BufferPoolManagerInstance::PrefetchBatch(const std::vector<std::pair<page_id_t, BufferAccessType>> &hints) {
+  struct Load {
+    frame_id_t frame_id_;
+    page_id_t page_id_;
+    page_id_t victim_page_id_;
+    bool victim_dirty_;
+  };
+  std::vector<Load> loads;
+  std::vector<DiskRequest> writes;
+  std::vector<DiskRequest> reads;
+  std::unique_lock<std::mutex> lock(latch_);
+  for (const auto &[page_id, access_type] : hints) {
+    frame_id_t frame_id = -1;
+    // resident, or just evicted and still being written back: a hint is not worth waiting for
+    if (page_table_->Find(page_id, frame_id) || writeback_.count(page_id) != 0) {
+      continue;
+    }
+    // a hint queued before its page was deleted; reading it in would leave a stale copy for the page's reuse
+    if (free_space_map_ != nullptr && free_space_map_->IsFree(page_id)) {
+      continue;
+    }
+    // like a regular fetch, only take free or evictable frames
+    auto *ring = GetRing(access_type == BufferAccessType::NORMAL ? nullptr : &prefetch_strategy_);
+    if (!AcquireFrame(&frame_id, ring)) {
+      break;
+    }
+    page_id_t victim_page_id = INVALID_PAGE_ID;
+    bool victim_dirty = false;
+    InstallPage(frame_id, page_id, ring, &victim_page_id, &victim_dirty);
+    if (victim_page_id != INVALID_PAGE_ID && victim_dirty) {
+      writes.push_back({true, victim_page_id, PageOf(frame_id).data_, nullptr});
+    }
+    loads.push_back({frame_id, page_id, victim_page_id, victim_dirty});
+  }
+  if (loads.empty()) {
+    return;
+  }
+  lock.unlock();
+  // a frame is only read into once its victim is on disk
+  RunDiskBatch(std::move(writes));
+  for (const auto &load : loads) {
+    auto &page = PageOf(load.frame_id_);
+    if (load.victim_page_id_ != INVALID_PAGE_ID) {
+      // written back already, only left to cache
+      EvictVictim(load.victim_page_id_, false, page.data_);
+    }
+    if (!AttachPageData(load.frame_id_, load.page_id_) && !ReadFromCache(load.page_id_, page.data_)) {
+      reads.push_back({false, load.page_id_, page.data_, nullptr});
+    }
+  }
+  RunDiskBatch(std::move(reads));
+  lock.lock();
+  for (const auto &load : loads) {
+    FinishIo(load.frame_id_, load.victim_page_id_);
+    ReleasePin(load.frame_id_);
+  }
+}
+
+void BufferPoolManagerInstance::StartBackgroundFlusher(double target_clean_ratio, size_t max_writes_per_second) {
+  BUSTUB_ASSERT(background_flush_thread_ == nullptr, "background flusher is already running");
+  BUSTUB_ASSERT(target_clean_ratio >= 0 && target_clean_ratio <= 1, "target clean ratio must be in [0, 1]");
+  target_clean_ratio_ = target_clean_ratio;
+  max_writes_per_second_ = max_writes_per_second;
+  enable_background_flush_ = true;
+  background_flush_thread_ = new std::thread(&BufferPoolManagerInstance::RunBackgroundFlush, this);
+}
+
+void BufferPoolManagerInstance::StopBackgroundFlusher() {
+  if (background_flush_thread_ == nullptr) {
+    return;
+  }
+  enable_background_flush_ = false;
+  background_flush_thread_->join();
+  delete background_flush_thread_;
+  background_flush_thread_ = nullptr;
+}
+
+auto BufferPoolManagerInstance::GetWriteStats() const -> BufferPoolWriteStats {
+  BufferPoolWriteStats stats;
+  stats.background_writes_ = background_writes_;
+  stats.dirty_evictions_ = dirty_evictions_;
+  stats.clean_evictions_ = clean_evictions_;
+  return stats;
+}
+
+void BufferPoolManagerInstance::RunBackgroundFlush() {
+  const double writes_per_round =
+      static_cast<double>(max_writes_per_second_) * std::chrono::duration<double>(background_flush_interval).count();
+  // unused budget carries over to the next round, but never more than one second's worth
+  double credit = 0;
+  while (enable_background_flush_) {
+    std::this_thread::sleep_for(background_flush_interval);
+    credit = std::min(credit + writes_per_round, static_cast<double>(max_writes_per_second_));
+    if (credit >= 1) {
+      credit -= static_cast<double>(BackgroundFlushRound(static_cast<size_t>(credit)));
+    }
+  }
+}
+
+auto BufferPoolManagerInstance::BackgroundFlushRound(size_t max_writes) -> size_t {
+  std::unique_lock<std::mutex> lock(latch_);
+  DrainAccesses();
+  const auto horizon = static_cast<size_t>(target_clean_ratio_ * static_cast<double>(pool_size_));
+  std::vector<frame_id_t> dirty_frames;
+  for (auto frame_id : replacer_->EvictionCandidates(horizon)) {
+    if (dirty_frames.size() == max_writes) {
+      break;
+    }
+    auto &page = PageOf(frame_id);
+    if (page.page_id_ == INVALID_PAGE_ID || !page.is_dirty_ || page.pin_count_ != 0 ||
+        StateOf(frame_id).in_progress_) {
+      continue;
+    }
+    dirty_frames.push_back(frame_id);
+  }
+  // one batch, so that the disk manager can keep all the writes in flight at once
+  FlushFrames(dirty_frames, &lock);
+  background_writes_ += dirty_frames.size();
+  return dirty_frames.size();
+}
+
+auto BufferPoolManagerInstance::GetMetrics() -> BufferPoolMetrics {
+  BufferPoolMetrics metrics;
+  {
+    // frames are only stable under latch_
+    std::scoped_lock<std::mutex> lock(latch_);
+    metrics.pool_size_ = pool_size_;
+    for (size_t i = 0; i < pool_size_; ++i) {
+      if (PageOf(i).pin_count_ > 0) {
+        metrics.pinned_frames_++;
+      }
+    }
+  }
+  for (size_t i = 0; i < num_stripes_; ++i) {
+    metrics.hits_ += hit_path_stripes_[i].hits_.load(std::memory_order_relaxed);
+    metrics.misses_ += hit_path_stripes_[i].misses_.load(std::memory_order_relaxed);
+  }
+  metrics.clean_evictions_ = clean_evictions_;
+  metrics.dirty_evictions_ = dirty_evictions_;
+  metrics.background_writes_ = background_writes_;
+  metrics.pin_wait_failures_ = pin_wait_failures_;
+  metrics.compressed_cache_hits_ = compressed_cache_hits_;
+  metrics.compressed_cache_misses_ = compressed_cache_misses_;
+  metrics.read_latency_ = read_latency_.Snapshot();
+  metrics.write_latency_ = write_latency_.Snapshot();
+  return metrics;
+}
+
+auto BufferPoolManagerInstance::AttachPageData(frame_id_t frame_id, page_id_t page_id) -> bool {
+  auto &page = PageOf(frame_id);
+  const char *mapped = nullptr;
+  if (page_id != INVALID_PAGE_ID && zero_copy_reads_.load(std::memory_order_relaxed)) {
+    mapped = disk_manager_->GetMappedPage(page_id);
+  }
+  // writes to a mapped page fault and dirty unpins of one throw, zero-copy is only for pools that never write
+  page.data_ = mapped != nullptr ? const_cast<char *>(mapped) : arena_.Data(frame_id);
+  return mapped != nullptr;
+}
+
+void BufferPoolManagerInstance::ReadFromDisk(page_id_t page_id, char *data) {
+  auto start = std::chrono::steady_clock::now();
+  disk_manager_->ReadPage(page_id, data);
+  read_latency_.Record(static_cast<uint64_t>(
+      std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count()));
+}
+
+auto BufferPoolManagerInstance::ReadFromCache(page_id_t page_id, char *data) -> bool {
+  if (compressed_cache_ == nullptr) {
+    return false;
+  }
+  const bool hit = compressed_cache_->Take(page_id, data);
+  (hit ? compressed_cache_hits_ : compressed_cache_misses_)++;
+  return hit;
+}
+
+void BufferPoolManagerInstance::EvictVictim(page_id_t victim_page_id, bool victim_dirty, const char *data) {
+  if (victim_dirty) {
+    WriteToDisk(victim_page_id, data);
+  }
+  if (compressed_cache_ != nullptr) {
+    compressed_cache_->Put(victim_page_id, data);
+  }
+}
+
+void BufferPoolManagerInstance::WriteToDisk(page_id_t page_id, const char *data) {
+  auto start = std::chrono::steady_clock::now();
+  disk_manager_->WritePage(page_id, data);
+  write_latency_.Record(static_cast<uint64_t>(
+      std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count()));
+}
+
+void BufferPoolManagerInstance::RunDiskBatch(std::vector<DiskRequest> requests) {
+  const auto start = std::chrono::steady_clock::now();
+  for (auto &request : requests) {
+    request.callback_ = LatencyCallback(request.is_write_, start);
+  }
+  disk_manager_->SubmitRequestsAndWait(std::move(requests));
+}
+
+auto BufferPoolManagerInstance::LatencyCallback(bool is_write, std::chrono::steady_clock::time_point start)
+    -> std::function<void(bool)> {
+  auto *latency = is_write ? &write_latency_ : &read_latency_;
+  return [latency, start](bool /* ok */) {
+    latency->Record(static_cast<uint64_t>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count()));
+  };
+}
+
+void BufferPoolManagerInstance::SetTraceRecorder(PageTraceRecorder *recorder) { trace_recorder_ = recorder; }
+
+void BufferPoolManagerInstance::TraceEvent(PageTraceEvent event, page_id_t page_id, uint8_t flags) {
+  if (auto *recorder = trace_recorder_.load(std::memory_order_relaxed); recorder != nullptr) {
+    recorder->Record(event, page_id, flags);
+  }
+}
+
+auto BufferPoolManagerInstance::AllocatePage(bool *reused) -> page_id_t {
+  if (free_space_map_ != nullptr) {
+    const page_id_t page_id = free_space_map_->Allocate(instance_index_, num_instances_, reused);
+    ValidatePageId(page_id);
+    // Prefetch() only takes hints for pages below next_page_id_
+    page_id_t next_page_id = next_page_id_;
+    while (next_page_id <= page_id &&
+           !next_page_id_.compare_exchange_weak(next_page_id, page_id + static_cast<page_id_t>(num_instances_))) {
+    }
+    return page_id;
+  }
+  const page_id_t next_page_id = next_page_id_.fetch_add(static_cast<page_id_t>(num_instances_));
+  ValidatePageId(next_page_id);
+  *reused = false;
+  return next_page_id;
+}
+
+void BufferPoolManagerInstance::DeallocatePage(page_id_t page_id) {
+  if (compressed_cache_ != nullptr) {
+    compressed_cache_->Remove(page_id);
+  }
+  if (free_space_map_ != nullptr) {
+    free_space_map_->Free(page_id);
+  }
+}
+
+void BufferPoolManagerInstance::ValidatePageId(const page_id_t page_id) const {
+  // allocated pages mod back to this BPI
+  BUSTUB_ASSERT(page_id % num_instances_ == instance_index_, "page id is routed to the wrong buffer pool instance");
+}
 
 }  // namespace bustub
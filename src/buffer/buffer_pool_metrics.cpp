@@ -0,0 +1,88 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// buffer_pool_metrics.cpp
+//
+// Identification: src/buffer/buffer_pool_metrics.cpp
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "buffer/buffer_pool_metrics.h"
+
+#include <cmath>
+
+namespace bustub {
+
+auto LatencyHistogram::MeanMicros() const -> double {
+  return count_ == 0 ? 0 : static_cast<double>(total_ns_) / static_cast<double>(count_) / 1000;
+}
+
+auto LatencyHistogram::QuantileMicros(double fraction) const -> uint64_t {
+  if (count_ == 0) {
+    return 0;
+  }
+  // the rank of the quantile, counted from 1
+  auto rank = static_cast<uint64_t>(std::ceil(fraction * static_cast<double>(count_)));
+  rank = rank == 0 ? 1 : rank;
+  uint64_t seen = 0;
+  for (size_t i = 0; i < LATENCY_HISTOGRAM_BUCKETS; i++) {
+    seen += buckets_[i];
+    if (seen >= rank) {
+      return BucketUpperBoundMicros(i);
+    }
+  }
+  return BucketUpperBoundMicros(LATENCY_HISTOGRAM_BUCKETS - 1);
+}
+
+auto LatencyHistogram::operator+=(const LatencyHistogram &other) -> LatencyHistogram & {
+  for (size_t i = 0; i < LATENCY_HISTOGRAM_BUCKETS; i++) {
+    buckets_[i] += other.buckets_[i];
+  }
+  count_ += other.count_;
+  total_ns_ += other.total_ns_;
+  return *this;
+}
+
+void AtomicLatencyHistogram::Record(uint64_t latency_ns) {
+  // bucket i > 0 holds [2^(i-1), 2^i) us, i.e. the bit width of the latency in microseconds
+  uint64_t micros = latency_ns / 1000;
+  size_t bucket = 0;
+  while (micros != 0 && bucket < LATENCY_HISTOGRAM_BUCKETS - 1) {
+    micros >>= 1;
+    bucket++;
+  }
+  buckets_[bucket].fetch_add(1, std::memory_order_relaxed);
+  count_.fetch_add(1, std::memory_order_relaxed);
+  total_ns_.fetch_add(latency_ns, std::memory_order_relaxed);
+}
+
+auto AtomicLatencyHistogram::Snapshot() const -> LatencyHistogram {
+  LatencyHistogram histogram;
+  for (size_t i = 0; i < LATENCY_HISTOGRAM_BUCKETS; i++) {
+    histogram.buckets_[i] = buckets_[i].load(std::memory_order_relaxed);
+  }
+  histogram.count_ = count_.load(std::memory_order_relaxed);
+  histogram.total_ns_ = total_ns_.load(std::memory_order_relaxed);
+  return histogram;
+}
+
+auto BufferPoolMetrics::operator+=(const BufferPoolMetrics &other) -> BufferPoolMetrics & {
+  pool_size_ += other.pool_size_;
+  pinned_frames_ += other.pinned_frames_;
+  hits_ += other.hits_;
+  misses_ += other.misses_;
+  clean_evictions_ += other.clean_evictions_;
+  dirty_evictions_ += other.dirty_evictions_;
+  background_writes_ += other.background_writes_;
+  pin_wait_failures_ += other.pin_wait_failures_;
+  compressed_cache_hits_ += other.compressed_cache_hits_;
+  compressed_cache_misses_ += other.compressed_cache_misses_;
+  read_latency_ += other.read_latency_;
+  write_latency_ += other.write_latency_;
+  return *this;
+}
+
+}  // namespace bustub
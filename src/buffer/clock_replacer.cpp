@@ -12,18 +12,100 @@
 
 #include "buffer/clock_replacer.h"
 
+#include "common/macros.h"
+
 namespace bustub {
 
-ClockReplacer::ClockReplacer(size_t num_pages) {}
+ClockReplacer::ClockReplacer(size_t num_pages) : frames_(num_pages) {}
 
 ClockReplacer::~ClockReplacer() = default;
 
-auto ClockReplacer::Victim(frame_id_t *frame_id) -> bool { return false; }
+void ClockReplacer::Resize(size_t num_frames) {
+  std::scoped_lock<std::mutex> lock(latch_);
+  for (size_t i = num_frames; i < frames_.size(); ++i) {
+    BUSTUB_ASSERT(!frames_[i].is_tracked_, "cannot drop a tracked frame");
+  }
+  frames_.resize(num_frames);
+  if (hand_ >= num_frames) {
+    hand_ = 0;
+  }
+}
+
+auto ClockReplacer::Evict(frame_id_t *frame_id) -> bool {
+  std::scoped_lock<std::mutex> lock(latch_);
+  if (curr_size_ == 0) {
+    return false;
+  }
+
+  // the first turn clears the bits of referenced frames, so the second one always finds a victim
+  for (size_t step = 0; step < 2 * frames_.size(); ++step) {
+    auto &meta = frames_[hand_];
+    const size_t frame = hand_;
+    hand_ = (hand_ + 1) % frames_.size();
+    if (!meta.is_evictable_) {
+      continue;
+    }
+    if (meta.is_referenced_) {
+      meta.is_referenced_ = false;
+      continue;
+    }
+    meta = FrameMeta{};
+    curr_size_--;
+    *frame_id = static_cast<frame_id_t>(frame);
+    return true;
+  }
+  UNREACHABLE("an evictable frame must be found within two turns of the clock");
+}
+
+void ClockReplacer::RecordAccess(frame_id_t frame_id) {
+  std::scoped_lock<std::mutex> lock(latch_);
+  BUSTUB_ASSERT(frame_id >= 0 && static_cast<size_t>(frame_id) < frames_.size(), "frame id is invalid");
+  auto &meta = frames_[frame_id];
+  meta.is_tracked_ = true;
+  meta.is_referenced_ = true;
+}
+
+void ClockReplacer::SetEvictable(frame_id_t frame_id, bool set_evictable) {
+  std::scoped_lock<std::mutex> lock(latch_);
+  BUSTUB_ASSERT(frame_id >= 0 && static_cast<size_t>(frame_id) < frames_.size(), "frame id is invalid");
+  auto &meta = frames_[frame_id];
+  if (!meta.is_tracked_ || meta.is_evictable_ == set_evictable) {
+    return;
+  }
+  meta.is_evictable_ = set_evictable;
+  curr_size_ = set_evictable ? curr_size_ + 1 : curr_size_ - 1;
+}
 
-void ClockReplacer::Pin(frame_id_t frame_id) {}
+void ClockReplacer::Remove(frame_id_t frame_id) {
+  std::scoped_lock<std::mutex> lock(latch_);
+  BUSTUB_ASSERT(frame_id >= 0 && static_cast<size_t>(frame_id) < frames_.size(), "frame id is invalid");
+  auto &meta = frames_[frame_id];
+  if (!meta.is_tracked_) {
+    return;
+  }
+  BUSTUB_ASSERT(meta.is_evictable_, "# Remove a non_evictable frame");
+  meta = FrameMeta{};
+  curr_size_--;
+}
 
-void ClockReplacer::Unpin(frame_id_t frame_id) {}
+auto ClockReplacer::Size() -> size_t {
+  std::scoped_lock<std::mutex> lock(latch_);
+  return curr_size_;
+}
 
-auto ClockReplacer::Size() -> size_t { return 0; }
+auto ClockReplacer::EvictionCandidates(size_t max_count) -> std::vector<frame_id_t> {
+  std::scoped_lock<std::mutex> lock(latch_);
+  // a sweep takes the unreferenced frames in hand order, then the referenced ones once their bits are cleared
+  std::vector<frame_id_t> candidates;
+  for (bool referenced : {false, true}) {
+    for (size_t i = 0; i < frames_.size() && candidates.size() < max_count; ++i) {
+      const size_t frame = (hand_ + i) % frames_.size();
+      if (frames_[frame].is_evictable_ && frames_[frame].is_referenced_ == referenced) {
+        candidates.push_back(static_cast<frame_id_t>(frame));
+      }
+    }
+  }
+  return candidates;
+}
 
 }  // namespace bustub
@@ -0,0 +1,90 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// frame_arena.cpp
+//
+// Identification: src/buffer/frame_arena.cpp
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "buffer/frame_arena.h"
+
+#include <linux/mempolicy.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <cstdint>
+#include <fstream>
+#include <string>
+
+#include "common/exception.h"
+
+namespace bustub {
+
+FrameArena::FrameArena(size_t max_frames, const FrameArenaOptions &options) : max_frames_(max_frames) {
+  const size_t size = max_frames * BUSTUB_PAGE_SIZE;
+  // over-reserve by one huge page so that the frames can start on a huge page boundary
+  mapping_size_ = options.huge_pages_ ? size + HUGE_PAGE_SIZE : size;
+  void *mapping = mmap(nullptr, mapping_size_, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+  if (mapping == MAP_FAILED) {
+    throw Exception(ExceptionType::OUT_OF_MEMORY, "cannot reserve address space for the frame arena");
+  }
+  mapping_ = static_cast<char *>(mapping);
+  base_ = mapping_;
+  if (options.huge_pages_) {
+    auto address = reinterpret_cast<uintptr_t>(mapping_);
+    base_ = mapping_ + (HUGE_PAGE_SIZE - address % HUGE_PAGE_SIZE) % HUGE_PAGE_SIZE;
+    huge_pages_ = madvise(base_, size, MADV_HUGEPAGE) == 0;
+  }
+  if (options.numa_node_ != FrameArenaOptions::NO_NUMA_NODE && options.numa_node_ < 64) {
+    // prefer, rather than require, the node: a full node should not make the pool fail to grow
+    uint64_t node_mask = uint64_t{1} << options.numa_node_;
+    if (syscall(SYS_mbind, base_, size, MPOL_PREFERRED, &node_mask, 64, 0) == 0) {
+      numa_node_ = options.numa_node_;
+    }
+  }
+}
+
+FrameArena::~FrameArena() { munmap(mapping_, mapping_size_); }
+
+void FrameArena::Commit(size_t first_frame, size_t num_frames) {
+  BUSTUB_ASSERT(first_frame + num_frames <= max_frames_, "frames out of the arena");
+  if (mprotect(Data(static_cast<frame_id_t>(first_frame)), num_frames * BUSTUB_PAGE_SIZE, PROT_READ | PROT_WRITE) !=
+      0) {
+    throw Exception(ExceptionType::OUT_OF_MEMORY, "cannot commit memory for buffer pool frames");
+  }
+}
+
+void FrameArena::Decommit(size_t first_frame, size_t num_frames) {
+  BUSTUB_ASSERT(first_frame + num_frames <= max_frames_, "frames out of the arena");
+  char *data = Data(static_cast<frame_id_t>(first_frame));
+  // dropping the pages makes them read as zeros once they are committed again
+  madvise(data, num_frames * BUSTUB_PAGE_SIZE, MADV_DONTNEED);
+  mprotect(data, num_frames * BUSTUB_PAGE_SIZE, PROT_NONE);
+}
+
+auto FrameArena::NumNumaNodes() -> size_t {
+  // e.g. "0" or "0-3"; nodes are numbered densely on the machines we care about
+  std::ifstream online("/sys/devices/system/node/online");
+  std::string nodes;
+  if (!(online >> nodes) || nodes.empty()) {
+    return 1;
+  }
+  auto dash = nodes.find_last_of("-,");
+  return std::stoul(dash == std::string::npos ? nodes : nodes.substr(dash + 1)) + 1;
+}
+
+auto FrameArena::CurrentNumaNode() -> int {
+  unsigned int cpu = 0;
+  unsigned int node = 0;
+  if (syscall(SYS_getcpu, &cpu, &node, nullptr) != 0) {
+    return 0;
+  }
+  return static_cast<int>(node);
+}
+
+}  // namespace bustub
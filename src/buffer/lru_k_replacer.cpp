@@ -12,108 +12,91 @@
 
 #include "buffer/lru_k_replacer.h"
 
+#include <queue>
+#include <utility>
+
 namespace bustub {
 
-LRUKReplacer::LRUKReplacer(size_t num_frames, size_t k) : replacer_size_(num_frames), k_(k) {}
+LRUKReplacer::LRUKReplacer(size_t num_frames, size_t k)
+    : replacer_size_(num_frames), k_(k), frames_(num_frames), timestamps_(num_frames * k) {
+  BUSTUB_ASSERT(k > 0, "k must be positive");
+  heap_.reserve(num_frames);
+}
 
-auto LRUKReplacer::Evict(frame_id_t *frame_id) -> bool {
+void LRUKReplacer::Resize(size_t num_frames) {
   std::scoped_lock<std::mutex> lock(latch_);
-  if (curr_size_ == 0) {
-    return false;
-  }
-
-  for (auto itor = history_.begin(); itor != history_.end(); ++itor) {
-    if ((*itor)->is_evictable_) {
-      *frame_id = (*itor)->frame_id_;
-      frames_.erase(*frame_id);
-      history_.erase(itor);
-      curr_size_--;
-      return true;
-    }
+  for (size_t i = num_frames; i < replacer_size_; ++i) {
+    BUSTUB_ASSERT(frames_[i].count_ == 0, "cannot drop a tracked frame");
   }
+  replacer_size_ = num_frames;
+  frames_.resize(num_frames);
+  timestamps_.resize(num_frames * k_);
+  heap_.reserve(num_frames);
+}
 
-  for (auto itor = cache_.begin(); itor != history_.end(); ++itor) {
-    if ((*itor)->is_evictable_) {
-      *frame_id = (*itor)->frame_id_;
-      frames_.erase(*frame_id);
-      cache_.erase(itor);
-      curr_size_--;
-      return true;
-    }
+auto LRUKReplacer::Evict(frame_id_t *frame_id) -> bool {
+  std::scoped_lock<std::mutex> lock(latch_);
+  if (heap_.empty()) {
+    return false;
   }
 
-  return false;
+  *frame_id = heap_.front();
+  HeapErase(*frame_id);
+  ResetFrame(*frame_id);
+  curr_size_--;
+  return true;
 }
 
 void LRUKReplacer::RecordAccess(frame_id_t frame_id) {
   std::scoped_lock<std::mutex> lock(latch_);
-  // BUSTUB_ASSERT(frame_id <= (frame_id_t)replacer_size_, "frame id is invalid");
-  auto kv = frames_.find(frame_id);
+  BUSTUB_ASSERT(frame_id >= 0 && static_cast<size_t>(frame_id) < replacer_size_, "frame id is invalid");
+  auto &meta = frames_[frame_id];
+  auto *ring = &timestamps_[frame_id * k_];
   current_timestamp_++;
-  // not found a frame
-  if (kv == frames_.end()) {
-    auto frame_meta = std::make_shared<FrameMeta>(frame_id, current_timestamp_, false);
-    frames_.insert(std::make_pair(frame_id, frame_meta));
-    if (frame_meta->cur_ >= k_) {
-      cache_.push_back(frame_meta);
-    } else {
-      history_.push_back(frame_meta);
-    }
-    return;
+  if (meta.count_ < k_) {
+    ring[(meta.head_ + meta.count_) % k_] = current_timestamp_;
+    meta.count_++;
+  } else {
+    // overwrite the oldest timestamp, the next one becomes the k-th most recent access
+    ring[meta.head_] = current_timestamp_;
+    meta.head_ = (meta.head_ + 1) % k_;
   }
 
-  auto frame_ptr = kv->second;
-  frame_ptr->timestamps_ = current_timestamp_;
-  frame_ptr->cur_++;
-
-  // now access times reach k, move it in cache
-  if (frame_ptr->cur_ == k_) {
-    history_.remove(frame_ptr);
-    cache_.push_back(frame_ptr);
-  } else if (frame_ptr->cur_ > k_) {
-    // lru rule
-    cache_.remove(frame_ptr);
-    cache_.push_back(frame_ptr);
+  // the priority of an evictable frame can only move backwards
+  if (meta.heap_index_ != NOT_IN_HEAP) {
+    HeapSiftDown(meta.heap_index_);
   }
-  // frame access times < k, FIFO rule
 }
 
 void LRUKReplacer::SetEvictable(frame_id_t frame_id, bool set_evictable) {
   std::scoped_lock<std::mutex> lock(latch_);
-  auto kv = frames_.find(frame_id);
-  if (kv != frames_.end()) {
-    auto frame_ptr = kv->second;
-    if (frame_ptr->is_evictable_ && !set_evictable) {
-      // set evictable to false
-      curr_size_--;
-      frame_ptr->is_evictable_ = set_evictable;
-    } else if (!frame_ptr->is_evictable_ && set_evictable) {
-      ++curr_size_;
-      frame_ptr->is_evictable_ = set_evictable;
-    }
+  BUSTUB_ASSERT(frame_id >= 0 && static_cast<size_t>(frame_id) < replacer_size_, "frame id is invalid");
+  auto &meta = frames_[frame_id];
+  if (meta.count_ == 0 || meta.is_evictable_ == set_evictable) {
+    return;
+  }
+
+  meta.is_evictable_ = set_evictable;
+  if (set_evictable) {
+    HeapPush(frame_id);
+    ++curr_size_;
+  } else {
+    HeapErase(frame_id);
+    curr_size_--;
   }
 }
 
 void LRUKReplacer::Remove(frame_id_t frame_id) {
   std::scoped_lock<std::mutex> lock(latch_);
-  // BUSTUB_ASSERT(frame_id <= (frame_id_t)replacer_size_, "frame id is invalid");
-  auto kv = frames_.find(frame_id);
-  if (kv == frames_.end()) {
+  BUSTUB_ASSERT(frame_id >= 0 && static_cast<size_t>(frame_id) < replacer_size_, "frame id is invalid");
+  auto &meta = frames_[frame_id];
+  if (meta.count_ == 0) {
     return;
   }
+  BUSTUB_ASSERT(meta.is_evictable_, "# Remove a non_evictable frame");
 
-  auto frame_ptr = kv->second;
-  // if (!frame_ptr->is_evictable_) {
-  //   return;
-  // }
-  BUSTUB_ASSERT(frame_ptr->is_evictable_ == true, "# Remove a non_evictable frame");
-
-  if (frame_ptr->cur_ < k_) {
-    history_.remove(frame_ptr);
-  } else {
-    cache_.remove(frame_ptr);
-  }
-  frames_.erase(frame_id);
+  HeapErase(frame_id);
+  ResetFrame(frame_id);
   curr_size_--;
 }
 
@@ -122,4 +105,102 @@ auto LRUKReplacer::Size() -> size_t {
   return curr_size_;
 }
 
+auto LRUKReplacer::EvictionCandidates(size_t max_count) -> std::vector<frame_id_t> {
+  std::scoped_lock<std::mutex> lock(latch_);
+  std::vector<frame_id_t> candidates;
+  // best-first walk of the heap, a child is never evicted before its parent
+  auto later = [this](size_t a, size_t b) { return EvictsBefore(heap_[b], heap_[a]); };
+  std::priority_queue<size_t, std::vector<size_t>, decltype(later)> frontier(later);
+  if (!heap_.empty()) {
+    frontier.push(0);
+  }
+  while (!frontier.empty() && candidates.size() < max_count) {
+    const size_t index = frontier.top();
+    frontier.pop();
+    candidates.push_back(heap_[index]);
+    for (size_t child = 2 * index + 1; child <= 2 * index + 2 && child < heap_.size(); ++child) {
+      frontier.push(child);
+    }
+  }
+  return candidates;
+}
+
+auto LRUKReplacer::OldestTimestamp(frame_id_t frame_id) const -> size_t {
+  return timestamps_[frame_id * k_ + frames_[frame_id].head_];
+}
+
+auto LRUKReplacer::EvictsBefore(frame_id_t a, frame_id_t b) const -> bool {
+  // +inf backward k-distance first, ties broken by the earliest access
+  const bool a_inf = frames_[a].count_ < k_;
+  const bool b_inf = frames_[b].count_ < k_;
+  if (a_inf != b_inf) {
+    return a_inf;
+  }
+  // otherwise the larger backward k-distance is the older k-th most recent access
+  return OldestTimestamp(a) < OldestTimestamp(b);
+}
+
+void LRUKReplacer::HeapPush(frame_id_t frame_id) {
+  frames_[frame_id].heap_index_ = heap_.size();
+  heap_.push_back(frame_id);
+  HeapSiftUp(heap_.size() - 1);
+}
+
+void LRUKReplacer::HeapErase(frame_id_t frame_id) {
+  const size_t index = frames_[frame_id].heap_index_;
+  const size_t last = heap_.size() - 1;
+  if (index != last) {
+    HeapSwap(index, last);
+  }
+  heap_.pop_back();
+  frames_[frame_id].heap_index_ = NOT_IN_HEAP;
+  if (index < heap_.size()) {
+    HeapSiftUp(index);
+    HeapSiftDown(index);
+  }
+}
+
+void LRUKReplacer::HeapSiftUp(size_t index) {
+  while (index > 0) {
+    const size_t parent = (index - 1) / 2;
+    if (!EvictsBefore(heap_[index], heap_[parent])) {
+      break;
+    }
+    HeapSwap(index, parent);
+    index = parent;
+  }
+}
+
+void LRUKReplacer::HeapSiftDown(size_t index) {
+  while (true) {
+    size_t first = index;
+    const size_t left = 2 * index + 1;
+    const size_t right = left + 1;
+    if (left < heap_.size() && EvictsBefore(heap_[left], heap_[first])) {
+      first = left;
+    }
+    if (right < heap_.size() && EvictsBefore(heap_[right], heap_[first])) {
+      first = right;
+    }
+    if (first == index) {
+      break;
+    }
+    HeapSwap(index, first);
+    index = first;
+  }
+}
+
+void LRUKReplacer::HeapSwap(size_t i, size_t j) {
+  std::swap(heap_[i], heap_[j]);
+  frames_[heap_[i]].heap_index_ = i;
+  frames_[heap_[j]].heap_index_ = j;
+}
+
+void LRUKReplacer::ResetFrame(frame_id_t frame_id) {
+  auto &meta = frames_[frame_id];
+  meta.count_ = 0;
+  meta.head_ = 0;
+  meta.is_evictable_ = false;
+}
+
 }  // namespace bustub
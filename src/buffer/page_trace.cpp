@@ -0,0 +1,120 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// page_trace.cpp
+//
+// Identification: src/buffer/page_trace.cpp
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "buffer/page_trace.h"
+
+#include <atomic>
+#include <cstring>
+
+#include "common/exception.h"
+
+namespace bustub {
+
+namespace {
+
+constexpr char PAGE_TRACE_MAGIC[8] = {'B', 'T', 'P', 'G', 'T', 'R', 'C', '1'};
+
+std::atomic<uint16_t> next_thread_id{0};
+
+auto CurrentThreadId() -> uint16_t {
+  thread_local uint16_t thread_id = next_thread_id++;
+  return thread_id;
+}
+
+}  // namespace
+
+PageTraceRecorder::PageTraceRecorder(const std::string &file_name)
+    : file_(file_name, std::ios::binary | std::ios::out | std::ios::trunc), start_(std::chrono::steady_clock::now()) {
+  if (!file_.is_open()) {
+    throw Exception("cannot create page trace file " + file_name);
+  }
+  file_.write(PAGE_TRACE_MAGIC, sizeof(PAGE_TRACE_MAGIC));
+  batch_.reserve(BATCH_SIZE);
+}
+
+PageTraceRecorder::~PageTraceRecorder() { Close(); }
+
+void PageTraceRecorder::Record(PageTraceEvent event, page_id_t page_id, uint8_t flags) {
+  PageTraceRecord record{};
+  record.timestamp_ns_ = static_cast<uint64_t>(
+      std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start_).count());
+  record.page_id_ = page_id;
+  record.thread_id_ = CurrentThreadId();
+  record.event_ = event;
+  record.flags_ = flags;
+
+  std::scoped_lock<std::mutex> lock(latch_);
+  if (closed_) {
+    return;
+  }
+  batch_.push_back(record);
+  record_count_++;
+  if (batch_.size() == BATCH_SIZE) {
+    WriteBatch();
+  }
+}
+
+void PageTraceRecorder::Close() {
+  std::scoped_lock<std::mutex> lock(latch_);
+  if (closed_) {
+    return;
+  }
+  WriteBatch();
+  file_.close();
+  closed_ = true;
+}
+
+auto PageTraceRecorder::GetRecordCount() -> size_t {
+  std::scoped_lock<std::mutex> lock(latch_);
+  return record_count_;
+}
+
+void PageTraceRecorder::WriteBatch() {
+  file_.write(reinterpret_cast<const char *>(batch_.data()),
+              static_cast<std::streamsize>(batch_.size() * sizeof(PageTraceRecord)));
+  batch_.clear();
+}
+
+auto ReadPageTrace(const std::string &file_name) -> std::vector<PageTraceRecord> {
+  std::ifstream file(file_name, std::ios::binary | std::ios::in | std::ios::ate);
+  if (!file.is_open()) {
+    throw Exception("cannot open page trace file " + file_name);
+  }
+  auto file_size = static_cast<size_t>(file.tellg());
+  char magic[sizeof(PAGE_TRACE_MAGIC)];
+  file.seekg(0);
+  if (file_size < sizeof(magic) || !file.read(magic, sizeof(magic)) ||
+      memcmp(magic, PAGE_TRACE_MAGIC, sizeof(magic)) != 0) {
+    throw Exception(file_name + " is not a page trace");
+  }
+  // a trailing partial record is what a crash in the middle of a batch leaves behind, skip it
+  std::vector<PageTraceRecord> records((file_size - sizeof(magic)) / sizeof(PageTraceRecord));
+  file.read(reinterpret_cast<char *>(records.data()),
+            static_cast<std::streamsize>(records.size() * sizeof(PageTraceRecord)));
+  if (!file) {
+    throw Exception("cannot read page trace file " + file_name);
+  }
+  return records;
+}
+
+auto PageTraceReferences(const std::vector<PageTraceRecord> &records) -> std::vector<page_id_t> {
+  std::vector<page_id_t> references;
+  for (const auto &record : records) {
+    if ((record.event_ == PageTraceEvent::FETCH || record.event_ == PageTraceEvent::NEW) &&
+        (record.flags_ & PAGE_TRACE_FAILED) == 0) {
+      references.push_back(record.page_id_);
+    }
+  }
+  return references;
+}
+
+}  // namespace bustub
@@ -0,0 +1,179 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// parallel_buffer_pool_manager.cpp
+//
+// Identification: src/buffer/parallel_buffer_pool_manager.cpp
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "buffer/parallel_buffer_pool_manager.h"
+
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+#include "common/exception.h"
+#include "common/macros.h"
+#include "fmt/format.h"
+
+namespace bustub {
+
+ParallelBufferPoolManager::ParallelBufferPoolManager(size_t num_instances, size_t pool_size, DiskManager *disk_manager,
+                                                     size_t replacer_k, LogManager *log_manager,
+                                                     ReplacerPolicy replacer_policy,
+                                                     const FrameArenaOptions &arena_options)
+    : disk_manager_(disk_manager) {
+  BUSTUB_ASSERT(num_instances > 0, "a parallel buffer pool needs at least one instance");
+  if (arena_options.numa_sub_pools_) {
+    num_numa_nodes_ = std::min(FrameArena::NumNumaNodes(), num_instances);
+  }
+  instances_.reserve(num_instances);
+  for (size_t i = 0; i < num_instances; ++i) {
+    auto instance_options = arena_options;
+    if (arena_options.numa_sub_pools_) {
+      instance_options.numa_node_ = static_cast<int>(i % num_numa_nodes_);
+    }
+    instances_.emplace_back(std::make_unique<BufferPoolManagerInstance>(
+        pool_size, static_cast<uint32_t>(num_instances), static_cast<uint32_t>(i), disk_manager, replacer_k,
+        log_manager, replacer_policy, instance_options));
+  }
+}
+
+ParallelBufferPoolManager::~ParallelBufferPoolManager() = default;
+
+auto ParallelBufferPoolManager::GetPoolSize() -> size_t {
+  size_t pool_size = 0;
+  for (auto &instance : instances_) {
+    pool_size += instance->GetPoolSize();
+  }
+  return pool_size;
+}
+
+void ParallelBufferPoolManager::Prefetch(page_id_t page_id, BufferAccessType access_type) {
+  if (page_id != INVALID_PAGE_ID) {
+    GetBufferPoolManager(page_id)->Prefetch(page_id, access_type);
+  }
+}
+
+auto ParallelBufferPoolManager::SetPoolSize(size_t pool_size) -> size_t {
+  const size_t num_instances = instances_.size();
+  // the shares differ by at most one frame; check them all before any instance is resized
+  const size_t max_pool_size = BufferPoolManagerInstance::MAX_POOL_SIZE;
+  if (pool_size < num_instances || (pool_size + num_instances - 1) / num_instances > max_pool_size) {
+    throw Exception(ExceptionType::OUT_OF_RANGE, fmt::format("buffer pool size must be between {} and {}",
+                                                             num_instances, num_instances * max_pool_size));
+  }
+  size_t total = 0;
+  for (size_t i = 0; i < num_instances; ++i) {
+    total += instances_[i]->SetPoolSize(pool_size / num_instances + (i < pool_size % num_instances ? 1 : 0));
+  }
+  return total;
+}
+
+auto ParallelBufferPoolManager::GetMetrics() -> BufferPoolMetrics {
+  BufferPoolMetrics metrics;
+  for (auto &instance : instances_) {
+    metrics += instance->GetMetrics();
+  }
+  return metrics;
+}
+
+void ParallelBufferPoolManager::SetTraceRecorder(PageTraceRecorder *recorder) {
+  for (auto &instance : instances_) {
+    instance->SetTraceRecorder(recorder);
+  }
+}
+
+void ParallelBufferPoolManager::SetZeroCopyReads(bool zero_copy) {
+  for (auto &instance : instances_) {
+    instance->SetZeroCopyReads(zero_copy);
+  }
+}
+
+auto ParallelBufferPoolManager::GetBufferPoolManager(page_id_t page_id) -> BufferPoolManagerInstance * {
+  // Page ids are handed out round-robin by the instances themselves, so the modulo is the inverse mapping.
+  return instances_[static_cast<size_t>(page_id) % instances_.size()].get();
+}
+
+auto ParallelBufferPoolManager::FetchPgImp(page_id_t page_id) -> Page * {
+  return GetBufferPoolManager(page_id)->FetchPage(page_id);
+}
+
+auto ParallelBufferPoolManager::FetchPgStrategyImp(page_id_t page_id, BufferAccessStrategy *strategy) -> Page * {
+  return GetBufferPoolManager(page_id)->FetchPage(page_id, *strategy);
+}
+
+auto ParallelBufferPoolManager::UnpinPgImp(page_id_t page_id, bool is_dirty) -> bool {
+  return GetBufferPoolManager(page_id)->UnpinPage(page_id, is_dirty);
+}
+
+auto ParallelBufferPoolManager::FlushPgImp(page_id_t page_id) -> bool {
+  if (page_id == INVALID_PAGE_ID) {
+    return false;
+  }
+  return GetBufferPoolManager(page_id)->FlushPage(page_id);
+}
+
+auto ParallelBufferPoolManager::NextNewPageInstance() -> size_t {
+  const size_t num_instances = instances_.size();
+  if (num_numa_nodes_ == 1) {
+    return next_instance_.fetch_add(1) % num_instances;
+  }
+  // round-robin over the instances on the caller's node: node, node + num_numa_nodes_, ...
+  const auto node = static_cast<size_t>(FrameArena::CurrentNumaNode()) % num_numa_nodes_;
+  const size_t local_instances = (num_instances - node + num_numa_nodes_ - 1) / num_numa_nodes_;
+  return node + num_numa_nodes_ * (next_instance_.fetch_add(1) % local_instances);
+}
+
+auto ParallelBufferPoolManager::NewPgImp(page_id_t *page_id) -> Page * {
+  // Claim a starting instance for this call; concurrent callers start from different instances.
+  const size_t num_instances = instances_.size();
+  const size_t start = NextNewPageInstance();
+  for (size_t i = 0; i < num_instances; ++i) {
+    auto *page = instances_[(start + i) % num_instances]->NewPage(page_id);
+    if (page != nullptr) {
+      return page;
+    }
+  }
+  *page_id = INVALID_PAGE_ID;
+  return nullptr;
+}
+
+auto ParallelBufferPoolManager::NewPgStrategyImp(page_id_t *page_id, BufferAccessStrategy *strategy) -> Page * {
+  const size_t num_instances = instances_.size();
+  const size_t start = NextNewPageInstance();
+  for (size_t i = 0; i < num_instances; ++i) {
+    auto *page = instances_[(start + i) % num_instances]->NewPage(page_id, *strategy);
+    if (page != nullptr) {
+      return page;
+    }
+  }
+  *page_id = INVALID_PAGE_ID;
+  return nullptr;
+}
+
+auto ParallelBufferPoolManager::DeletePgImp(page_id_t page_id) -> bool {
+  return GetBufferPoolManager(page_id)->DeletePage(page_id);
+}
+
+void ParallelBufferPoolManager::FlushAllPgsImp() {
+  // adjacent page ids live in different instances, so only one batch over all of them has runs of pages to coalesce
+  std::vector<DiskRequest> requests;
+  std::vector<std::vector<frame_id_t>> pinned_frames;
+  pinned_frames.reserve(instances_.size());
+  for (auto &instance : instances_) {
+    pinned_frames.push_back(instance->PinDirtyPages(&requests));
+  }
+  std::sort(requests.begin(), requests.end(),
+            [](const DiskRequest &a, const DiskRequest &b) { return a.page_id_ < b.page_id_; });
+  disk_manager_->SubmitRequestsAndWait(std::move(requests));
+  for (size_t i = 0; i < instances_.size(); ++i) {
+    instances_[i]->UnpinFlushedPages(pinned_frames[i]);
+  }
+}
+
+}  // namespace bustub
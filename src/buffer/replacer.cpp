@@ -0,0 +1,56 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// replacer.cpp
+//
+// Identification: src/buffer/replacer.cpp
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "buffer/replacer.h"
+
+#include "buffer/arc_replacer.h"
+#include "buffer/clock_replacer.h"
+#include "buffer/lru_k_replacer.h"
+#include "buffer/lru_replacer.h"
+#include "buffer/two_q_replacer.h"
+#include "common/exception.h"
+
+namespace bustub {
+
+auto MakeReplacer(ReplacerPolicy policy, size_t num_frames, size_t k) -> std::unique_ptr<Replacer> {
+  switch (policy) {
+    case ReplacerPolicy::LRU_K:
+      return std::make_unique<LRUKReplacer>(num_frames, k);
+    case ReplacerPolicy::LRU:
+      return std::make_unique<LRUReplacer>(num_frames);
+    case ReplacerPolicy::CLOCK:
+      return std::make_unique<ClockReplacer>(num_frames);
+    case ReplacerPolicy::TWO_Q:
+      return std::make_unique<TwoQReplacer>(num_frames);
+    case ReplacerPolicy::ARC:
+      return std::make_unique<ARCReplacer>(num_frames);
+  }
+  throw Exception(ExceptionType::INVALID, "unknown replacer policy");
+}
+
+auto ReplacerPolicyToString(ReplacerPolicy policy) -> std::string {
+  switch (policy) {
+    case ReplacerPolicy::LRU_K:
+      return "LRU-K";
+    case ReplacerPolicy::LRU:
+      return "LRU";
+    case ReplacerPolicy::CLOCK:
+      return "CLOCK";
+    case ReplacerPolicy::TWO_Q:
+      return "2Q";
+    case ReplacerPolicy::ARC:
+      return "ARC";
+  }
+  return "UNKNOWN";
+}
+
+}  // namespace bustub
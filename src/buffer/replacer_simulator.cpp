@@ -0,0 +1,62 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// replacer_simulator.cpp
+//
+// Identification: src/buffer/replacer_simulator.cpp
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "buffer/replacer_simulator.h"
+
+#include <chrono>  // NOLINT
+#include <unordered_map>
+
+#include "common/macros.h"
+
+namespace bustub {
+
+auto SimulateReplacer(ReplacerPolicy policy, size_t num_frames, const std::vector<page_id_t> &trace, size_t k)
+    -> ReplacerSimulationResult {
+  BUSTUB_ASSERT(num_frames > 0, "the simulated buffer pool needs at least one frame");
+  auto replacer = MakeReplacer(policy, num_frames, k);
+  std::unordered_map<page_id_t, frame_id_t> page_table;
+  page_table.reserve(num_frames);
+  std::vector<page_id_t> frame_to_page(num_frames, INVALID_PAGE_ID);
+  size_t next_free = 0;
+
+  ReplacerSimulationResult result;
+  auto start = std::chrono::steady_clock::now();
+  for (auto page_id : trace) {
+    frame_id_t frame_id;
+    auto kv = page_table.find(page_id);
+    if (kv != page_table.end()) {
+      frame_id = kv->second;
+      replacer->RecordAccess(frame_id);
+      result.hits_++;
+    } else {
+      if (next_free < num_frames) {
+        frame_id = static_cast<frame_id_t>(next_free++);
+      } else {
+        BUSTUB_ENSURE(replacer->Evict(&frame_id), "every simulated frame is unpinned between references");
+        page_table.erase(frame_to_page[frame_id]);
+        result.replacer_ops_++;
+      }
+      page_table[page_id] = frame_id;
+      frame_to_page[frame_id] = page_id;
+      replacer->RecordLoad(frame_id, page_id);
+      result.misses_++;
+    }
+    replacer->SetEvictable(frame_id, false);
+    replacer->SetEvictable(frame_id, true);
+    result.replacer_ops_ += 3;
+  }
+  auto elapsed = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+  result.ns_per_op_ = result.replacer_ops_ == 0 ? 0 : elapsed / static_cast<double>(result.replacer_ops_);
+  return result;
+}
+
+}  // namespace bustub
@@ -0,0 +1,150 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// two_q_replacer.cpp
+//
+// Identification: src/buffer/two_q_replacer.cpp
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "buffer/two_q_replacer.h"
+
+#include <algorithm>
+
+#include "common/macros.h"
+
+namespace bustub {
+
+TwoQReplacer::TwoQReplacer(size_t num_frames)
+    : kin_(std::max<size_t>(num_frames / 4, 1)),
+      kout_(std::max<size_t>(num_frames / 2, 1)),
+      lists_(num_frames, 2),
+      page_ids_(num_frames, INVALID_PAGE_ID),
+      is_evictable_(num_frames, false) {}
+
+TwoQReplacer::~TwoQReplacer() = default;
+
+void TwoQReplacer::Resize(size_t num_frames) {
+  std::scoped_lock<std::mutex> lock(latch_);
+  lists_.Resize(num_frames);
+  page_ids_.resize(num_frames, INVALID_PAGE_ID);
+  is_evictable_.resize(num_frames, false);
+  kin_ = std::max<size_t>(num_frames / 4, 1);
+  kout_ = std::max<size_t>(num_frames / 2, 1);
+  while (a1out_.Size() > kout_) {
+    a1out_.PopFront();
+  }
+}
+
+auto TwoQReplacer::Evict(frame_id_t *frame_id) -> bool {
+  std::scoped_lock<std::mutex> lock(latch_);
+  if (curr_size_ == 0) {
+    return false;
+  }
+
+  const bool a1in_first = lists_.Size(A1IN) > kin_;
+  for (size_t list : {a1in_first ? A1IN : AM, a1in_first ? AM : A1IN}) {
+    const frame_id_t victim = NextEvictable(lists_.Front(list));
+    if (victim == FrameLists::NO_FRAME) {
+      continue;
+    }
+    // only pages that were never re-referenced are worth remembering
+    if (list == A1IN && page_ids_[victim] != INVALID_PAGE_ID) {
+      a1out_.PushBack(page_ids_[victim]);
+      if (a1out_.Size() > kout_) {
+        a1out_.PopFront();
+      }
+    }
+    Untrack(victim);
+    *frame_id = victim;
+    return true;
+  }
+  UNREACHABLE("an evictable frame must be in one of the lists");
+}
+
+void TwoQReplacer::RecordAccess(frame_id_t frame_id) {
+  std::scoped_lock<std::mutex> lock(latch_);
+  BUSTUB_ASSERT(frame_id >= 0 && static_cast<size_t>(frame_id) < page_ids_.size(), "frame id is invalid");
+  switch (lists_.ListOf(frame_id)) {
+    case AM:
+      lists_.PushBack(AM, frame_id);
+      break;
+    case A1IN:
+      // correlated reference, the page stays where it is
+      break;
+    default:
+      lists_.PushBack(A1IN, frame_id);
+      page_ids_[frame_id] = INVALID_PAGE_ID;
+  }
+}
+
+void TwoQReplacer::RecordLoad(frame_id_t frame_id, page_id_t page_id) {
+  std::scoped_lock<std::mutex> lock(latch_);
+  BUSTUB_ASSERT(frame_id >= 0 && static_cast<size_t>(frame_id) < page_ids_.size(), "frame id is invalid");
+  lists_.PushBack(a1out_.Erase(page_id) ? AM : A1IN, frame_id);
+  page_ids_[frame_id] = page_id;
+}
+
+void TwoQReplacer::SetEvictable(frame_id_t frame_id, bool set_evictable) {
+  std::scoped_lock<std::mutex> lock(latch_);
+  BUSTUB_ASSERT(frame_id >= 0 && static_cast<size_t>(frame_id) < page_ids_.size(), "frame id is invalid");
+  if (lists_.ListOf(frame_id) == FrameLists::NO_LIST || is_evictable_[frame_id] == set_evictable) {
+    return;
+  }
+  is_evictable_[frame_id] = set_evictable;
+  curr_size_ = set_evictable ? curr_size_ + 1 : curr_size_ - 1;
+}
+
+void TwoQReplacer::Remove(frame_id_t frame_id) {
+  std::scoped_lock<std::mutex> lock(latch_);
+  BUSTUB_ASSERT(frame_id >= 0 && static_cast<size_t>(frame_id) < page_ids_.size(), "frame id is invalid");
+  if (lists_.ListOf(frame_id) == FrameLists::NO_LIST) {
+    return;
+  }
+  BUSTUB_ASSERT(is_evictable_[frame_id], "# Remove a non_evictable frame");
+  Untrack(frame_id);
+}
+
+auto TwoQReplacer::Size() -> size_t {
+  std::scoped_lock<std::mutex> lock(latch_);
+  return curr_size_;
+}
+
+auto TwoQReplacer::EvictionCandidates(size_t max_count) -> std::vector<frame_id_t> {
+  std::scoped_lock<std::mutex> lock(latch_);
+  std::vector<frame_id_t> candidates;
+  // replay Evict() on cursors; every A1in victim shrinks A1in, pinned frames keep counting towards it
+  size_t a1in_size = lists_.Size(A1IN);
+  frame_id_t next[2] = {NextEvictable(lists_.Front(A1IN)), NextEvictable(lists_.Front(AM))};
+  while (candidates.size() < max_count && (next[A1IN] != FrameLists::NO_FRAME || next[AM] != FrameLists::NO_FRAME)) {
+    size_t list = a1in_size > kin_ ? A1IN : AM;
+    if (next[list] == FrameLists::NO_FRAME) {
+      list = list == A1IN ? AM : A1IN;
+    }
+    candidates.push_back(next[list]);
+    next[list] = NextEvictable(lists_.Next(next[list]));
+    if (list == A1IN) {
+      a1in_size--;
+    }
+  }
+  return candidates;
+}
+
+auto TwoQReplacer::NextEvictable(frame_id_t frame_id) const -> frame_id_t {
+  while (frame_id != FrameLists::NO_FRAME && !is_evictable_[frame_id]) {
+    frame_id = lists_.Next(frame_id);
+  }
+  return frame_id;
+}
+
+void TwoQReplacer::Untrack(frame_id_t frame_id) {
+  lists_.Erase(frame_id);
+  page_ids_[frame_id] = INVALID_PAGE_ID;
+  is_evictable_[frame_id] = false;
+  curr_size_--;
+}
+
+}  // namespace bustub
@@ -64,6 +64,8 @@ auto TableGenerator::MakeValues(ColumnInsertMeta *col_meta, uint32_t count) -> s
 void TableGenerator::FillTable(TableInfo *info, TableInsertMeta *table_meta) {
   uint32_t num_inserted = 0;
   uint32_t batch_size = 128;
+  // a generated table is a bulk load, keep it from flushing the rest of the buffer pool
+  BufferAccessStrategy strategy(BufferAccessType::BULK_WRITE);
   while (num_inserted < table_meta->num_rows_) {
     std::vector<std::vector<Value>> values;
     uint32_t num_values = std::min(batch_size, table_meta->num_rows_ - num_inserted);
@@ -77,7 +79,8 @@ void TableGenerator::FillTable(TableInfo *info, TableInsertMeta *table_meta) {
         entry.emplace_back(col[i]);
       }
       RID rid;
-      bool inserted = info->table_->InsertTuple(Tuple(entry, &info->schema_), &rid, exec_ctx_->GetTransaction());
+      bool inserted =
+          info->table_->InsertTuple(Tuple(entry, &info->schema_), &rid, exec_ctx_->GetTransaction(), &strategy);
       BUSTUB_ENSURE(inserted, "Sequential insertion cannot fail");
       num_inserted++;
     }
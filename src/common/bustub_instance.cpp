@@ -33,6 +33,7 @@
 #include "recovery/log_manager.h"
 #include "storage/disk/disk_manager.h"
 #include "storage/disk/disk_manager_memory.h"
+#include "storage/disk/disk_manager_posix.h"
 #include "type/value_factory.h"
 
 namespace bustub {
@@ -45,7 +46,9 @@ BustubInstance::BustubInstance(const std::string &db_file_name) {
   enable_logging = false;
 
   // Storage related.
-  disk_manager_ = new DiskManager(db_file_name);
+  disk_manager_ = new DiskManagerPosix(db_file_name);
+  // deleted pages are reused, and \compact gives free pages at the end of the file back
+  disk_manager_->EnableFreeSpaceMap();
 
   // Log related.
   log_manager_ = new LogManager(disk_manager_);
@@ -146,6 +149,101 @@ void BustubInstance::CmdDisplayIndices(ResultWriter &writer) {
   writer.EndTable();
 }
 
+void BustubInstance::CmdDisplayBufferPoolMetrics(ResultWriter &writer) {
+  if (buffer_pool_manager_ == nullptr) {
+    throw Exception("buffer pool is not available");
+  }
+  auto metrics = buffer_pool_manager_->GetMetrics();
+  auto write_row = [&writer](const std::string &name, const std::string &value) {
+    writer.BeginRow();
+    writer.WriteCell(name);
+    writer.WriteCell(value);
+    writer.EndRow();
+  };
+
+  writer.BeginTable(false);
+  writer.BeginHeader();
+  writer.WriteHeaderCell("metric");
+  writer.WriteHeaderCell("value");
+  writer.EndHeader();
+  write_row("pool_size", fmt::format("{}", metrics.pool_size_));
+  write_row("pinned_frames", fmt::format("{}", metrics.pinned_frames_));
+  write_row("hits", fmt::format("{}", metrics.hits_));
+  write_row("misses", fmt::format("{}", metrics.misses_));
+  write_row("hit_ratio", fmt::format("{:.4f}", metrics.HitRatio()));
+  write_row("clean_evictions", fmt::format("{}", metrics.clean_evictions_));
+  write_row("dirty_evictions", fmt::format("{}", metrics.dirty_evictions_));
+  write_row("background_writes", fmt::format("{}", metrics.background_writes_));
+  write_row("pin_wait_failures", fmt::format("{}", metrics.pin_wait_failures_));
+  write_row("compressed_cache_hits", fmt::format("{}", metrics.compressed_cache_hits_));
+  write_row("compressed_cache_misses", fmt::format("{}", metrics.compressed_cache_misses_));
+  write_row("compressed_cache_hit_ratio", fmt::format("{:.4f}", metrics.CompressedCacheHitRatio()));
+  for (const auto &[name, histogram] : {std::make_pair("read", metrics.read_latency_),
+                                        std::make_pair("write", metrics.write_latency_)}) {
+    write_row(fmt::format("{}s", name), fmt::format("{}", histogram.count_));
+    write_row(fmt::format("{}_mean_us", name), fmt::format("{:.1f}", histogram.MeanMicros()));
+    // quantiles are only known up to their histogram bucket
+    for (const auto &[label, fraction] : {std::make_pair("p50", 0.5), std::make_pair("p99", 0.99)}) {
+      write_row(fmt::format("{}_{}_us", name, label),
+                histogram.count_ == 0 ? "-" : fmt::format("<{}", histogram.QuantileMicros(fraction)));
+    }
+  }
+  writer.EndTable();
+
+  // the latency histograms, without the empty buckets
+  writer.BeginTable(false);
+  writer.BeginHeader();
+  writer.WriteHeaderCell("latency_us");
+  writer.WriteHeaderCell("reads");
+  writer.WriteHeaderCell("writes");
+  writer.EndHeader();
+  for (size_t i = 0; i < LATENCY_HISTOGRAM_BUCKETS; i++) {
+    if (metrics.read_latency_.buckets_[i] == 0 && metrics.write_latency_.buckets_[i] == 0) {
+      continue;
+    }
+    writer.BeginRow();
+    writer.WriteCell(i + 1 == LATENCY_HISTOGRAM_BUCKETS
+                         ? fmt::format(">={}", LatencyHistogram::BucketUpperBoundMicros(i - 1))
+                         : fmt::format("<{}", LatencyHistogram::BucketUpperBoundMicros(i)));
+    writer.WriteCell(fmt::format("{}", metrics.read_latency_.buckets_[i]));
+    writer.WriteCell(fmt::format("{}", metrics.write_latency_.buckets_[i]));
+    writer.EndRow();
+  }
+  writer.EndTable();
+}
+
+void BustubInstance::CmdSetBufferPoolSize(const std::string &value, ResultWriter &writer) {
+  if (buffer_pool_manager_ == nullptr) {
+    throw Exception("buffer pool is not available");
+  }
+  size_t pool_size = 0;
+  try {
+    size_t parsed = 0;
+    pool_size = std::stoul(value, &parsed);
+    if (parsed != value.size()) {
+      throw std::invalid_argument(value);
+    }
+  } catch (const std::logic_error &e) {
+    throw Exception(fmt::format("invalid buffer_pool_size: {}", value));
+  }
+  const size_t new_pool_size = buffer_pool_manager_->SetPoolSize(pool_size);
+  if (new_pool_size != pool_size) {
+    WriteOneCell(fmt::format("buffer_pool_size={}, pinned pages kept the pool from shrinking further", new_pool_size),
+                 writer);
+  }
+}
+
+void BustubInstance::CmdCompact(ResultWriter &writer) {
+  auto *free_space_map = disk_manager_->GetFreeSpaceMap();
+  if (free_space_map == nullptr) {
+    throw Exception("the database has no free space map");
+  }
+  const size_t truncated = disk_manager_->TruncateFreePages();
+  WriteOneCell(fmt::format("truncated {} free pages, the database file has {} pages of which {} are free", truncated,
+                           free_space_map->GetEnd(), free_space_map->GetNumFreePages()),
+               writer);
+}
+
 void BustubInstance::WriteOneCell(const std::string &cell, ResultWriter &writer) {
   writer.BeginTable(true);
   writer.BeginRow();
@@ -159,6 +257,8 @@ void BustubInstance::CmdDisplayHelp(ResultWriter &writer) {
 
 \dt: show all tables
 \di: show all indices
+\bpm: show buffer pool metrics
+\compact: truncate the free pages at the end of the database file
 \help: show this message again
 
 BusTub shell currently only supports a small set of Postgres queries. We'll set
@@ -191,6 +291,14 @@ auto BustubInstance::ExecuteSqlTxn(const std::string &sql, ResultWriter &writer,
       CmdDisplayIndices(writer);
       return true;
     }
+    if (sql == "\\bpm") {
+      CmdDisplayBufferPoolMetrics(writer);
+      return true;
+    }
+    if (sql == "\\compact") {
+      CmdCompact(writer);
+      return true;
+    }
     if (sql == "\\help") {
       CmdDisplayHelp(writer);
       return true;
@@ -240,7 +348,7 @@ auto BustubInstance::ExecuteSqlTxn(const std::string &sql, ResultWriter &writer,
         std::unique_lock<std::shared_mutex> l(catalog_lock_);
         auto info = catalog_->CreateIndex<IntegerKeyType, IntegerValueType, IntegerComparatorType>(
             txn, index_stmt.index_name_, index_stmt.table_->table_, index_stmt.table_->schema_, key_schema, col_ids,
-            INTEGER_SIZE, IntegerHashFunctionType{});
+            INTEGER_SIZE, IntegerHashFunctionType{}, index_stmt.index_type_, index_stmt.fill_factor_);
         l.unlock();
 
         if (info == nullptr) {
@@ -252,11 +360,18 @@ auto BustubInstance::ExecuteSqlTxn(const std::string &sql, ResultWriter &writer,
       case StatementType::VARIABLE_SHOW_STATEMENT: {
         const auto &show_stmt = dynamic_cast<const VariableShowStatement &>(*statement);
         auto content = GetSessionVariable(show_stmt.variable_);
+        if (show_stmt.variable_ == "buffer_pool_size" && buffer_pool_manager_ != nullptr) {
+          content = fmt::format("{}", buffer_pool_manager_->GetPoolSize());
+        }
         WriteOneCell(fmt::format("{}={}", show_stmt.variable_, content), writer);
         continue;
       }
       case StatementType::VARIABLE_SET_STATEMENT: {
         const auto &set_stmt = dynamic_cast<const VariableSetStatement &>(*statement);
+        if (set_stmt.variable_ == "buffer_pool_size") {
+          CmdSetBufferPoolSize(set_stmt.value_, writer);
+          continue;
+        }
         session_variables_[set_stmt.variable_] = set_stmt.value_;
         continue;
       }
@@ -20,4 +20,10 @@ std::chrono::duration<int64_t> log_timeout = std::chrono::seconds(1);
 
 std::chrono::milliseconds cycle_detection_interval = std::chrono::milliseconds(50);
 
+std::chrono::milliseconds background_flush_interval = std::chrono::milliseconds(10);
+
+std::atomic<size_t> scan_prefetch_window(8);
+
+std::atomic<size_t> index_build_sort_memory(64 << 20);
+
 }  // namespace bustub
@@ -0,0 +1,59 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// striped_hash_table.cpp
+//
+// Identification: src/container/hash/striped_hash_table.cpp
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "container/hash/striped_hash_table.h"
+
+#include <mutex>  // NOLINT
+#include <string>
+
+#include "common/config.h"
+#include "common/macros.h"
+
+namespace bustub {
+
+template <typename K, typename V>
+StripedHashTable<K, V>::StripedHashTable(size_t num_stripes)
+    : num_stripes_(num_stripes), stripes_(new Stripe[num_stripes]) {
+  BUSTUB_ASSERT(num_stripes > 0, "a striped hash table needs at least one stripe");
+}
+
+template <typename K, typename V>
+auto StripedHashTable<K, V>::Find(const K &key, V &value) -> bool {
+  auto &stripe = GetStripe(key);
+  std::shared_lock<std::shared_mutex> lock(stripe.latch_);
+  auto it = stripe.map_.find(key);
+  if (it == stripe.map_.end()) {
+    return false;
+  }
+  value = it->second;
+  return true;
+}
+
+template <typename K, typename V>
+void StripedHashTable<K, V>::Insert(const K &key, const V &value) {
+  auto &stripe = GetStripe(key);
+  std::unique_lock<std::shared_mutex> lock(stripe.latch_);
+  stripe.map_[key] = value;
+}
+
+template <typename K, typename V>
+auto StripedHashTable<K, V>::Remove(const K &key) -> bool {
+  auto &stripe = GetStripe(key);
+  std::unique_lock<std::shared_mutex> lock(stripe.latch_);
+  return stripe.map_.erase(key) > 0;
+}
+
+template class StripedHashTable<page_id_t, frame_id_t>;
+// test purpose
+template class StripedHashTable<int, std::string>;
+
+}  // namespace bustub
@@ -66,7 +66,11 @@ auto InsertExecutor::Next([[maybe_unused]] Tuple *tuple, RID *rid) -> bool {
     //     throw e;
     //   }
     // }
-    if (table_info_->table_->InsertTuple(*tuple, rid, exec_ctx_->GetTransaction())) {
+    if (rows == BULK_INSERT_THRESHOLD && strategy_ == nullptr) {
+      // a large insert appends through a ring of frames instead of filling the buffer pool with new pages
+      strategy_ = std::make_unique<BufferAccessStrategy>(BufferAccessType::BULK_WRITE);
+    }
+    if (table_info_->table_->InsertTuple(*tuple, rid, exec_ctx_->GetTransaction(), strategy_.get())) {
       rows++;
       auto index_infos = exec_ctx_->GetCatalog()->GetTableIndexes(table_info_->name_);
       for (auto &index_info : index_infos) {
@@ -14,11 +14,26 @@
 
 namespace bustub {
 
+namespace {
+/**
+ * Scans of tables that take up at least a quarter of the buffer pool go through a bulk-read ring, so that they do not
+ * push everything else out of the pool. Smaller tables are scanned normally: they are cheap to keep resident, and
+ * rescans (e.g. the inner side of a nested loop join) should keep hitting them.
+ */
+auto MakeScanStrategy(ExecutorContext *exec_ctx, TableInfo *table_info) -> std::unique_ptr<BufferAccessStrategy> {
+  if (table_info->table_->GetKnownPageCount() * 4 < exec_ctx->GetBufferPoolManager()->GetPoolSize()) {
+    return nullptr;
+  }
+  return std::make_unique<BufferAccessStrategy>(BufferAccessType::BULK_READ);
+}
+}  // namespace
+
 SeqScanExecutor::SeqScanExecutor(ExecutorContext *exec_ctx, const SeqScanPlanNode *plan)
     : AbstractExecutor(exec_ctx),
       plan_(plan),
       table_info_(exec_ctx->GetCatalog()->GetTable(plan->GetTableOid())),
-      table_iter_(table_info_->table_->Begin(exec_ctx_->GetTransaction())) {}
+      strategy_(MakeScanStrategy(exec_ctx, table_info_)),
+      table_iter_(table_info_->table_->Begin(exec_ctx_->GetTransaction(), strategy_.get())) {}
 
 void SeqScanExecutor::Init() {
   auto txn = exec_ctx_->GetTransaction();
@@ -14,6 +14,7 @@
 #include "binder/bound_statement.h"
 #include "binder/expressions/bound_column_ref.h"
 #include "binder/table_ref/bound_base_table_ref.h"
+#include "catalog/catalog.h"
 #include "catalog/column.h"
 
 namespace bustub {
@@ -21,7 +22,8 @@ namespace bustub {
 class IndexStatement : public BoundStatement {
  public:
   explicit IndexStatement(std::string index_name, std::unique_ptr<BoundBaseTableRef> table,
-                          std::vector<std::unique_ptr<BoundColumnRef>> cols);
+                          std::vector<std::unique_ptr<BoundColumnRef>> cols,
+                          IndexType index_type = IndexType::BPlusTreeIndex, int fill_factor = INDEX_FILL_FACTOR);
 
   /** Name of the index */
   std::string index_name_;
@@ -32,6 +34,12 @@ class IndexStatement : public BoundStatement {
   /** Name of the columns */
   std::vector<std::unique_ptr<BoundColumnRef>> cols_;
 
+  /** Data structure of the index, from USING */
+  IndexType index_type_;
+
+  /** Percent of a page a bulk loaded B+ tree fills, from WITH (fillfactor = n) */
+  int fill_factor_;
+
   auto ToString() const -> std::string override;
 };
 
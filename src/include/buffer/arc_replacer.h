@@ -0,0 +1,88 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// arc_replacer.h
+//
+// Identification: src/include/buffer/arc_replacer.h
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <mutex>  // NOLINT
+#include <vector>
+
+#include "buffer/frame_list.h"
+#include "buffer/replacer.h"
+#include "common/config.h"
+
+namespace bustub {
+
+/**
+ * ARCReplacer implements the Adaptive Replacement Cache policy (Megiddo and Modha, FAST 2003).
+ *
+ * Resident pages are split between T1, pages seen once recently, and T2, pages seen at least twice; both are LRU
+ * lists. B1 and B2 remember the ids of pages recently evicted from T1 and T2. A load of a page remembered in B1 means
+ * T1 was too small and grows the target size p of T1, a load of a page remembered in B2 shrinks it. Victims come
+ * from T1 while it is larger than p, otherwise from T2.
+ *
+ * Eviction is decided before the next page is known, so the original tie-break on |T1| == p for a page coming back
+ * from B2 is not applied. Lists keep their order while frames are pinned; Evict() skips non-evictable frames from the
+ * LRU end of a list.
+ */
+class ARCReplacer : public Replacer {
+ public:
+  /**
+   * Create a new ARCReplacer.
+   * @param num_frames the maximum number of frames the replacer will be required to store
+   */
+  explicit ARCReplacer(size_t num_frames);
+
+  ~ARCReplacer() override;
+
+  auto Evict(frame_id_t *frame_id) -> bool override;
+
+  void RecordAccess(frame_id_t frame_id) override;
+
+  void RecordLoad(frame_id_t frame_id, page_id_t page_id) override;
+
+  void SetEvictable(frame_id_t frame_id, bool set_evictable) override;
+
+  void Remove(frame_id_t frame_id) override;
+
+  auto Size() -> size_t override;
+
+  auto EvictionCandidates(size_t max_count) -> std::vector<frame_id_t> override;
+
+  void Resize(size_t num_frames) override;
+
+  /** @return the current target size of T1, for tests */
+  auto GetTargetT1Size() -> size_t;
+
+ private:
+  static constexpr size_t T1 = 0;
+  static constexpr size_t T2 = 1;
+
+  /** @return the first evictable frame at or after frame_id in its list, or FrameLists::NO_FRAME */
+  auto NextEvictable(frame_id_t frame_id) const -> frame_id_t;
+  /** Stop tracking a frame that is in one of the lists. */
+  void Untrack(frame_id_t frame_id);
+
+  /** Number of frames, c in the paper. */
+  size_t capacity_;
+  /** Target size of T1, p in the paper. */
+  size_t target_t1_{0};
+  FrameLists lists_;
+  /** Page held by every tracked frame, INVALID_PAGE_ID if it was tracked through RecordAccess(). */
+  std::vector<page_id_t> page_ids_;
+  std::vector<bool> is_evictable_;
+  GhostList b1_;
+  GhostList b2_;
+  size_t curr_size_{0};
+  std::mutex latch_;
+};
+
+}  // namespace bustub
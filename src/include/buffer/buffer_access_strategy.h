@@ -0,0 +1,85 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// buffer_access_strategy.h
+//
+// Identification: src/include/buffer/buffer_access_strategy.h
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <vector>
+
+#include "common/config.h"
+
+namespace bustub {
+
+/** How a caller is going to use the pages it fetches, see BufferAccessStrategy. */
+enum class BufferAccessType {
+  /** Regular access: pages enter the replacer's history like any other page. */
+  NORMAL,
+  /** A large sequential read, e.g. a full table scan or the heap scan of CREATE INDEX. */
+  BULK_READ,
+  /** A large sequential write, e.g. a bulk insert. Recycled frames are usually dirty and written back on reuse. */
+  BULK_WRITE,
+};
+
+/** Number of frames a BULK_READ strategy recycles, before the per-instance cap of the buffer pool. */
+static constexpr size_t BULK_READ_RING_SIZE = 32;
+/** Number of frames a BULK_WRITE strategy recycles, before the per-instance cap of the buffer pool. */
+static constexpr size_t BULK_WRITE_RING_SIZE = 64;
+
+/**
+ * BufferAccessStrategy keeps a large sequential operation from flushing the rest of the buffer pool. Under a bulk
+ * strategy, the pages the operation reads in go to a small private ring of frames: once the ring is full, the next
+ * miss reuses the frame of the oldest page in the ring instead of asking the replacer for a victim. Repeated fetches of
+ * a ring page through the strategy are not recorded in the replacer's history, so the page never looks hot to LRU-K
+ * and is among the first victims once the operation moves on.
+ *
+ * A ring page that somebody else fetches without the strategy is handed over to the replacer and is not recycled by
+ * the ring. A NORMAL strategy behaves exactly like FetchPage()/NewPage() without a strategy.
+ *
+ * A strategy belongs to a single operation and is not thread-safe. It may be used with any BufferPoolManager; the
+ * instances of a ParallelBufferPoolManager each keep their own ring inside it.
+ */
+class BufferAccessStrategy {
+ public:
+  /** The frames recycled by one buffer pool instance, as the page ids that were read into them, oldest first. */
+  struct Ring {
+    /** Page id last read into each slot of the ring, INVALID_PAGE_ID for a slot that was never used. */
+    std::vector<page_id_t> slots_;
+    /** The slot that is reused by the next miss. */
+    size_t next_{0};
+  };
+
+  /**
+   * @brief Create a new strategy with empty rings.
+   * @param type the access pattern of the operation
+   */
+  explicit BufferAccessStrategy(BufferAccessType type);
+
+  /** @return the access pattern of the operation */
+  auto GetType() const -> BufferAccessType { return type_; }
+
+  /** @return the number of frames the strategy may recycle in one buffer pool instance, 0 for NORMAL */
+  auto GetRingSize() const -> size_t;
+
+  /**
+   * @brief Get the ring of a buffer pool instance, creating it on first use.
+   * @param instance_index index of the buffer pool instance in its parallel buffer pool, 0 if it stands alone
+   * @param ring_size number of slots of the ring if it has to be created
+   * @return the ring of the instance
+   */
+  auto GetRing(uint32_t instance_index, size_t ring_size) -> Ring &;
+
+ private:
+  BufferAccessType type_;
+  /** Rings indexed by buffer pool instance. */
+  std::vector<Ring> rings_;
+};
+
+}  // namespace bustub
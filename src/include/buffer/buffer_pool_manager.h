@@ -16,6 +16,8 @@
 #include <mutex>  // NOLINT
 #include <unordered_map>
 
+#include "buffer/buffer_access_strategy.h"
+#include "buffer/buffer_pool_metrics.h"
 #include "buffer/lru_replacer.h"
 #include "recovery/log_manager.h"
 #include "storage/disk/disk_manager.h"
@@ -84,9 +86,72 @@ class BufferPoolManager {
     GradingCallback(callback, CallbackType::AFTER, INVALID_PAGE_ID);
   }
 
+  /**
+   * Fetch a page on behalf of a large sequential operation, see BufferAccessStrategy. On a miss, the page is read into
+   * a frame recycled from the strategy's ring when possible, and the fetch is not recorded in the replacer's history.
+   * @param page_id id of page to be fetched
+   * @param strategy the access strategy of the operation
+   * @return nullptr if page_id cannot be fetched, otherwise pointer to the requested page
+   */
+  auto FetchPage(page_id_t page_id, BufferAccessStrategy &strategy) -> Page * {
+    return FetchPgStrategyImp(page_id, &strategy);
+  }
+
+  /**
+   * Create a new page on behalf of a large sequential operation, see BufferAccessStrategy.
+   * @param[out] page_id id of created page
+   * @param strategy the access strategy of the operation
+   * @return nullptr if no new pages could be created, otherwise pointer to new page
+   */
+  auto NewPage(page_id_t *page_id, BufferAccessStrategy &strategy) -> Page * {
+    return NewPgStrategyImp(page_id, &strategy);
+  }
+
   /** @return size of the buffer pool */
   virtual auto GetPoolSize() -> size_t = 0;
 
+  /**
+   * Grow or shrink the buffer pool while it is in use. The default implementation cannot resize.
+   * @param pool_size the requested number of frames
+   * @return the number of frames after the call, which may differ from the request if pinned pages keep the pool from
+   * shrinking
+   */
+  virtual auto SetPoolSize(__attribute__((unused)) size_t pool_size) -> size_t { return GetPoolSize(); }
+
+  /**
+   * Take a snapshot of the buffer pool's counters. Counters only grow, so the difference of two snapshots describes
+   * the calls made in between. The default implementation only fills in the pool size.
+   * @return the current metrics
+   */
+  virtual auto GetMetrics() -> BufferPoolMetrics {
+    BufferPoolMetrics metrics;
+    metrics.pool_size_ = GetPoolSize();
+    return metrics;
+  }
+
+  /**
+   * Hint that a page will be fetched soon. If it is not resident, it is read into a free or evictable frame in the
+   * background and left unpinned. Page ids that were never allocated are ignored. The default implementation ignores
+   * every hint.
+   * @param page_id id of page to be prefetched
+   * @param access_type the access pattern of the caller; pages prefetched for a bulk operation are read into frames
+   * recycled from a private ring, like the pages the operation fetches itself, see BufferAccessStrategy
+   */
+  virtual void Prefetch(__attribute__((unused)) page_id_t page_id,
+                        __attribute__((unused)) BufferAccessType access_type = BufferAccessType::NORMAL) {}
+
+  /**
+   * Hint that the pages [first_page_id, first_page_id + count) will be fetched soon, see Prefetch().
+   * @param first_page_id id of the first page to be prefetched
+   * @param count number of pages to prefetch
+   * @param access_type the access pattern of the caller
+   */
+  void PrefetchRange(page_id_t first_page_id, size_t count, BufferAccessType access_type = BufferAccessType::NORMAL) {
+    for (size_t i = 0; i < count; ++i) {
+      Prefetch(first_page_id + static_cast<page_id_t>(i), access_type);
+    }
+  }
+
  protected:
   /**
    * Grading function. Do not modify!
@@ -108,6 +173,18 @@ class BufferPoolManager {
    */
   virtual auto FetchPgImp(page_id_t page_id) -> Page * = 0;
 
+  /**
+   * Fetch the requested page from the buffer pool under an access strategy. The default implementation ignores the
+   * strategy.
+   * @param page_id id of page to be fetched
+   * @param strategy the access strategy of the caller
+   * @return the requested page
+   */
+  virtual auto FetchPgStrategyImp(page_id_t page_id, __attribute__((unused)) BufferAccessStrategy *strategy)
+      -> Page * {
+    return FetchPgImp(page_id);
+  }
+
   /**
    * Unpin the target page from the buffer pool.
    * @param page_id id of page to be unpinned
@@ -130,6 +207,17 @@ class BufferPoolManager {
    */
   virtual auto NewPgImp(page_id_t *page_id) -> Page * = 0;
 
+  /**
+   * Creates a new page in the buffer pool under an access strategy. The default implementation ignores the strategy.
+   * @param[out] page_id id of created page
+   * @param strategy the access strategy of the caller
+   * @return nullptr if no new pages could be created, otherwise pointer to new page
+   */
+  virtual auto NewPgStrategyImp(page_id_t *page_id, __attribute__((unused)) BufferAccessStrategy *strategy)
+      -> Page * {
+    return NewPgImp(page_id);
+  }
+
   /**
    * Deletes a page from the buffer pool.
    * @param page_id id of page to be deleted
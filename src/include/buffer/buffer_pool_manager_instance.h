@@ -12,20 +12,44 @@
 
 #pragma once
 
+#include <atomic>
+#include <chrono>  // NOLINT
+#include <condition_variable>  // NOLINT
+#include <functional>
 #include <list>
-#include <mutex>  // NOLINT
+#include <memory>
+#include <mutex>   // NOLINT
+#include <thread>  // NOLINT
 #include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
 
+#include "buffer/buffer_access_strategy.h"
 #include "buffer/buffer_pool_manager.h"
+#include "buffer/frame_arena.h"
 #include "buffer/lru_k_replacer.h"
+#include "buffer/page_trace.h"
+#include "buffer/replacer.h"
 #include "common/config.h"
-#include "container/hash/extendible_hash_table.h"
+#include "common/macros.h"
+#include "container/hash/striped_hash_table.h"
 #include "recovery/log_manager.h"
 #include "storage/disk/disk_manager.h"
 #include "storage/page/page.h"
 
 namespace bustub {
 
+/** Counters describing how dirty pages reached the disk, see BufferPoolManagerInstance::GetWriteStats(). */
+struct BufferPoolWriteStats {
+  /** Pages written by the background flusher. */
+  uint64_t background_writes_{0};
+  /** Victims that were still dirty when a foreground FetchPage/NewPage evicted them, and had to be written first. */
+  uint64_t dirty_evictions_{0};
+  /** Victims that were clean when a foreground FetchPage/NewPage evicted them. */
+  uint64_t clean_evictions_{0};
+};
+
 /**
  * BufferPoolManager reads disk pages to and from its internal buffer pool.
  */
@@ -37,9 +61,32 @@ class BufferPoolManagerInstance : public BufferPoolManager {
    * @param disk_manager the disk manager
    * @param replacer_k the lookback constant k for the LRU-K replacer
    * @param log_manager the log manager (for testing only: nullptr = disable logging). Please ignore this for P1.
+   * @param replacer_policy the replacement policy of the buffer pool
+   * @param arena_options huge page and NUMA placement of the page data
    */
   BufferPoolManagerInstance(size_t pool_size, DiskManager *disk_manager, size_t replacer_k = LRUK_REPLACER_K,
-                            LogManager *log_manager = nullptr);
+                            LogManager *log_manager = nullptr, ReplacerPolicy replacer_policy = ReplacerPolicy::LRU_K,
+                            const FrameArenaOptions &arena_options = {});
+
+  /**
+   * @brief Creates a new BufferPoolManagerInstance that is one shard of a ParallelBufferPoolManager.
+   *
+   * A shard only allocates page ids that satisfy page_id % num_instances == instance_index, so that the owning
+   * ParallelBufferPoolManager can route any page id back to the shard that created it.
+   *
+   * @param pool_size the size of the buffer pool
+   * @param num_instances total number of BPIs in parallel BPM
+   * @param instance_index index of this BPI in the parallel BPM
+   * @param disk_manager the disk manager
+   * @param replacer_k the lookback constant k for the LRU-K replacer
+   * @param log_manager the log manager (for testing only: nullptr = disable logging). Please ignore this for P1.
+   * @param replacer_policy the replacement policy of the buffer pool
+   * @param arena_options huge page and NUMA placement of the page data
+   */
+  BufferPoolManagerInstance(size_t pool_size, uint32_t num_instances, uint32_t instance_index,
+                            DiskManager *disk_manager, size_t replacer_k = LRUK_REPLACER_K,
+                            LogManager *log_manager = nullptr, ReplacerPolicy replacer_policy = ReplacerPolicy::LRU_K,
+                            const FrameArenaOptions &arena_options = {});
 
   /**
    * @brief Destroy an existing BufferPoolManagerInstance.
@@ -49,8 +96,89 @@ class BufferPoolManagerInstance : public BufferPoolManager {
   /** @brief Return the size (number of frames) of the buffer pool. */
   auto GetPoolSize() -> size_t override { return pool_size_; }
 
-  /** @brief Return the pointer to all the pages in the buffer pool. */
-  auto GetPages() -> Page * { return pages_; }
+  /**
+   * @brief Return the page object of a frame, whatever page it holds. Only meant for tests that inspect the pool while
+   * nothing else runs.
+   * @param frame_id the frame, less than GetPoolSize()
+   */
+  auto GetFrame(frame_id_t frame_id) -> Page * { return &PageOf(frame_id); }
+
+  /** @return the arena holding the page data of every frame */
+  auto GetFrameArena() const -> const FrameArena & { return arena_; }
+
+  /**
+   * @brief Grow or shrink the pool while it is in use. Growing adds empty frames. Shrinking drops frames from the end
+   * of the pool: their pages are written back if dirty and evicted, and chunks of frames that are no longer used are
+   * freed. A frame that is pinned or doing I/O stops the shrink there, so the pool may end up larger than requested.
+   * Concurrent calls are serialized.
+   * @param pool_size the requested number of frames, in [1, MAX_POOL_SIZE]
+   * @return the number of frames after the call
+   */
+  auto SetPoolSize(size_t pool_size) -> size_t override;
+
+  /** Number of frames allocated and freed together when the pool is resized. */
+  static constexpr size_t FRAME_CHUNK_SIZE = 32;
+  /** Number of chunks the pool may grow to. */
+  static constexpr size_t MAX_FRAME_CHUNKS = 8192;
+  /** Largest pool size SetPoolSize() accepts. */
+  static constexpr size_t MAX_POOL_SIZE = FRAME_CHUNK_SIZE * MAX_FRAME_CHUNKS;
+
+  /**
+   * @brief Start the background flusher thread. Every background_flush_interval it writes out dirty, unpinned pages
+   * among the next victims of the replacer, so that misses find clean victims and do not pay for the write.
+   * @param target_clean_ratio fraction of the pool, counted from the next victim onwards, that should be kept clean
+   * @param max_writes_per_second upper bound on the number of pages the flusher writes per second
+   */
+  void StartBackgroundFlusher(double target_clean_ratio, size_t max_writes_per_second);
+
+  /** @brief Stop and join the background flusher thread, if it is running. */
+  void StopBackgroundFlusher();
+
+  /** @return a snapshot of the write-back counters */
+  auto GetWriteStats() const -> BufferPoolWriteStats;
+
+  /** @return a snapshot of the counters, latency histograms and pinned frames of this instance */
+  auto GetMetrics() -> BufferPoolMetrics override;
+
+  /**
+   * @brief Queue a page to be read in by the prefetch thread, which is started on first use. The hint is dropped if
+   * the page is resident or already queued, if it was not allocated by this instance, or if the queue is full.
+   * Hints of bulk operations are read into frames recycled from the prefetch thread's own ring.
+   * @param page_id id of page to be prefetched
+   * @param access_type the access pattern of the caller
+   */
+  void Prefetch(page_id_t page_id, BufferAccessType access_type = BufferAccessType::NORMAL) override;
+
+  /**
+   * @brief Start or stop recording the page accesses of this instance. Every FetchPage, NewPage, UnpinPage and
+   * DeletePage call is appended to the recorder when it completes; reads of the prefetch thread are not. Several
+   * instances may share a recorder. Tracing is off by default and costs one atomic load per call while it is off.
+   * @param recorder the recorder to append to, or nullptr to stop. The caller keeps ownership and must keep it alive
+   * until calls that may have started before tracing was stopped have returned.
+   */
+  void SetTraceRecorder(PageTraceRecorder *recorder);
+
+  /**
+   * @brief Pin every dirty, resident page and mark it clean, appending its write to requests, so that the caller can
+   * write the dirty pages of several instances as one batch. Pass the result to UnpinFlushedPages() once the writes
+   * are done.
+   * @param[out] requests the writes, whose callbacks record their latency in this instance
+   * @return the pinned frames
+   */
+  auto PinDirtyPages(std::vector<DiskRequest> *requests) -> std::vector<frame_id_t>;
+
+  /** @brief Unpin the frames returned by PinDirtyPages(). */
+  void UnpinFlushedPages(const std::vector<frame_id_t> &frame_ids);
+
+  /**
+   * @brief Turn the zero-copy mode on or off. In zero-copy mode, a page the disk manager can map (see
+   * DiskManager::GetMappedPage(), e.g. DiskManagerMmap) is not read into its frame: the frame points at the mapping
+   * instead, so that fetching costs no copy and the page is not cached twice, in the pool and in the OS page cache.
+   * Mapped pages are read-only: writing to one faults, and unpinning one as dirty throws. Only for pools on read-only
+   * copies of a database.
+   * @param zero_copy true to pin mapped pages directly, false to copy pages read from now on into their frames
+   */
+  void SetZeroCopyReads(bool zero_copy) { zero_copy_reads_ = zero_copy; }
 
  protected:
   /**
@@ -72,6 +200,15 @@ class BufferPoolManagerInstance : public BufferPoolManager {
    */
   auto NewPgImp(page_id_t *page_id) -> Page * override;
 
+  /**
+   * @brief Create a new page like NewPgImp(). Under a bulk strategy, the frame of the oldest page in the strategy's
+   * ring is reused when that page is still resident, unpinned and was not fetched without the strategy since.
+   * @param[out] page_id id of created page
+   * @param strategy the access strategy of the caller
+   * @return nullptr if no new pages could be created, otherwise pointer to new page
+   */
+  auto NewPgStrategyImp(page_id_t *page_id, BufferAccessStrategy *strategy) -> Page * override;
+
   /**
    * TODO(P1): Add implementation
    *
@@ -90,6 +227,15 @@ class BufferPoolManagerInstance : public BufferPoolManager {
    */
   auto FetchPgImp(page_id_t page_id) -> Page * override;
 
+  /**
+   * @brief Fetch a page like FetchPgImp(). Under a bulk strategy, a miss reuses a frame from the strategy's ring like
+   * NewPgStrategyImp(), and the access is not recorded in the replacer.
+   * @param page_id id of page to be fetched
+   * @param strategy the access strategy of the caller
+   * @return nullptr if page_id cannot be fetched, otherwise pointer to the requested page
+   */
+  auto FetchPgStrategyImp(page_id_t page_id, BufferAccessStrategy *strategy) -> Page * override;
+
   /**
    * TODO(P1): Add implementation
    *
@@ -102,6 +248,8 @@ class BufferPoolManagerInstance : public BufferPoolManager {
    * @param page_id id of page to be unpinned
    * @param is_dirty true if the page should be marked as dirty, false otherwise
    * @return false if the page is not in the page table or its pin count is <= 0 before this call, true otherwise
+   * @throws Exception if is_dirty is true for a page pinned from the disk manager's mapping in zero-copy mode, see
+   * SetZeroCopyReads(); the page stays pinned
    */
   auto UnpinPgImp(page_id_t page_id, bool is_dirty) -> bool override;
 
@@ -128,54 +276,408 @@ class BufferPoolManagerInstance : public BufferPoolManager {
   /**
    * TODO(P1): Add implementation
    *
-   * @brief Delete a page from the buffer pool. If page_id is not in the buffer pool, do nothing and return true. If the
-   * page is pinned and cannot be deleted, return false immediately.
+   * @brief Delete a page from the buffer pool. If page_id is not in the buffer pool, only deallocate it and return
+   * true, once a write-back of the page that is still in flight is done. If the page is pinned and cannot be deleted,
+   * return false immediately.
    *
    * After deleting the page from the page table, stop tracking the frame in the replacer and add the frame
    * back to the free list. Also, reset the page's memory and metadata. Finally, you should call DeallocatePage() to
-   * imitate freeing the page on the disk.
+   * imitate freeing the page on the disk. A dirty page is dropped without being written back.
    *
    * @param page_id id of page to be deleted
    * @return false if the page exists but could not be deleted, true if the page didn't exist or deletion succeeded
    */
   auto DeletePgImp(page_id_t page_id) -> bool override;
 
-  /** Number of pages in the buffer pool. */
-  const size_t pool_size_;
+  /** Number of frames in the buffer pool, frame ids are [0, pool_size_). Changes under latch_. */
+  std::atomic<size_t> pool_size_;
+  /** How many instances are in the parallel BPM (if present, otherwise just 1 BPI) */
+  const uint32_t num_instances_ = 1;
+  /** Index of this BPI in the parallel BPM (if present, otherwise just 0) */
+  const uint32_t instance_index_ = 0;
   /** The next page id to be allocated  */
   std::atomic<page_id_t> next_page_id_ = 0;
-  /** Bucket size for the extendible hash table */
-  const size_t bucket_size_ = 4;
 
-  /** Array of buffer pool pages. */
-  Page *pages_;
   /** Pointer to the disk manager. */
   DiskManager *disk_manager_ __attribute__((__unused__));
+  /** The free-space map of the disk manager, nullptr if it has none; then page ids are never reused. */
+  FreeSpaceMap *const free_space_map_;
+  /** The compressed page cache of the disk manager that evicted pages go to, nullptr if it has none. */
+  CompressedPageCache *const compressed_cache_;
   /** Pointer to the log manager. Please ignore this for P1. */
   LogManager *log_manager_ __attribute__((__unused__));
-  /** Page table for keeping track of buffer pool pages. */
-  ExtendibleHashTable<page_id_t, frame_id_t> *page_table_;
+  /** Page table for keeping track of buffer pool pages. Lookups do not need latch_. */
+  StripedHashTable<page_id_t, frame_id_t> *page_table_;
+  /** Number of stripes of the page table and of the access buffers. */
+  const size_t num_stripes_ = 16;
   /** Replacer to find unpinned pages for replacement. */
-  LRUKReplacer *replacer_;
+  std::unique_ptr<Replacer> replacer_;
+  /** The lookback constant k of the replacer, also the most accesses one drain records for a frame. */
+  const size_t replacer_k_;
   /** List of free frames that don't have any pages on them. */
   std::list<frame_id_t> free_list_;
-  /** This latch protects shared data structures. We recommend updating this comment to describe what it protects. */
+  /**
+   * This latch protects the replacer, the free list, the write-back table and changes to the page table and to the
+   * page id of a frame. It is never held across a disk read or write, and it is not taken by FetchPage() on a page that
+   * is already resident or by UnpinPage().
+   */
   std::mutex latch_;
 
+  /** Per-frame state, indexed by frame id. */
+  struct FrameState {
+    /** True while the frame's contents are being written back and/or read in without holding latch_. */
+    std::atomic<bool> in_progress_{false};
+    /** Notified (under latch_) when in_progress_ goes back to false. */
+    std::condition_variable cv_;
+    /** Accesses made through the latch-free hit path that the replacer has not seen yet. */
+    std::atomic<uint32_t> pending_accesses_{0};
+    /** True while the frame sits in an access buffer waiting for the next drain. */
+    std::atomic<bool> queued_{false};
+    /** True if the page was read in through a bulk strategy and was not fetched without one since. */
+    std::atomic<bool> ring_owned_{false};
+  };
+  /**
+   * The page objects and states of FRAME_CHUNK_SIZE consecutive frames. Their page data is not in the chunk but in
+   * arena_, so that the data of all frames is contiguous and the metadata of neighbouring frames is packed together.
+   */
+  struct FrameChunk {
+    Page pages_[FRAME_CHUNK_SIZE];
+    FrameState states_[FRAME_CHUNK_SIZE];
+  };
+  /** Page data of every frame, committed one chunk at a time. */
+  FrameArena arena_;
+  /**
+   * Frame metadata: chunk i holds frames [i * FRAME_CHUNK_SIZE, (i + 1) * FRAME_CHUNK_SIZE), nullptr past the end of
+   * the pool. The slots never move, so the latch-free paths can index them while the pool is resized.
+   */
+  std::unique_ptr<std::atomic<FrameChunk *>[]> chunks_;
+  /**
+   * @brief Commit the page data of a chunk and allocate its metadata.
+   * @param chunk_index the chunk, it must not be allocated
+   * @return the new chunk, not yet published in chunks_
+   */
+  auto AllocateChunk(size_t chunk_index) -> FrameChunk *;
+
+  /** @brief Free a chunk that is no longer published and decommit its page data. */
+  void FreeChunk(size_t chunk_index, FrameChunk *chunk);
+
+  /** Serializes SetPoolSize() calls. */
+  std::mutex resize_latch_;
+
+  /** @return the page object of a frame */
+  auto PageOf(frame_id_t frame_id) -> Page & {
+    return chunks_[frame_id / FRAME_CHUNK_SIZE].load(std::memory_order_acquire)->pages_[frame_id % FRAME_CHUNK_SIZE];
+  }
+
+  /** @return the state of a frame */
+  auto StateOf(frame_id_t frame_id) -> FrameState & {
+    return chunks_[frame_id / FRAME_CHUNK_SIZE].load(std::memory_order_acquire)->states_[frame_id % FRAME_CHUNK_SIZE];
+  }
+
+  /**
+   * Frames touched by the latch-free paths (pinned on a hit, or unpinned down to zero) since the replacer was last
+   * updated. Each frame is queued at most once; the buffers are drained under latch_ before picking a victim.
+   */
+  struct alignas(64) AccessBuffer {
+    std::mutex latch_;
+    std::vector<frame_id_t> frames_;
+  };
+  /** Array of access buffers, frame i is queued in buffer i % num_stripes_. */
+  AccessBuffer *access_buffers_;
+
+  /**
+   * Pages that have been evicted but whose dirty contents are still being written back, or that are still being stored
+   * in the compressed cache, mapped to the frame doing it. A fetch of such a page must wait for it to finish, otherwise
+   * it could read a stale copy from disk, or miss the cache and then find the page there later.
+   */
+  std::unordered_map<page_id_t, frame_id_t> writeback_;
+
+  /** True while the background flusher should keep running. */
+  std::atomic<bool> enable_background_flush_{false};
+  /** The background flusher thread, nullptr if it is not running. */
+  std::thread *background_flush_thread_{nullptr};
+  /** Fraction of the pool at the eviction end that the background flusher keeps clean. */
+  double target_clean_ratio_{0};
+  /** Write budget of the background flusher. */
+  size_t max_writes_per_second_{0};
+  std::atomic<uint64_t> background_writes_{0};
+  std::atomic<uint64_t> dirty_evictions_{0};
+  std::atomic<uint64_t> clean_evictions_{0};
+
+  /**
+   * Per-stripe state of the latch-free paths, striped by page id like the page table so that hits on different pages
+   * do not share a line: the fetch counters, and the number of threads using a frame they found in the page table
+   * without latch_, split by reader epoch (see HitPathGuard).
+   */
+  struct alignas(64) HitPathStripe {
+    std::atomic<uint64_t> hits_{0};
+    std::atomic<uint64_t> misses_{0};
+    std::atomic<int64_t> readers_[2]{};
+  };
+  /** Array of hit path stripes, page i uses stripe i % num_stripes_. */
+  HitPathStripe *hit_path_stripes_;
+  /** The epoch new readers register in, flipped by WaitForHitPathReaders(). */
+  std::atomic<uint32_t> reader_epoch_{0};
+
+  /**
+   * Registers a latch-free use of a frame found through the page table. Frames are only freed by a shrink once every
+   * guard that might have seen their page table entries has been destroyed.
+   */
+  class HitPathGuard {
+   public:
+    HitPathGuard(BufferPoolManagerInstance *bpm, page_id_t page_id);
+    ~HitPathGuard();
+    DISALLOW_COPY_AND_MOVE(HitPathGuard);
+
+   private:
+    std::atomic<int64_t> *readers_;
+  };
+
+  /**
+   * @brief Wait until every HitPathGuard that existed when this was called has been destroyed. Must not be called with
+   * latch_ held.
+   */
+  void WaitForHitPathReaders();
+
+  /** @brief Drop frames [pool_size, pool_size_) if possible, see SetPoolSize(). Caller must hold resize_latch_. */
+  auto ShrinkPool(size_t pool_size) -> size_t;
+  std::atomic<uint64_t> pin_wait_failures_{0};
+  std::atomic<uint64_t> compressed_cache_hits_{0};
+  std::atomic<uint64_t> compressed_cache_misses_{0};
+  AtomicLatencyHistogram read_latency_;
+  AtomicLatencyHistogram write_latency_;
+
+  /** Protects the prefetch queue and the prefetch thread. Never held together with latch_. */
+  std::mutex prefetch_latch_;
+  /** Notified when a page is queued or the prefetch thread has to stop. */
+  std::condition_variable prefetch_cv_;
+  /** Pages waiting to be prefetched, in request order, with the access pattern of the requester. */
+  std::list<std::pair<page_id_t, BufferAccessType>> prefetch_queue_;
+  /** Pages that are queued or being read by the prefetch thread. */
+  std::unordered_set<page_id_t> prefetch_pending_;
+  /** True when the prefetch thread has to exit. */
+  bool stop_prefetch_{false};
+  /** The prefetch thread, nullptr until the first prefetch request. */
+  std::thread *prefetch_thread_{nullptr};
+  /** The ring that the prefetch thread reads the hints of bulk operations into. Only used by the prefetch thread. */
+  BufferAccessStrategy prefetch_strategy_{BufferAccessType::BULK_READ};
+
+  /** Pin pages mapped by the disk manager instead of reading them, see SetZeroCopyReads(). */
+  std::atomic<bool> zero_copy_reads_{false};
+
+  /** Where page accesses are traced to, nullptr while tracing is off. */
+  std::atomic<PageTraceRecorder *> trace_recorder_{nullptr};
+
   /**
-   * @brief Allocate a page on disk. Caller should acquire the latch before calling this function.
+   * @brief Allocate a page on disk: a deleted page of this instance's stripe if the disk manager has a free-space map,
+   * a page past the last one allocated otherwise. Caller should acquire the latch before calling this function.
+   * @param[out] reused set to true if the page was deleted before, so that the disk still holds its old contents
    * @return the id of the allocated page
    */
-  auto AllocatePage() -> page_id_t;
+  auto AllocatePage(bool *reused) -> page_id_t;
+
+  /**
+   * @brief Validate that the page_id being used is accessible to this BPI. This can be used in all of the functions
+   * that take a page_id to make sure that the page is routed to the right shard.
+   * @param page_id the page id to validate
+   */
+  void ValidatePageId(page_id_t page_id) const;
 
   /**
-   * @brief Deallocate a page on disk. Caller should acquire the latch before calling this function.
+   * @brief Deallocate a page on disk, so that AllocatePage() can hand it out again if the disk manager has a free-space
+   * map, and drop it from the compressed cache. Caller should acquire the latch before calling this function.
    * @param page_id id of the page to deallocate
    */
-  void DeallocatePage(__attribute__((unused)) page_id_t page_id) {
-    // This is a no-nop right now without a more complex data structure to track deallocated pages
-  }
+  void DeallocatePage(page_id_t page_id);
+
+  /**
+   * @brief Fetch a page like FetchPgStrategyImp(), without tracing the call.
+   * @param page_id id of page to be fetched
+   * @param strategy the access strategy of the caller, may be nullptr
+   * @param[out] hit set to true if the page was resident or being read in already
+   * @return nullptr if page_id cannot be fetched, otherwise pointer to the requested page
+   */
+  auto FetchPageUntraced(page_id_t page_id, BufferAccessStrategy *strategy, bool *hit) -> Page *;
+
+  /** @brief Unpin a page like UnpinPgImp(), without tracing the call. */
+  auto UnpinPageUntraced(page_id_t page_id, bool is_dirty) -> bool;
+
+  /** @brief Delete a page like DeletePgImp(), without tracing the call. */
+  auto DeletePageUntraced(page_id_t page_id) -> bool;
+
+  /** @brief Read a page from disk, recording the latency. */
+  void ReadFromDisk(page_id_t page_id, char *data);
+
+  /**
+   * @brief Take a page out of the compressed cache, counting the hit or miss.
+   * @return false if there is no compressed cache or the page is not in it
+   */
+  auto ReadFromCache(page_id_t page_id, char *data) -> bool;
+
+  /**
+   * @brief Write an evicted page back if it is dirty and store it in the compressed cache if there is one, while its
+   * data is still in the frame. Does not need latch_.
+   */
+  void EvictVictim(page_id_t victim_page_id, bool victim_dirty, const char *data);
+
+  /** @brief Write a page to disk, recording the latency. */
+  void WriteToDisk(page_id_t page_id, const char *data);
+
+  /**
+   * @brief Submit page reads and writes to the disk manager as one batch and wait until all of them are done, recording
+   * their latencies. Must not be called with latch_ held.
+   * @param requests the requests; their callbacks are set here
+   */
+  void RunDiskBatch(std::vector<DiskRequest> requests);
+
+  /**
+   * @brief Point a frame at the data of the page it is getting, at the end of its I/O: at the disk manager's mapping
+   * of the page in zero-copy mode, at the frame's own memory otherwise.
+   * @param page_id the page, INVALID_PAGE_ID for the frame's own memory
+   * @return true if the frame points at a mapping, false if the page still has to be read into the frame
+   */
+  auto AttachPageData(frame_id_t frame_id, page_id_t page_id) -> bool;
+
+  /** @return a disk request callback recording the time since start as read or write latency */
+  auto LatencyCallback(bool is_write, std::chrono::steady_clock::time_point start) -> std::function<void(bool)>;
+
+  /** @brief Append a call to the trace recorder, if tracing is on. Must not be called with latch_ held. */
+  void TraceEvent(PageTraceEvent event, page_id_t page_id, uint8_t flags);
+
+  /**
+   * @brief Pin a resident page without taking latch_.
+   * @param page_id id of page to be fetched
+   * @param record_access false if the fetch is made under a bulk strategy and must not count for the replacer
+   * @return nullptr if the page is not resident, is still being read in, or is being evicted
+   */
+  auto FetchResident(page_id_t page_id, bool record_access) -> Page *;
+
+  /**
+   * @brief Drop one pin taken without latch_. If it was the last one, queue the frame so the replacer learns that it
+   * became evictable.
+   * @param frame_id the frame to unpin
+   */
+  void ReleasePin(frame_id_t frame_id);
+
+  /**
+   * @brief Put a frame in its access buffer unless it is already there.
+   * @param frame_id the frame that was touched
+   */
+  void QueueAccess(frame_id_t frame_id);
+
+  /**
+   * @brief Replay the access buffers into the replacer: record the pending accesses of every queued frame and update
+   * whether it is evictable. Caller must hold latch_.
+   */
+  void DrainAccesses();
+
+  /**
+   * @brief Get the ring of a strategy for this instance, at most an eighth of the pool.
+   * @param strategy the access strategy of the caller, may be nullptr
+   * @return nullptr if there is no strategy or it is NORMAL
+   */
+  auto GetRing(BufferAccessStrategy *strategy) -> BufferAccessStrategy::Ring *;
+
+  /**
+   * @brief Take the frame of the next page in a ring if that page can be recycled, otherwise take a frame from the
+   * free list or evict one from the replacer. Either way, claim it by setting its pin count to -1 so that the
+   * latch-free hit path cannot pin it. Caller must hold latch_.
+   * @param[out] frame_id the frame that was picked
+   * @param ring the ring of the caller's strategy, or nullptr
+   * @return false if every frame is pinned
+   */
+  auto AcquireFrame(frame_id_t *frame_id, BufferAccessStrategy::Ring *ring) -> bool;
+
+  /**
+   * @brief Claim the frame of the next page in a ring, if that page is still resident, unpinned and owned by the ring.
+   * Caller must hold latch_.
+   * @param[out] frame_id the frame that was recycled
+   * @param ring the ring of the caller's strategy
+   * @return false if the next slot cannot be recycled
+   */
+  auto RecycleRingFrame(frame_id_t *frame_id, BufferAccessStrategy::Ring *ring) -> bool;
+
+  /**
+   * @brief Install page_id in a frame obtained from AcquireFrame(), mark it as doing I/O and pin it. If the frame held
+   * a dirty page, or any page while there is a compressed cache, that page is registered in writeback_ to be passed to
+   * EvictVictim(). Caller must hold latch_.
+   * @param frame_id the frame to install the page in
+   * @param page_id the new page id of the frame
+   * @param ring the ring the page is read in for, or nullptr; the page takes the ring's next slot
+   * @param[out] victim_page_id id of the page that has to be written back or cached, or INVALID_PAGE_ID
+   * @param[out] victim_dirty true if the victim has to be written back
+   */
+  void InstallPage(frame_id_t frame_id, page_id_t page_id, BufferAccessStrategy::Ring *ring, page_id_t *victim_page_id,
+                   bool *victim_dirty);
+
+  /**
+   * @brief Drop the page of a claimed frame without writing it back, and put the frame on the free list. Caller must
+   * hold latch_.
+   * @param frame_id the frame, whose pin count is -1
+   */
+  void FreeClaimedFrame(frame_id_t frame_id);
+
+  /**
+   * @brief Drop a stale copy of a freed page that is being reused, left behind by a fetch after its delete. Caller
+   * must hold latch_.
+   * @param stale_frame_id the frame holding the stale copy
+   * @param frame_id the frame the reused page is going to be installed in, which may be the stale one
+   */
+  void DropStalePage(frame_id_t stale_frame_id, frame_id_t frame_id);
+
+  /**
+   * @brief Clear the I/O state of a frame set up by InstallPage() and wake up its waiters. Caller must hold latch_.
+   * @param frame_id the frame whose I/O finished
+   * @param victim_page_id the page that was written back or cached, or INVALID_PAGE_ID
+   */
+  void FinishIo(frame_id_t frame_id, page_id_t victim_page_id);
+
+  /** @brief Body of the prefetch thread. */
+  void RunPrefetch();
+
+  /**
+   * @brief Read the pages of a batch of prefetch hints into free or evictable frames, with the write-backs of all
+   * victims and then all reads submitted as one batch each. Hints for pages that became resident are skipped.
+   * @param hints the pages to read, with the access pattern of the requester
+   */
+  void PrefetchBatch(const std::vector<std::pair<page_id_t, BufferAccessType>> &hints);
+
+  /** @brief Body of the background flusher thread. */
+  void RunBackgroundFlush();
+
+  /**
+   * @brief Write out dirty, unpinned pages among the next target_clean_ratio_ * pool_size_ victims.
+   * @param max_writes the maximum number of pages to write
+   * @return the number of pages written
+   */
+  auto BackgroundFlushRound(size_t max_writes) -> size_t;
+
+  /**
+   * @brief Pin a resident frame, then write it out with latch_ released. The pin keeps the frame from being evicted
+   * or deleted during the write.
+   * @param frame_id the frame to flush
+   * @param lock the held lock on latch_; it is released during the write and held again on return
+   */
+  void FlushFrame(frame_id_t frame_id, std::unique_lock<std::mutex> *lock);
+
+  /**
+   * @brief Flush several resident frames like FlushFrame(), submitting all the writes to the disk manager as one batch
+   * sorted by page id, so that writes of adjacent pages can be coalesced.
+   * @param frame_ids the frames to flush
+   * @param lock the held lock on latch_; it is released during the writes and held again on return
+   */
+  void FlushFrames(const std::vector<frame_id_t> &frame_ids, std::unique_lock<std::mutex> *lock);
+
+  /** @return the resident frames holding dirty pages that are not doing I/O. Must be called with latch_ held. */
+  auto DirtyFrames() -> std::vector<frame_id_t>;
+
+  /**
+   * @brief Pin a resident frame and mark it clean, for a write of its page. Must be called with latch_ held.
+   * @return the write of the page, without a callback
+   */
+  auto PinForFlush(frame_id_t frame_id) -> DiskRequest;
 
-  // TODO(student): You may add additional private members and helper functions
+  /** Most prefetch hints read in one batch. */
+  static constexpr size_t PREFETCH_BATCH_SIZE = 16;
 };
 }  // namespace bustub
@@ -0,0 +1,112 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// buffer_pool_metrics.h
+//
+// Identification: src/include/buffer/buffer_pool_metrics.h
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+namespace bustub {
+
+/** Number of buckets of a LatencyHistogram. */
+static constexpr size_t LATENCY_HISTOGRAM_BUCKETS = 24;
+
+/**
+ * A snapshot of a latency distribution with power-of-two buckets: bucket 0 counts latencies below 1us, bucket i counts
+ * latencies in [2^(i-1), 2^i) us, and the last bucket also counts everything slower.
+ */
+struct LatencyHistogram {
+  std::array<uint64_t, LATENCY_HISTOGRAM_BUCKETS> buckets_{};
+  /** Number of recorded latencies. */
+  uint64_t count_{0};
+  /** Sum of the recorded latencies, in nanoseconds. */
+  uint64_t total_ns_{0};
+
+  /** @return the exclusive upper bound of a bucket in microseconds; the last bucket is open-ended */
+  static auto BucketUpperBoundMicros(size_t bucket) -> uint64_t { return uint64_t{1} << bucket; }
+
+  /** @return the mean latency in microseconds, 0 if nothing was recorded */
+  auto MeanMicros() const -> double;
+
+  /**
+   * @param fraction a fraction in [0, 1], e.g. 0.99
+   * @return the upper bound of the bucket that holds the given quantile, in microseconds; 0 if nothing was recorded
+   */
+  auto QuantileMicros(double fraction) const -> uint64_t;
+
+  /** Add the counts of another histogram to this one. */
+  auto operator+=(const LatencyHistogram &other) -> LatencyHistogram &;
+};
+
+/** LatencyHistogram that many threads can record into without a latch. */
+class AtomicLatencyHistogram {
+ public:
+  /**
+   * @brief Count one latency.
+   * @param latency_ns the latency in nanoseconds
+   */
+  void Record(uint64_t latency_ns);
+
+  /** @return the counts recorded so far; buckets recorded concurrently may or may not be included */
+  auto Snapshot() const -> LatencyHistogram;
+
+ private:
+  std::array<std::atomic<uint64_t>, LATENCY_HISTOGRAM_BUCKETS> buckets_{};
+  std::atomic<uint64_t> count_{0};
+  std::atomic<uint64_t> total_ns_{0};
+};
+
+/** A point-in-time view of the counters of a buffer pool, see BufferPoolManager::GetMetrics(). */
+struct BufferPoolMetrics {
+  /** Number of frames. */
+  uint64_t pool_size_{0};
+  /** Frames currently holding a page with a positive pin count. */
+  uint64_t pinned_frames_{0};
+  /** FetchPage calls that found the page resident, or being read in by another call. */
+  uint64_t hits_{0};
+  /** FetchPage calls that had to read the page from disk. */
+  uint64_t misses_{0};
+  /** Pages evicted clean, so that their frame could be reused right away. */
+  uint64_t clean_evictions_{0};
+  /** Pages that were dirty when evicted, and had to be written back before their frame could be reused. */
+  uint64_t dirty_evictions_{0};
+  /** Pages written by the background flusher. */
+  uint64_t background_writes_{0};
+  /** FetchPage and NewPage calls that returned nullptr because every frame was pinned. */
+  uint64_t pin_wait_failures_{0};
+  /** Misses served by the compressed page cache of the disk manager instead of the disk. */
+  uint64_t compressed_cache_hits_{0};
+  /** Misses that looked for the page in the compressed page cache and did not find it. */
+  uint64_t compressed_cache_misses_{0};
+  /** Latency of page reads from disk, including the reads of the prefetch thread. */
+  LatencyHistogram read_latency_;
+  /** Latency of page writes to disk: write-backs of victims, flushes and deletes of dirty pages. */
+  LatencyHistogram write_latency_;
+
+  /** @return hits / (hits + misses), 0 before the first fetch */
+  auto HitRatio() const -> double {
+    return hits_ + misses_ == 0 ? 0 : static_cast<double>(hits_) / static_cast<double>(hits_ + misses_);
+  }
+
+  /** @return the fraction of the lookups in the compressed page cache that hit, 0 before the first one */
+  auto CompressedCacheHitRatio() const -> double {
+    const uint64_t lookups = compressed_cache_hits_ + compressed_cache_misses_;
+    return lookups == 0 ? 0 : static_cast<double>(compressed_cache_hits_) / static_cast<double>(lookups);
+  }
+
+  /** Add the counters of another pool to this one, e.g. to sum up the instances of a parallel buffer pool. */
+  auto operator+=(const BufferPoolMetrics &other) -> BufferPoolMetrics &;
+};
+
+}  // namespace bustub
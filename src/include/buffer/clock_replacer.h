@@ -12,7 +12,6 @@
 
 #pragma once
 
-#include <list>
 #include <mutex>  // NOLINT
 #include <vector>
 
@@ -22,7 +21,12 @@
 namespace bustub {
 
 /**
- * ClockReplacer implements the clock replacement policy, which approximates the Least Recently Used policy.
+ * ClockReplacer implements the clock (second-chance) replacement policy, which approximates the Least Recently Used
+ * policy.
+ *
+ * Every tracked frame has a reference bit that is set by each access. The clock hand sweeps the frames in frame id
+ * order: a referenced frame has its bit cleared and is skipped once, the first evictable frame found without the bit
+ * is the victim. Accesses are O(1) and never move anything; an eviction clears at most one full turn of bits.
  */
 class ClockReplacer : public Replacer {
  public:
@@ -37,16 +41,33 @@ class ClockReplacer : public Replacer {
    */
   ~ClockReplacer() override;
 
-  auto Victim(frame_id_t *frame_id) -> bool override;
+  auto Evict(frame_id_t *frame_id) -> bool override;
 
-  void Pin(frame_id_t frame_id) override;
+  void RecordAccess(frame_id_t frame_id) override;
 
-  void Unpin(frame_id_t frame_id) override;
+  void SetEvictable(frame_id_t frame_id, bool set_evictable) override;
+
+  void Remove(frame_id_t frame_id) override;
 
   auto Size() -> size_t override;
 
+  auto EvictionCandidates(size_t max_count) -> std::vector<frame_id_t> override;
+
+  void Resize(size_t num_frames) override;
+
  private:
-  // TODO(student): implement me!
+  struct FrameMeta {
+    bool is_tracked_{false};
+    bool is_evictable_{false};
+    bool is_referenced_{false};
+  };
+
+  /** Metadata of every frame, indexed by frame id; the clock face. */
+  std::vector<FrameMeta> frames_;
+  /** The frame the clock hand points at. */
+  size_t hand_{0};
+  size_t curr_size_{0};
+  std::mutex latch_;
 };
 
 }  // namespace bustub
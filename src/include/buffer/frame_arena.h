@@ -0,0 +1,97 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// frame_arena.h
+//
+// Identification: src/include/buffer/frame_arena.h
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <cstddef>
+
+#include "common/config.h"
+#include "common/macros.h"
+
+namespace bustub {
+
+/** How the frame arena of a buffer pool is backed. */
+struct FrameArenaOptions {
+  /** Marks the pages of the caller as not bound to any NUMA node. */
+  static constexpr int NO_NUMA_NODE = -1;
+
+  /** Ask the kernel to back the arena with transparent huge pages, which cuts TLB misses on large pools. */
+  bool huge_pages_{false};
+  /** NUMA node the frames of a BufferPoolManagerInstance are placed on, or NO_NUMA_NODE to let the kernel decide. */
+  int numa_node_{NO_NUMA_NODE};
+  /**
+   * ParallelBufferPoolManager only: spread the instances over the NUMA nodes of the machine (overriding numa_node_),
+   * and let NewPage() try the instances on the node of the calling thread first.
+   */
+  bool numa_sub_pools_{false};
+};
+
+/**
+ * FrameArena holds the page data of every frame a buffer pool may ever have in one contiguous, page-aligned virtual
+ * memory reservation: frame i lives at Data(i), BUSTUB_PAGE_SIZE bytes after frame i - 1. Address space is reserved
+ * up front for max_frames frames, but memory is only committed for the ranges passed to Commit(), so that a pool can
+ * grow and shrink without moving its frames. Committed memory reads as zeros. Not thread-safe.
+ */
+class FrameArena {
+ public:
+  /**
+   * @brief Reserve address space for max_frames frames.
+   * @param max_frames the number of frames the arena can ever hold
+   * @param options huge page and NUMA placement hints; hints the kernel does not support are ignored
+   * @throws Exception if the address space cannot be reserved
+   */
+  FrameArena(size_t max_frames, const FrameArenaOptions &options);
+
+  /** @brief Release the whole reservation. */
+  ~FrameArena();
+
+  DISALLOW_COPY_AND_MOVE(FrameArena);
+
+  /** @return the page data of a frame */
+  auto Data(frame_id_t frame_id) const -> char * { return base_ + static_cast<size_t>(frame_id) * BUSTUB_PAGE_SIZE; }
+
+  /**
+   * @brief Make frames [first_frame, first_frame + num_frames) usable. Their data reads as zeros.
+   * @throws Exception if the memory cannot be committed
+   */
+  void Commit(size_t first_frame, size_t num_frames);
+
+  /** @brief Return the memory of frames [first_frame, first_frame + num_frames) to the kernel. */
+  void Decommit(size_t first_frame, size_t num_frames);
+
+  /** @return true if the kernel accepted the transparent huge page hint for the arena */
+  auto UsesHugePages() const -> bool { return huge_pages_; }
+
+  /** @return the NUMA node the arena is bound to, or FrameArenaOptions::NO_NUMA_NODE */
+  auto GetNumaNode() const -> int { return numa_node_; }
+
+  /** @return the number of NUMA nodes of the machine, 1 if it cannot be determined */
+  static auto NumNumaNodes() -> size_t;
+
+  /** @return the NUMA node the calling thread runs on, 0 if it cannot be determined */
+  static auto CurrentNumaNode() -> int;
+
+ private:
+  /** Alignment of the reservation when huge pages are requested, the size of an x86-64 transparent huge page. */
+  static constexpr size_t HUGE_PAGE_SIZE = 2 * 1024 * 1024;
+
+  /** Start of the mapping, which may be below base_ to align it for huge pages. */
+  char *mapping_{nullptr};
+  size_t mapping_size_{0};
+  /** Frame 0. */
+  char *base_{nullptr};
+  size_t max_frames_;
+  bool huge_pages_{false};
+  int numa_node_{FrameArenaOptions::NO_NUMA_NODE};
+};
+
+}  // namespace bustub
@@ -0,0 +1,160 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// frame_list.h
+//
+// Identification: src/include/buffer/frame_list.h
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <list>
+#include <unordered_map>
+#include <vector>
+
+#include "common/config.h"
+#include "common/macros.h"
+
+namespace bustub {
+
+/**
+ * FrameLists keeps a fixed number of doubly linked lists of frame ids, with the links preallocated for every frame.
+ * A frame is in at most one of the lists at a time, so moving a frame between lists or to the back of its list is
+ * O(1) and never allocates. Lists are ordered from front (oldest) to back (newest). Not thread-safe.
+ */
+class FrameLists {
+ public:
+  /** The list of a frame that is in none of the lists. */
+  static constexpr size_t NO_LIST = static_cast<size_t>(-1);
+  /** Marks the end of a list. */
+  static constexpr frame_id_t NO_FRAME = -1;
+
+  /**
+   * @param num_frames the number of frame ids, [0, num_frames)
+   * @param num_lists the number of lists
+   */
+  FrameLists(size_t num_frames, size_t num_lists) : links_(num_frames), lists_(num_lists) {}
+
+  /**
+   * Change the number of frame ids to [0, num_frames). Frames that go away must not be in a list.
+   * @param num_frames the new number of frame ids
+   */
+  void Resize(size_t num_frames) {
+    for (size_t i = num_frames; i < links_.size(); ++i) {
+      BUSTUB_ASSERT(links_[i].list_ == NO_LIST, "cannot drop a frame that is in a list");
+    }
+    links_.resize(num_frames);
+  }
+
+  /** @return the list frame_id is in, or NO_LIST */
+  auto ListOf(frame_id_t frame_id) const -> size_t { return links_[frame_id].list_; }
+
+  /** @return the number of frames in a list */
+  auto Size(size_t list) const -> size_t { return lists_[list].size_; }
+
+  /** @return the oldest frame of a list, or NO_FRAME if it is empty */
+  auto Front(size_t list) const -> frame_id_t { return lists_[list].front_; }
+
+  /** @return the frame after frame_id in its list, or NO_FRAME if it is the newest */
+  auto Next(frame_id_t frame_id) const -> frame_id_t { return links_[frame_id].next_; }
+
+  /** Append frame_id to the back of a list, taking it out of the list it was in before. */
+  void PushBack(size_t list, frame_id_t frame_id) {
+    Erase(frame_id);
+    auto &link = links_[frame_id];
+    auto &target = lists_[list];
+    link.list_ = list;
+    link.prev_ = target.back_;
+    link.next_ = NO_FRAME;
+    if (target.back_ == NO_FRAME) {
+      target.front_ = frame_id;
+    } else {
+      links_[target.back_].next_ = frame_id;
+    }
+    target.back_ = frame_id;
+    target.size_++;
+  }
+
+  /** Take frame_id out of its list, if it is in one. */
+  void Erase(frame_id_t frame_id) {
+    auto &link = links_[frame_id];
+    if (link.list_ == NO_LIST) {
+      return;
+    }
+    auto &source = lists_[link.list_];
+    if (link.prev_ == NO_FRAME) {
+      source.front_ = link.next_;
+    } else {
+      links_[link.prev_].next_ = link.next_;
+    }
+    if (link.next_ == NO_FRAME) {
+      source.back_ = link.prev_;
+    } else {
+      links_[link.next_].prev_ = link.prev_;
+    }
+    source.size_--;
+    link = Link{};
+  }
+
+ private:
+  struct Link {
+    size_t list_{NO_LIST};
+    frame_id_t prev_{NO_FRAME};
+    frame_id_t next_{NO_FRAME};
+  };
+  struct List {
+    frame_id_t front_{NO_FRAME};
+    frame_id_t back_{NO_FRAME};
+    size_t size_{0};
+  };
+
+  std::vector<Link> links_;
+  std::vector<List> lists_;
+};
+
+/**
+ * GhostList remembers the ids of recently evicted pages in FIFO order, without their contents. Used by the policies
+ * that adapt to pages coming back soon after they were evicted. Not thread-safe.
+ */
+class GhostList {
+ public:
+  /** @return the number of remembered pages */
+  auto Size() const -> size_t { return pages_.size(); }
+
+  /** Remember page_id as the newest entry. */
+  void PushBack(page_id_t page_id) {
+    Erase(page_id);
+    index_[page_id] = pages_.insert(pages_.end(), page_id);
+  }
+
+  /** Forget the oldest entry. The list must not be empty. */
+  void PopFront() {
+    BUSTUB_ASSERT(!pages_.empty(), "ghost list is empty");
+    index_.erase(pages_.front());
+    pages_.pop_front();
+  }
+
+  /**
+   * Forget page_id.
+   * @return true if page_id was remembered
+   */
+  auto Erase(page_id_t page_id) -> bool {
+    auto it = index_.find(page_id);
+    if (it == index_.end()) {
+      return false;
+    }
+    pages_.erase(it->second);
+    index_.erase(it);
+    return true;
+  }
+
+ private:
+  std::list<page_id_t> pages_;
+  std::unordered_map<page_id_t, std::list<page_id_t>::iterator> index_;
+};
+
+}  // namespace bustub
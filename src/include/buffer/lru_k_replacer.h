@@ -13,12 +13,10 @@
 #pragma once
 
 #include <limits>
-#include <list>
-#include <memory>
 #include <mutex>  // NOLINT
-#include <unordered_map>
 #include <vector>
 
+#include "buffer/replacer.h"
 #include "common/config.h"
 #include "common/logger.h"
 #include "common/macros.h"
@@ -35,38 +33,13 @@ namespace bustub {
  * A frame with less than k historical references is given
  * +inf as its backward k-distance. When multiple frames have +inf backward k-distance,
  * classical LRU algorithm is used to choose victim.
+ *
+ * Per-frame metadata (including the last k access timestamps) is preallocated for every frame id. Evictable frames
+ * are kept in a binary min-heap ordered by eviction priority, and each frame remembers its own position in the heap,
+ * so RecordAccess, SetEvictable, Remove and Evict are all O(log n) and never allocate.
  */
 
-class FrameMeta {
- public:
-  FrameMeta(const frame_id_t frame_id, const size_t timestamps)
-      : frame_id_(frame_id), cur_(1), timestamps_(timestamps), is_evictable_(false) {}
-  // FrameMeta(const FrameMeta &&fm) noexcept
-  //     : frame_id_(fm.frame_id_), cur_(fm.cur_), timestamps_(fm.timestamps_), is_evictable_(fm.is_evictable_) {}
-
-  auto CurrTimestamp() -> size_t { return timestamps_; }
-
-  auto FrameId() -> size_t { return frame_id_; }
-
-  auto AccessTimes() -> size_t { return cur_; }
-
-  auto SetEvictable(bool set_evivtable) -> void { is_evictable_ = set_evivtable; }
-
-  auto Evictable() -> bool { return is_evictable_; }
-
-  auto Access(size_t timestamps) -> void {
-    ++cur_;
-    timestamps_ = timestamps;
-  }
-
- private:
-  frame_id_t frame_id_;
-  size_t cur_;
-  size_t timestamps_;
-  bool is_evictable_;
-};
-
-class LRUKReplacer {
+class LRUKReplacer : public Replacer {
  public:
   /**
    *
@@ -84,7 +57,7 @@ class LRUKReplacer {
    *
    * @brief Destroys the LRUReplacer.
    */
-  ~LRUKReplacer() = default;
+  ~LRUKReplacer() override = default;
 
   /**
    * TODO(P1): Add implementation
@@ -102,7 +75,7 @@ class LRUKReplacer {
    * @param[out] frame_id id of frame that is evicted.
    * @return true if a frame is evicted successfully, false if no frames can be evicted.
    */
-  auto Evict(frame_id_t *frame_id) -> bool;
+  auto Evict(frame_id_t *frame_id) -> bool override;
 
   /**
    * TODO(P1): Add implementation
@@ -115,7 +88,7 @@ class LRUKReplacer {
    *
    * @param frame_id id of frame that received a new access.
    */
-  void RecordAccess(frame_id_t frame_id);
+  void RecordAccess(frame_id_t frame_id) override;
 
   /**
    * TODO(P1): Add implementation
@@ -134,7 +107,7 @@ class LRUKReplacer {
    * @param frame_id id of frame whose 'evictable' status will be modified
    * @param set_evictable whether the given frame is evictable or not
    */
-  void SetEvictable(frame_id_t frame_id, bool set_evictable);
+  void SetEvictable(frame_id_t frame_id, bool set_evictable) override;
 
   /**
    * TODO(P1): Add implementation
@@ -153,7 +126,7 @@ class LRUKReplacer {
    *
    * @param frame_id id of frame to be removed
    */
-  void Remove(frame_id_t frame_id);
+  void Remove(frame_id_t frame_id) override;
 
   /**
    * TODO(P1): Add implementation
@@ -162,27 +135,57 @@ class LRUKReplacer {
    *
    * @return size_t
    */
-  auto Size() -> size_t;
+  auto Size() -> size_t override;
+
+  /**
+   * @brief Return the evictable frames in the order Evict() would pick them, without evicting anything.
+   * @param max_count the maximum number of frames to return
+   * @return up to max_count frames, next victim first
+   */
+  auto EvictionCandidates(size_t max_count) -> std::vector<frame_id_t> override;
+
+  /**
+   * @brief Change the number of frames, keeping the history of the frames that stay.
+   * @param num_frames the new number of frames
+   */
+  void Resize(size_t num_frames) override;
 
  private:
-  // TODO(student): implement me! You can replace these member variables as you like.
-  // Remove maybe_unused if you start using them.
+  /** Position of a frame that is not in the eviction heap. */
+  static constexpr size_t NOT_IN_HEAP = std::numeric_limits<size_t>::max();
+
   struct FrameMeta {
-    FrameMeta(const frame_id_t frame_id, const size_t timestamps, bool is_evictable)
-        : frame_id_(frame_id), cur_(1), timestamps_(timestamps), is_evictable_(is_evictable) {}
-    frame_id_t frame_id_;
-    size_t cur_;
-    size_t timestamps_;
-    bool is_evictable_;
+    /** Number of recorded accesses, capped at k. Zero means the frame is not tracked. */
+    size_t count_{0};
+    /** Slot of the oldest retained timestamp in this frame's ring of k timestamps. */
+    size_t head_{0};
+    /** Index of this frame in heap_, or NOT_IN_HEAP if the frame is not evictable. */
+    size_t heap_index_{NOT_IN_HEAP};
+    bool is_evictable_{false};
   };
 
-  [[maybe_unused]] size_t current_timestamp_{0};
-  [[maybe_unused]] size_t curr_size_{0};
-  [[maybe_unused]] size_t replacer_size_;
-  [[maybe_unused]] size_t k_;
-  std::unordered_map<frame_id_t, std::shared_ptr<FrameMeta>> frames_;
-  std::list<std::shared_ptr<FrameMeta>> history_;  // frame access times < k
-  std::list<std::shared_ptr<FrameMeta>> cache_;    // frame access times >= k
+  /** @return the oldest retained timestamp: the first access if count < k, the k-th most recent access otherwise. */
+  auto OldestTimestamp(frame_id_t frame_id) const -> size_t;
+  /** @return true if frame a should be evicted before frame b. */
+  auto EvictsBefore(frame_id_t a, frame_id_t b) const -> bool;
+  void HeapPush(frame_id_t frame_id);
+  void HeapErase(frame_id_t frame_id);
+  void HeapSiftUp(size_t index);
+  void HeapSiftDown(size_t index);
+  void HeapSwap(size_t i, size_t j);
+  /** Drop the access history of a frame that has just left the heap. */
+  void ResetFrame(frame_id_t frame_id);
+
+  size_t current_timestamp_{0};
+  size_t curr_size_{0};
+  size_t replacer_size_;
+  size_t k_;
+  /** Metadata of every frame, indexed by frame id. */
+  std::vector<FrameMeta> frames_;
+  /** Ring buffers of the last k access timestamps; frame i owns [i * k, (i + 1) * k). */
+  std::vector<size_t> timestamps_;
+  /** Min-heap of evictable frames, the next victim is at the front. */
+  std::vector<frame_id_t> heap_;
   std::mutex latch_;
 };
 
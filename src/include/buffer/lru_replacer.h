@@ -12,19 +12,16 @@
 
 #pragma once
 
-#include <list>
-#include <mutex>  // NOLINT
-#include <vector>
-
-#include "buffer/replacer.h"
+#include "buffer/lru_k_replacer.h"
 #include "common/config.h"
 
 namespace bustub {
 
 /**
- * LRUReplacer implements the Least Recently Used replacement policy.
+ * LRUReplacer implements the Least Recently Used replacement policy. LRU is LRU-K with k = 1: the backward 1-distance
+ * of a frame is the time since its last access, so the heap of LRUKReplacer evicts the least recently used frame.
  */
-class LRUReplacer : public Replacer {
+class LRUReplacer : public LRUKReplacer {
  public:
   /**
    * Create a new LRUReplacer.
@@ -36,17 +33,6 @@ class LRUReplacer : public Replacer {
    * Destroys the LRUReplacer.
    */
   ~LRUReplacer() override;
-
-  auto Victim(frame_id_t *frame_id) -> bool override;
-
-  void Pin(frame_id_t frame_id) override;
-
-  void Unpin(frame_id_t frame_id) override;
-
-  auto Size() -> size_t override;
-
- private:
-  // TODO(student): implement me!
 };
 
 }  // namespace bustub
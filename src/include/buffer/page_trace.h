@@ -0,0 +1,111 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// page_trace.h
+//
+// Identification: src/include/buffer/page_trace.h
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <chrono>  // NOLINT
+#include <cstdint>
+#include <fstream>
+#include <mutex>  // NOLINT
+#include <string>
+#include <vector>
+
+#include "common/config.h"
+
+namespace bustub {
+
+/** The buffer pool calls a page trace records. */
+enum class PageTraceEvent : uint8_t { FETCH, NEW, UNPIN, DELETE };
+
+/** FETCH: the page was resident. */
+static constexpr uint8_t PAGE_TRACE_HIT = 1;
+/** UNPIN: the caller marked the page dirty. */
+static constexpr uint8_t PAGE_TRACE_DIRTY = 2;
+/** The call failed: FETCH/NEW found every frame pinned, UNPIN/DELETE returned false. */
+static constexpr uint8_t PAGE_TRACE_FAILED = 4;
+
+/** One event of a page trace, stored as is (16 bytes, host byte order) in the trace file. */
+struct PageTraceRecord {
+  /** Nanoseconds since the recorder was created. */
+  uint64_t timestamp_ns_;
+  /** The page of the call; for a NEW that failed, INVALID_PAGE_ID. */
+  page_id_t page_id_;
+  /** Small id of the calling thread, numbered in the order threads first record an event in the process. */
+  uint16_t thread_id_;
+  PageTraceEvent event_;
+  /** PAGE_TRACE_* bits. */
+  uint8_t flags_;
+};
+static_assert(sizeof(PageTraceRecord) == 16, "page trace records are written as 16 raw bytes");
+
+/**
+ * PageTraceRecorder writes the page accesses of one or more buffer pool instances to a binary file, see
+ * BufferPoolManagerInstance::SetTraceRecorder(). The file starts with an 8-byte magic followed by PageTraceRecord
+ * entries in the order the calls completed. Records are buffered in memory and written in batches, so the file is
+ * only complete after Close() or destruction. Thread-safe.
+ */
+class PageTraceRecorder {
+ public:
+  /**
+   * @brief Create the trace file, truncating it if it exists.
+   * @param file_name path of the trace file
+   */
+  explicit PageTraceRecorder(const std::string &file_name);
+
+  /** @brief Close the trace file. */
+  ~PageTraceRecorder();
+
+  /**
+   * @brief Append an event. Ignored once the recorder is closed.
+   * @param event the buffer pool call
+   * @param page_id the page of the call
+   * @param flags PAGE_TRACE_* bits
+   */
+  void Record(PageTraceEvent event, page_id_t page_id, uint8_t flags = 0);
+
+  /** @brief Write out the buffered records and close the file. Later events are dropped. */
+  void Close();
+
+  /** @return the number of events recorded so far */
+  auto GetRecordCount() -> size_t;
+
+ private:
+  /** Records buffered before they are written out. */
+  static constexpr size_t BATCH_SIZE = 4096;
+
+  void WriteBatch();
+
+  std::mutex latch_;
+  std::ofstream file_;
+  const std::chrono::steady_clock::time_point start_;
+  std::vector<PageTraceRecord> batch_;
+  size_t record_count_{0};
+  bool closed_{false};
+};
+
+/**
+ * @brief Read a trace file written by PageTraceRecorder.
+ * @param file_name path of the trace file
+ * @return the records of the trace, in file order
+ * @throws Exception if the file cannot be read or is not a page trace
+ */
+auto ReadPageTrace(const std::string &file_name) -> std::vector<PageTraceRecord>;
+
+/**
+ * @brief Extract the page reference string of a trace, for SimulateReplacer(): the pages of every FETCH and NEW that
+ * succeeded, in order.
+ * @param records the records of a trace
+ * @return the referenced page ids
+ */
+auto PageTraceReferences(const std::vector<PageTraceRecord> &records) -> std::vector<page_id_t>;
+
+}  // namespace bustub
@@ -0,0 +1,177 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// parallel_buffer_pool_manager.h
+//
+// Identification: src/include/buffer/parallel_buffer_pool_manager.h
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <vector>
+
+#include "buffer/buffer_pool_manager.h"
+#include "buffer/buffer_pool_manager_instance.h"
+#include "recovery/log_manager.h"
+#include "storage/disk/disk_manager.h"
+#include "storage/page/page.h"
+
+namespace bustub {
+
+/**
+ * ParallelBufferPoolManager owns several independent BufferPoolManagerInstances (shards), each with its own latch,
+ * page table and replacer. A page lives in exactly one shard, chosen by page_id % num_instances, so operations on
+ * pages that hash to different shards never contend with each other. New pages are allocated round-robin across the
+ * shards to spread both page ids and frame usage evenly.
+ *
+ * With FrameArenaOptions::numa_sub_pools_, the instances are spread over the NUMA nodes of the machine, each keeping
+ * its frames on its node, and new pages are allocated from the instances on the node of the calling thread first.
+ */
+class ParallelBufferPoolManager : public BufferPoolManager {
+ public:
+  /**
+   * Creates a new ParallelBufferPoolManager.
+   * @param num_instances the number of individual BufferPoolManagerInstances to store
+   * @param pool_size the pool size of each BufferPoolManagerInstance
+   * @param disk_manager the disk manager
+   * @param replacer_k the lookback constant k for the LRU-K replacer of every instance
+   * @param log_manager the log manager (for testing only: nullptr = disable logging)
+   * @param replacer_policy the replacement policy of every instance
+   * @param arena_options huge page and NUMA placement of the page data of every instance
+   */
+  ParallelBufferPoolManager(size_t num_instances, size_t pool_size, DiskManager *disk_manager,
+                            size_t replacer_k = LRUK_REPLACER_K, LogManager *log_manager = nullptr,
+                            ReplacerPolicy replacer_policy = ReplacerPolicy::LRU_K,
+                            const FrameArenaOptions &arena_options = {});
+
+  /**
+   * Destroys an existing ParallelBufferPoolManager.
+   */
+  ~ParallelBufferPoolManager() override;
+
+  /** @return size of the buffer pool, i.e. the total number of frames over all instances */
+  auto GetPoolSize() -> size_t override;
+
+  /**
+   * Resize every instance to an equal share of the requested size, see BufferPoolManagerInstance::SetPoolSize().
+   * @param pool_size the requested total number of frames, at least one and at most
+   * BufferPoolManagerInstance::MAX_POOL_SIZE per instance
+   * @return the total number of frames after the call
+   * @throws Exception if pool_size is out of range; no instance is resized then
+   */
+  auto SetPoolSize(size_t pool_size) -> size_t override;
+
+  /** @return the metrics of all instances added up */
+  auto GetMetrics() -> BufferPoolMetrics override;
+
+  /**
+   * Hint that a page will be fetched soon, forwarded to the instance that owns it.
+   * @param page_id id of page to be prefetched
+   * @param access_type the access pattern of the caller
+   */
+  void Prefetch(page_id_t page_id, BufferAccessType access_type = BufferAccessType::NORMAL) override;
+
+  /**
+   * Start or stop tracing the page accesses of every instance into one recorder.
+   * @param recorder the recorder to append to, or nullptr to stop, see BufferPoolManagerInstance::SetTraceRecorder()
+   */
+  void SetTraceRecorder(PageTraceRecorder *recorder);
+
+  /**
+   * Turn the zero-copy mode of every instance on or off.
+   * @param zero_copy true to pin mapped pages directly, see BufferPoolManagerInstance::SetZeroCopyReads()
+   */
+  void SetZeroCopyReads(bool zero_copy);
+
+  /** @return the number of BufferPoolManagerInstances in this pool */
+  auto GetNumInstances() const -> size_t { return instances_.size(); }
+
+  /** @return the number of NUMA nodes the instances are spread over, 1 without NUMA sub-pools */
+  auto GetNumNumaNodes() const -> size_t { return num_numa_nodes_; }
+
+ protected:
+  /**
+   * @param page_id id of page
+   * @return pointer to the BufferPoolManagerInstance responsible for handling given page id
+   */
+  auto GetBufferPoolManager(page_id_t page_id) -> BufferPoolManagerInstance *;
+
+  /**
+   * Fetch the requested page from the buffer pool.
+   * @param page_id id of page to be fetched
+   * @return the requested page
+   */
+  auto FetchPgImp(page_id_t page_id) -> Page * override;
+
+  /**
+   * Fetch the requested page from the buffer pool under an access strategy.
+   * @param page_id id of page to be fetched
+   * @param strategy the access strategy of the caller; every instance keeps its own ring in it
+   * @return the requested page
+   */
+  auto FetchPgStrategyImp(page_id_t page_id, BufferAccessStrategy *strategy) -> Page * override;
+
+  /**
+   * Unpin the target page from the buffer pool.
+   * @param page_id id of page to be unpinned
+   * @param is_dirty true if the page should be marked as dirty, false otherwise
+   * @return false if the page pin count is <= 0 before this call, true otherwise
+   */
+  auto UnpinPgImp(page_id_t page_id, bool is_dirty) -> bool override;
+
+  /**
+   * Flushes the target page to disk.
+   * @param page_id id of page to be flushed, cannot be INVALID_PAGE_ID
+   * @return false if the page could not be found in the page table, true otherwise
+   */
+  auto FlushPgImp(page_id_t page_id) -> bool override;
+
+  /**
+   * Creates a new page in the buffer pool. Instances are tried in round-robin order, starting from a different
+   * instance on every call (on the caller's NUMA node, with NUMA sub-pools), and the first one that can serve the
+   * request wins.
+   * @param[out] page_id id of created page
+   * @return nullptr if no new pages could be created, otherwise pointer to new page
+   */
+  auto NewPgImp(page_id_t *page_id) -> Page * override;
+
+  /**
+   * Creates a new page in the buffer pool under an access strategy, trying the instances like NewPgImp().
+   * @param[out] page_id id of created page
+   * @param strategy the access strategy of the caller
+   * @return nullptr if no new pages could be created, otherwise pointer to new page
+   */
+  auto NewPgStrategyImp(page_id_t *page_id, BufferAccessStrategy *strategy) -> Page * override;
+
+  /**
+   * Deletes a page from the buffer pool.
+   * @param page_id id of page to be deleted
+   * @return false if the page exists but could not be deleted, true if the page didn't exist or deletion succeeded
+   */
+  auto DeletePgImp(page_id_t page_id) -> bool override;
+
+  /**
+   * Flushes all the pages in the buffer pool to disk, as one batch of writes sorted by page id over all instances.
+   */
+  void FlushAllPgsImp() override;
+
+ private:
+  /** @return the instance a NewPgImp() call tries first */
+  auto NextNewPageInstance() -> size_t;
+
+  /** The shards of this buffer pool; instances_[i] owns every page id with page_id % num_instances == i. */
+  std::vector<std::unique_ptr<BufferPoolManagerInstance>> instances_;
+  DiskManager *disk_manager_;
+  /** The instance NewPgImp tries first on its next call. */
+  std::atomic<size_t> next_instance_{0};
+  /** Instance i keeps its frames on NUMA node i % num_numa_nodes_. */
+  size_t num_numa_nodes_{1};
+};
+
+}  // namespace bustub
@@ -12,12 +12,22 @@
 
 #pragma once
 
+#include <memory>
+#include <string>
+#include <vector>
+
 #include "common/config.h"
 
 namespace bustub {
 
+/** The replacement policies a buffer pool can be built with, see MakeReplacer(). */
+enum class ReplacerPolicy { LRU_K, LRU, CLOCK, TWO_Q, ARC };
+
 /**
- * Replacer is an abstract class that tracks page usage.
+ * Replacer is an abstract class that tracks frame usage and picks the frame to evict when the buffer pool is full.
+ *
+ * A frame is tracked from its first recorded access until it is evicted or removed. Only frames that are marked as
+ * evictable are candidates for eviction, and Size() counts exactly those. Implementations are thread-safe.
  */
 class Replacer {
  public:
@@ -25,26 +35,70 @@ class Replacer {
   virtual ~Replacer() = default;
 
   /**
-   * Remove the victim frame as defined by the replacement policy.
-   * @param[out] frame_id id of frame that was removed, nullptr if no victim was found
+   * Evict the victim frame as defined by the replacement policy and stop tracking it.
+   * @param[out] frame_id id of frame that was evicted
    * @return true if a victim frame was found, false otherwise
    */
-  virtual auto Victim(frame_id_t *frame_id) -> bool = 0;
+  virtual auto Evict(frame_id_t *frame_id) -> bool = 0;
+
+  /**
+   * Record an access to a frame, and start tracking the frame if it was not tracked yet.
+   * @param frame_id id of frame that received a new access
+   */
+  virtual void RecordAccess(frame_id_t frame_id) = 0;
 
   /**
-   * Pins a frame, indicating that it should not be victimized until it is unpinned.
-   * @param frame_id the id of the frame to pin
+   * Record that page_id was just read into (or created in) frame_id, which counts as the first access to the frame.
+   * Policies that remember recently evicted pages (2Q, ARC) use the page id to recognize a page that comes back; the
+   * default implementation forwards to RecordAccess().
+   * @param frame_id id of frame that now holds page_id
+   * @param page_id id of the page in the frame
    */
-  virtual void Pin(frame_id_t frame_id) = 0;
+  virtual void RecordLoad(frame_id_t frame_id, __attribute__((unused)) page_id_t page_id) { RecordAccess(frame_id); }
 
   /**
-   * Unpins a frame, indicating that it can now be victimized.
-   * @param frame_id the id of the frame to unpin
+   * Toggle whether a tracked frame is evictable. Untracked frames are ignored.
+   * @param frame_id id of frame whose 'evictable' status will be modified
+   * @param set_evictable whether the given frame is evictable or not
    */
-  virtual void Unpin(frame_id_t frame_id) = 0;
+  virtual void SetEvictable(frame_id_t frame_id, bool set_evictable) = 0;
 
-  /** @return the number of elements in the replacer that can be victimized */
+  /**
+   * Stop tracking an evictable frame without evicting it, e.g. because its page was deleted. The page is not
+   * remembered as recently evicted. Untracked frames are ignored; removing a non-evictable frame aborts.
+   * @param frame_id id of frame to be removed
+   */
+  virtual void Remove(frame_id_t frame_id) = 0;
+
+  /** @return the number of elements in the replacer that can be evicted */
   virtual auto Size() -> size_t = 0;
+
+  /**
+   * Change the number of frames the replacer can track, e.g. because the buffer pool grew or shrank. Frame ids at or
+   * above the new number of frames must not be tracked when shrinking.
+   * @param num_frames the new number of frames
+   */
+  virtual void Resize(size_t num_frames) = 0;
+
+  /**
+   * Return the evictable frames in the order Evict() would pick them if nothing changed in between, without evicting
+   * anything.
+   * @param max_count the maximum number of frames to return
+   * @return up to max_count frames, next victim first
+   */
+  virtual auto EvictionCandidates(size_t max_count) -> std::vector<frame_id_t> = 0;
 };
 
+/**
+ * Create a replacer.
+ * @param policy the replacement policy
+ * @param num_frames the number of frames the replacer will be required to track
+ * @param k the lookback constant, only used by LRU_K
+ * @return the new replacer
+ */
+auto MakeReplacer(ReplacerPolicy policy, size_t num_frames, size_t k = LRUK_REPLACER_K) -> std::unique_ptr<Replacer>;
+
+/** @return the name of a replacement policy, e.g. "LRU-K" */
+auto ReplacerPolicyToString(ReplacerPolicy policy) -> std::string;
+
 }  // namespace bustub
@@ -0,0 +1,52 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// replacer_simulator.h
+//
+// Identification: src/include/buffer/replacer_simulator.h
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <vector>
+
+#include "buffer/replacer.h"
+#include "common/config.h"
+
+namespace bustub {
+
+/** The outcome of replaying a page reference trace against a replacer, see SimulateReplacer(). */
+struct ReplacerSimulationResult {
+  /** References to pages that were resident. */
+  size_t hits_{0};
+  /** References that had to load the page. */
+  size_t misses_{0};
+  /** Calls made to the replacer. */
+  size_t replacer_ops_{0};
+  /** Average wall-clock time of a replacer call, in nanoseconds. */
+  double ns_per_op_{0};
+
+  /** @return hits / references, 0 for an empty trace */
+  auto HitRatio() const -> double {
+    return hits_ + misses_ == 0 ? 0 : static_cast<double>(hits_) / static_cast<double>(hits_ + misses_);
+  }
+};
+
+/**
+ * Replay a page reference trace against a replacer the way BufferPoolManagerInstance drives it, without any disk I/O
+ * or page contents: a hit pins and unpins the page's frame (RecordAccess, then non-evictable and evictable again), a
+ * miss takes a free frame or evicts a victim and loads the page into it (RecordLoad).
+ * @param policy the replacement policy
+ * @param num_frames the number of frames of the simulated buffer pool
+ * @param trace the page ids in reference order
+ * @param k the lookback constant for LRU_K
+ * @return hit and miss counts and the replacer's cost per call
+ */
+auto SimulateReplacer(ReplacerPolicy policy, size_t num_frames, const std::vector<page_id_t> &trace,
+                      size_t k = LRUK_REPLACER_K) -> ReplacerSimulationResult;
+
+}  // namespace bustub
@@ -0,0 +1,83 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// two_q_replacer.h
+//
+// Identification: src/include/buffer/two_q_replacer.h
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <mutex>  // NOLINT
+#include <vector>
+
+#include "buffer/frame_list.h"
+#include "buffer/replacer.h"
+#include "common/config.h"
+
+namespace bustub {
+
+/**
+ * TwoQReplacer implements the full 2Q replacement policy (Johnson and Shasha, VLDB 1994).
+ *
+ * A newly loaded page enters A1in, a FIFO queue of roughly a quarter of the frames; further accesses while it is in
+ * A1in are treated as correlated and ignored. Pages evicted from A1in are remembered in A1out, a ghost FIFO of page ids
+ * covering half the frames. A page that is loaded again while it is remembered in A1out has proven that it is reused
+ * and goes to Am, an LRU list. Victims come from A1in while it is larger than its target, otherwise from Am, so a
+ * scan only ever cycles through A1in.
+ *
+ * Lists keep their order while frames are pinned; Evict() skips non-evictable frames from the old end of a list.
+ */
+class TwoQReplacer : public Replacer {
+ public:
+  /**
+   * Create a new TwoQReplacer.
+   * @param num_frames the maximum number of frames the replacer will be required to store
+   */
+  explicit TwoQReplacer(size_t num_frames);
+
+  ~TwoQReplacer() override;
+
+  auto Evict(frame_id_t *frame_id) -> bool override;
+
+  void RecordAccess(frame_id_t frame_id) override;
+
+  void RecordLoad(frame_id_t frame_id, page_id_t page_id) override;
+
+  void SetEvictable(frame_id_t frame_id, bool set_evictable) override;
+
+  void Remove(frame_id_t frame_id) override;
+
+  auto Size() -> size_t override;
+
+  auto EvictionCandidates(size_t max_count) -> std::vector<frame_id_t> override;
+
+  void Resize(size_t num_frames) override;
+
+ private:
+  static constexpr size_t A1IN = 0;
+  static constexpr size_t AM = 1;
+
+  /** @return the first evictable frame at or after frame_id in its list, or FrameLists::NO_FRAME */
+  auto NextEvictable(frame_id_t frame_id) const -> frame_id_t;
+  /** Stop tracking a frame that is in one of the lists. */
+  void Untrack(frame_id_t frame_id);
+
+  /** Target size of A1in. */
+  size_t kin_;
+  /** Capacity of A1out. */
+  size_t kout_;
+  FrameLists lists_;
+  /** Page held by every tracked frame, INVALID_PAGE_ID if it was tracked through RecordAccess(). */
+  std::vector<page_id_t> page_ids_;
+  std::vector<bool> is_evictable_;
+  GhostList a1out_;
+  size_t curr_size_{0};
+  std::mutex latch_;
+};
+
+}  // namespace bustub
@@ -21,8 +21,10 @@
 #include "buffer/buffer_pool_manager.h"
 #include "catalog/schema.h"
 #include "container/hash/hash_function.h"
+#include "storage/index/b_link_tree_index.h"
 #include "storage/index/b_plus_tree_index.h"
 #include "storage/index/extendible_hash_table_index.h"
+#include "storage/index/index_entry_sorter.h"
 #include "storage/index/index.h"
 #include "storage/table/table_heap.h"
 
@@ -35,6 +37,14 @@ using table_oid_t = uint32_t;
 using column_oid_t = uint32_t;
 using index_oid_t = uint32_t;
 
+/** The data structures an index can be built on, chosen with CREATE INDEX ... USING. */
+enum class IndexType {
+  /** A B+ tree with latch crabbing, see BPlusTree. The default; supports index scans. */
+  BPlusTreeIndex,
+  /** A Lehman-Yao B-link tree, see BLinkTree. Point lookups only. */
+  BLinkTreeIndex,
+};
+
 /**
  * The TableInfo class maintains metadata about a table.
  */
@@ -70,15 +80,17 @@ struct IndexInfo {
    * @param index_oid The unique OID for the index
    * @param table_name The name of the table on which the index is created
    * @param key_size The size of the index key, in bytes
+   * @param index_type The data structure of the index
    */
   IndexInfo(Schema key_schema, std::string name, std::unique_ptr<Index> &&index, index_oid_t index_oid,
-            std::string table_name, size_t key_size)
+            std::string table_name, size_t key_size, IndexType index_type = IndexType::BPlusTreeIndex)
       : key_schema_{std::move(key_schema)},
         name_{std::move(name)},
         index_{std::move(index)},
         index_oid_{index_oid},
         table_name_{std::move(table_name)},
-        key_size_{key_size} {}
+        key_size_{key_size},
+        index_type_{index_type} {}
   /** The schema for the index key */
   Schema key_schema_;
   /** The name of the index */
@@ -91,6 +103,8 @@ struct IndexInfo {
   std::string table_name_;
   /** The size of the index key, in bytes */
   const size_t key_size_;
+  /** The data structure of the index */
+  const IndexType index_type_;
 };
 
 /**
@@ -196,12 +210,15 @@ class Catalog {
    * @param key_attrs Key attributes
    * @param keysize Size of the key
    * @param hash_function The hash function for the index
+   * @param index_type The data structure of the index
+   * @param fill_factor How full a B+ tree index fills its pages, in percent
    * @return A (non-owning) pointer to the metadata of the new table
    */
   template <class KeyType, class ValueType, class KeyComparator>
   auto CreateIndex(Transaction *txn, const std::string &index_name, const std::string &table_name, const Schema &schema,
                    const Schema &key_schema, const std::vector<uint32_t> &key_attrs, std::size_t keysize,
-                   HashFunction<KeyType> hash_function) -> IndexInfo * {
+                   HashFunction<KeyType> hash_function, IndexType index_type = IndexType::BPlusTreeIndex,
+                   int fill_factor = INDEX_FILL_FACTOR) -> IndexInfo * {
     // Reject the creation request for nonexistent table
     if (table_names_.find(table_name) == table_names_.end()) {
       return NULL_INDEX_INFO;
@@ -226,21 +243,43 @@ class Catalog {
     // just the key, value, and comparator types
 
     // TODO(chi): support both hash index and btree index
-    auto index = std::make_unique<BPlusTreeIndex<KeyType, ValueType, KeyComparator>>(std::move(meta), bpm_);
+    std::unique_ptr<Index> index;
 
-    // Populate the index with all tuples in table heap
+    // Populate the index with all tuples in table heap. The heap is read through a bulk-read ring so that the build
+    // does not evict the rest of the pool; the index pages themselves are fetched normally.
     auto *table_meta = GetTable(table_name);
     auto *heap = table_meta->table_.get();
-    for (auto tuple = heap->Begin(txn); tuple != heap->End(); ++tuple) {
-      index->InsertEntry(tuple->KeyFromTuple(schema, key_schema, key_attrs), tuple->GetRid(), txn);
+    BufferAccessStrategy strategy(BufferAccessType::BULK_READ);
+    if (index_type == IndexType::BLinkTreeIndex) {
+      index = std::make_unique<BLinkTreeIndex<KeyType, ValueType, KeyComparator>>(std::move(meta), bpm_);
+      for (auto tuple = heap->Begin(txn, &strategy); tuple != heap->End(); ++tuple) {
+        index->InsertEntry(tuple->KeyFromTuple(schema, key_schema, key_attrs), tuple->GetRid(), txn);
+      }
+    } else {
+      // A B+ tree is built bottom up from the entries sorted by key, rather than by inserting them in heap order:
+      // no page splits and every page is filled to the fill factor.
+      auto b_plus_tree_index =
+          std::make_unique<BPlusTreeIndex<KeyType, ValueType, KeyComparator>>(std::move(meta), bpm_);
+      IndexEntrySorter<KeyType, ValueType, KeyComparator> sorter(KeyComparator(b_plus_tree_index->GetKeySchema()),
+                                                                 index_build_sort_memory);
+      KeyType index_key;
+      for (auto tuple = heap->Begin(txn, &strategy); tuple != heap->End(); ++tuple) {
+        index_key.SetFromKey(tuple->KeyFromTuple(schema, key_schema, key_attrs), &key_schema);
+        sorter.Add(index_key, tuple->GetRid());
+      }
+      sorter.Finish();
+      b_plus_tree_index->BulkLoad(
+          sorter.GetNumEntries(), [&sorter](KeyType *key, ValueType *value) { return sorter.Next(key, value); },
+          fill_factor);
+      index = std::move(b_plus_tree_index);
     }
 
     // Get the next OID for the new index
     const auto index_oid = next_index_oid_.fetch_add(1);
 
     // Construct index information; IndexInfo takes ownership of the Index itself
-    auto index_info =
-        std::make_unique<IndexInfo>(key_schema, index_name, std::move(index), index_oid, table_name, keysize);
+    auto index_info = std::make_unique<IndexInfo>(key_schema, index_name, std::move(index), index_oid, table_name,
+                                                  keysize, index_type);
     auto *tmp = index_info.get();
 
     // Update internal tracking
@@ -269,6 +269,9 @@ class BustubInstance {
  private:
   void CmdDisplayTables(ResultWriter &writer);
   void CmdDisplayIndices(ResultWriter &writer);
+  void CmdDisplayBufferPoolMetrics(ResultWriter &writer);
+  void CmdSetBufferPoolSize(const std::string &value, ResultWriter &writer);
+  void CmdCompact(ResultWriter &writer);
   void CmdDisplayHelp(ResultWriter &writer);
   void WriteOneCell(const std::string &cell, ResultWriter &writer);
   std::unordered_map<std::string, std::string> session_variables_;
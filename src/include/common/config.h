@@ -21,6 +21,15 @@ namespace bustub {
 /** Cycle detection is performed every CYCLE_DETECTION_INTERVAL milliseconds. */
 extern std::chrono::milliseconds cycle_detection_interval;
 
+/** The buffer pool background flusher wakes up every BACKGROUND_FLUSH_INTERVAL milliseconds. */
+extern std::chrono::milliseconds background_flush_interval;
+
+/** Number of upcoming pages that table scans and index scans ask the buffer pool to prefetch, 0 disables read-ahead. */
+extern std::atomic<size_t> scan_prefetch_window;
+
+/** Bytes of index entries CREATE INDEX sorts in memory before it spills sorted runs to temporary files. */
+extern std::atomic<size_t> index_build_sort_memory;
+
 /** True if logging should be enabled, false otherwise. */
 extern std::atomic<bool> enable_logging;
 
@@ -36,6 +45,7 @@ static constexpr int BUFFER_POOL_SIZE = 10;
 static constexpr int LOG_BUFFER_SIZE = ((BUFFER_POOL_SIZE + 1) * BUSTUB_PAGE_SIZE);  // size of a log buffer in byte
 static constexpr int BUCKET_SIZE = 50;                                               // size of extendible hash bucket
 static constexpr int LRUK_REPLACER_K = 10;  // lookback window for lru-k replacer
+static constexpr int INDEX_FILL_FACTOR = 90;  // percent of a page CREATE INDEX fills, unless WITH (fillfactor = n)
 
 using frame_id_t = int32_t;    // frame id type
 using page_id_t = int32_t;     // page id type
@@ -0,0 +1,82 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// striped_hash_table.h
+//
+// Identification: src/include/container/hash/striped_hash_table.h
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+/**
+ * striped_hash_table.h
+ *
+ * Implementation of in-memory hash table with lock striping
+ */
+
+#pragma once
+
+#include <functional>
+#include <memory>
+#include <shared_mutex>
+#include <unordered_map>
+
+#include "container/hash/hash_table.h"
+
+namespace bustub {
+
+/**
+ * StripedHashTable splits its keys over a fixed number of independently latched stripes. Lookups only take a shared
+ * latch on the key's stripe, so concurrent readers never contend and writers only contend within a stripe.
+ * @tparam K key type
+ * @tparam V value type
+ */
+template <typename K, typename V>
+class StripedHashTable : public HashTable<K, V> {
+ public:
+  /**
+   * @brief Create a new StripedHashTable.
+   * @param num_stripes number of independently latched stripes
+   */
+  explicit StripedHashTable(size_t num_stripes);
+
+  /**
+   * @brief Find the value associated with the given key.
+   * @param key The key to be searched.
+   * @param[out] value The value associated with the key.
+   * @return True if the key is found, false otherwise.
+   */
+  auto Find(const K &key, V &value) -> bool override;
+
+  /**
+   * @brief Insert the given key-value pair into the hash table, overwriting the value of an existing key.
+   * @param key The key to be inserted.
+   * @param value The value to be inserted.
+   */
+  void Insert(const K &key, const V &value) override;
+
+  /**
+   * @brief Given the key, remove the corresponding key-value pair in the hash table.
+   * @param key The key to be deleted.
+   * @return True if the key exists, false otherwise.
+   */
+  auto Remove(const K &key) -> bool override;
+
+  /** @return the number of stripes */
+  auto GetNumStripes() const -> size_t { return num_stripes_; }
+
+ private:
+  /** One latch and its map, padded so that neighbouring stripes do not share a cache line. */
+  struct alignas(64) Stripe {
+    std::shared_mutex latch_;
+    std::unordered_map<K, V> map_;
+  };
+
+  auto GetStripe(const K &key) -> Stripe & { return stripes_[std::hash<K>()(key) % num_stripes_]; }
+
+  const size_t num_stripes_;
+  std::unique_ptr<Stripe[]> stripes_;
+};
+
+}  // namespace bustub
@@ -60,6 +60,10 @@ class InsertExecutor : public AbstractExecutor {
   TableInfo *table_info_;
   std::unique_ptr<AbstractExecutor> child_executor_;
   bool is_inserted_;
+  /** The bulk-write strategy, created once the insert turns out to be large; nullptr before that */
+  std::unique_ptr<BufferAccessStrategy> strategy_;
+  /** Number of rows after which an insert switches to a bulk-write strategy */
+  static constexpr int BULK_INSERT_THRESHOLD = 1000;
 };
 
 }  // namespace bustub
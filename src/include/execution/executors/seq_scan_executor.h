@@ -12,6 +12,7 @@
 
 #pragma once
 
+#include <memory>
 #include <vector>
 
 #include "execution/executor_context.h"
@@ -51,6 +52,8 @@ class SeqScanExecutor : public AbstractExecutor {
   /** The sequential scan plan node to be executed */
   const SeqScanPlanNode *plan_;
   TableInfo *table_info_;
+  /** The bulk-read strategy of the scan, nullptr if the table is small enough to be scanned normally */
+  std::unique_ptr<BufferAccessStrategy> strategy_;
   TableIterator table_iter_;
 };
 }  // namespace bustub
@@ -0,0 +1,87 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// async_io.h
+//
+// Identification: src/include/storage/disk/async_io.h
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <sys/types.h>
+#include <sys/uio.h>
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace bustub {
+
+/** The ways AsyncIo can run requests. */
+enum class AsyncIoBackend {
+  /** io_uring if the kernel allows it, a thread pool otherwise. */
+  AUTO,
+  /** Linux io_uring: a whole batch is handed to the kernel with one system call. */
+  IO_URING,
+  /** A few threads doing blocking pread()/pwrite(). */
+  THREAD_POOL
+};
+
+/** @return the name of an AsyncIo backend, e.g. "io_uring" */
+auto AsyncIoBackendToString(AsyncIoBackend backend) -> std::string;
+
+/** A read or write of one contiguous range of a file, see AsyncIo::Submit(). */
+struct AsyncIoRequest {
+  /** True to write buffer_ to the file, false to read the file into buffer_. */
+  bool is_write_;
+  int fd_;
+  /** length_ bytes, which must stay valid until the callback ran. */
+  char *buffer_;
+  size_t length_;
+  off_t offset_;
+  /**
+   * If not empty, the request is vectored like preadv()/pwritev(): buffer_ and length_ are ignored, and the buffers of
+   * iov_ are transferred in order to or from the range starting at offset_. At most IOV_MAX entries.
+   */
+  std::vector<iovec> iov_;
+  /**
+   * Called exactly once when the request is done, with the number of bytes transferred (less than length_ if a read
+   * hit the end of the file) or a negative errno. Runs on an I/O thread, so it must not block for long.
+   */
+  std::function<void(int64_t)> callback_;
+};
+
+/**
+ * AsyncIo runs file reads and writes in the background, so that the caller can keep many of them outstanding at once.
+ * Thread-safe. Destroying an AsyncIo waits for every submitted request to complete.
+ */
+class AsyncIo {
+ public:
+  virtual ~AsyncIo() = default;
+
+  /**
+   * @brief Start a batch of requests. They may complete in any order, and their callbacks may run before or after
+   * Submit() returns. Blocks while the number of requests in flight is at the queue depth.
+   * @param requests the requests
+   */
+  virtual void Submit(std::vector<AsyncIoRequest> requests) = 0;
+
+  /** @return the backend actually used, never AUTO */
+  virtual auto GetBackend() const -> AsyncIoBackend = 0;
+
+  /**
+   * @brief Create an AsyncIo.
+   * @param backend the backend to use; AUTO and IO_URING fall back to THREAD_POOL if io_uring is unavailable
+   * @param queue_depth the most requests in flight at once
+   * @return the new AsyncIo
+   */
+  static auto Create(AsyncIoBackend backend, size_t queue_depth) -> std::unique_ptr<AsyncIo>;
+};
+
+}  // namespace bustub
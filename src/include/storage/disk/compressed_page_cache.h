@@ -0,0 +1,157 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// compressed_page_cache.h
+//
+// Identification: src/include/storage/disk/compressed_page_cache.h
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <mutex>  // NOLINT
+#include <unordered_map>
+#include <vector>
+
+#include "common/config.h"
+#include "common/macros.h"
+
+namespace bustub {
+
+/** A point-in-time view of the counters of a CompressedPageCache. */
+struct CompressedPageCacheStats {
+  /** Pages held by the cache. */
+  uint64_t pages_{0};
+  /** Memory charged to the pages held, in bytes: their compressed size plus a fixed overhead per page. */
+  uint64_t used_bytes_{0};
+  /** The memory cap, in bytes. */
+  uint64_t capacity_bytes_{0};
+  /** Pages stored by Put(). */
+  uint64_t stores_{0};
+  /** Pages Put() did not store because they did not compress well enough. */
+  uint64_t rejects_{0};
+  /** Pages dropped to stay below the memory cap. */
+  uint64_t evictions_{0};
+  /** Take() calls that found the page. */
+  uint64_t hits_{0};
+  /** Take() calls that did not find the page. */
+  uint64_t misses_{0};
+
+  /** @return hits / (hits + misses), 0 before the first lookup */
+  auto HitRatio() const -> double {
+    return hits_ + misses_ == 0 ? 0 : static_cast<double>(hits_) / static_cast<double>(hits_ + misses_);
+  }
+
+  /** @return the uncompressed size of the pages held over the memory charged to them, 0 if the cache is empty */
+  auto CompressionRatio() const -> double {
+    return used_bytes_ == 0 ? 0 : static_cast<double>(pages_ * BUSTUB_PAGE_SIZE) / static_cast<double>(used_bytes_);
+  }
+};
+
+/**
+ * CompressedPageCache is a second tier behind the buffer pool, like zswap behind the page cache of an OS: pages the
+ * buffer pool evicts are compressed into it, and a later miss on one of them is served by decompressing it instead of
+ * reading the disk. It is owned by the DiskManager (see DiskManager::EnableCompressedCache()) and used by the buffer
+ * pools on top of it.
+ *
+ * The cache is exclusive: Take() removes the page, so a page is never both resident in a buffer pool and cached, and a
+ * cached page is always at least as recent as the disk. It holds as many pages as fit below its memory cap and drops
+ * the least recently stored ones first. Pages that do not compress below MAX_COMPRESSED_SIZE are not stored at all.
+ *
+ * Pages are compressed with a small built-in LZ77 compressor in the block format of LZ4, which is fast and does well
+ * on the mostly empty and repetitive pages of a database. Thread-safe; pages are compressed and decompressed outside
+ * the latch.
+ */
+class CompressedPageCache {
+ public:
+  /** Largest compressed page the cache stores. */
+  static constexpr size_t MAX_COMPRESSED_SIZE = BUSTUB_PAGE_SIZE * 3 / 4;
+  /** Memory charged to every cached page on top of its compressed size, for the bookkeeping. */
+  static constexpr size_t ENTRY_OVERHEAD = 64;
+
+  /**
+   * @brief Create an empty cache.
+   * @param capacity_bytes the memory cap in bytes, see CompressedPageCacheStats::used_bytes_
+   */
+  explicit CompressedPageCache(size_t capacity_bytes);
+
+  DISALLOW_COPY_AND_MOVE(CompressedPageCache);
+
+  /**
+   * @brief Store a page, replacing the version cached before if any.
+   * @param page_id id of the page
+   * @param data BUSTUB_PAGE_SIZE bytes of page data
+   * @return false if the page did not compress well enough or is larger than the cap; a cached version is dropped then
+   */
+  auto Put(page_id_t page_id, const char *data) -> bool;
+
+  /**
+   * @brief Remove a page from the cache and decompress it.
+   * @param page_id id of the page
+   * @param[out] data BUSTUB_PAGE_SIZE bytes to decompress the page into
+   * @return false if the page is not cached
+   */
+  auto Take(page_id_t page_id, char *data) -> bool;
+
+  /** @brief Drop a page from the cache, e.g. because it was deleted. */
+  void Remove(page_id_t page_id);
+
+  /** @brief Change the memory cap, dropping pages until the cache fits. */
+  void SetCapacity(size_t capacity_bytes);
+
+  /** @return the counters of the cache */
+  auto GetStats() -> CompressedPageCacheStats;
+
+  /**
+   * @brief Compress a buffer.
+   * @param src the data to compress, at most 65535 bytes
+   * @param size size of src
+   * @param[out] dst where to write the compressed data
+   * @param capacity size of dst
+   * @return size of the compressed data, 0 if it does not fit into capacity bytes
+   */
+  static auto Compress(const char *src, size_t size, char *dst, size_t capacity) -> size_t;
+
+  /**
+   * @brief Decompress the output of Compress().
+   * @param src the compressed data
+   * @param size size of src
+   * @param[out] dst where to write the data
+   * @param dst_size the size of the data before it was compressed
+   * @return false if src is not valid compressed data of dst_size bytes
+   */
+  static auto Decompress(const char *src, size_t size, char *dst, size_t dst_size) -> bool;
+
+ private:
+  struct Entry {
+    std::vector<char> data_;
+    /** Position in lru_. */
+    std::list<page_id_t>::iterator position_;
+  };
+
+  /** Drop an entry and return its compressed data. Needs latch_. */
+  auto Erase(std::unordered_map<page_id_t, Entry>::iterator entry) -> std::vector<char>;
+
+  /** Drop the least recently stored pages until the cache fits below its cap. Needs latch_. */
+  void EvictToCapacity();
+
+  std::mutex latch_;
+  size_t capacity_bytes_;
+  size_t used_bytes_{0};
+  std::unordered_map<page_id_t, Entry> entries_;
+  /** Cached page ids, the most recently stored first. */
+  std::list<page_id_t> lru_;
+  uint64_t stores_{0};
+  uint64_t rejects_{0};
+  uint64_t evictions_{0};
+  uint64_t hits_{0};
+  uint64_t misses_{0};
+};
+
+}  // namespace bustub
@@ -14,14 +14,30 @@
 
 #include <atomic>
 #include <fstream>
+#include <functional>
 #include <future>  // NOLINT
-#include <mutex>   // NOLINT
+#include <memory>
+#include <mutex>  // NOLINT
 #include <string>
+#include <vector>
 
 #include "common/config.h"
+#include "storage/disk/compressed_page_cache.h"
+#include "storage/disk/free_space_map.h"
 
 namespace bustub {
 
+/** A page read or write submitted to DiskManager::SubmitRequests(). */
+struct DiskRequest {
+  /** True to write data_ to the page, false to read the page into data_. */
+  bool is_write_;
+  page_id_t page_id_;
+  /** BUSTUB_PAGE_SIZE bytes, which must stay valid until the callback ran. Writes do not modify it. */
+  char *data_;
+  /** Called exactly once when the request is done, with true on success. May run on an I/O thread. */
+  std::function<void(bool)> callback_;
+};
+
 /**
  * DiskManager takes care of the allocation and deallocation of pages within a database. It performs the reading and
  * writing of pages to and from disk, providing a logical file layer within the context of a database management system.
@@ -42,7 +58,7 @@ class DiskManager {
   /**
    * Shut down the disk manager and close all the file resources.
    */
-  void ShutDown();
+  virtual void ShutDown();
 
   /**
    * Write a page to the database file.
@@ -58,6 +74,45 @@ class DiskManager {
    */
   virtual void ReadPage(page_id_t page_id, char *page_data);
 
+  /**
+   * Start a batch of page reads and writes. The requests may complete in any order, and their callbacks may run before
+   * or after this call returns, on any thread. Requests on the same page that are in flight together may run in any
+   * order. The
+   * default implementation runs them one by one with ReadPage() and WritePage() before it returns.
+   * @param requests the requests
+   */
+  virtual void SubmitRequests(std::vector<DiskRequest> requests);
+
+  /**
+   * Get a page without reading it, for disk managers that map the database file.
+   * @param page_id id of the page
+   * @return the page data in a read-only mapping that stays valid for the lifetime of the disk manager, or nullptr if
+   * the page is not mapped; the default implementation maps no page
+   */
+  virtual auto GetMappedPage(__attribute__((unused)) page_id_t page_id) -> const char * { return nullptr; }
+
+  /**
+   * Submit a batch of page reads and writes like SubmitRequests() and wait until all of them are done.
+   * @param requests the requests; a callback may be empty
+   */
+  void SubmitRequestsAndWait(std::vector<DiskRequest> requests);
+
+  /**
+   * Start reading a page, see SubmitRequests().
+   * @param page_id id of the page
+   * @param[out] page_data output buffer, which must stay valid until the future is ready
+   * @return a future that becomes true once the page was read, false on an I/O error
+   */
+  auto ReadPageAsync(page_id_t page_id, char *page_data) -> std::future<bool>;
+
+  /**
+   * Start writing a page, see SubmitRequests().
+   * @param page_id id of the page
+   * @param page_data raw page data, which must stay valid until the future is ready
+   * @return a future that becomes true once the page was written, false on an I/O error
+   */
+  auto WritePageAsync(page_id_t page_id, const char *page_data) -> std::future<bool>;
+
   /**
    * Flush the entire log buffer into disk.
    * @param log_data raw log data
@@ -83,6 +138,34 @@ class DiskManager {
   /** @return the number of disk writes */
   auto GetNumWrites() const -> int;
 
+  /**
+   * Track free pages in a FreeSpaceMap persisted next to the database file, in <db file stem>.fsm, so that buffer pools
+   * on this disk manager reuse deleted pages. Must be called before a buffer pool is created on this disk manager.
+   * @throws Exception if the disk manager has no database file or the map cannot be opened
+   */
+  void EnableFreeSpaceMap();
+
+  /** @return the free-space map, nullptr unless EnableFreeSpaceMap() was called */
+  auto GetFreeSpaceMap() -> FreeSpaceMap * { return free_space_map_.get(); }
+
+  /**
+   * Shrink the database file by the free pages at its end. Does nothing without a free-space map.
+   * @return the number of pages the file shrank by
+   */
+  auto TruncateFreePages() -> size_t;
+
+  /**
+   * Keep the pages that buffer pools on this disk manager evict in a CompressedPageCache, so that misses on them are
+   * served from memory. Must be called before a buffer pool is created on this disk manager.
+   * @param capacity_bytes the memory cap of the cache in bytes
+   */
+  void EnableCompressedCache(size_t capacity_bytes) {
+    compressed_cache_ = std::make_unique<CompressedPageCache>(capacity_bytes);
+  }
+
+  /** @return the compressed page cache, nullptr unless EnableCompressedCache() was called */
+  auto GetCompressedCache() -> CompressedPageCache * { return compressed_cache_.get(); }
+
   /**
    * Sets the future which is used to check for non-blocking flushes.
    * @param f the non-blocking flush check
@@ -93,7 +176,22 @@ class DiskManager {
   inline auto HasFlushLogFuture() -> bool { return flush_log_f_ != nullptr; }
 
  protected:
+  /**
+   * Creates a disk manager for the specified database file that does its own page I/O: the database file is left to
+   * the subclass, which is its only owner, and only the log file is opened.
+   * @param db_file the file name of the database file
+   * @param open_log false to keep no log file either, e.g. for one data file of a DiskManagerStriped
+   */
+  DiskManager(const std::string &db_file, bool open_log);
+
   auto GetFileSize(const std::string &file_name) -> int;
+
+  /**
+   * Shrink the database file to size bytes, if it is larger. Called with allocations blocked.
+   * @param size the new size of the file
+   */
+  virtual void TruncateDbFile(int64_t size);
+
   // stream to write log file
   std::fstream log_io_;
   std::string log_name_;
@@ -101,11 +199,13 @@ class DiskManager {
   std::fstream db_io_;
   std::string file_name_;
   int num_flushes_{0};
-  int num_writes_{0};
+  std::atomic<int> num_writes_{0};
   bool flush_log_{false};
   std::future<void> *flush_log_f_{nullptr};
   // With multiple buffer pool instances, need to protect file access
   std::mutex db_io_latch_;
+  std::unique_ptr<FreeSpaceMap> free_space_map_;
+  std::unique_ptr<CompressedPageCache> compressed_cache_;
 };
 
 }  // namespace bustub
@@ -0,0 +1,74 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// disk_manager_mmap.h
+//
+// Identification: src/include/storage/disk/disk_manager_mmap.h
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+#include "common/config.h"
+#include "storage/disk/disk_manager.h"
+
+namespace bustub {
+
+/**
+ * DiskManagerMmap serves the pages of a database file that is never written, like an analytic copy, from a read-only
+ * shared mapping of the whole file. Opening it reads nothing, ReadPage() is a memcpy from the mapping, and
+ * GetMappedPage() lets a buffer pool in zero-copy mode (see BufferPoolManagerInstance::SetZeroCopyReads()) pin the
+ * mapped pages without copying them at all, so that the OS page cache is the only copy of the data.
+ *
+ * The file is mapped as large as it is when the disk manager is created; pages past its end read as zeros. There is no
+ * log file. Writing a page throws.
+ */
+class DiskManagerMmap : public DiskManager {
+ public:
+  /**
+   * Maps the specified database file.
+   * @param db_file the file name of the database file to read
+   * @throws Exception if the database file cannot be opened or mapped
+   */
+  explicit DiskManagerMmap(const std::string &db_file);
+
+  /** Unmaps the database file. Pages pinned from the mapping must not be used afterwards. */
+  ~DiskManagerMmap() override;
+
+  /** Does nothing: the mapping stays valid for pinned pages until the disk manager is destroyed. */
+  void ShutDown() override {}
+
+  /**
+   * Always throws, the mapping is read-only.
+   * @throws Exception
+   */
+  void WritePage(page_id_t page_id, const char *page_data) override;
+
+  /**
+   * Copy a page from the mapping. The part of the page past the end of the file reads as zeros.
+   * @param page_id id of the page
+   * @param[out] page_data output buffer
+   */
+  void ReadPage(page_id_t page_id, char *page_data) override;
+
+  /**
+   * @param page_id id of the page
+   * @return the page in the mapping, or nullptr if the page is not completely inside the file
+   */
+  auto GetMappedPage(page_id_t page_id) -> const char * override;
+
+  /** @return the size of the mapped database file in bytes */
+  auto GetDbFileSize() const -> int64_t { return db_file_size_; }
+
+ private:
+  char *mapping_{nullptr};
+  int64_t db_file_size_{0};
+};
+
+}  // namespace bustub
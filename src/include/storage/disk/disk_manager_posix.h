@@ -0,0 +1,147 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// disk_manager_posix.h
+//
+// Identification: src/include/storage/disk/disk_manager_posix.h
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <mutex>  // NOLINT
+#include <string>
+#include <vector>
+
+#include "common/config.h"
+#include "storage/disk/async_io.h"
+#include "storage/disk/disk_manager.h"
+
+namespace bustub {
+
+/**
+ * DiskManagerPosix reads and writes pages of the database file with positional pread()/pwrite() on a file descriptor.
+ * Unlike DiskManager, which seeks a shared stream under one latch, page I/O takes no latch at all, so reads and writes
+ * of different pages from different buffer pool instances run in parallel. The file size is cached instead of being
+ * stat()ed on every read. The log file is handled like in DiskManager.
+ *
+ * With direct I/O the file is opened with O_DIRECT and page I/O bypasses the page cache. O_DIRECT needs the buffers to
+ * be aligned: buffer pool frames are, other buffers are copied through an aligned per-thread bounce buffer. If the file
+ * system does not support O_DIRECT (e.g. tmpfs), the file is opened for buffered I/O instead, see IsDirectIo().
+ *
+ * SubmitRequests() runs batches of page I/O asynchronously on io_uring, or on a thread pool where io_uring is not
+ * available, so that prefetching and flushing can keep many I/Os outstanding. Writes of a batch are sorted by page id
+ * and runs of adjacent pages are merged into one vectored write, so flushing many dirty pages of a sequentially
+ * filled file costs a few large writes instead of one system call per page.
+ */
+class DiskManagerPosix : public DiskManager {
+ public:
+  /** Alignment of buffers, offsets and sizes of direct I/O. */
+  static constexpr size_t DIRECT_IO_ALIGNMENT = 4096;
+
+  /**
+   * Creates a new disk manager that writes to the specified database file.
+   * @param db_file the file name of the database file to write to
+   * @param direct_io true to bypass the page cache with O_DIRECT
+   * @param async_backend how SubmitRequests() runs requests, set up on its first call
+   * @param open_log false to keep no log file, for a data file of a DiskManagerStriped
+   * @throws Exception if the database or log file cannot be opened
+   */
+  explicit DiskManagerPosix(const std::string &db_file, bool direct_io = false,
+                            AsyncIoBackend async_backend = AsyncIoBackend::AUTO, bool open_log = true);
+
+  /** Closes the database file. */
+  ~DiskManagerPosix() override;
+
+  /** Shut down the disk manager and close all the file resources. */
+  void ShutDown() override;
+
+  /**
+   * Write a page to the database file. Safe to call concurrently, also for the same page.
+   * @param page_id id of the page
+   * @param page_data raw page data
+   */
+  void WritePage(page_id_t page_id, const char *page_data) override;
+
+  /**
+   * Read a page from the database file. The part of the page past the end of the file reads as zeros.
+   * @param page_id id of the page
+   * @param[out] page_data output buffer
+   */
+  void ReadPage(page_id_t page_id, char *page_data) override;
+
+  /**
+   * Start a batch of page reads and writes without waiting for them, see DiskManager::SubmitRequests(). The whole
+   * batch is handed to the kernel at once, with writes of adjacent pages coalesced into pwritev()-style writes of up
+   * to MAX_COALESCED_PAGES pages. All pages of a coalesced write succeed or fail together. Callbacks run on an I/O
+   * thread.
+   * @param requests the requests
+   */
+  void SubmitRequests(std::vector<DiskRequest> requests) override;
+
+  /** @return the backend SubmitRequests() uses, setting it up if it was not used yet */
+  auto GetAsyncIoBackend() -> AsyncIoBackend;
+
+  /** @return true if page I/O bypasses the page cache */
+  auto IsDirectIo() const -> bool { return direct_io_; }
+
+  /** @return the size of the database file in bytes, as far as this disk manager has written it */
+  auto GetDbFileSize() const -> int64_t { return db_file_size_; }
+
+  /** @return the number of writes issued to the database file; a coalesced write of many pages counts once */
+  auto GetNumFileWrites() const -> int { return num_file_writes_; }
+
+  /** Most pages merged into one vectored write. */
+  static constexpr size_t MAX_COALESCED_PAGES = 64;
+
+ private:
+  /** Truncates its data files. */
+  friend class DiskManagerStriped;
+
+  /** A page write of SubmitRequests() waiting to be coalesced. */
+  struct PendingWrite {
+    /** @return the buffer to write from */
+    auto Buffer() const -> char * { return bounce_ != nullptr ? bounce_ : request_.data_; }
+
+    DiskRequest request_;
+    /** Aligned copy of the page data for direct I/O, or nullptr. */
+    char *bounce_;
+  };
+
+  /** Sort writes by page id and append one request per run of adjacent pages to io_requests. */
+  void CoalesceWrites(std::vector<PendingWrite> writes, std::vector<AsyncIoRequest> *io_requests);
+
+  /** @return true if page I/O on buffer has to go through the bounce buffer */
+  auto NeedsBounceBuffer(const char *buffer) const -> bool;
+
+  /** @return an aligned, page-sized buffer owned by the calling thread */
+  static auto BounceBuffer() -> char *;
+
+  /** @return the async I/O engine, created on first use */
+  auto GetAsyncIo() -> AsyncIo *;
+
+  /** Shrink the file with ftruncate(), keeping the cached size in sync. */
+  void TruncateDbFile(int64_t size) override;
+
+  /** Grow the cached file size to cover a write that ended at end. */
+  void ExtendFileSize(int64_t end);
+
+  /** Most page I/Os SubmitRequests() keeps in flight. */
+  static constexpr size_t ASYNC_QUEUE_DEPTH = 64;
+
+  int db_fd_{-1};
+  bool direct_io_{false};
+  /** Size of the database file, grown by writes past its end. */
+  std::atomic<int64_t> db_file_size_{0};
+  std::atomic<int> num_file_writes_{0};
+  const AsyncIoBackend async_backend_;
+  std::once_flag async_io_once_;
+  std::unique_ptr<AsyncIo> async_io_;
+};
+
+}  // namespace bustub
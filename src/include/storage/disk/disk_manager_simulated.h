@@ -0,0 +1,150 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// disk_manager_simulated.h
+//
+// Identification: src/include/storage/disk/disk_manager_simulated.h
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <chrono>  // NOLINT
+#include <cstdint>
+#include <mutex>  // NOLINT
+#include <vector>
+
+#include "common/config.h"
+#include "storage/disk/disk_manager.h"
+
+namespace bustub {
+
+/** The performance of a simulated storage device, see DiskManagerSimulated. */
+struct SimulatedDeviceProfile {
+  /** Time from the start of a read until its data starts to transfer, in microseconds. */
+  uint64_t read_latency_us_{0};
+  /** Time from the start of a write until its data starts to transfer, in microseconds. */
+  uint64_t write_latency_us_{0};
+  /**
+   * Extra latency of a request that does not continue where the previous one ended, in microseconds: the seek and
+   * rotational delay of a disk. 0 for devices without a penalty for random access.
+   */
+  uint64_t seek_latency_us_{0};
+  /** Requests the device works on at once; more requests wait in its queue. */
+  size_t queue_depth_{1};
+  /** Transfer rate shared by all requests, in bytes per second; 0 for unlimited. */
+  uint64_t bandwidth_bytes_per_second_{0};
+
+  /** @return a NVMe flash drive: fast random access, deep queue, high bandwidth */
+  static auto Ssd() -> SimulatedDeviceProfile { return {80, 20, 0, 32, 2000000000}; }
+
+  /** @return a 7200 rpm hard disk: a few milliseconds per random access, one request at a time */
+  static auto Hdd() -> SimulatedDeviceProfile { return {100, 100, 8000, 1, 150000000}; }
+};
+
+/** Counters of a DiskManagerSimulated. */
+struct SimulatedDeviceStats {
+  uint64_t reads_{0};
+  uint64_t writes_{0};
+  /** Requests that paid the seek latency. */
+  uint64_t seeks_{0};
+  /** Total time requests waited in the queue for the device, in nanoseconds. */
+  uint64_t queue_wait_ns_{0};
+  /** Total time from the start of requests to their completion, queueing included, in nanoseconds. */
+  uint64_t total_latency_ns_{0};
+};
+
+/**
+ * DiskManagerSimulated gives another disk manager, typically a DiskManagerMemory or a DiskManagerUnlimitedMemory, the
+ * performance of a real device, so that benchmarks of the buffer pool and the indexes pay for their misses.
+ *
+ * Every page request is scheduled on a model of the device described by a SimulatedDeviceProfile: it waits for one of
+ * queue_depth_ slots, takes the read or write latency plus the seek latency if it is not sequential, and then
+ * transfers its page through a channel of the given bandwidth that all requests share. The model decides when each
+ * request completes; the wrapped disk manager only does the actual reads and writes.
+ *
+ * In real time mode, the caller is blocked until the simulated completion, so wall-clock measurements include the I/O.
+ * In virtual time mode, nothing sleeps: the device keeps a clock that a request starts at and that moves to the
+ * completion of the requests, as if a single caller waited for every request or batch. That is deterministic and
+ * fast, and GetSimulatedTime() tells how long a workload would have taken on the device.
+ */
+class DiskManagerSimulated : public DiskManager {
+ public:
+  /**
+   * Creates a simulated device on top of another disk manager.
+   * @param disk_manager the disk manager that stores the pages, not owned
+   * @param profile the performance of the device
+   * @param real_time true to block callers until their requests complete, false to only advance a virtual clock
+   */
+  DiskManagerSimulated(DiskManager *disk_manager, const SimulatedDeviceProfile &profile, bool real_time = true);
+
+  /** Shut down the wrapped disk manager. */
+  void ShutDown() override { disk_manager_->ShutDown(); }
+
+  /**
+   * Write a page through the simulated device.
+   * @param page_id id of the page
+   * @param page_data raw page data
+   */
+  void WritePage(page_id_t page_id, const char *page_data) override;
+
+  /**
+   * Read a page through the simulated device.
+   * @param page_id id of the page
+   * @param[out] page_data output buffer
+   */
+  void ReadPage(page_id_t page_id, char *page_data) override;
+
+  /**
+   * Run a batch of requests, all of them issued at once so that up to queue_depth_ of them overlap. Callbacks run on
+   * the calling thread in the order the requests complete, before this returns.
+   * @param requests the requests
+   */
+  void SubmitRequests(std::vector<DiskRequest> requests) override;
+
+  /** @return the time since the device was created until its last scheduled request completes */
+  auto GetSimulatedTime() -> std::chrono::nanoseconds;
+
+  /** @return the counters of the device */
+  auto GetStats() -> SimulatedDeviceStats;
+
+ private:
+  /** @return the current time of the device: elapsed since creation in real time mode, the virtual clock otherwise */
+  auto Now() -> std::chrono::nanoseconds;
+
+  /**
+   * Schedule a request on the device model. Needs latch_.
+   * @param is_write true for a write
+   * @param page_id the page of the request
+   * @param issue the time the request is issued
+   * @return the time the request completes
+   */
+  auto Schedule(bool is_write, page_id_t page_id, std::chrono::nanoseconds issue) -> std::chrono::nanoseconds;
+
+  /** Block until the device time reaches a point in real time mode, move the virtual clock there otherwise. */
+  void WaitUntil(std::chrono::nanoseconds time);
+
+  DiskManager *disk_manager_;
+  const SimulatedDeviceProfile profile_;
+  const bool real_time_;
+  const std::chrono::steady_clock::time_point start_;
+
+  /** Protects the device model and the counters. */
+  std::mutex latch_;
+  /** When each queue slot becomes free. */
+  std::vector<std::chrono::nanoseconds> slot_free_at_;
+  /** When the transfer channel becomes free. */
+  std::chrono::nanoseconds channel_free_at_{0};
+  /** The completion time of the latest request scheduled. */
+  std::chrono::nanoseconds last_completion_{0};
+  /** The virtual clock. */
+  std::chrono::nanoseconds clock_{0};
+  /** The page after the one of the previous request, where a sequential request starts. */
+  page_id_t next_sequential_page_id_{INVALID_PAGE_ID};
+  SimulatedDeviceStats stats_;
+};
+
+}  // namespace bustub
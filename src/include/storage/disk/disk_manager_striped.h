@@ -0,0 +1,97 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// disk_manager_striped.h
+//
+// Identification: src/include/storage/disk/disk_manager_striped.h
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "common/config.h"
+#include "storage/disk/disk_manager.h"
+#include "storage/disk/disk_manager_posix.h"
+
+namespace bustub {
+
+/**
+ * DiskManagerStriped stores the database in a tablespace of several data files, which may live on different devices.
+ * Page ids are striped over the files RAID-0 style: the pages are cut into stripes of stripe_pages consecutive pages,
+ * and stripe i goes to file i % num_files. Each file is a DiskManagerPosix of its own, with its own file descriptor and
+ * its own asynchronous I/O queue, so a batch of requests, like a flush or the reads of a scan, is split by file and the
+ * files work on their parts in parallel. No file grows beyond its share of the database.
+ *
+ * File 0 is the database file given to the constructor, which also names the log file and the free-space map; file i
+ * is <stem>.<i><extension>, e.g. test.db, test.1.db, test.2.db. A tablespace must always be opened with the same
+ * number of files and stripe size.
+ */
+class DiskManagerStriped : public DiskManager {
+ public:
+  /**
+   * Creates a striped tablespace.
+   * @param db_file the file name of the first data file, which also names the other files and the log
+   * @param num_files the number of data files, at least 1
+   * @param stripe_pages the number of consecutive pages that go to the same file, at least 1
+   * @param direct_io true to bypass the page cache with O_DIRECT, see DiskManagerPosix
+   * @param async_backend how the data files run asynchronous requests
+   * @throws Exception if a file cannot be opened
+   */
+  DiskManagerStriped(const std::string &db_file, size_t num_files, size_t stripe_pages, bool direct_io = false,
+                     AsyncIoBackend async_backend = AsyncIoBackend::AUTO);
+
+  /** Shut down the data files and close the log. */
+  void ShutDown() override;
+
+  /**
+   * Write a page to its data file.
+   * @param page_id id of the page
+   * @param page_data raw page data
+   */
+  void WritePage(page_id_t page_id, const char *page_data) override;
+
+  /**
+   * Read a page from its data file.
+   * @param page_id id of the page
+   * @param[out] page_data output buffer
+   */
+  void ReadPage(page_id_t page_id, char *page_data) override;
+
+  /**
+   * Split a batch of requests by data file and submit each part to its file, see DiskManagerPosix::SubmitRequests().
+   * @param requests the requests
+   */
+  void SubmitRequests(std::vector<DiskRequest> requests) override;
+
+  /**
+   * @param page_id id of the page
+   * @return the index of the data file the page is stored in, and the page's position in that file
+   */
+  auto Locate(page_id_t page_id) const -> std::pair<size_t, page_id_t>;
+
+  /** @return the number of data files */
+  auto GetNumFiles() const -> size_t { return files_.size(); }
+
+  /** @return a data file */
+  auto GetFile(size_t index) -> DiskManagerPosix * { return files_[index].get(); }
+
+  /** @return the file name of data file index of the tablespace whose first data file is db_file */
+  static auto DataFileName(const std::string &db_file, size_t index) -> std::string;
+
+ private:
+  /** Shrink every data file to its share of the first size bytes of the database. */
+  void TruncateDbFile(int64_t size) override;
+
+  const size_t stripe_pages_;
+  std::vector<std::unique_ptr<DiskManagerPosix>> files_;
+};
+
+}  // namespace bustub
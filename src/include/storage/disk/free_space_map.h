@@ -0,0 +1,140 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// free_space_map.h
+//
+// Identification: src/include/storage/disk/free_space_map.h
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <mutex>  // NOLINT
+#include <set>
+#include <string>
+#include <vector>
+
+#include "common/config.h"
+#include "common/macros.h"
+
+namespace bustub {
+
+/**
+ * FreeSpaceMap tracks which pages of a database file are free, so that deleted pages are reused instead of the file
+ * growing forever. It keeps one bit per page, set while the page is free, and the end of the file: the number of
+ * pages ever allocated. Both live in memory and are persisted to a file of their own made of BUSTUB_PAGE_SIZE pages:
+ * page 0 is a header, page i + 1 holds the bits of the pages [i * BITS_PER_PAGE, (i + 1) * BITS_PER_PAGE).
+ *
+ * The bitmap on disk is only trusted after a clean Close(). A crash may have lost the reuse of a free page, so after
+ * an unclean shutdown every page counts as allocated: that leaks the free pages, but never hands out a page in use.
+ * For the same reason the end of the file is persisted ahead of the allocations, ALLOCATION_EXTENT pages at a time.
+ *
+ * Page ids may be striped over several allocators, like the instances of a ParallelBufferPoolManager: Allocate() only
+ * returns ids with page_id % num_stripes == stripe. Thread-safe.
+ */
+class FreeSpaceMap {
+ public:
+  /** Pages tracked by one bitmap page. */
+  static constexpr size_t BITS_PER_PAGE = BUSTUB_PAGE_SIZE * 8;
+  /** Pages the persisted end of the file runs ahead of the allocations. */
+  static constexpr page_id_t ALLOCATION_EXTENT = 64;
+
+  /**
+   * @brief Open the free-space map persisted in file_name, or create an empty one.
+   * @throws Exception if the file cannot be opened
+   */
+  explicit FreeSpaceMap(const std::string &file_name);
+
+  /** @brief Close() the map. */
+  ~FreeSpaceMap();
+
+  DISALLOW_COPY_AND_MOVE(FreeSpaceMap);
+
+  /**
+   * @brief Allocate a page of a stripe: the free page with the lowest id if there is one, otherwise a page at the end
+   * of the file. Pages of other stripes skipped at the end of the file become free for their stripes.
+   * @param stripe the stripe of the page id, less than num_stripes
+   * @param num_stripes the number of stripes the page ids are spread over
+   * @param[out] reused if not nullptr, set to true if the page was free, false if it is a new page at the end
+   * @return the page id
+   */
+  auto Allocate(uint32_t stripe, uint32_t num_stripes, bool *reused = nullptr) -> page_id_t;
+
+  /** @brief Mark a page free. Freeing a free page or a page past the end of the file does nothing. */
+  void Free(page_id_t page_id);
+
+  /** @return true if the page is free */
+  auto IsFree(page_id_t page_id) -> bool;
+
+  /** @return the number of free pages */
+  auto GetNumFreePages() -> size_t;
+
+  /**
+   * @return the number of pages ever allocated and not truncated, i.e. the file size in pages once every allocated
+   * page has been written; pages at the end that were never written are not in the file yet
+   */
+  auto GetEnd() -> page_id_t;
+
+  /**
+   * @brief Cut the free pages off the end of the file, so that the file can shrink.
+   * @param truncate called with the new end while allocations are blocked, to shrink the file to that many pages
+   * @return the number of pages cut off
+   */
+  auto TruncateFreeTail(const std::function<void(page_id_t)> &truncate) -> size_t;
+
+  /** @brief Write the changed parts of the map to its file. The map stays unclean until Close(). */
+  void Flush();
+
+  /** @brief Flush the map, mark it clean and close its file. Later calls do nothing. */
+  void Close();
+
+ private:
+  /** The header page of the file. */
+  struct Header {
+    uint32_t magic_;
+    /** 1 if the map was closed cleanly, so that the bitmap can be trusted. */
+    uint32_t clean_;
+    /** The end of the file, or a bound on it if the map is not clean. */
+    int64_t end_;
+  };
+
+  static constexpr uint32_t MAGIC = 0x4653504d;  // "FSPM"
+  static constexpr size_t BITS_PER_WORD = 64;
+  static constexpr size_t WORDS_PER_PAGE = BITS_PER_PAGE / BITS_PER_WORD;
+
+  /** Set or clear the bit of a page, keeping the counters and dirty pages up to date. Needs latch_. */
+  void SetFree(page_id_t page_id, bool free);
+
+  /** Grow the bitmap to cover the pages below end. Needs latch_. */
+  void Reserve(page_id_t end);
+
+  /** Write the header and the dirty bitmap pages. Needs latch_. */
+  void WriteDirty(bool clean);
+
+  /** Write the header. Needs latch_. */
+  void WriteHeader(bool clean, page_id_t end);
+
+  /** Read or write one page of the file, zero-filling reads past its end. */
+  void ReadFilePage(size_t index, char *data);
+  void WriteFilePage(size_t index, const char *data);
+
+  std::mutex latch_;
+  int fd_{-1};
+  /** Bit i of word i / 64 is set while page i is free. */
+  std::vector<uint64_t> bits_;
+  /** Bitmap pages changed since the last write. */
+  std::set<size_t> dirty_pages_;
+  /** No word below this one has a bit set. */
+  size_t first_free_word_{0};
+  size_t num_free_{0};
+  page_id_t end_{0};
+  /** The end of the file as written in the header. Never below end_. */
+  page_id_t persisted_end_{0};
+};
+
+}  // namespace bustub
@@ -0,0 +1,103 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// b_link_tree.h
+//
+// Identification: src/include/storage/index/b_link_tree.h
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+#pragma once
+
+#include <atomic>
+#include <mutex>  // NOLINT
+#include <string>
+#include <vector>
+
+#include "concurrency/transaction.h"
+#include "storage/page/b_link_tree_page.h"
+
+namespace bustub {
+
+#define BLINKTREE_TYPE BLinkTree<KeyType, ValueType, KeyComparator>
+
+/**
+ * A concurrent B+ tree after Lehman and Yao, "Efficient Locking for Concurrent Operations on B-Trees" (1981).
+ *
+ * Every node has a high key and a link to its right sibling (see BLinkTreePage). A split moves the upper half of a node
+ * into a new right sibling and links it in before the parent learns about it, so the tree is a valid search structure
+ * at every point in between: a search that lands on the left half of a split node moves right. Hence:
+ * (1) readers latch one node at a time, and never wait for a split to finish;
+ * (2) writers descend like readers, write latch only the leaf, and on a split latch the parent while still holding the
+ *     child, so at most two nodes (three while moving right) are latched at once;
+ * (3) there is no latch over the whole tree: a mutex is taken only to install a new root.
+ *
+ * As in the paper, removes only take the entry out of its leaf: nodes are never merged or freed, so underfull nodes
+ * stay until the index is rebuilt. We only support unique keys.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+class BLinkTree {
+  using InternalPage = BLinkTreePage<KeyType, page_id_t, KeyComparator>;
+  using LeafPage = BLinkTreePage<KeyType, ValueType, KeyComparator>;
+
+ public:
+  explicit BLinkTree(std::string name, BufferPoolManager *buffer_pool_manager, const KeyComparator &comparator,
+                     int leaf_max_size = 0, int internal_max_size = 0);
+
+  // Returns true if this tree has no root yet.
+  auto IsEmpty() const -> bool;
+
+  // Insert a key-value pair into this tree. Returns false if the key exists.
+  auto Insert(const KeyType &key, const ValueType &value, Transaction *transaction = nullptr) -> bool;
+
+  // Remove a key and its value from this tree.
+  void Remove(const KeyType &key, Transaction *transaction = nullptr);
+
+  // return the value associated with a given key
+  auto GetValue(const KeyType &key, std::vector<ValueType> *result, Transaction *transaction = nullptr) -> bool;
+
+  // return the page id of the root node
+  auto GetRootPageId() -> page_id_t;
+
+  // return all entries in key order, walking the leaves along their right links; for tests and debugging
+  auto ScanAll() -> std::vector<std::pair<KeyType, ValueType>>;
+
+ private:
+  void UpdateRootPageId(int insert_record = 0);
+
+  // Fetch a page and latch it.
+  auto FetchLatched(page_id_t page_id, bool exclusive) -> Page *;
+
+  // Unlatch a page and unpin it.
+  void Release(Page *page, bool exclusive, bool is_dirty);
+
+  // Follow right links from a latched node until reaching the node covering key, latching each before releasing the
+  // one to its left. Returns the latched page.
+  auto MoveRight(Page *page, const KeyType &key, bool exclusive) -> Page *;
+
+  /**
+   * Descend from the root to the node at the given level covering key, read latching one node at a time.
+   * @param path if not null, receives the internal nodes passed on the way, top down
+   * @return the node, latched as asked, or nullptr if the tree is empty
+   */
+  auto FindNode(const KeyType &key, int level, bool exclusive, std::vector<page_id_t> *path) -> Page *;
+
+  // Link a new right sibling split off child into the level above. child is write latched and released here.
+  void InsertInParent(Page *child, const KeyType &separator, page_id_t new_page_id, std::vector<page_id_t> *path);
+
+  // member variable
+  std::string index_name_;
+  std::atomic<page_id_t> root_page_id_;
+  // level of the root, changes together with root_page_id_ under root_latch_
+  std::atomic<int> root_level_{0};
+  // taken to install a root, never while descending
+  std::mutex root_latch_;
+  BufferPoolManager *buffer_pool_manager_;
+  KeyComparator comparator_;
+  int leaf_max_size_;
+  int internal_max_size_;
+};
+
+}  // namespace bustub
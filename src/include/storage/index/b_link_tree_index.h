@@ -0,0 +1,46 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// b_link_tree_index.h
+//
+// Identification: src/include/storage/index/b_link_tree_index.h
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "storage/index/b_link_tree.h"
+#include "storage/index/index.h"
+
+namespace bustub {
+
+#define BLINKTREE_INDEX_TYPE BLinkTreeIndex<KeyType, ValueType, KeyComparator>
+
+/**
+ * An index backed by a BLinkTree. It supports the point operations of Index only; scans in key order need a
+ * BPlusTreeIndex.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+class BLinkTreeIndex : public Index {
+ public:
+  BLinkTreeIndex(std::unique_ptr<IndexMetadata> &&metadata, BufferPoolManager *buffer_pool_manager);
+
+  void InsertEntry(const Tuple &key, RID rid, Transaction *transaction) override;
+
+  void DeleteEntry(const Tuple &key, RID rid, Transaction *transaction) override;
+
+  void ScanKey(const Tuple &key, std::vector<RID> *result, Transaction *transaction) override;
+
+ protected:
+  KeyComparator comparator_;
+  BLinkTree<KeyType, ValueType, KeyComparator> container_;
+};
+
+}  // namespace bustub
@@ -10,6 +10,8 @@
 //===----------------------------------------------------------------------===//
 #pragma once
 
+#include <atomic>
+#include <functional>
 #include <queue>
 #include <string>
 #include <vector>
@@ -49,6 +51,10 @@ class BPlusTree {
   // Insert a key-value pair into this B+ tree.
   auto Insert(const KeyType &key, const ValueType &value, Transaction *transaction = nullptr) -> bool;
 
+  // Fill an empty B+ tree bottom up from num_entries entries that next returns in strictly ascending key order.
+  auto BulkLoad(size_t num_entries, const std::function<bool(KeyType *, ValueType *)> &next, int fill_factor = 100)
+      -> bool;
+
   // Remove a key and its value from this B+ tree.
   void Remove(const KeyType &key, Transaction *transaction = nullptr);
 
@@ -88,6 +94,13 @@ class BPlusTree {
 
   auto FindLeafPage(const KeyType &key, OperType op, Transaction *transaction = nullptr) -> LeafPage *;
 
+  // Inserts and removes first descend with read latches and write latch only the leaf, and fall back to write latch
+  // crabbing from the root when the leaf would split or underflow. Enabled by default; disable to always crab.
+  void SetOptimisticLatching(bool enable) { optimistic_latching_ = enable; }
+
+  // Number of optimistic inserts and removes that had to restart with write latch crabbing.
+  auto GetOptimisticRestarts() const -> uint64_t { return optimistic_restarts_; }
+
  private:
   void UpdateRootPageId(int insert_record = 0);
 
@@ -98,6 +111,10 @@ class BPlusTree {
 
   inline auto GetBPlusTreePage(page_id_t page_id) -> BPlusTreePage *;
 
+  auto LookupChild(InternalPage *b_plus_internal_page, const KeyType &key) -> page_id_t;
+
+  auto FindLeafPageOptimistic(const KeyType &key) -> Page *;
+
   inline auto GetBPlusTreePageWithLatch(page_id_t page_id, OperType op, page_id_t pre_page_id,
                                         Transaction *transaction = nullptr) -> BPlusTreePage *;
 
@@ -127,6 +144,10 @@ class BPlusTree {
   KeyComparator comparator_;
   int leaf_max_size_;
   int internal_max_size_;
+  bool optimistic_latching_{true};
+  std::atomic<uint64_t> optimistic_restarts_{0};
+  // sibling links of the leaves seen so far, so that scans can prefetch several leaves ahead
+  LeafChain leaf_chain_;
 };
 
 }  // namespace bustub
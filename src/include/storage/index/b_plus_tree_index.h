@@ -11,6 +11,7 @@
 
 #pragma once
 
+#include <functional>
 #include <map>
 #include <memory>
 #include <string>
@@ -35,6 +36,9 @@ class BPlusTreeIndex : public Index {
 
   void ScanKey(const Tuple &key, std::vector<RID> *result, Transaction *transaction) override;
 
+  // Fill the empty index from num_entries entries in strictly ascending key order, see BPlusTree::BulkLoad().
+  auto BulkLoad(size_t num_entries, const std::function<bool(KeyType *, ValueType *)> &next, int fill_factor) -> bool;
+
   auto GetBeginIterator() -> INDEXITERATOR_TYPE;
 
   auto GetBeginIterator(const KeyType &key) -> INDEXITERATOR_TYPE;
@@ -13,7 +13,9 @@
 #pragma once
 
 #include <cstring>
+#include <string>
 
+#include "common/macros.h"
 #include "storage/table/tuple.h"
 #include "type/value.h"
 
@@ -25,42 +27,52 @@ namespace bustub {
  * This key type uses an fixed length array to hold data for indexing
  * purposes, the actual size of which is specified and instantiated
  * with a template argument.
+ *
+ * The columns of the key are stored in an order-preserving (normalized) encoding, so that two keys compare like their
+ * bytes under memcmp, with no need to deserialize them:
+ * - integer types and timestamps big-endian, with the sign bit of signed types flipped. NULL stays the in-band
+ *   sentinel BusTub uses for the type (the minimum, or the maximum for timestamps).
+ * - decimals as the bits of the double, all of them flipped if it is negative and only the sign bit otherwise.
+ * - varchars as a NULL marker byte (0 for NULL, 1 otherwise), then the characters with every 0 byte escaped as
+ *   0 0xFF, then a 0 0 terminator, so that a string sorts before its extensions.
+ * Unused bytes are 0. A key that does not fit into KeySize is truncated: keys that only differ past KeySize are equal.
  */
 template <size_t KeySize>
 class GenericKey {
  public:
-  inline void SetFromKey(const Tuple &tuple) {
+  // build the key from a tuple of the key schema
+  inline void SetFromKey(const Tuple &tuple, const Schema *key_schema) {
     // intialize to 0
     memset(data_, 0, KeySize);
-    memcpy(data_, tuple.GetData(), tuple.GetLength());
+    size_t offset = 0;
+    for (uint32_t i = 0; i < key_schema->GetColumnCount(); i++) {
+      offset = EncodeValue(tuple.GetValue(key_schema, i), offset);
+    }
   }
 
   // NOTE: for test purpose only
+  // encode key as a single bigint column
   inline void SetFromInteger(int64_t key) {
     memset(data_, 0, KeySize);
-    memcpy(data_, &key, sizeof(int64_t));
+    EncodeUnsigned(static_cast<uint64_t>(key) ^ SIGN_BIT_64, sizeof(int64_t), 0);
   }
 
   inline auto ToValue(Schema *schema, uint32_t column_idx) const -> Value {
-    const char *data_ptr;
-    const auto &col = schema->GetColumn(column_idx);
-    const TypeId column_type = col.GetType();
-    const bool is_inlined = col.IsInlined();
-    if (is_inlined) {
-      data_ptr = (data_ + col.GetOffset());
-    } else {
-      int32_t offset = *reinterpret_cast<int32_t *>(const_cast<char *>(data_ + col.GetOffset()));
-      data_ptr = (data_ + offset);
+    size_t offset = 0;
+    for (uint32_t i = 0; i < column_idx; i++) {
+      offset = SkipValue(schema->GetColumn(i).GetType(), offset);
     }
-    return Value::DeserializeFrom(data_ptr, column_type);
+    return DecodeValue(schema->GetColumn(column_idx).GetType(), offset);
   }
 
   // NOTE: for test purpose only
-  // interpret the first 8 bytes as int64_t from data vector
-  inline auto ToString() const -> int64_t { return *reinterpret_cast<int64_t *>(const_cast<char *>(data_)); }
+  // interpret the first 8 bytes as a bigint column
+  inline auto ToString() const -> int64_t {
+    return static_cast<int64_t>(DecodeUnsigned(sizeof(int64_t), 0) ^ SIGN_BIT_64);
+  }
 
   // NOTE: for test purpose only
-  // interpret the first 8 bytes as int64_t from data vector
+  // interpret the first 8 bytes as a bigint column
   friend auto operator<<(std::ostream &os, const GenericKey &key) -> std::ostream & {
     os << key.ToString();
     return os;
@@ -68,39 +80,158 @@ class GenericKey {
 
   // actual location of data, extends past the end.
   char data_[KeySize];
+
+ private:
+  static constexpr uint64_t SIGN_BIT_64 = uint64_t{1} << 63;
+
+  // bytes past KeySize are dropped when writing and read as 0
+  inline void PutByte(size_t offset, uint8_t byte) {
+    if (offset < KeySize) {
+      data_[offset] = static_cast<char>(byte);
+    }
+  }
+
+  inline auto GetByte(size_t offset) const -> uint8_t {
+    return offset < KeySize ? static_cast<uint8_t>(data_[offset]) : 0;
+  }
+
+  // write the low width bytes of bits big-endian, @return the offset after them
+  inline auto EncodeUnsigned(uint64_t bits, size_t width, size_t offset) -> size_t {
+    for (size_t i = 0; i < width; i++) {
+      PutByte(offset + i, static_cast<uint8_t>(bits >> (8 * (width - 1 - i))));
+    }
+    return offset + width;
+  }
+
+  inline auto DecodeUnsigned(size_t width, size_t offset) const -> uint64_t {
+    uint64_t bits = 0;
+    for (size_t i = 0; i < width; i++) {
+      bits = (bits << 8) | GetByte(offset + i);
+    }
+    return bits;
+  }
+
+  // @return the offset after the encoded value
+  inline auto EncodeValue(const Value &value, size_t offset) -> size_t {
+    switch (value.GetTypeId()) {
+      case TypeId::BOOLEAN:
+      case TypeId::TINYINT:
+        return EncodeUnsigned(static_cast<uint8_t>(value.GetAs<int8_t>()) ^ 0x80U, 1, offset);
+      case TypeId::SMALLINT:
+        return EncodeUnsigned(static_cast<uint16_t>(value.GetAs<int16_t>()) ^ 0x8000U, 2, offset);
+      case TypeId::INTEGER:
+        return EncodeUnsigned(static_cast<uint32_t>(value.GetAs<int32_t>()) ^ 0x80000000U, 4, offset);
+      case TypeId::BIGINT:
+        return EncodeUnsigned(static_cast<uint64_t>(value.GetAs<int64_t>()) ^ SIGN_BIT_64, 8, offset);
+      case TypeId::TIMESTAMP:
+        return EncodeUnsigned(value.GetAs<uint64_t>(), 8, offset);
+      case TypeId::DECIMAL: {
+        auto decimal = value.GetAs<double>();
+        uint64_t bits;
+        memcpy(&bits, &decimal, sizeof(bits));
+        return EncodeUnsigned((bits & SIGN_BIT_64) != 0 ? ~bits : bits | SIGN_BIT_64, 8, offset);
+      }
+      case TypeId::VARCHAR: {
+        if (value.IsNull()) {
+          PutByte(offset, 0);
+          return offset + 1;
+        }
+        PutByte(offset++, 1);
+        const char *str = value.GetData();
+        // the length includes the terminating '\0'
+        for (uint32_t i = 0; i + 1 < value.GetLength(); i++) {
+          PutByte(offset++, static_cast<uint8_t>(str[i]));
+          if (str[i] == 0) {
+            PutByte(offset++, 0xFF);
+          }
+        }
+        PutByte(offset++, 0);
+        PutByte(offset++, 0);
+        return offset;
+      }
+      default:
+        UNREACHABLE("cannot index a value of this type");
+    }
+  }
+
+  // @return the offset after the encoded value of the given type
+  inline auto SkipValue(TypeId type, size_t offset) const -> size_t {
+    switch (type) {
+      case TypeId::BOOLEAN:
+      case TypeId::TINYINT:
+        return offset + 1;
+      case TypeId::SMALLINT:
+        return offset + 2;
+      case TypeId::INTEGER:
+        return offset + 4;
+      case TypeId::VARCHAR: {
+        if (GetByte(offset++) == 0) {
+          return offset;
+        }
+        while (offset < KeySize && (GetByte(offset) != 0 || GetByte(offset + 1) == 0xFF)) {
+          offset += GetByte(offset) == 0 ? 2 : 1;
+        }
+        return offset + 2;
+      }
+      default:
+        return offset + 8;
+    }
+  }
+
+  inline auto DecodeValue(TypeId type, size_t offset) const -> Value {
+    switch (type) {
+      case TypeId::BOOLEAN:
+      case TypeId::TINYINT:
+        return {type, static_cast<int8_t>(DecodeUnsigned(1, offset) ^ 0x80U)};
+      case TypeId::SMALLINT:
+        return {type, static_cast<int16_t>(DecodeUnsigned(2, offset) ^ 0x8000U)};
+      case TypeId::INTEGER:
+        return {type, static_cast<int32_t>(DecodeUnsigned(4, offset) ^ 0x80000000U)};
+      case TypeId::BIGINT:
+        return {type, static_cast<int64_t>(DecodeUnsigned(8, offset) ^ SIGN_BIT_64)};
+      case TypeId::TIMESTAMP:
+        return {type, DecodeUnsigned(8, offset)};
+      case TypeId::DECIMAL: {
+        auto bits = DecodeUnsigned(8, offset);
+        bits = (bits & SIGN_BIT_64) != 0 ? bits & ~SIGN_BIT_64 : ~bits;
+        double decimal;
+        memcpy(&decimal, &bits, sizeof(decimal));
+        return {type, decimal};
+      }
+      case TypeId::VARCHAR: {
+        if (GetByte(offset++) == 0) {
+          return {type, nullptr, 0, false};
+        }
+        std::string str;
+        while (offset < KeySize && (GetByte(offset) != 0 || GetByte(offset + 1) == 0xFF)) {
+          str.push_back(static_cast<char>(GetByte(offset)));
+          offset += GetByte(offset) == 0 ? 2 : 1;
+        }
+        return {type, str};
+      }
+      default:
+        UNREACHABLE("cannot index a value of this type");
+    }
+  }
 };
 
 /**
  * Function object returns true if lhs < rhs, used for trees
+ *
+ * Keys are normalized (see GenericKey), so they are compared bytewise; the key schema is only needed to build them.
  */
 template <size_t KeySize>
 class GenericComparator {
  public:
   inline auto operator()(const GenericKey<KeySize> &lhs, const GenericKey<KeySize> &rhs) const -> int {
-    uint32_t column_count = key_schema_->GetColumnCount();
-
-    for (uint32_t i = 0; i < column_count; i++) {
-      Value lhs_value = (lhs.ToValue(key_schema_, i));
-      Value rhs_value = (rhs.ToValue(key_schema_, i));
-
-      if (lhs_value.CompareLessThan(rhs_value) == CmpBool::CmpTrue) {
-        return -1;
-      }
-      if (lhs_value.CompareGreaterThan(rhs_value) == CmpBool::CmpTrue) {
-        return 1;
-      }
-    }
-    // equals
-    return 0;
+    auto cmp = memcmp(lhs.data_, rhs.data_, KeySize);
+    return cmp < 0 ? -1 : (cmp > 0 ? 1 : 0);
   }
 
-  GenericComparator(const GenericComparator &other) : key_schema_{other.key_schema_} {}
+  GenericComparator(const GenericComparator &other) = default;
 
   // constructor
-  explicit GenericComparator(Schema *key_schema) : key_schema_(key_schema) {}
-
- private:
-  Schema *key_schema_;
+  explicit GenericComparator(Schema * /* key_schema */) {}
 };
 
 }  // namespace bustub
@@ -0,0 +1,89 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// index_entry_sorter.h
+//
+// Identification: src/include/storage/index/index_entry_sorter.h
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <cstdio>
+#include <utility>
+#include <vector>
+
+#include "storage/page/b_plus_tree_page.h"
+
+namespace bustub {
+
+#define INDEX_ENTRY_SORTER_TYPE IndexEntrySorter<KeyType, ValueType, KeyComparator>
+
+/**
+ * Sorts the key/value entries of an index build by key, e.g. to bulk load a B+ tree.
+ *
+ * Entries are buffered until they reach the memory budget. A full buffer is sorted and spilled to a temporary file as
+ * a run; once all entries are added, the runs are merged while the entries are read back. Only a block of every run is
+ * held in memory during the merge.
+ *
+ * Keys are unique: of the entries with equal keys only the one added first is returned, the same one that survives
+ * inserting the entries into the index one by one in the order they were added.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+class IndexEntrySorter {
+ public:
+  /**
+   * @param comparator the key comparator
+   * @param memory_budget bytes of entries to sort in memory before spilling a run
+   */
+  IndexEntrySorter(const KeyComparator &comparator, size_t memory_budget);
+
+  ~IndexEntrySorter();
+
+  void Add(const KeyType &key, const ValueType &value);
+
+  // Sort what is left in memory and count the distinct keys. No entries can be added afterwards.
+  void Finish();
+
+  // @return the next entry in key order, false once all are returned
+  auto Next(KeyType *key, ValueType *value) -> bool;
+
+  // @return the number of entries Next() returns, valid after Finish()
+  auto GetNumEntries() const -> size_t { return num_entries_; }
+
+  // @return the number of runs spilled to temporary files
+  auto GetNumRuns() const -> size_t { return runs_.size(); }
+
+ private:
+  struct Run {
+    std::FILE *file_;
+    size_t size_;
+    size_t remaining_;
+    std::vector<MappingType> block_;
+    size_t pos_;
+  };
+
+  void SortBuffer();
+  void SpillRun();
+  void Refill(Run *run);
+  void StartMerge();
+  auto MergeNext(KeyType *key, ValueType *value) -> bool;
+  // heap order of the runs: by their current entry, then by run number so that equal keys come in insertion order
+  auto RunGreater(size_t left, size_t right) const -> bool;
+
+  KeyComparator comparator_;
+  size_t buffer_capacity_;
+  std::vector<MappingType> buffer_;
+  size_t buffer_pos_{0};
+  std::vector<Run> runs_;
+  std::vector<size_t> heap_;
+  bool has_last_key_{false};
+  KeyType last_key_;
+  bool finished_{false};
+  size_t num_entries_{0};
+};
+
+}  // namespace bustub
@@ -13,6 +13,7 @@
  * For range scan of b+ tree
  */
 #pragma once
+#include "storage/index/leaf_chain.h"
 #include "storage/page/b_plus_tree_leaf_page.h"
 
 namespace bustub {
@@ -27,7 +28,7 @@ class IndexIterator {
   // you may define your own constructor based on your member variables
   IndexIterator();
   IndexIterator(BufferPoolManager *buffer_pool_manager, LeafPage *current_leaf_page, int current_index = 0,
-                bool is_end = false);
+                bool is_end = false, LeafChain *leaf_chain = nullptr);
   ~IndexIterator();  // NOLINT
 
   auto IsEnd() -> bool;
@@ -41,11 +42,22 @@ class IndexIterator {
   auto operator!=(const IndexIterator &itr) const -> bool;
 
  private:
+  /**
+   * Ask the buffer pool to prefetch up to scan_prefetch_window leaves that follow the current one, so that they are
+   * read while the current one is scanned. The sibling link of the current leaf is recorded in the tree's leaf chain
+   * first; the leaves further ahead are only known once some scan has passed them, like the page chain of a table
+   * heap. Without a leaf chain only the next leaf is prefetched.
+   */
+  void PrefetchLeaves();
+
   // add your own private member variables here
   BufferPoolManager *buffer_pool_manager_;
   LeafPage *current_leaf_page_;
   int current_index_;
   bool is_end_;
+  LeafChain *leaf_chain_{nullptr};
+  // the leaf stores keys and values apart, so the entry operator* refers to is put together here
+  MappingType current_entry_;
 };
 
 }  // namespace bustub
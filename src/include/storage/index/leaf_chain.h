@@ -0,0 +1,59 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// leaf_chain.h
+//
+// Identification: src/include/storage/index/leaf_chain.h
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <mutex>  // NOLINT
+#include <unordered_map>
+
+#include "buffer/buffer_pool_manager.h"
+#include "common/config.h"
+
+namespace bustub {
+
+/**
+ * LeafChain remembers the sibling links of the B+ tree leaves that have been seen so far, so that a scan can prefetch
+ * more than one leaf ahead without reading the leaves in between. It plays the role the known page chain plays for a
+ * table heap. The links are only prefetch hints: the tree keeps them up to date on splits and merges, and a stale link
+ * costs at most a wasted read.
+ */
+class LeafChain {
+ public:
+  /**
+   * Record that next_page_id follows leaf_page_id in the leaf chain.
+   * @param leaf_page_id the id of a leaf page
+   * @param next_page_id the id of its right sibling, or INVALID_PAGE_ID if it is the last leaf
+   */
+  void Link(page_id_t leaf_page_id, page_id_t next_page_id);
+
+  /**
+   * Forget the link out of a leaf that is no longer part of the tree.
+   * @param leaf_page_id the id of the removed leaf page
+   */
+  void Unlink(page_id_t leaf_page_id);
+
+  /**
+   * Prefetch up to window known leaves that follow leaf_page_id. Stops early at the end of the known chain.
+   * @param buffer_pool_manager the buffer pool to prefetch into
+   * @param leaf_page_id the id of the leaf being scanned
+   * @param window the number of following leaves to prefetch
+   */
+  void PrefetchAfter(BufferPoolManager *buffer_pool_manager, page_id_t leaf_page_id, size_t window);
+
+ private:
+  /** Protects next_leaf_. */
+  std::mutex latch_;
+  /** The right sibling of every known leaf. */
+  std::unordered_map<page_id_t, page_id_t> next_leaf_;
+};
+
+}  // namespace bustub
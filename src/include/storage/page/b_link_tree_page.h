@@ -0,0 +1,94 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// b_link_tree_page.h
+//
+// Identification: src/include/storage/page/b_link_tree_page.h
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+#pragma once
+
+#include <utility>
+
+#include "storage/page/b_plus_tree_page.h"
+
+namespace bustub {
+
+#define B_LINK_TREE_PAGE_TYPE BLinkTreePage<KeyType, ValueType, KeyComparator>
+#define B_LINK_TREE_PAGE_HEADER_SIZE (24 + 12 + sizeof(KeyType))
+#define B_LINK_TREE_PAGE_SIZE static_cast<int>((BUSTUB_PAGE_SIZE - B_LINK_TREE_PAGE_HEADER_SIZE) / sizeof(MappingType))
+
+/**
+ * A node of a Lehman-Yao B-link tree, see BLinkTree. The same layout serves leaves (ValueType is RID) and internal
+ * nodes (ValueType is page_id_t).
+ *
+ * Every node covers a key range [low, high): it has a link to its right sibling on the same level and a high key, the
+ * smallest key that belongs to the right sibling. The rightmost node of a level has no high key. A search that reaches
+ * a node whose high key is not greater than the search key, because the node split after its parent was read, follows
+ * the right link.
+ *
+ * Entries are sorted by key. In a leaf they are the key/RID pairs. In an internal node, entry i points to the child
+ * covering [KEY(i), KEY(i+1)); KEY(0) is not used for routing.
+ *
+ * Page format:
+ *  --------------------------------------------------------------------------------------------
+ * | HEADER | KEY(0) + VALUE(0) | KEY(1) + VALUE(1) | ... | KEY(n-1) + VALUE(n-1)
+ *  --------------------------------------------------------------------------------------------
+ *
+ *  Header format (size in byte, 36 bytes plus the size of a key in total):
+ *  ---------------------------------------------------------------------
+ * | PageType (4) | LSN (4) | CurrentSize (4) | MaxSize (4) | ParentPageId (4) | PageId (4) |
+ *  ---------------------------------------------------------------------
+ *  ---------------------------------------------------------------------
+ * | RightPageId (4) | Level (4) | HasHighKey (4) | HighKey (sizeof(KeyType)) |
+ *  ---------------------------------------------------------------------
+ * ParentPageId is always INVALID_PAGE_ID: a B-link tree finds parents through the path of the descent.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+class BLinkTreePage : public BPlusTreePage {
+ public:
+  // After creating a new page from buffer pool, must call initialize method to set default values. Level 0 is a leaf.
+  void Init(page_id_t page_id, int level, int max_size = B_LINK_TREE_PAGE_SIZE);
+
+  auto GetRightPageId() const -> page_id_t { return right_page_id_; }
+  void SetRightPageId(page_id_t right_page_id) { right_page_id_ = right_page_id; }
+  auto GetLevel() const -> int { return level_; }
+  auto HasHighKey() const -> bool { return has_high_key_ != 0; }
+  auto GetHighKey() const -> const KeyType & { return high_key_; }
+
+  // @return true if key belongs to a node to the right, i.e. key >= the high key
+  auto IsBeyond(const KeyType &key, const KeyComparator &comparator) const -> bool;
+
+  auto KeyAt(int index) const -> KeyType { return array_[index].first; }
+  auto ValueAt(int index) const -> ValueType { return array_[index].second; }
+  auto IsFull() const -> bool { return GetSize() >= GetMaxSize(); }
+
+  // @return the index of the first entry from first on whose key is not less than key, GetSize() if there is none
+  auto LowerBound(const KeyType &key, const KeyComparator &comparator, int first = 0) const -> int;
+
+  // @return the child of an internal node that covers key
+  auto LookupChild(const KeyType &key, const KeyComparator &comparator) const -> ValueType;
+
+  void InsertAt(int index, const KeyType &key, const ValueType &value);
+  void RemoveAt(int index);
+
+  /**
+   * Move the upper half of the entries into an empty node of the same level and link it in as the right sibling: it
+   * takes over the right link and the high key, and this node's high key becomes its first key.
+   * @return the separator, the first key of the recipient
+   */
+  auto MoveHalfTo(B_LINK_TREE_PAGE_TYPE *recipient) -> KeyType;
+
+ private:
+  page_id_t right_page_id_;
+  int level_;
+  int has_high_key_;
+  KeyType high_key_;
+  // Flexible array member for page data.
+  MappingType array_[1];
+};
+
+}  // namespace bustub
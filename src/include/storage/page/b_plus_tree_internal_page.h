@@ -10,9 +10,11 @@
 //===----------------------------------------------------------------------===//
 #pragma once
 
+#include <algorithm>
 #include <queue>
 #include <vector>
 
+#include "storage/page/b_plus_tree_key_search.h"
 #include "storage/page/b_plus_tree_page.h"
 
 namespace bustub {
@@ -28,9 +30,11 @@ namespace bustub {
  * the first key always remains invalid. That is to say, any search/lookup
  * should ignore the first key.
  *
- * Internal page format (keys are stored in increasing order):
+ * Internal page format (keys are stored in increasing order, apart from the
+ * page ids so that a search only touches the keys, see KeySearch;
+ * m = INTERNAL_PAGE_SIZE):
  *  --------------------------------------------------------------------------
- * | HEADER | KEY(1)+PAGE_ID(1) | KEY(2)+PAGE_ID(2) | ... | KEY(n)+PAGE_ID(n) |
+ * | HEADER | KEY(1) | ... | KEY(n) | ... | KEY(m) | PAGE_ID(1) | ... | PAGE_ID(n) | ...
  *  --------------------------------------------------------------------------
  */
 INDEX_TEMPLATE_ARGUMENTS
@@ -48,13 +52,19 @@ class BPlusTreeInternalPage : public BPlusTreePage {
                    const KeyComparator &comparator) -> bool;
   auto CopyDataFrom(std::vector<MappingType> &data_copy, int first, int last) -> void;
   auto RemoveEntry(const KeyType &key, const KeyComparator &comparator) -> void;
-  auto KeyIndex(const KeyType &key, const KeyComparator &comparator) -> int;
+  auto KeyIndex(const KeyType &key, const KeyComparator &comparator) const -> int;
   auto MoveFirstToEnd(B_PLUS_TREE_INTERNAL_PAGE_TYPE *b_plus_leaf_page, const KeyType &key) -> void;
   auto MoveLastToFront(B_PLUS_TREE_INTERNAL_PAGE_TYPE *b_plus_leaf_page, const KeyType &key) -> void;
   auto MoveTo(B_PLUS_TREE_INTERNAL_PAGE_TYPE *left, const KeyType &key) -> void;
 
  private:
-  // Flexible array member for page data.
-  MappingType array_[1];
+  // lower bound over the valid keys, KEY(2) to KEY(n)
+  auto LowerBound(const KeyType &key, const KeyComparator &comparator) const -> int {
+    return KeySearch<KeyType, KeyComparator>::LowerBound(keys_ + 1, std::max(GetSize() - 1, 0), key, comparator) + 1;
+  }
+
+  // The keys and the child page ids, each array as long as a page has room for entries.
+  KeyType keys_[INTERNAL_PAGE_SIZE];
+  ValueType values_[INTERNAL_PAGE_SIZE];
 };
 }  // namespace bustub
@@ -0,0 +1,67 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// b_plus_tree_key_search.h
+//
+// Identification: src/include/storage/page/b_plus_tree_key_search.h
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <algorithm>
+
+#include "storage/index/generic_key.h"
+
+namespace bustub {
+
+/** Instruction sets the search over integer keys can use. */
+enum class KeySearchIsa { SCALAR = 0, SSE42, AVX2 };
+
+// @return the instruction set the search over integer keys uses, the best one the CPU supports unless set otherwise
+auto GetKeySearchIsa() -> KeySearchIsa;
+
+// Use another instruction set for the search over integer keys, for tests and benchmarks. One the CPU does not
+// support falls back to the best one it does.
+void SetKeySearchIsa(KeySearchIsa isa);
+
+// Lower bound over sorted normalized keys of 4 and 8 bytes, see GenericKey.
+auto LowerBoundNormalized32(const char *keys, int size, const char *key) -> int;
+auto LowerBoundNormalized64(const char *keys, int size, const char *key) -> int;
+
+/**
+ * Lower bound over the sorted keys of a B+ tree node: the index of the first of keys[0, size) that is not less than
+ * key, or size if there is none.
+ *
+ * This is a binary search with the comparator. The nodes store their keys apart from their values, so the keys are
+ * contiguous; GenericKey<4> and GenericKey<8> hold normalized keys, which order like big-endian unsigned integers,
+ * and are specialized below to search them as integers, with AVX2 or SSE4.2 once few keys are left.
+ */
+template <typename KeyType, typename KeyComparator>
+struct KeySearch {
+  static auto LowerBound(const KeyType *keys, int size, const KeyType &key, const KeyComparator &comparator) -> int {
+    auto less = [&comparator](const KeyType &lhs, const KeyType &rhs) { return comparator(lhs, rhs) < 0; };
+    return static_cast<int>(std::lower_bound(keys, keys + size, key, less) - keys);
+  }
+};
+
+template <>
+struct KeySearch<GenericKey<4>, GenericComparator<4>> {
+  static auto LowerBound(const GenericKey<4> *keys, int size, const GenericKey<4> &key,
+                         const GenericComparator<4> & /* comparator */) -> int {
+    return LowerBoundNormalized32(reinterpret_cast<const char *>(keys), size, key.data_);
+  }
+};
+
+template <>
+struct KeySearch<GenericKey<8>, GenericComparator<8>> {
+  static auto LowerBound(const GenericKey<8> *keys, int size, const GenericKey<8> &key,
+                         const GenericComparator<8> & /* comparator */) -> int {
+    return LowerBoundNormalized64(reinterpret_cast<const char *>(keys), size, key.data_);
+  }
+};
+
+}  // namespace bustub
@@ -14,6 +14,7 @@
 #include <utility>
 #include <vector>
 
+#include "storage/page/b_plus_tree_key_search.h"
 #include "storage/page/b_plus_tree_page.h"
 
 namespace bustub {
@@ -27,9 +28,10 @@ namespace bustub {
  * see include/common/rid.h for detailed implementation) together within leaf
  * page. Only support unique key.
  *
- * Leaf page format (keys are stored in order):
+ * Leaf page format (keys are stored in order, apart from the rids so that a
+ * search only touches the keys, see KeySearch; m = LEAF_PAGE_SIZE):
  *  ----------------------------------------------------------------------
- * | HEADER | KEY(1) + RID(1) | KEY(2) + RID(2) | ... | KEY(n) + RID(n)
+ * | HEADER | KEY(1) | ... | KEY(n) | ... | KEY(m) | RID(1) | ... | RID(n) | ...
  *  ----------------------------------------------------------------------
  *
  *  Header format (size in byte, 28 bytes in total):
@@ -57,15 +59,20 @@ class BPlusTreeLeafPage : public BPlusTreePage {
   auto Insert(const KeyType &key, const ValueType &value, const KeyComparator &comparator) -> bool;
   auto GetDataCopy(std::vector<MappingType> &data_copy, const KeyComparator &comparator) -> bool;
   auto CopyDataFrom(std::vector<MappingType> &data_copy, int first, int last) -> void;
-  auto GetKV(int index) -> const MappingType &;
+  auto GetKV(int index) const -> MappingType;
   auto RemoveEntry(const KeyType &key, const KeyComparator &comparator) -> void;
   auto MoveFirstToEnd(B_PLUS_TREE_LEAF_PAGE_TYPE *b_plus_leaf_page, const KeyType &key) -> void;
   auto MoveLastToFront(B_PLUS_TREE_LEAF_PAGE_TYPE *b_plus_leaf_page, const KeyType &key) -> void;
   auto MoveTo(B_PLUS_TREE_LEAF_PAGE_TYPE *left, const KeyType &key) -> void;
 
  private:
+  auto LowerBound(const KeyType &key, const KeyComparator &comparator) const -> int {
+    return KeySearch<KeyType, KeyComparator>::LowerBound(keys_, GetSize(), key, comparator);
+  }
+
   page_id_t next_page_id_;
-  // Flexible array member for page data.
-  MappingType array_[1];
+  // The keys and the values of the entries, each array as long as a page has room for entries.
+  KeyType keys_[LEAF_PAGE_SIZE];
+  ValueType values_[LEAF_PAGE_SIZE];
 };
 }  // namespace bustub
@@ -12,6 +12,10 @@
 
 #pragma once
 
+#include <mutex>  // NOLINT
+#include <unordered_map>
+#include <vector>
+
 #include "buffer/buffer_pool_manager.h"
 #include "recovery/log_manager.h"
 #include "storage/page/table_page.h"
@@ -55,9 +59,11 @@ class TableHeap {
    * @param tuple tuple to insert
    * @param[out] rid the rid of the inserted tuple
    * @param txn the transaction performing the insert
+   * @param strategy the buffer access strategy of a bulk insert, or nullptr. A bulk insert does not look for free space
+   * before the last known page of the table.
    * @return true iff the insert is successful
    */
-  auto InsertTuple(const Tuple &tuple, RID *rid, Transaction *txn) -> bool;
+  auto InsertTuple(const Tuple &tuple, RID *rid, Transaction *txn, BufferAccessStrategy *strategy = nullptr) -> bool;
 
   /**
    * Mark the tuple as deleted. The actual delete will occur when ApplyDelete is called.
@@ -95,12 +101,18 @@ class TableHeap {
    * @param rid rid of the tuple to read
    * @param tuple output variable for the tuple
    * @param txn transaction performing the read
+   * @param strategy the buffer access strategy of the reader, or nullptr
    * @return true if the read was successful (i.e. the tuple exists)
    */
-  auto GetTuple(const RID &rid, Tuple *tuple, Transaction *txn, bool acquire_read_lock = true) -> bool;
+  auto GetTuple(const RID &rid, Tuple *tuple, Transaction *txn, bool acquire_read_lock = true,
+                BufferAccessStrategy *strategy = nullptr) -> bool;
 
-  /** @return the begin iterator of this table */
-  auto Begin(Transaction *txn) -> TableIterator;
+  /**
+   * @param txn the transaction performing the scan
+   * @param strategy the buffer access strategy of the scan, or nullptr; it must outlive the iterator
+   * @return the begin iterator of this table
+   */
+  auto Begin(Transaction *txn, BufferAccessStrategy *strategy = nullptr) -> TableIterator;
 
   /** @return the end iterator of this table */
   auto End() -> TableIterator;
@@ -108,11 +120,42 @@ class TableHeap {
   /** @return the id of the first page of this table */
   inline auto GetFirstPageId() const -> page_id_t { return first_page_id_; }
 
+  /** @return the number of pages of this table known so far, a lower bound on its size */
+  auto GetKnownPageCount() -> size_t;
+
  private:
+  /**
+   * Record that next_page_id follows page_id in the page chain. Only extends the known prefix of the chain, i.e. it is
+   * a no-op unless page_id is the last known page.
+   */
+  void AppendPageId(page_id_t page_id, page_id_t next_page_id);
+
+  /**
+   * Ask the buffer pool to prefetch the pages that follow page_id in the page chain.
+   * @param page_id the page a scan just moved to
+   * @param window the number of following pages to prefetch
+   * @param access_type the access pattern of the scan
+   */
+  void PrefetchAfter(page_id_t page_id, size_t window, BufferAccessType access_type);
+
+  /**
+   * Fetch a page of this table, under a buffer access strategy if one is given.
+   * @param page_id id of the page to fetch
+   * @param strategy the buffer access strategy of the caller, or nullptr
+   */
+  auto FetchTablePage(page_id_t page_id, BufferAccessStrategy *strategy) -> TablePage *;
+
   BufferPoolManager *buffer_pool_manager_;
   LockManager *lock_manager_;
   LogManager *log_manager_;
   page_id_t first_page_id_{};
+
+  /** Protects page_ids_ and page_index_. */
+  std::mutex page_ids_latch_;
+  /** The known prefix of the page chain, starting with first_page_id_, in scan order. */
+  std::vector<page_id_t> page_ids_;
+  /** Position of every page in page_ids_. */
+  std::unordered_map<page_id_t, size_t> page_index_;
 };
 
 }  // namespace bustub
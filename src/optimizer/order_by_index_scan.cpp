@@ -62,7 +62,8 @@ auto Optimizer::OptimizeOrderByAsIndexScan(const AbstractPlanNodeRef &plan) -> A
 
       for (const auto *index : indices) {
         const auto &columns = index->key_schema_.GetColumns();
-        if (columns.size() == 1 &&
+        // only a B+ tree can be scanned in key order
+        if (index->index_type_ == IndexType::BPlusTreeIndex && columns.size() == 1 &&
             columns[0].GetName() == table_info->schema_.GetColumn(order_by_column_id).GetName()) {
           // Index matched, return index scan instead
           return std::make_shared<IndexScanPlanNode>(optimized_plan->output_schema_, index->index_oid_);
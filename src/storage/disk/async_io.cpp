@@ -0,0 +1,475 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// async_io.cpp
+//
+// Identification: src/storage/disk/async_io.cpp
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "storage/disk/async_io.h"
+
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <condition_variable>  // NOLINT
+#include <cstring>
+#include <deque>
+#include <mutex>   // NOLINT
+#include <thread>  // NOLINT
+#include <utility>
+
+#include "common/macros.h"
+
+namespace bustub {
+
+auto AsyncIoBackendToString(AsyncIoBackend backend) -> std::string {
+  switch (backend) {
+    case AsyncIoBackend::AUTO:
+      return "auto";
+    case AsyncIoBackend::IO_URING:
+      return "io_uring";
+    case AsyncIoBackend::THREAD_POOL:
+      return "thread pool";
+  }
+  UNREACHABLE("unknown async I/O backend");
+}
+
+namespace {
+
+/**
+ * Skip the first transferred bytes of the buffers iov[*first, iov.size()): the buffers that were transferred completely
+ * and the transferred head of the next one.
+ */
+void AdvanceIov(std::vector<iovec> *iov, size_t *first, size_t transferred) {
+  while (*first < iov->size() && transferred >= (*iov)[*first].iov_len) {
+    transferred -= (*iov)[*first].iov_len;
+    (*first)++;
+  }
+  if (*first < iov->size()) {
+    (*iov)[*first].iov_base = static_cast<char *>((*iov)[*first].iov_base) + transferred;
+    (*iov)[*first].iov_len -= transferred;
+  }
+}
+
+/** Run a vectored request with blocking system calls, retrying short transfers. */
+auto RunBlockingVectored(AsyncIoRequest *request) -> int64_t {
+  size_t done = 0;
+  size_t first = 0;
+  auto &iov = request->iov_;
+  while (first < iov.size()) {
+    ssize_t rc = request->is_write_
+                     ? pwritev(request->fd_, &iov[first], static_cast<int>(iov.size() - first), request->offset_ + done)
+                     : preadv(request->fd_, &iov[first], static_cast<int>(iov.size() - first), request->offset_ + done);
+    if (rc < 0 && errno == EINTR) {
+      continue;
+    }
+    if (rc < 0) {
+      return -errno;
+    }
+    if (rc == 0) {
+      break;
+    }
+    done += rc;
+    AdvanceIov(&iov, &first, static_cast<size_t>(rc));
+  }
+  return static_cast<int64_t>(done);
+}
+
+/** Run a request with blocking system calls, retrying short transfers. */
+auto RunBlocking(AsyncIoRequest *request) -> int64_t {
+  if (!request->iov_.empty()) {
+    return RunBlockingVectored(request);
+  }
+  const auto &single = *request;
+  size_t done = 0;
+  while (done < single.length_) {
+    ssize_t rc = single.is_write_
+                     ? pwrite(single.fd_, single.buffer_ + done, single.length_ - done, single.offset_ + done)
+                     : pread(single.fd_, single.buffer_ + done, single.length_ - done, single.offset_ + done);
+    if (rc < 0 && errno == EINTR) {
+      continue;
+    }
+    if (rc < 0) {
+      return -errno;
+    }
+    if (rc == 0) {
+      break;
+    }
+    done += rc;
+  }
+  return static_cast<int64_t>(done);
+}
+
+/** Blocking I/O on a few worker threads, for kernels or sandboxes without io_uring. */
+class ThreadPoolAsyncIo : public AsyncIo {
+ public:
+  explicit ThreadPoolAsyncIo(size_t num_threads) {
+    for (size_t i = 0; i < num_threads; ++i) {
+      workers_.emplace_back(&ThreadPoolAsyncIo::Run, this);
+    }
+  }
+
+  ~ThreadPoolAsyncIo() override {
+    {
+      std::scoped_lock<std::mutex> lock(latch_);
+      stop_ = true;
+    }
+    cv_.notify_all();
+    for (auto &worker : workers_) {
+      worker.join();
+    }
+  }
+
+  void Submit(std::vector<AsyncIoRequest> requests) override {
+    {
+      std::scoped_lock<std::mutex> lock(latch_);
+      for (auto &request : requests) {
+        queue_.push_back(std::move(request));
+      }
+    }
+    cv_.notify_all();
+  }
+
+  auto GetBackend() const -> AsyncIoBackend override { return AsyncIoBackend::THREAD_POOL; }
+
+ private:
+  void Run() {
+    std::unique_lock<std::mutex> lock(latch_);
+    while (true) {
+      cv_.wait(lock, [this] { return stop_ || !queue_.empty(); });
+      // drain the queue before stopping, every request gets its callback
+      if (queue_.empty()) {
+        return;
+      }
+      auto request = std::move(queue_.front());
+      queue_.pop_front();
+      lock.unlock();
+      request.callback_(RunBlocking(&request));
+      lock.lock();
+    }
+  }
+
+  std::mutex latch_;
+  std::condition_variable cv_;
+  std::deque<AsyncIoRequest> queue_;
+  bool stop_{false};
+  std::vector<std::thread> workers_;
+};
+
+/**
+ * io_uring driven through the raw system calls. Submit() fills submission queue entries and hands a whole batch to
+ * the kernel with one io_uring_enter(); a completion thread reaps the completion queue and runs the callbacks. The
+ * number of requests in flight is capped by the size of the completion queue, so that it can never overflow. A write
+ * that completes short is resubmitted for the rest by the completion thread before its callback runs.
+ */
+class IoUringAsyncIo : public AsyncIo {
+ public:
+  /** @return a ring with room for queue_depth submissions, or nullptr if io_uring is not available */
+  static auto Create(size_t queue_depth) -> std::unique_ptr<IoUringAsyncIo> {
+    io_uring_params params;
+    memset(&params, 0, sizeof(params));
+    int ring_fd = static_cast<int>(syscall(__NR_io_uring_setup, static_cast<unsigned>(queue_depth), &params));
+    if (ring_fd < 0) {
+      return nullptr;
+    }
+    auto ring = std::unique_ptr<IoUringAsyncIo>(new IoUringAsyncIo(ring_fd));
+    if (!ring->SupportsOpcodes() || !ring->Map(params)) {
+      return nullptr;
+    }
+    ring->completion_thread_ = std::thread(&IoUringAsyncIo::RunCompletions, ring.get());
+    return ring;
+  }
+
+  ~IoUringAsyncIo() override {
+    if (completion_thread_.joinable()) {
+      std::unique_lock<std::mutex> lock(submit_latch_);
+      space_cv_.wait(lock, [this] { return in_flight_ == 0; });
+      // a no-op with user data 0 tells the completion thread to stop
+      PushEntry(IORING_OP_NOP, -1, nullptr, 0, 0, 0);
+      in_flight_++;
+      Enter();
+      lock.unlock();
+      completion_thread_.join();
+    }
+    if (sqes_ != nullptr) {
+      munmap(sqes_, sqes_size_);
+    }
+    if (cq_ring_ != nullptr && cq_ring_ != sq_ring_) {
+      munmap(cq_ring_, cq_ring_size_);
+    }
+    if (sq_ring_ != nullptr) {
+      munmap(sq_ring_, sq_ring_size_);
+    }
+    close(ring_fd_);
+  }
+
+  void Submit(std::vector<AsyncIoRequest> requests) override {
+    std::unique_lock<std::mutex> lock(submit_latch_);
+    for (auto &request : requests) {
+      if (in_flight_ == max_in_flight_) {
+        // hand over what is queued so far, then wait for completions to make room
+        Enter();
+        space_cv_.wait(lock, [this] { return in_flight_ < max_in_flight_; });
+      }
+      PushRequest(new InFlightRequest{std::move(request)});
+      in_flight_++;
+      if (pending_ == sq_entries_) {
+        Enter();
+      }
+    }
+    Enter();
+  }
+
+  auto GetBackend() const -> AsyncIoBackend override { return AsyncIoBackend::IO_URING; }
+
+ private:
+  /** A submitted request and how much of it was transferred by earlier submissions. */
+  struct InFlightRequest {
+    AsyncIoRequest request_;
+    int64_t done_{0};
+    /** The first buffer of request_.iov_ that is not transferred completely yet. */
+    size_t first_iov_{0};
+  };
+
+  /** The opcodes Submit() and the destructor use. */
+  static constexpr uint8_t USED_OPCODES[] = {IORING_OP_NOP, IORING_OP_READV, IORING_OP_WRITEV, IORING_OP_READ,
+                                             IORING_OP_WRITE};
+
+  explicit IoUringAsyncIo(int ring_fd) : ring_fd_(ring_fd) {}
+
+  /**
+   * Ask the kernel which opcodes it supports. io_uring_setup() succeeds on kernels from before IORING_OP_READ and
+   * IORING_OP_WRITE; those reject the requests only once they are submitted.
+   */
+  auto SupportsOpcodes() const -> bool {
+    constexpr unsigned max_ops = 256;
+    std::vector<char> buffer(sizeof(io_uring_probe) + max_ops * sizeof(io_uring_probe_op), 0);
+    auto *probe = reinterpret_cast<io_uring_probe *>(buffer.data());
+    // kernels without the probe fail with EINVAL, and predate IORING_OP_READ as well
+    if (syscall(__NR_io_uring_register, ring_fd_, IORING_REGISTER_PROBE, probe, max_ops) < 0) {
+      return false;
+    }
+    return std::all_of(std::begin(USED_OPCODES), std::end(USED_OPCODES), [probe](uint8_t opcode) {
+      return opcode <= probe->last_op && opcode < probe->ops_len &&
+             (probe->ops[opcode].flags & IO_URING_OP_SUPPORTED) != 0;
+    });
+  }
+
+  /** Map the submission queue, the completion queue and the submission entries. */
+  auto Map(const io_uring_params &params) -> bool {
+    sq_ring_size_ = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+    cq_ring_size_ = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+    const bool single_mmap = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+    if (single_mmap) {
+      sq_ring_size_ = cq_ring_size_ = std::max(sq_ring_size_, cq_ring_size_);
+    }
+    void *sq_ring = mmap(nullptr, sq_ring_size_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring_fd_,
+                         IORING_OFF_SQ_RING);
+    if (sq_ring == MAP_FAILED) {
+      return false;
+    }
+    sq_ring_ = static_cast<char *>(sq_ring);
+    if (single_mmap) {
+      cq_ring_ = sq_ring_;
+    } else {
+      void *cq_ring = mmap(nullptr, cq_ring_size_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring_fd_,
+                           IORING_OFF_CQ_RING);
+      if (cq_ring == MAP_FAILED) {
+        return false;
+      }
+      cq_ring_ = static_cast<char *>(cq_ring);
+    }
+    sqes_size_ = params.sq_entries * sizeof(io_uring_sqe);
+    void *sqes =
+        mmap(nullptr, sqes_size_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring_fd_, IORING_OFF_SQES);
+    if (sqes == MAP_FAILED) {
+      return false;
+    }
+    sqes_ = static_cast<io_uring_sqe *>(sqes);
+
+    sq_tail_ = reinterpret_cast<unsigned *>(sq_ring_ + params.sq_off.tail);
+    sq_mask_ = *reinterpret_cast<unsigned *>(sq_ring_ + params.sq_off.ring_mask);
+    sq_array_ = reinterpret_cast<unsigned *>(sq_ring_ + params.sq_off.array);
+    sq_entries_ = params.sq_entries;
+    cq_head_ = reinterpret_cast<unsigned *>(cq_ring_ + params.cq_off.head);
+    cq_tail_ = reinterpret_cast<unsigned *>(cq_ring_ + params.cq_off.tail);
+    cq_mask_ = *reinterpret_cast<unsigned *>(cq_ring_ + params.cq_off.ring_mask);
+    cqes_ = reinterpret_cast<io_uring_cqe *>(cq_ring_ + params.cq_off.cqes);
+    max_in_flight_ = params.cq_entries;
+    return true;
+  }
+
+  /** Fill the next submission queue entry. Needs submit_latch_; the kernel only sees it after Enter(). */
+  void PushEntry(uint8_t opcode, int fd, char *buffer, uint32_t length, off_t offset, uint64_t user_data) {
+    const unsigned tail = *sq_tail_ + pending_;
+    const unsigned index = tail & sq_mask_;
+    auto &sqe = sqes_[index];
+    memset(&sqe, 0, sizeof(sqe));
+    sqe.opcode = opcode;
+    sqe.fd = fd;
+    sqe.addr = reinterpret_cast<uint64_t>(buffer);
+    sqe.len = length;
+    sqe.off = static_cast<uint64_t>(offset);
+    sqe.user_data = user_data;
+    sq_array_[index] = index;
+    pending_++;
+  }
+
+  /** Fill a submission queue entry for what is left of a request. Needs submit_latch_. */
+  void PushRequest(InFlightRequest *owned) {
+    auto &request = owned->request_;
+    const auto user_data = reinterpret_cast<uint64_t>(owned);
+    const off_t offset = request.offset_ + owned->done_;
+    if (request.iov_.empty()) {
+      PushEntry(request.is_write_ ? IORING_OP_WRITE : IORING_OP_READ, request.fd_, request.buffer_ + owned->done_,
+                static_cast<uint32_t>(request.length_ - owned->done_), offset, user_data);
+    } else {
+      // the iovec array lives in the owned request, so it stays valid until the completion
+      PushEntry(request.is_write_ ? IORING_OP_WRITEV : IORING_OP_READV, request.fd_,
+                reinterpret_cast<char *>(&request.iov_[owned->first_iov_]),
+                static_cast<uint32_t>(request.iov_.size() - owned->first_iov_), offset, user_data);
+    }
+  }
+
+  /**
+   * Account for a completion of a request.
+   * @return true if the request is done, false if it is a short write whose rest must be resubmitted
+   */
+  static auto Complete(InFlightRequest *owned, int64_t result) -> bool {
+    if (result < 0) {
+      owned->done_ = result;
+      return true;
+    }
+    owned->done_ += result;
+    auto &request = owned->request_;
+    // a read completes short only at the end of a regular file; a write that made no progress would loop forever
+    if (!request.is_write_ || result == 0) {
+      return true;
+    }
+    if (request.iov_.empty()) {
+      return static_cast<size_t>(owned->done_) == request.length_;
+    }
+    AdvanceIov(&request.iov_, &owned->first_iov_, static_cast<size_t>(result));
+    return owned->first_iov_ == request.iov_.size();
+  }
+
+  /** Publish the pending entries and submit them. Needs submit_latch_. */
+  void Enter() {
+    if (pending_ == 0) {
+      return;
+    }
+    __atomic_store_n(sq_tail_, *sq_tail_ + pending_, __ATOMIC_RELEASE);
+    unsigned to_submit = pending_;
+    while (to_submit > 0) {
+      auto rc = syscall(__NR_io_uring_enter, ring_fd_, to_submit, 0, 0, nullptr, 0);
+      if (rc < 0) {
+        // EAGAIN/EBUSY: the kernel is short of resources or completions, retry once some are reaped
+        BUSTUB_ASSERT(errno == EINTR || errno == EAGAIN || errno == EBUSY, "io_uring_enter failed");
+        std::this_thread::yield();
+        continue;
+      }
+      to_submit -= static_cast<unsigned>(rc);
+    }
+    pending_ = 0;
+  }
+
+  void RunCompletions() {
+    while (true) {
+      auto rc = syscall(__NR_io_uring_enter, ring_fd_, 0, 1, IORING_ENTER_GETEVENTS, nullptr, 0);
+      if (rc < 0 && errno != EINTR) {
+        BUSTUB_ASSERT(errno == EAGAIN || errno == EBUSY, "io_uring_enter failed");
+      }
+      unsigned head = *cq_head_;
+      const unsigned tail = __atomic_load_n(cq_tail_, __ATOMIC_ACQUIRE);
+      bool stop = false;
+      size_t completed = 0;
+      std::vector<InFlightRequest *> resubmit;
+      for (; head != tail; ++head) {
+        const auto &cqe = cqes_[head & cq_mask_];
+        if (cqe.user_data == 0) {
+          stop = true;
+          completed++;
+          continue;
+        }
+        auto *owned = reinterpret_cast<InFlightRequest *>(cqe.user_data);
+        if (!Complete(owned, cqe.res)) {
+          resubmit.push_back(owned);
+          continue;
+        }
+        owned->request_.callback_(owned->done_);
+        delete owned;
+        completed++;
+      }
+      // the completions are consumed before the resubmissions can produce new ones
+      __atomic_store_n(cq_head_, head, __ATOMIC_RELEASE);
+      if (completed > 0 || !resubmit.empty()) {
+        std::scoped_lock<std::mutex> lock(submit_latch_);
+        // a resubmitted request stays in flight, so there is room for it in the completion queue
+        for (auto *owned : resubmit) {
+          PushRequest(owned);
+          if (pending_ == sq_entries_) {
+            Enter();
+          }
+        }
+        Enter();
+        in_flight_ -= completed;
+        space_cv_.notify_all();
+      }
+      if (stop) {
+        return;
+      }
+    }
+  }
+
+  int ring_fd_;
+  char *sq_ring_{nullptr};
+  size_t sq_ring_size_{0};
+  char *cq_ring_{nullptr};
+  size_t cq_ring_size_{0};
+  io_uring_sqe *sqes_{nullptr};
+  size_t sqes_size_{0};
+
+  unsigned *sq_tail_{nullptr};
+  unsigned sq_mask_{0};
+  unsigned *sq_array_{nullptr};
+  unsigned sq_entries_{0};
+  unsigned *cq_head_{nullptr};
+  unsigned *cq_tail_{nullptr};
+  unsigned cq_mask_{0};
+  io_uring_cqe *cqes_{nullptr};
+
+  /** Protects the submission queue and the counters below. */
+  std::mutex submit_latch_;
+  /** Notified when requests complete. */
+  std::condition_variable space_cv_;
+  /** Entries filled but not yet submitted. */
+  unsigned pending_{0};
+  /** Requests submitted or pending whose completion was not reaped yet. */
+  size_t in_flight_{0};
+  size_t max_in_flight_{0};
+  std::thread completion_thread_;
+};
+
+/** Workers of the thread pool fallback. */
+constexpr size_t THREAD_POOL_SIZE = 4;
+
+}  // namespace
+
+auto AsyncIo::Create(AsyncIoBackend backend, size_t queue_depth) -> std::unique_ptr<AsyncIo> {
+  if (backend != AsyncIoBackend::THREAD_POOL) {
+    if (auto ring = IoUringAsyncIo::Create(queue_depth); ring != nullptr) {
+      return ring;
+    }
+  }
+  return std::make_unique<ThreadPoolAsyncIo>(THREAD_POOL_SIZE);
+}
+
+}  // namespace bustub
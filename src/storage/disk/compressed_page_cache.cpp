@@ -0,0 +1,268 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// compressed_page_cache.cpp
+//
+// Identification: src/storage/disk/compressed_page_cache.cpp
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "storage/disk/compressed_page_cache.h"
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <string>
+#include <utility>
+
+#include "common/exception.h"
+
+namespace bustub {
+
+namespace {
+
+/** Shortest match worth a sequence. */
+constexpr size_t MIN_MATCH = 4;
+/** Matches are found through a hash table of the 4-byte sequences seen so far. */
+constexpr size_t HASH_BITS = 12;
+/** A token nibble holds lengths below this one, longer lengths continue in extra bytes. */
+constexpr size_t NIBBLE_MAX = 15;
+
+auto Load32(const char *data) -> uint32_t {
+  uint32_t value;
+  memcpy(&value, data, sizeof(value));
+  return value;
+}
+
+auto Hash(uint32_t sequence) -> size_t { return (sequence * 2654435761U) >> (32 - HASH_BITS); }
+
+/** Write the part of a length that does not fit into its token nibble, 255 at a time. */
+auto WriteLength(size_t length, char **out, const char *out_end) -> bool {
+  for (; length >= 255; length -= 255) {
+    if (*out == out_end) {
+      return false;
+    }
+    *(*out)++ = static_cast<char>(255);
+  }
+  if (*out == out_end) {
+    return false;
+  }
+  *(*out)++ = static_cast<char>(length);
+  return true;
+}
+
+/** Add the bytes written by WriteLength() to a length. */
+auto ReadLength(size_t *length, const char **in, const char *in_end) -> bool {
+  uint8_t byte;
+  do {
+    if (*in == in_end) {
+      return false;
+    }
+    byte = static_cast<uint8_t>(*(*in)++);
+    *length += byte;
+  } while (byte == 255);
+  return true;
+}
+
+/**
+ * Write a sequence: a token with the literal length in its high nibble and the match length in its low one, the
+ * literals, and then the match offset and length, unless match_length is 0 for the last sequence of a block.
+ */
+auto WriteSequence(const char *literals, size_t literal_length, size_t offset, size_t match_length, char **out,
+                   const char *out_end) -> bool {
+  if (*out == out_end) {
+    return false;
+  }
+  char *token = (*out)++;
+  const size_t literal_nibble = std::min(literal_length, NIBBLE_MAX);
+  const size_t match_nibble = match_length == 0 ? 0 : std::min(match_length - MIN_MATCH, NIBBLE_MAX);
+  *token = static_cast<char>((literal_nibble << 4) | match_nibble);
+  if (literal_nibble == NIBBLE_MAX && !WriteLength(literal_length - NIBBLE_MAX, out, out_end)) {
+    return false;
+  }
+  if (static_cast<size_t>(out_end - *out) < literal_length) {
+    return false;
+  }
+  memcpy(*out, literals, literal_length);
+  *out += literal_length;
+  if (match_length == 0) {
+    return true;
+  }
+  if (out_end - *out < 2) {
+    return false;
+  }
+  *(*out)++ = static_cast<char>(offset & 0xff);
+  *(*out)++ = static_cast<char>(offset >> 8);
+  return match_nibble < NIBBLE_MAX || WriteLength(match_length - MIN_MATCH - NIBBLE_MAX, out, out_end);
+}
+
+}  // namespace
+
+CompressedPageCache::CompressedPageCache(size_t capacity_bytes) : capacity_bytes_(capacity_bytes) {}
+
+auto CompressedPageCache::Put(page_id_t page_id, const char *data) -> bool {
+  char compressed[MAX_COMPRESSED_SIZE];
+  const size_t size = Compress(data, BUSTUB_PAGE_SIZE, compressed, sizeof(compressed));
+  std::scoped_lock<std::mutex> lock(latch_);
+  // the cached version is stale either way
+  if (auto entry = entries_.find(page_id); entry != entries_.end()) {
+    Erase(entry);
+  }
+  if (size == 0 || size + ENTRY_OVERHEAD > capacity_bytes_) {
+    rejects_++;
+    return false;
+  }
+  lru_.push_front(page_id);
+  entries_[page_id] = Entry{std::vector<char>(compressed, compressed + size), lru_.begin()};
+  used_bytes_ += size + ENTRY_OVERHEAD;
+  stores_++;
+  EvictToCapacity();
+  return true;
+}
+
+auto CompressedPageCache::Take(page_id_t page_id, char *data) -> bool {
+  std::vector<char> compressed;
+  {
+    std::scoped_lock<std::mutex> lock(latch_);
+    auto entry = entries_.find(page_id);
+    if (entry == entries_.end()) {
+      misses_++;
+      return false;
+    }
+    compressed = Erase(entry);
+    hits_++;
+  }
+  if (!Decompress(compressed.data(), compressed.size(), data, BUSTUB_PAGE_SIZE)) {
+    throw Exception("cached page " + std::to_string(page_id) + " does not decompress");
+  }
+  return true;
+}
+
+void CompressedPageCache::Remove(page_id_t page_id) {
+  std::scoped_lock<std::mutex> lock(latch_);
+  if (auto entry = entries_.find(page_id); entry != entries_.end()) {
+    Erase(entry);
+  }
+}
+
+void CompressedPageCache::SetCapacity(size_t capacity_bytes) {
+  std::scoped_lock<std::mutex> lock(latch_);
+  capacity_bytes_ = capacity_bytes;
+  EvictToCapacity();
+}
+
+auto CompressedPageCache::GetStats() -> CompressedPageCacheStats {
+  std::scoped_lock<std::mutex> lock(latch_);
+  CompressedPageCacheStats stats;
+  stats.pages_ = entries_.size();
+  stats.used_bytes_ = used_bytes_;
+  stats.capacity_bytes_ = capacity_bytes_;
+  stats.stores_ = stores_;
+  stats.rejects_ = rejects_;
+  stats.evictions_ = evictions_;
+  stats.hits_ = hits_;
+  stats.misses_ = misses_;
+  return stats;
+}
+
+auto CompressedPageCache::Compress(const char *src, size_t size, char *dst, size_t capacity) -> size_t {
+  // positions are kept + 1 in 16 bits, so that 0 means none and every offset fits into a sequence
+  BUSTUB_ASSERT(size <= UINT16_MAX, "block too large to compress");
+  std::array<uint16_t, size_t{1} << HASH_BITS> positions{};
+  const char *in = src;
+  const char *anchor = src;
+  const char *in_end = src + size;
+  char *out = dst;
+  const char *out_end = dst + capacity;
+  while (static_cast<size_t>(in_end - in) >= MIN_MATCH) {
+    const uint32_t sequence = Load32(in);
+    auto &position = positions[Hash(sequence)];
+    const char *match = position == 0 ? nullptr : src + position - 1;
+    position = static_cast<uint16_t>(in - src + 1);
+    if (match == nullptr || Load32(match) != sequence) {
+      in++;
+      continue;
+    }
+    // a match may overlap the bytes it produces, e.g. offset 1 repeats a single byte
+    size_t length = MIN_MATCH;
+    while (in + length < in_end && in[length] == match[length]) {
+      length++;
+    }
+    if (!WriteSequence(anchor, in - anchor, in - match, length, &out, out_end)) {
+      return 0;
+    }
+    in += length;
+    anchor = in;
+  }
+  if (!WriteSequence(anchor, in_end - anchor, 0, 0, &out, out_end)) {
+    return 0;
+  }
+  return out - dst;
+}
+
+auto CompressedPageCache::Decompress(const char *src, size_t size, char *dst, size_t dst_size) -> bool {
+  const char *in = src;
+  const char *in_end = src + size;
+  char *out = dst;
+  const char *out_end = dst + dst_size;
+  while (in < in_end) {
+    const auto token = static_cast<uint8_t>(*in++);
+    size_t literal_length = token >> 4;
+    if (literal_length == NIBBLE_MAX && !ReadLength(&literal_length, &in, in_end)) {
+      return false;
+    }
+    if (static_cast<size_t>(in_end - in) < literal_length || static_cast<size_t>(out_end - out) < literal_length) {
+      return false;
+    }
+    memcpy(out, in, literal_length);
+    in += literal_length;
+    out += literal_length;
+    // only the last sequence has no match
+    if (in == in_end) {
+      break;
+    }
+    if (in_end - in < 2) {
+      return false;
+    }
+    const size_t offset = static_cast<uint8_t>(in[0]) | (static_cast<size_t>(static_cast<uint8_t>(in[1])) << 8);
+    in += 2;
+    size_t match_length = (token & NIBBLE_MAX) + MIN_MATCH;
+    if ((token & NIBBLE_MAX) == NIBBLE_MAX && !ReadLength(&match_length, &in, in_end)) {
+      return false;
+    }
+    if (offset == 0 || offset > static_cast<size_t>(out - dst) || static_cast<size_t>(out_end - out) < match_length) {
+      return false;
+    }
+    const char *match = out - offset;
+    if (offset >= match_length) {
+      memcpy(out, match, match_length);
+    } else {
+      // byte by byte, the match overlaps the bytes being written
+      for (size_t i = 0; i < match_length; ++i) {
+        out[i] = match[i];
+      }
+    }
+    out += match_length;
+  }
+  return out == out_end;
+}
+
+auto CompressedPageCache::Erase(std::unordered_map<page_id_t, Entry>::iterator entry) -> std::vector<char> {
+  std::vector<char> data = std::move(entry->second.data_);
+  used_bytes_ -= data.size() + ENTRY_OVERHEAD;
+  lru_.erase(entry->second.position_);
+  entries_.erase(entry);
+  return data;
+}
+
+void CompressedPageCache::EvictToCapacity() {
+  while (used_bytes_ > capacity_bytes_ && !lru_.empty()) {
+    Erase(entries_.find(lru_.back()));
+    evictions_++;
+  }
+}
+
+}  // namespace bustub
@@ -11,12 +11,18 @@
 //===----------------------------------------------------------------------===//
 
 #include <sys/stat.h>
+#include <unistd.h>
+
 #include <cassert>
+#include <condition_variable>  // NOLINT
 #include <cstring>
 #include <iostream>
+#include <memory>
 #include <mutex>  // NOLINT
 #include <string>
 #include <thread>  // NOLINT
+#include <utility>
+#include <vector>
 
 #include "common/exception.h"
 #include "common/logger.h"
@@ -30,7 +36,28 @@ static char *buffer_used;
  * Constructor: open/create a single database file & log file
  * @input db_file: database file name
  */
-DiskManager::DiskManager(const std::string &db_file) : file_name_(db_file) {
+DiskManager::DiskManager(const std::string &db_file) : DiskManager(db_file, true) {
+  // a database file name without an extension gives no log file name, and no file is opened for it
+  if (log_name_.empty()) {
+    return;
+  }
+  std::scoped_lock scoped_db_io_latch(db_io_latch_);
+  db_io_.open(db_file, std::ios::binary | std::ios::in | std::ios::out);
+  // directory or file does not exist
+  if (!db_io_.is_open()) {
+    db_io_.clear();
+    // create a new file
+    db_io_.open(db_file, std::ios::binary | std::ios::trunc | std::ios::out | std::ios::in);
+    if (!db_io_.is_open()) {
+      throw Exception("can't open db file");
+    }
+  }
+}
+
+DiskManager::DiskManager(const std::string &db_file, bool open_log) : file_name_(db_file) {
+  if (!open_log) {
+    return;
+  }
   std::string::size_type n = file_name_.rfind('.');
   if (n == std::string::npos) {
     LOG_DEBUG("wrong file format");
@@ -48,18 +75,6 @@ DiskManager::DiskManager(const std::string &db_file) : file_name_(db_file) {
       throw Exception("can't open dblog file");
     }
   }
-
-  std::scoped_lock scoped_db_io_latch(db_io_latch_);
-  db_io_.open(db_file, std::ios::binary | std::ios::in | std::ios::out);
-  // directory or file does not exist
-  if (!db_io_.is_open()) {
-    db_io_.clear();
-    // create a new file
-    db_io_.open(db_file, std::ios::binary | std::ios::trunc | std::ios::out | std::ios::in);
-    if (!db_io_.is_open()) {
-      throw Exception("can't open db file");
-    }
-  }
   buffer_used = nullptr;
 }
 
@@ -67,6 +82,9 @@ DiskManager::DiskManager(const std::string &db_file) : file_name_(db_file) {
  * Close all file streams
  */
 void DiskManager::ShutDown() {
+  if (free_space_map_ != nullptr) {
+    free_space_map_->Close();
+  }
   {
     std::scoped_lock scoped_db_io_latch(db_io_latch_);
     db_io_.close();
@@ -102,7 +120,8 @@ void DiskManager::ReadPage(page_id_t page_id, char *page_data) {
   // check if read beyond file length
   if (offset > GetFileSize(file_name_)) {
     LOG_DEBUG("I/O error reading past end of file");
-    // std::cerr << "I/O error while reading" << std::endl;
+    // a page that was allocated but never written
+    memset(page_data, 0, BUSTUB_PAGE_SIZE);
   } else {
     // set read cursor to offset
     db_io_.seekp(offset);
@@ -122,6 +141,63 @@ void DiskManager::ReadPage(page_id_t page_id, char *page_data) {
   }
 }
 
+/**
+ * Run a batch of page requests synchronously, in order
+ */
+void DiskManager::SubmitRequests(std::vector<DiskRequest> requests) {
+  for (auto &request : requests) {
+    if (request.is_write_) {
+      WritePage(request.page_id_, request.data_);
+    } else {
+      ReadPage(request.page_id_, request.data_);
+    }
+    request.callback_(true);
+  }
+}
+
+void DiskManager::SubmitRequestsAndWait(std::vector<DiskRequest> requests) {
+  if (requests.empty()) {
+    return;
+  }
+  std::mutex done_latch;
+  std::condition_variable done_cv;
+  size_t remaining = requests.size();
+  for (auto &request : requests) {
+    request.callback_ = [&, callback = std::move(request.callback_)](bool ok) {
+      if (callback) {
+        callback(ok);
+      }
+      // notify under the latch, the waiter may destroy the condition variable as soon as it can take it
+      std::scoped_lock<std::mutex> done_lock(done_latch);
+      if (--remaining == 0) {
+        done_cv.notify_one();
+      }
+    };
+  }
+  SubmitRequests(std::move(requests));
+  std::unique_lock<std::mutex> done_lock(done_latch);
+  done_cv.wait(done_lock, [&remaining] { return remaining == 0; });
+}
+
+auto DiskManager::ReadPageAsync(page_id_t page_id, char *page_data) -> std::future<bool> {
+  auto promise = std::make_shared<std::promise<bool>>();
+  auto future = promise->get_future();
+  std::vector<DiskRequest> requests;
+  requests.push_back({false, page_id, page_data, [promise](bool ok) { promise->set_value(ok); }});
+  SubmitRequests(std::move(requests));
+  return future;
+}
+
+auto DiskManager::WritePageAsync(page_id_t page_id, const char *page_data) -> std::future<bool> {
+  auto promise = std::make_shared<std::promise<bool>>();
+  auto future = promise->get_future();
+  std::vector<DiskRequest> requests;
+  requests.push_back(
+      {true, page_id, const_cast<char *>(page_data), [promise](bool ok) { promise->set_value(ok); }});
+  SubmitRequests(std::move(requests));
+  return future;
+}
+
 /**
  * Write the contents of the log into disk file
  * Only return when sync is done, and only perform sequence write
@@ -194,6 +270,30 @@ auto DiskManager::GetNumFlushes() const -> int { return num_flushes_; }
  */
 auto DiskManager::GetNumWrites() const -> int { return num_writes_; }
 
+void DiskManager::EnableFreeSpaceMap() {
+  std::string::size_type n = file_name_.rfind('.');
+  if (n == std::string::npos) {
+    throw Exception("a free space map needs a database file");
+  }
+  free_space_map_ = std::make_unique<FreeSpaceMap>(file_name_.substr(0, n) + ".fsm");
+}
+
+auto DiskManager::TruncateFreePages() -> size_t {
+  if (free_space_map_ == nullptr) {
+    return 0;
+  }
+  return free_space_map_->TruncateFreeTail(
+      [this](page_id_t end) { TruncateDbFile(static_cast<int64_t>(end) * BUSTUB_PAGE_SIZE); });
+}
+
+void DiskManager::TruncateDbFile(int64_t size) {
+  std::scoped_lock scoped_db_io_latch(db_io_latch_);
+  db_io_.flush();
+  if (GetFileSize(file_name_) > size && truncate(file_name_.c_str(), size) != 0) {
+    LOG_DEBUG("I/O error while truncating");
+  }
+}
+
 /**
  * Returns true if the log is currently being flushed
  */
@@ -0,0 +1,85 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// disk_manager_mmap.cpp
+//
+// Identification: src/storage/disk/disk_manager_mmap.cpp
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "storage/disk/disk_manager_mmap.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cstring>
+#include <string>
+
+#include "common/exception.h"
+#include "common/logger.h"
+
+namespace bustub {
+
+DiskManagerMmap::DiskManagerMmap(const std::string &db_file) {
+  file_name_ = db_file;
+  int fd = open(db_file.c_str(), O_RDONLY);
+  if (fd < 0) {
+    throw Exception("can't open db file");
+  }
+  struct stat stat_buf;
+  if (fstat(fd, &stat_buf) != 0) {
+    close(fd);
+    throw Exception("can't stat db file");
+  }
+  db_file_size_ = stat_buf.st_size;
+  // an empty file cannot be mapped, every page of it reads as zeros anyway
+  if (db_file_size_ > 0) {
+    void *mapping = mmap(nullptr, db_file_size_, PROT_READ, MAP_SHARED, fd, 0);
+    if (mapping == MAP_FAILED) {
+      close(fd);
+      throw Exception("can't map db file");
+    }
+    mapping_ = static_cast<char *>(mapping);
+  }
+  // the mapping keeps the file open
+  close(fd);
+}
+
+DiskManagerMmap::~DiskManagerMmap() {
+  if (mapping_ != nullptr) {
+    munmap(mapping_, db_file_size_);
+  }
+}
+
+void DiskManagerMmap::WritePage(page_id_t page_id, const char *page_data) {
+  throw Exception("can't write page " + std::to_string(page_id) + " of a read-only db file");
+}
+
+void DiskManagerMmap::ReadPage(page_id_t page_id, char *page_data) {
+  const auto offset = static_cast<int64_t>(page_id) * BUSTUB_PAGE_SIZE;
+  if (page_id < 0 || offset >= db_file_size_) {
+    LOG_DEBUG("I/O error reading past end of file");
+    memset(page_data, 0, BUSTUB_PAGE_SIZE);
+    return;
+  }
+  const auto length = static_cast<size_t>(std::min<int64_t>(BUSTUB_PAGE_SIZE, db_file_size_ - offset));
+  memcpy(page_data, mapping_ + offset, length);
+  // the file ends before the end of the page
+  memset(page_data + length, 0, BUSTUB_PAGE_SIZE - length);
+}
+
+auto DiskManagerMmap::GetMappedPage(page_id_t page_id) -> const char * {
+  const auto offset = static_cast<int64_t>(page_id) * BUSTUB_PAGE_SIZE;
+  if (page_id < 0 || offset + BUSTUB_PAGE_SIZE > db_file_size_) {
+    return nullptr;
+  }
+  return mapping_ + offset;
+}
+
+}  // namespace bustub
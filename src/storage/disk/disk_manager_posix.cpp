@@ -0,0 +1,255 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// disk_manager_posix.cpp
+//
+// Identification: src/storage/disk/disk_manager_posix.cpp
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "storage/disk/disk_manager_posix.h"
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <iterator>
+#include <utility>
+
+#include "common/exception.h"
+#include "common/logger.h"
+
+namespace bustub {
+
+DiskManagerPosix::DiskManagerPosix(const std::string &db_file, bool direct_io, AsyncIoBackend async_backend,
+                                   bool open_log)
+    : DiskManager(db_file, open_log), async_backend_(async_backend) {
+  if (direct_io) {
+    db_fd_ = open(db_file.c_str(), O_RDWR | O_CREAT | O_DIRECT, 0644);
+    // e.g. tmpfs rejects O_DIRECT with EINVAL, fall back to buffered I/O
+    direct_io_ = db_fd_ >= 0;
+  }
+  if (db_fd_ < 0) {
+    db_fd_ = open(db_file.c_str(), O_RDWR | O_CREAT, 0644);
+  }
+  if (db_fd_ < 0) {
+    throw Exception("can't open db file");
+  }
+  struct stat stat_buf;
+  if (fstat(db_fd_, &stat_buf) == 0) {
+    db_file_size_ = stat_buf.st_size;
+  }
+}
+
+DiskManagerPosix::~DiskManagerPosix() {
+  // wait for the requests in flight before closing their file
+  async_io_.reset();
+  if (db_fd_ >= 0) {
+    close(db_fd_);
+  }
+}
+
+void DiskManagerPosix::ShutDown() {
+  async_io_.reset();
+  if (db_fd_ >= 0) {
+    close(db_fd_);
+    db_fd_ = -1;
+  }
+  DiskManager::ShutDown();
+}
+
+void DiskManagerPosix::WritePage(page_id_t page_id, const char *page_data) {
+  const auto offset = static_cast<off_t>(page_id) * BUSTUB_PAGE_SIZE;
+  const char *buffer = page_data;
+  if (NeedsBounceBuffer(page_data)) {
+    char *bounce = BounceBuffer();
+    memcpy(bounce, page_data, BUSTUB_PAGE_SIZE);
+    buffer = bounce;
+  }
+  num_writes_ += 1;
+  num_file_writes_ += 1;
+  size_t written = 0;
+  while (written < BUSTUB_PAGE_SIZE) {
+    ssize_t rc = pwrite(db_fd_, buffer + written, BUSTUB_PAGE_SIZE - written, offset + written);
+    if (rc < 0 && errno == EINTR) {
+      continue;
+    }
+    if (rc <= 0) {
+      LOG_DEBUG("I/O error while writing");
+      return;
+    }
+    written += rc;
+  }
+  ExtendFileSize(offset + BUSTUB_PAGE_SIZE);
+}
+
+void DiskManagerPosix::ReadPage(page_id_t page_id, char *page_data) {
+  const auto offset = static_cast<off_t>(page_id) * BUSTUB_PAGE_SIZE;
+  if (offset >= db_file_size_) {
+    LOG_DEBUG("I/O error reading past end of file");
+    memset(page_data, 0, BUSTUB_PAGE_SIZE);
+    return;
+  }
+  char *buffer = NeedsBounceBuffer(page_data) ? BounceBuffer() : page_data;
+  size_t read_count = 0;
+  while (read_count < BUSTUB_PAGE_SIZE) {
+    ssize_t rc = pread(db_fd_, buffer + read_count, BUSTUB_PAGE_SIZE - read_count, offset + read_count);
+    if (rc < 0 && errno == EINTR) {
+      continue;
+    }
+    if (rc < 0) {
+      LOG_DEBUG("I/O error while reading");
+      return;
+    }
+    if (rc == 0) {
+      // the file ends before the end of the page
+      LOG_DEBUG("Read less than a page");
+      memset(buffer + read_count, 0, BUSTUB_PAGE_SIZE - read_count);
+      break;
+    }
+    read_count += rc;
+  }
+  if (buffer != page_data) {
+    memcpy(page_data, buffer, BUSTUB_PAGE_SIZE);
+  }
+}
+
+void DiskManagerPosix::SubmitRequests(std::vector<DiskRequest> requests) {
+  auto *async_io = GetAsyncIo();
+  std::vector<AsyncIoRequest> io_requests;
+  io_requests.reserve(requests.size());
+  std::vector<PendingWrite> writes;
+  for (auto &request : requests) {
+    const auto offset = static_cast<off_t>(request.page_id_) * BUSTUB_PAGE_SIZE;
+    if (!request.is_write_ && offset >= db_file_size_) {
+      memset(request.data_, 0, BUSTUB_PAGE_SIZE);
+      request.callback_(true);
+      continue;
+    }
+    // the thread-local bounce buffer cannot outlive the call, so unaligned requests get their own
+    char *bounce = nullptr;
+    if (NeedsBounceBuffer(request.data_)) {
+      bounce = static_cast<char *>(std::aligned_alloc(DIRECT_IO_ALIGNMENT, BUSTUB_PAGE_SIZE));
+      if (request.is_write_) {
+        memcpy(bounce, request.data_, BUSTUB_PAGE_SIZE);
+      }
+    }
+    if (request.is_write_) {
+      writes.push_back({std::move(request), bounce});
+      continue;
+    }
+    char *buffer = bounce != nullptr ? bounce : request.data_;
+    io_requests.push_back({false, db_fd_, buffer, BUSTUB_PAGE_SIZE, offset, {},
+                           [request = std::move(request), bounce](int64_t result) {
+                             bool ok = result >= 0;
+                             if (!ok) {
+                               LOG_DEBUG("I/O error in asynchronous page I/O");
+                             } else {
+                               // the file ends before the end of the page
+                               char *buffer = bounce != nullptr ? bounce : request.data_;
+                               memset(buffer + result, 0, BUSTUB_PAGE_SIZE - result);
+                               if (bounce != nullptr) {
+                                 memcpy(request.data_, bounce, BUSTUB_PAGE_SIZE);
+                               }
+                             }
+                             std::free(bounce);
+                             request.callback_(ok);
+                           }});
+  }
+  CoalesceWrites(std::move(writes), &io_requests);
+  if (!io_requests.empty()) {
+    async_io->Submit(std::move(io_requests));
+  }
+}
+
+void DiskManagerPosix::CoalesceWrites(std::vector<PendingWrite> writes, std::vector<AsyncIoRequest> *io_requests) {
+  std::stable_sort(writes.begin(), writes.end(), [](const PendingWrite &a, const PendingWrite &b) {
+    return a.request_.page_id_ < b.request_.page_id_;
+  });
+  size_t run_begin = 0;
+  while (run_begin < writes.size()) {
+    // extend the run while the next write is for the very next page; a page written twice starts a new run
+    size_t run_end = run_begin + 1;
+    while (run_end < writes.size() && run_end - run_begin < MAX_COALESCED_PAGES &&
+           writes[run_end].request_.page_id_ == writes[run_end - 1].request_.page_id_ + 1) {
+      run_end++;
+    }
+    std::vector<PendingWrite> run;
+    run.reserve(run_end - run_begin);
+    std::move(writes.begin() + run_begin, writes.begin() + run_end, std::back_inserter(run));
+    run_begin = run_end;
+
+    const auto offset = static_cast<off_t>(run.front().request_.page_id_) * BUSTUB_PAGE_SIZE;
+    const auto length = static_cast<int64_t>(run.size() * BUSTUB_PAGE_SIZE);
+    AsyncIoRequest io_request{true, db_fd_, run.front().Buffer(), BUSTUB_PAGE_SIZE, offset, {}, nullptr};
+    if (run.size() > 1) {
+      io_request.iov_.reserve(run.size());
+      for (auto &write : run) {
+        io_request.iov_.push_back({write.Buffer(), BUSTUB_PAGE_SIZE});
+      }
+    }
+    num_writes_ += static_cast<int>(run.size());
+    num_file_writes_ += 1;
+    io_request.callback_ = [this, run = std::move(run), offset, length](int64_t result) {
+      bool ok = result == length;
+      if (!ok) {
+        LOG_DEBUG("I/O error in asynchronous page I/O");
+      } else {
+        ExtendFileSize(offset + length);
+      }
+      for (const auto &write : run) {
+        std::free(write.bounce_);
+        write.request_.callback_(ok);
+      }
+    };
+    io_requests->push_back(std::move(io_request));
+  }
+}
+
+auto DiskManagerPosix::GetAsyncIoBackend() -> AsyncIoBackend { return GetAsyncIo()->GetBackend(); }
+
+auto DiskManagerPosix::GetAsyncIo() -> AsyncIo * {
+  std::call_once(async_io_once_, [this] { async_io_ = AsyncIo::Create(async_backend_, ASYNC_QUEUE_DEPTH); });
+  return async_io_.get();
+}
+
+void DiskManagerPosix::TruncateDbFile(int64_t size) {
+  if (db_file_size_ > size) {
+    if (ftruncate(db_fd_, size) != 0) {
+      LOG_DEBUG("I/O error while truncating");
+      return;
+    }
+    db_file_size_ = size;
+  }
+}
+
+void DiskManagerPosix::ExtendFileSize(int64_t end) {
+  // concurrent writers past the end race to the largest end offset
+  int64_t size = db_file_size_;
+  while (size < end && !db_file_size_.compare_exchange_weak(size, end)) {
+  }
+}
+
+auto DiskManagerPosix::NeedsBounceBuffer(const char *buffer) const -> bool {
+  return direct_io_ && reinterpret_cast<uintptr_t>(buffer) % DIRECT_IO_ALIGNMENT != 0;
+}
+
+auto DiskManagerPosix::BounceBuffer() -> char * {
+  struct AlignedPage {
+    AlignedPage() : data_(static_cast<char *>(std::aligned_alloc(DIRECT_IO_ALIGNMENT, BUSTUB_PAGE_SIZE))) {}
+    ~AlignedPage() { std::free(data_); }
+    char *data_;
+  };
+  static thread_local AlignedPage bounce;
+  return bounce.data_;
+}
+
+}  // namespace bustub
@@ -0,0 +1,135 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// disk_manager_simulated.cpp
+//
+// Identification: src/storage/disk/disk_manager_simulated.cpp
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "storage/disk/disk_manager_simulated.h"
+
+#include <algorithm>
+#include <numeric>
+#include <thread>  // NOLINT
+#include <utility>
+#include <vector>
+
+#include "common/macros.h"
+
+namespace bustub {
+
+DiskManagerSimulated::DiskManagerSimulated(DiskManager *disk_manager, const SimulatedDeviceProfile &profile,
+                                           bool real_time)
+    : disk_manager_(disk_manager),
+      profile_(profile),
+      real_time_(real_time),
+      start_(std::chrono::steady_clock::now()),
+      slot_free_at_(std::max<size_t>(profile.queue_depth_, 1), std::chrono::nanoseconds(0)) {
+  BUSTUB_ASSERT(disk_manager != nullptr, "a simulated device needs a disk manager to store its pages");
+}
+
+void DiskManagerSimulated::WritePage(page_id_t page_id, const char *page_data) {
+  std::chrono::nanoseconds completion;
+  {
+    std::scoped_lock<std::mutex> lock(latch_);
+    completion = Schedule(true, page_id, Now());
+  }
+  disk_manager_->WritePage(page_id, page_data);
+  WaitUntil(completion);
+}
+
+void DiskManagerSimulated::ReadPage(page_id_t page_id, char *page_data) {
+  std::chrono::nanoseconds completion;
+  {
+    std::scoped_lock<std::mutex> lock(latch_);
+    completion = Schedule(false, page_id, Now());
+  }
+  disk_manager_->ReadPage(page_id, page_data);
+  WaitUntil(completion);
+}
+
+void DiskManagerSimulated::SubmitRequests(std::vector<DiskRequest> requests) {
+  std::vector<std::chrono::nanoseconds> completions(requests.size());
+  {
+    std::scoped_lock<std::mutex> lock(latch_);
+    const auto issue = Now();
+    for (size_t i = 0; i < requests.size(); ++i) {
+      completions[i] = Schedule(requests[i].is_write_, requests[i].page_id_, issue);
+    }
+  }
+  std::vector<size_t> order(requests.size());
+  std::iota(order.begin(), order.end(), 0);
+  std::stable_sort(order.begin(), order.end(),
+                   [&completions](size_t a, size_t b) { return completions[a] < completions[b]; });
+  for (auto i : order) {
+    auto &request = requests[i];
+    if (request.is_write_) {
+      disk_manager_->WritePage(request.page_id_, request.data_);
+    } else {
+      disk_manager_->ReadPage(request.page_id_, request.data_);
+    }
+    WaitUntil(completions[i]);
+    request.callback_(true);
+  }
+}
+
+auto DiskManagerSimulated::GetSimulatedTime() -> std::chrono::nanoseconds {
+  std::scoped_lock<std::mutex> lock(latch_);
+  return last_completion_;
+}
+
+auto DiskManagerSimulated::GetStats() -> SimulatedDeviceStats {
+  std::scoped_lock<std::mutex> lock(latch_);
+  return stats_;
+}
+
+auto DiskManagerSimulated::Now() -> std::chrono::nanoseconds {
+  if (!real_time_) {
+    return clock_;
+  }
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start_);
+}
+
+auto DiskManagerSimulated::Schedule(bool is_write, page_id_t page_id, std::chrono::nanoseconds issue)
+    -> std::chrono::nanoseconds {
+  // wait for the slot that frees up first
+  auto slot = std::min_element(slot_free_at_.begin(), slot_free_at_.end());
+  const auto start = std::max(issue, *slot);
+  auto latency = std::chrono::microseconds(is_write ? profile_.write_latency_us_ : profile_.read_latency_us_);
+  if (profile_.seek_latency_us_ != 0 && page_id != next_sequential_page_id_) {
+    latency += std::chrono::microseconds(profile_.seek_latency_us_);
+    stats_.seeks_++;
+  }
+  next_sequential_page_id_ = page_id + 1;
+
+  // the transfers of all slots share the bandwidth, one at a time
+  std::chrono::nanoseconds transfer{0};
+  if (profile_.bandwidth_bytes_per_second_ != 0) {
+    transfer = std::chrono::nanoseconds(uint64_t{BUSTUB_PAGE_SIZE} * 1000000000 / profile_.bandwidth_bytes_per_second_);
+  }
+  const auto transfer_start = std::max<std::chrono::nanoseconds>(start + latency, channel_free_at_);
+  const auto completion = transfer_start + transfer;
+  channel_free_at_ = completion;
+  *slot = completion;
+  last_completion_ = std::max(last_completion_, completion);
+
+  (is_write ? stats_.writes_ : stats_.reads_)++;
+  stats_.queue_wait_ns_ += (start - issue).count();
+  stats_.total_latency_ns_ += (completion - issue).count();
+  return completion;
+}
+
+void DiskManagerSimulated::WaitUntil(std::chrono::nanoseconds time) {
+  if (real_time_) {
+    std::this_thread::sleep_until(start_ + time);
+    return;
+  }
+  std::scoped_lock<std::mutex> lock(latch_);
+  clock_ = std::max(clock_, time);
+}
+
+}  // namespace bustub
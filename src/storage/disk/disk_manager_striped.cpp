@@ -0,0 +1,99 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// disk_manager_striped.cpp
+//
+// Identification: src/storage/disk/disk_manager_striped.cpp
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "storage/disk/disk_manager_striped.h"
+
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "common/macros.h"
+
+namespace bustub {
+
+DiskManagerStriped::DiskManagerStriped(const std::string &db_file, size_t num_files, size_t stripe_pages,
+                                       bool direct_io, AsyncIoBackend async_backend)
+    : DiskManager(db_file, true), stripe_pages_(stripe_pages) {
+  BUSTUB_ASSERT(num_files > 0, "a tablespace needs a data file");
+  BUSTUB_ASSERT(stripe_pages > 0, "a stripe needs a page");
+  for (size_t i = 0; i < num_files; ++i) {
+    files_.push_back(std::make_unique<DiskManagerPosix>(DataFileName(db_file, i), direct_io, async_backend, false));
+  }
+}
+
+void DiskManagerStriped::ShutDown() {
+  for (auto &file : files_) {
+    file->ShutDown();
+  }
+  DiskManager::ShutDown();
+}
+
+void DiskManagerStriped::WritePage(page_id_t page_id, const char *page_data) {
+  num_writes_ += 1;
+  auto [file, file_page_id] = Locate(page_id);
+  files_[file]->WritePage(file_page_id, page_data);
+}
+
+void DiskManagerStriped::ReadPage(page_id_t page_id, char *page_data) {
+  auto [file, file_page_id] = Locate(page_id);
+  files_[file]->ReadPage(file_page_id, page_data);
+}
+
+void DiskManagerStriped::SubmitRequests(std::vector<DiskRequest> requests) {
+  std::vector<std::vector<DiskRequest>> batches(files_.size());
+  for (auto &request : requests) {
+    if (request.is_write_) {
+      num_writes_ += 1;
+    }
+    auto [file, file_page_id] = Locate(request.page_id_);
+    request.page_id_ = file_page_id;
+    batches[file].push_back(std::move(request));
+  }
+  for (size_t i = 0; i < files_.size(); ++i) {
+    if (!batches[i].empty()) {
+      files_[i]->SubmitRequests(std::move(batches[i]));
+    }
+  }
+}
+
+auto DiskManagerStriped::Locate(page_id_t page_id) const -> std::pair<size_t, page_id_t> {
+  const auto stripe_pages = static_cast<page_id_t>(stripe_pages_);
+  const auto num_files = static_cast<page_id_t>(files_.size());
+  const page_id_t stripe = page_id / stripe_pages;
+  return {static_cast<size_t>(stripe % num_files), stripe / num_files * stripe_pages + page_id % stripe_pages};
+}
+
+auto DiskManagerStriped::DataFileName(const std::string &db_file, size_t index) -> std::string {
+  if (index == 0) {
+    return db_file;
+  }
+  const std::string::size_type n = db_file.rfind('.');
+  if (n == std::string::npos) {
+    return db_file + "." + std::to_string(index);
+  }
+  return db_file.substr(0, n) + "." + std::to_string(index) + db_file.substr(n);
+}
+
+void DiskManagerStriped::TruncateDbFile(int64_t size) {
+  const auto pages = static_cast<size_t>(size / BUSTUB_PAGE_SIZE);
+  const size_t full_stripes = pages / stripe_pages_;
+  for (size_t i = 0; i < files_.size(); ++i) {
+    // the full stripes of the file, and the partial stripe at the end if it is the file's
+    size_t file_pages = (full_stripes / files_.size() + (i < full_stripes % files_.size() ? 1 : 0)) * stripe_pages_;
+    if (i == full_stripes % files_.size()) {
+      file_pages += pages % stripe_pages_;
+    }
+    files_[i]->TruncateDbFile(static_cast<int64_t>(file_pages) * BUSTUB_PAGE_SIZE);
+  }
+}
+
+}  // namespace bustub
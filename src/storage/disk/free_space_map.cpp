@@ -0,0 +1,239 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// free_space_map.cpp
+//
+// Identification: src/storage/disk/free_space_map.cpp
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "storage/disk/free_space_map.h"
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+
+#include "common/exception.h"
+#include "common/logger.h"
+
+namespace bustub {
+
+FreeSpaceMap::FreeSpaceMap(const std::string &file_name) {
+  fd_ = open(file_name.c_str(), O_RDWR | O_CREAT, 0644);
+  if (fd_ < 0) {
+    throw Exception("can't open free space map file");
+  }
+  char page[BUSTUB_PAGE_SIZE];
+  ReadFilePage(0, page);
+  Header header;
+  memcpy(&header, page, sizeof(header));
+  if (header.magic_ == MAGIC) {
+    end_ = static_cast<page_id_t>(header.end_);
+    Reserve(end_);
+    // after a crash the bitmap may call pages free that were reused since, so everything counts as allocated
+    if (header.clean_ == 1) {
+      for (size_t i = 0; i < bits_.size(); i += WORDS_PER_PAGE) {
+        ReadFilePage(i / WORDS_PER_PAGE + 1, page);
+        memcpy(&bits_[i], page, BUSTUB_PAGE_SIZE);
+      }
+      for (auto word : bits_) {
+        num_free_ += __builtin_popcountll(word);
+      }
+    }
+  }
+  persisted_end_ = end_;
+  // from now on the bitmap on disk is stale until Close()
+  WriteHeader(false, persisted_end_);
+}
+
+FreeSpaceMap::~FreeSpaceMap() { Close(); }
+
+auto FreeSpaceMap::Allocate(uint32_t stripe, uint32_t num_stripes, bool *reused) -> page_id_t {
+  BUSTUB_ASSERT(stripe < num_stripes, "stripe out of range");
+  std::scoped_lock<std::mutex> lock(latch_);
+  if (num_free_ > 0) {
+    // the lowest free page keeps the end of the file free for TruncateFreeTail()
+    while (first_free_word_ < bits_.size() && bits_[first_free_word_] == 0) {
+      first_free_word_++;
+    }
+    for (size_t i = first_free_word_; i < bits_.size(); ++i) {
+      for (uint64_t word = bits_[i]; word != 0; word &= word - 1) {
+        auto page_id = static_cast<page_id_t>(i * BITS_PER_WORD + __builtin_ctzll(word));
+        if (static_cast<uint32_t>(page_id) % num_stripes == stripe) {
+          SetFree(page_id, false);
+          if (reused != nullptr) {
+            *reused = true;
+          }
+          return page_id;
+        }
+      }
+    }
+  }
+
+  if (reused != nullptr) {
+    *reused = false;
+  }
+  const auto stripes = static_cast<page_id_t>(num_stripes);
+  const page_id_t page_id = end_ + (static_cast<page_id_t>(stripe) - end_ % stripes + stripes) % stripes;
+  Reserve(page_id + 1);
+  const page_id_t skipped_begin = end_;
+  end_ = page_id + 1;
+  for (page_id_t skipped = skipped_begin; skipped < page_id; ++skipped) {
+    SetFree(skipped, true);
+  }
+  if (end_ > persisted_end_) {
+    persisted_end_ = end_ + ALLOCATION_EXTENT;
+    WriteHeader(false, persisted_end_);
+  }
+  return page_id;
+}
+
+void FreeSpaceMap::Free(page_id_t page_id) {
+  std::scoped_lock<std::mutex> lock(latch_);
+  if (page_id < 0 || page_id >= end_) {
+    return;
+  }
+  SetFree(page_id, true);
+}
+
+auto FreeSpaceMap::IsFree(page_id_t page_id) -> bool {
+  std::scoped_lock<std::mutex> lock(latch_);
+  if (page_id < 0 || page_id >= end_) {
+    return false;
+  }
+  return ((bits_[page_id / BITS_PER_WORD] >> (page_id % BITS_PER_WORD)) & 1) != 0;
+}
+
+auto FreeSpaceMap::GetNumFreePages() -> size_t {
+  std::scoped_lock<std::mutex> lock(latch_);
+  return num_free_;
+}
+
+auto FreeSpaceMap::GetEnd() -> page_id_t {
+  std::scoped_lock<std::mutex> lock(latch_);
+  return end_;
+}
+
+auto FreeSpaceMap::TruncateFreeTail(const std::function<void(page_id_t)> &truncate) -> size_t {
+  std::scoped_lock<std::mutex> lock(latch_);
+  const page_id_t old_end = end_;
+  while (end_ > 0 && ((bits_[(end_ - 1) / BITS_PER_WORD] >> ((end_ - 1) % BITS_PER_WORD)) & 1) != 0) {
+    SetFree(end_ - 1, false);
+    end_--;
+  }
+  if (end_ == old_end) {
+    return 0;
+  }
+  truncate(end_);
+  persisted_end_ = end_;
+  WriteHeader(false, persisted_end_);
+  return old_end - end_;
+}
+
+void FreeSpaceMap::Flush() {
+  std::scoped_lock<std::mutex> lock(latch_);
+  if (fd_ >= 0) {
+    WriteDirty(false);
+  }
+}
+
+void FreeSpaceMap::Close() {
+  std::scoped_lock<std::mutex> lock(latch_);
+  if (fd_ < 0) {
+    return;
+  }
+  WriteDirty(true);
+  fsync(fd_);
+  close(fd_);
+  fd_ = -1;
+}
+
+void FreeSpaceMap::SetFree(page_id_t page_id, bool free) {
+  auto &word = bits_[page_id / BITS_PER_WORD];
+  const uint64_t mask = uint64_t{1} << (page_id % BITS_PER_WORD);
+  if (((word & mask) != 0) == free) {
+    return;
+  }
+  if (free) {
+    word |= mask;
+    num_free_++;
+    first_free_word_ = std::min<size_t>(first_free_word_, page_id / BITS_PER_WORD);
+  } else {
+    word &= ~mask;
+    num_free_--;
+  }
+  dirty_pages_.insert(page_id / BITS_PER_PAGE);
+}
+
+void FreeSpaceMap::Reserve(page_id_t end) {
+  // whole bitmap pages, so that they can be read and written in place
+  const size_t pages = (static_cast<size_t>(end) + BITS_PER_PAGE - 1) / BITS_PER_PAGE;
+  if (pages * WORDS_PER_PAGE > bits_.size()) {
+    bits_.resize(pages * WORDS_PER_PAGE, 0);
+  }
+}
+
+void FreeSpaceMap::WriteDirty(bool clean) {
+  for (auto index : dirty_pages_) {
+    if ((index + 1) * WORDS_PER_PAGE <= bits_.size()) {
+      WriteFilePage(index + 1, reinterpret_cast<const char *>(&bits_[index * WORDS_PER_PAGE]));
+    }
+  }
+  dirty_pages_.clear();
+  if (clean) {
+    // the bitmap on disk must be complete before the header says so
+    fsync(fd_);
+  }
+  WriteHeader(clean, clean ? end_ : persisted_end_);
+}
+
+void FreeSpaceMap::WriteHeader(bool clean, page_id_t end) {
+  char page[BUSTUB_PAGE_SIZE] = {0};
+  Header header{MAGIC, clean ? 1U : 0U, end};
+  memcpy(page, &header, sizeof(header));
+  WriteFilePage(0, page);
+}
+
+void FreeSpaceMap::ReadFilePage(size_t index, char *data) {
+  size_t read_count = 0;
+  while (read_count < BUSTUB_PAGE_SIZE) {
+    ssize_t rc = pread(fd_, data + read_count, BUSTUB_PAGE_SIZE - read_count,
+                       static_cast<off_t>(index * BUSTUB_PAGE_SIZE + read_count));
+    if (rc < 0 && errno == EINTR) {
+      continue;
+    }
+    if (rc <= 0) {
+      break;
+    }
+    read_count += rc;
+  }
+  memset(data + read_count, 0, BUSTUB_PAGE_SIZE - read_count);
+}
+
+void FreeSpaceMap::WriteFilePage(size_t index, const char *data) {
+  if (fd_ < 0) {
+    // closed by a shut down disk manager, later changes are lost like those of a crash
+    return;
+  }
+  size_t written = 0;
+  while (written < BUSTUB_PAGE_SIZE) {
+    ssize_t rc =
+        pwrite(fd_, data + written, BUSTUB_PAGE_SIZE - written, static_cast<off_t>(index * BUSTUB_PAGE_SIZE + written));
+    if (rc < 0 && errno == EINTR) {
+      continue;
+    }
+    if (rc <= 0) {
+      LOG_DEBUG("I/O error while writing the free space map");
+      return;
+    }
+    written += rc;
+  }
+}
+
+}  // namespace bustub
@@ -0,0 +1,320 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// b_link_tree.cpp
+//
+// Identification: src/storage/index/b_link_tree.cpp
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <string>
+#include <thread>  // NOLINT
+#include <utility>
+#include <vector>
+
+#include "common/rid.h"
+#include "storage/index/b_link_tree.h"
+#include "storage/page/header_page.h"
+
+namespace bustub {
+
+INDEX_TEMPLATE_ARGUMENTS
+BLINKTREE_TYPE::BLinkTree(std::string name, BufferPoolManager *buffer_pool_manager, const KeyComparator &comparator,
+                          int leaf_max_size, int internal_max_size)
+    : index_name_(std::move(name)),
+      root_page_id_(INVALID_PAGE_ID),
+      buffer_pool_manager_(buffer_pool_manager),
+      comparator_(comparator),
+      leaf_max_size_(leaf_max_size != 0 ? leaf_max_size
+                                        : static_cast<int>((BUSTUB_PAGE_SIZE - B_LINK_TREE_PAGE_HEADER_SIZE) /
+                                                           sizeof(std::pair<KeyType, ValueType>))),
+      internal_max_size_(internal_max_size != 0 ? internal_max_size
+                                                : static_cast<int>((BUSTUB_PAGE_SIZE - B_LINK_TREE_PAGE_HEADER_SIZE) /
+                                                                   sizeof(std::pair<KeyType, page_id_t>))) {
+  BUSTUB_ASSERT(leaf_max_size_ >= 2 && internal_max_size_ >= 2, "a node has to hold two entries to split");
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+auto BLINKTREE_TYPE::IsEmpty() const -> bool { return root_page_id_ == INVALID_PAGE_ID; }
+
+INDEX_TEMPLATE_ARGUMENTS
+auto BLINKTREE_TYPE::GetRootPageId() -> page_id_t { return root_page_id_; }
+
+INDEX_TEMPLATE_ARGUMENTS
+auto BLINKTREE_TYPE::FetchLatched(page_id_t page_id, bool exclusive) -> Page * {
+  Page *page = buffer_pool_manager_->FetchPage(page_id);
+  BUSTUB_ASSERT(page != nullptr, "Fetch page failed in BLinkTree.");
+  if (exclusive) {
+    page->WLatch();
+  } else {
+    page->RLatch();
+  }
+  return page;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void BLINKTREE_TYPE::Release(Page *page, bool exclusive, bool is_dirty) {
+  if (exclusive) {
+    page->WUnlatch();
+  } else {
+    page->RUnlatch();
+  }
+  buffer_pool_manager_->UnpinPage(page->GetPageId(), is_dirty);
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+auto BLINKTREE_TYPE::MoveRight(Page *page, const KeyType &key, bool exclusive) -> Page * {
+  // the header and the high key are at the same place in leaves and internal nodes
+  auto node = reinterpret_cast<InternalPage *>(page->GetData());
+  while (node->IsBeyond(key, comparator_)) {
+    Page *right = FetchLatched(node->GetRightPageId(), exclusive);
+    Release(page, exclusive, false);
+    page = right;
+    node = reinterpret_cast<InternalPage *>(page->GetData());
+  }
+  return page;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+auto BLINKTREE_TYPE::FindNode(const KeyType &key, int level, bool exclusive, std::vector<page_id_t> *path) -> Page * {
+  page_id_t page_id = root_page_id_;
+  if (page_id == INVALID_PAGE_ID) {
+    return nullptr;
+  }
+  // pages are never freed, so a root that has been replaced meanwhile is still a valid place to start from
+  Page *page = FetchLatched(page_id, false);
+  bool page_exclusive = false;
+  while (true) {
+    auto node = reinterpret_cast<InternalPage *>(page->GetData());
+    if (node->GetLevel() == level && exclusive && !page_exclusive) {
+      // only the root can be reached at the target level with a read latch; a split meanwhile is handled by MoveRight
+      Release(page, false, false);
+      page = FetchLatched(page_id, true);
+      page_exclusive = true;
+    }
+    page = MoveRight(page, key, page_exclusive);
+    node = reinterpret_cast<InternalPage *>(page->GetData());
+    if (node->GetLevel() == level) {
+      return page;
+    }
+    BUSTUB_ASSERT(node->GetLevel() > level, "the tree is not that high.");
+    if (path != nullptr) {
+      path->push_back(page->GetPageId());
+    }
+    page_id = node->LookupChild(key, comparator_);
+    page_exclusive = exclusive && node->GetLevel() == level + 1;
+    // readers and writers hold one latch on the way down: a split of the child meanwhile is handled by MoveRight
+    Release(page, false, false);
+    page = FetchLatched(page_id, page_exclusive);
+  }
+}
+
+/*****************************************************************************
+ * SEARCH
+ *****************************************************************************/
+INDEX_TEMPLATE_ARGUMENTS
+auto BLINKTREE_TYPE::GetValue(const KeyType &key, std::vector<ValueType> *result, Transaction *transaction) -> bool {
+  Page *page = FindNode(key, 0, false, nullptr);
+  if (page == nullptr) {
+    return false;
+  }
+  auto leaf = reinterpret_cast<LeafPage *>(page->GetData());
+  int index = leaf->LowerBound(key, comparator_);
+  bool found = index < leaf->GetSize() && comparator_(leaf->KeyAt(index), key) == 0;
+  if (found) {
+    result->push_back(leaf->ValueAt(index));
+  }
+  Release(page, false, false);
+  return found;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+auto BLINKTREE_TYPE::ScanAll() -> std::vector<std::pair<KeyType, ValueType>> {
+  std::vector<std::pair<KeyType, ValueType>> entries;
+  if (IsEmpty()) {
+    return entries;
+  }
+  Page *page = FetchLatched(root_page_id_, false);
+  while (reinterpret_cast<InternalPage *>(page->GetData())->GetLevel() > 0) {
+    page_id_t child = reinterpret_cast<InternalPage *>(page->GetData())->ValueAt(0);
+    Release(page, false, false);
+    page = FetchLatched(child, false);
+  }
+  while (true) {
+    auto leaf = reinterpret_cast<LeafPage *>(page->GetData());
+    for (int i = 0; i < leaf->GetSize(); ++i) {
+      entries.emplace_back(leaf->KeyAt(i), leaf->ValueAt(i));
+    }
+    if (leaf->GetRightPageId() == INVALID_PAGE_ID) {
+      Release(page, false, false);
+      return entries;
+    }
+    Page *right = FetchLatched(leaf->GetRightPageId(), false);
+    Release(page, false, false);
+    page = right;
+  }
+}
+
+/*****************************************************************************
+ * INSERTION
+ *****************************************************************************/
+INDEX_TEMPLATE_ARGUMENTS
+auto BLINKTREE_TYPE::Insert(const KeyType &key, const ValueType &value, Transaction *transaction) -> bool {
+  if (IsEmpty()) {
+    std::scoped_lock<std::mutex> lock(root_latch_);
+    if (IsEmpty()) {
+      page_id_t page_id;
+      Page *page = buffer_pool_manager_->NewPage(&page_id);
+      BUSTUB_ASSERT(page != nullptr, "create a page for B-link tree failed.");
+      reinterpret_cast<LeafPage *>(page->GetData())->Init(page_id, 0, leaf_max_size_);
+      buffer_pool_manager_->UnpinPage(page_id, true);
+      root_level_ = 0;
+      root_page_id_ = page_id;
+      UpdateRootPageId(1);
+    }
+  }
+
+  std::vector<page_id_t> path;
+  Page *page = FindNode(key, 0, true, &path);
+  auto leaf = reinterpret_cast<LeafPage *>(page->GetData());
+  int index = leaf->LowerBound(key, comparator_);
+  if (index < leaf->GetSize() && comparator_(leaf->KeyAt(index), key) == 0) {
+    Release(page, true, false);
+    return false;
+  }
+  if (!leaf->IsFull()) {
+    leaf->InsertAt(index, key, value);
+    Release(page, true, true);
+    return true;
+  }
+
+  // split: the new right sibling is only reachable through the leaf, which stays write latched until it is complete
+  page_id_t new_page_id;
+  Page *new_page = buffer_pool_manager_->NewPage(&new_page_id);
+  BUSTUB_ASSERT(new_page != nullptr, "create a page for B-link tree failed.");
+  auto new_leaf = reinterpret_cast<LeafPage *>(new_page->GetData());
+  new_leaf->Init(new_page_id, 0, leaf_max_size_);
+  auto separator = leaf->MoveHalfTo(new_leaf);
+  if (comparator_(key, separator) < 0) {
+    leaf->InsertAt(leaf->LowerBound(key, comparator_), key, value);
+  } else {
+    new_leaf->InsertAt(new_leaf->LowerBound(key, comparator_), key, value);
+  }
+  buffer_pool_manager_->UnpinPage(new_page_id, true);
+  InsertInParent(page, separator, new_page_id, &path);
+  return true;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void BLINKTREE_TYPE::InsertInParent(Page *child, const KeyType &separator, page_id_t new_page_id,
+                                    std::vector<page_id_t> *path) {
+  int level = reinterpret_cast<InternalPage *>(child->GetData())->GetLevel();
+  Page *page = nullptr;
+  if (!path->empty()) {
+    page = FetchLatched(path->back(), true);
+    path->pop_back();
+    // the parent may have split since we passed it
+    page = MoveRight(page, separator, true);
+  } else {
+    // child was at the top when we went down. Either it still is the root and gets a new root on top, or the tree has
+    // grown meanwhile and the parent is found from the new root.
+    while (true) {
+      std::unique_lock<std::mutex> lock(root_latch_);
+      if (root_page_id_ == child->GetPageId()) {
+        page_id_t root_page_id;
+        Page *root_page = buffer_pool_manager_->NewPage(&root_page_id);
+        BUSTUB_ASSERT(root_page != nullptr, "create a page for B-link tree failed.");
+        auto root = reinterpret_cast<InternalPage *>(root_page->GetData());
+        root->Init(root_page_id, level + 1, internal_max_size_);
+        root->InsertAt(0, separator, child->GetPageId());
+        root->InsertAt(1, separator, new_page_id);
+        buffer_pool_manager_->UnpinPage(root_page_id, true);
+        root_level_ = level + 1;
+        root_page_id_ = root_page_id;
+        UpdateRootPageId(0);
+        lock.unlock();
+        Release(child, true, true);
+        return;
+      }
+      if (root_level_ > level) {
+        break;
+      }
+      // the root is a left sibling of child that has split too, and is about to install the new root
+      lock.unlock();
+      std::this_thread::yield();
+    }
+    page = FindNode(separator, level + 1, true, nullptr);
+  }
+  // the parent is latched, so nobody can reach the new sibling from above before it is linked in
+  Release(child, true, true);
+
+  auto parent = reinterpret_cast<InternalPage *>(page->GetData());
+  int index = parent->LowerBound(separator, comparator_, 1);
+  if (!parent->IsFull()) {
+    parent->InsertAt(index, separator, new_page_id);
+    Release(page, true, true);
+    return;
+  }
+
+  page_id_t new_parent_page_id;
+  Page *new_parent_page = buffer_pool_manager_->NewPage(&new_parent_page_id);
+  BUSTUB_ASSERT(new_parent_page != nullptr, "create a page for B-link tree failed.");
+  auto new_parent = reinterpret_cast<InternalPage *>(new_parent_page->GetData());
+  new_parent->Init(new_parent_page_id, level + 1, internal_max_size_);
+  // KEY(0) of the new node keeps the separator, the low end of its range
+  auto parent_separator = parent->MoveHalfTo(new_parent);
+  if (comparator_(separator, parent_separator) < 0) {
+    parent->InsertAt(parent->LowerBound(separator, comparator_, 1), separator, new_page_id);
+  } else {
+    new_parent->InsertAt(new_parent->LowerBound(separator, comparator_, 1), separator, new_page_id);
+  }
+  buffer_pool_manager_->UnpinPage(new_parent_page_id, true);
+  InsertInParent(page, parent_separator, new_parent_page_id, path);
+}
+
+/*****************************************************************************
+ * REMOVE
+ *****************************************************************************/
+INDEX_TEMPLATE_ARGUMENTS
+void BLINKTREE_TYPE::Remove(const KeyType &key, Transaction *transaction) {
+  Page *page = FindNode(key, 0, true, nullptr);
+  if (page == nullptr) {
+    return;
+  }
+  auto leaf = reinterpret_cast<LeafPage *>(page->GetData());
+  int index = leaf->LowerBound(key, comparator_);
+  bool found = index < leaf->GetSize() && comparator_(leaf->KeyAt(index), key) == 0;
+  if (found) {
+    leaf->RemoveAt(index);
+  }
+  Release(page, true, found);
+}
+
+/*****************************************************************************
+ * UTILITIES AND DEBUG
+ *****************************************************************************/
+/*
+ * Update/Insert root page id in header page(where page_id = 0, header_page is
+ * defined under include/page/header_page.h). Needs root_latch_.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+void BLINKTREE_TYPE::UpdateRootPageId(int insert_record) {
+  auto *header_page = static_cast<HeaderPage *>(buffer_pool_manager_->FetchPage(HEADER_PAGE_ID));
+  if (insert_record != 0) {
+    header_page->InsertRecord(index_name_, root_page_id_);
+  } else {
+    header_page->UpdateRecord(index_name_, root_page_id_);
+  }
+  buffer_pool_manager_->UnpinPage(HEADER_PAGE_ID, true);
+}
+
+template class BLinkTree<GenericKey<4>, RID, GenericComparator<4>>;
+template class BLinkTree<GenericKey<8>, RID, GenericComparator<8>>;
+template class BLinkTree<GenericKey<16>, RID, GenericComparator<16>>;
+template class BLinkTree<GenericKey<32>, RID, GenericComparator<32>>;
+template class BLinkTree<GenericKey<64>, RID, GenericComparator<64>>;
+
+}  // namespace bustub
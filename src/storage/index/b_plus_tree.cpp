@@ -1,3 +1,4 @@
+#include <algorithm>
 #include <string>
 
 #include "common/exception.h"
@@ -59,26 +60,7 @@ auto BPLUSTREE_TYPE::FindLeafPage(const KeyType &key, OperType op, Transaction *
   // 非叶节点
   while (!b_plus_tree_page->IsLeafPage()) {
     auto b_plus_internal_page = reinterpret_cast<InternalPage *>(b_plus_tree_page);
-    int index = 1;
-    int size = b_plus_internal_page->GetSize();
-    int comp = 0;
-    for (index = 1; index < size; ++index) {
-      comp = comparator_(key, b_plus_internal_page->KeyAt(index));
-      if (comp <= 0) {
-        break;
-      }
-    }
-    // key > k_m
-    if (index == size) {
-      index -= 1;
-    } else {
-      if (comp == -1) {
-        // key < k_i
-        index -= 1;
-      }
-      // key == k_i then find in P_i
-    }
-    auto page_id = b_plus_internal_page->ValueAt(index);
+    auto page_id = LookupChild(b_plus_internal_page, key);
     auto pre_page_id = b_plus_internal_page->GetPageId();
     // buffer_pool_manager_->UnpinPage(b_plus_internal_page->GetPageId(), false);
     b_plus_tree_page = GetBPlusTreePageWithLatch(page_id, op, pre_page_id, transaction);
@@ -89,6 +71,60 @@ auto BPLUSTREE_TYPE::FindLeafPage(const KeyType &key, OperType op, Transaction *
   return reinterpret_cast<LeafPage *>(b_plus_tree_page);
 }
 
+INDEX_TEMPLATE_ARGUMENTS
+auto BPLUSTREE_TYPE::LookupChild(InternalPage *b_plus_internal_page, const KeyType &key) -> page_id_t {
+  // k_i <= key < k_i+1 then find in P_i
+  int index = b_plus_internal_page->KeyIndex(key, comparator_);
+  return b_plus_internal_page->ValueAt(index);
+}
+
+/*
+ * Optimistic descent for a write: read latches on the inner nodes, released hand over hand, and a write latch on the
+ * leaf only. The caller may change the leaf only if that cannot change its parent, i.e. the leaf is safe; otherwise
+ * it has to unlatch the leaf and start over with the pessimistic descent of FindLeafPage.
+ * @return the pinned and write latched page of the leaf, nullptr if the tree is empty
+ */
+INDEX_TEMPLATE_ARGUMENTS
+auto BPLUSTREE_TYPE::FindLeafPageOptimistic(const KeyType &key) -> Page * {
+  // 根节点的读锁保证root_page_id_在拿到根节点的latch之前不会改变
+  root_latch_.RLock();
+  if (IsEmpty()) {
+    root_latch_.RUnlock();
+    return nullptr;
+  }
+  Page *page = buffer_pool_manager_->FetchPage(root_page_id_);
+  BUSTUB_ASSERT(page != nullptr, "Fetch page failed in BPlusTree.");
+  auto b_plus_tree_page = reinterpret_cast<BPlusTreePage *>(page->GetData());
+  // 修改根节点结构的写者持有root_latch_的写锁，因此根节点的类型不会改变
+  if (b_plus_tree_page->IsLeafPage()) {
+    page->WLatch();
+    root_latch_.RUnlock();
+    return page;
+  }
+  page->RLatch();
+  root_latch_.RUnlock();
+
+  while (true) {
+    auto b_plus_internal_page = reinterpret_cast<InternalPage *>(b_plus_tree_page);
+    Page *child = buffer_pool_manager_->FetchPage(LookupChild(b_plus_internal_page, key));
+    BUSTUB_ASSERT(child != nullptr, "Fetch page failed in BPlusTree.");
+    auto child_b_plus_tree_page = reinterpret_cast<BPlusTreePage *>(child->GetData());
+    // 父节点持有读锁，子节点的类型不会改变
+    if (child_b_plus_tree_page->IsLeafPage()) {
+      child->WLatch();
+    } else {
+      child->RLatch();
+    }
+    page->RUnlatch();
+    buffer_pool_manager_->UnpinPage(page->GetPageId(), false);
+    if (child_b_plus_tree_page->IsLeafPage()) {
+      return child;
+    }
+    page = child;
+    b_plus_tree_page = child_b_plus_tree_page;
+  }
+}
+
 INDEX_TEMPLATE_ARGUMENTS
 auto BPLUSTREE_TYPE::InsertInParent(BPlusTreePage *b_plus_tree_page, const KeyType &key,
                                     BPlusTreePage *new_b_plus_tree_page, Transaction *transaction) -> bool {
@@ -212,6 +248,23 @@ auto BPLUSTREE_TYPE::GetValue(const KeyType &key, std::vector<ValueType> *result
  */
 INDEX_TEMPLATE_ARGUMENTS
 auto BPLUSTREE_TYPE::Insert(const KeyType &key, const ValueType &value, Transaction *transaction) -> bool {
+  if (optimistic_latching_) {
+    auto page = FindLeafPageOptimistic(key);
+    if (page != nullptr) {
+      auto leaf_page = reinterpret_cast<LeafPage *>(page->GetData());
+      // 插入后叶子节点不会分裂，或者key重复不会插入，父节点都不受影响
+      if (leaf_page->IsSafe(OperType::INSERT) || leaf_page->KeyIndex(key, comparator_) != -1) {
+        auto res = leaf_page->Insert(key, value, comparator_);
+        page->WUnlatch();
+        buffer_pool_manager_->UnpinPage(page->GetPageId(), res);
+        return res;
+      }
+      page->WUnlatch();
+      buffer_pool_manager_->UnpinPage(page->GetPageId(), false);
+      optimistic_restarts_++;
+    }
+  }
+
   LeafPage *b_plus_leaf_page = nullptr;
   LockRoot(OperType::INSERT);
   if (IsEmpty()) {
@@ -261,6 +314,8 @@ auto BPLUSTREE_TYPE::Insert(const KeyType &key, const ValueType &value, Transact
       new_b_plus_leaf_page->Init(new_page_id, b_plus_leaf_page->GetParentPageId(), leaf_max_size_);
       new_b_plus_leaf_page->SetNextPageId(b_plus_leaf_page->GetNextPageId());
       b_plus_leaf_page->SetNextPageId(new_page_id);
+      leaf_chain_.Link(new_page_id, new_b_plus_leaf_page->GetNextPageId());
+      leaf_chain_.Link(b_plus_leaf_page->GetPageId(), new_page_id);
       auto max_size = data_copy.size();
       b_plus_leaf_page->SetSize(0);
       b_plus_leaf_page->CopyDataFrom(data_copy, 0, (max_size + 1) / 2);
@@ -284,6 +339,144 @@ auto BPLUSTREE_TYPE::Insert(const KeyType &key, const ValueType &value, Transact
   return false;
 }
 
+/*****************************************************************************
+ * BULK LOAD
+ *****************************************************************************/
+/*
+ * Build an empty tree bottom up from num_entries entries that next returns in
+ * strictly ascending key order, instead of inserting them one by one: the
+ * leaves are written left to right, and every new node hands its first key to
+ * the open node of the level above, which becomes its parent. No node splits
+ * and every page is written once.
+ * The number of nodes on each level is planned from num_entries up front:
+ * nodes are filled to fill_factor percent of their capacity, but at least to
+ * their minimum size, and the entries are spread evenly, so that no node but
+ * the root is left underfull, not even the last one of a level.
+ * Only the open node of every level, plus the previous leaf until the next
+ * one exists, stays pinned.
+ * @return: false if the tree is not empty
+ */
+INDEX_TEMPLATE_ARGUMENTS
+auto BPLUSTREE_TYPE::BulkLoad(size_t num_entries, const std::function<bool(KeyType *, ValueType *)> &next,
+                              int fill_factor) -> bool {
+  BUSTUB_ASSERT(fill_factor > 0 && fill_factor <= 100, "fill factor is a percentage");
+  LockRoot(OperType::INSERT);
+  if (!IsEmpty()) {
+    TryUnlockRoot(OperType::INSERT);
+    return false;
+  }
+  if (num_entries == 0) {
+    TryUnlockRoot(OperType::INSERT);
+    return true;
+  }
+
+  // a leaf splits once it reaches leaf_max_size_, an internal node once it exceeds internal_max_size_; below the
+  // minimum sizes of BPlusTreePage::GetMinSize() a node would be merged on the next remove
+  size_t leaf_capacity = std::max(leaf_max_size_ - 1, 1);
+  size_t internal_capacity = std::max(internal_max_size_, 2);
+  size_t leaf_min_size = std::max(leaf_max_size_ / 2, 1);
+  size_t internal_min_size = std::max((internal_max_size_ + 1) / 2, 2);
+  size_t leaf_fill = std::clamp<size_t>(leaf_capacity * fill_factor / 100, leaf_min_size, leaf_capacity);
+  size_t internal_fill =
+      std::clamp<size_t>(internal_capacity * fill_factor / 100, internal_min_size, internal_capacity);
+
+  // level 0 holds the leaves, the last level the root
+  std::vector<size_t> level_entries{num_entries};
+  std::vector<size_t> level_nodes;
+  while (true) {
+    auto entries = level_entries.back();
+    auto fill = level_nodes.empty() ? leaf_fill : internal_fill;
+    auto capacity = level_nodes.empty() ? leaf_capacity : internal_capacity;
+    level_nodes.push_back(std::max({entries / fill, (entries + capacity - 1) / capacity, size_t{1}}));
+    if (level_nodes.back() == 1) {
+      break;
+    }
+    level_entries.push_back(level_nodes.back());
+  }
+  auto height = level_nodes.size();
+
+  std::vector<Page *> open_pages(height, nullptr);
+  std::vector<size_t> opened_nodes(height, 0);
+  std::vector<std::vector<std::pair<KeyType, page_id_t>>> children(height);
+  std::vector<MappingType> leaf_entries;
+  // size of the open node of a level; the first nodes take one more entry if the entries do not divide evenly
+  auto node_size = [&](size_t level) {
+    auto entries = level_entries[level];
+    auto nodes = level_nodes[level];
+    return entries / nodes + (opened_nodes[level] - 1 < entries % nodes ? 1 : 0);
+  };
+
+  std::function<page_id_t(size_t, const KeyType &, page_id_t)> add_child;
+  auto open_node = [&](size_t level, const KeyType &first_key) -> Page * {
+    page_id_t page_id;
+    auto page = buffer_pool_manager_->NewPage(&page_id);
+    BUSTUB_ASSERT(page != nullptr, "create a page for B+tree failed.");
+    auto parent_page_id = INVALID_PAGE_ID;
+    if (level + 1 < height) {
+      parent_page_id = add_child(level + 1, first_key, page_id);
+    } else {
+      root_page_id_ = page_id;
+    }
+    if (level == 0) {
+      reinterpret_cast<LeafPage *>(page->GetData())->Init(page_id, parent_page_id, leaf_max_size_);
+    } else {
+      reinterpret_cast<InternalPage *>(page->GetData())->Init(page_id, parent_page_id, internal_max_size_);
+    }
+    opened_nodes[level]++;
+    return page;
+  };
+  auto close_internal_node = [&](size_t level) {
+    auto internal_page = reinterpret_cast<InternalPage *>(open_pages[level]->GetData());
+    internal_page->CopyDataFrom(children[level], 0, static_cast<int>(children[level].size()));
+    children[level].clear();
+    buffer_pool_manager_->UnpinPage(internal_page->GetPageId(), true);
+  };
+  // KEY(0) of an internal node is not used, it just carries the first key of the first child
+  add_child = [&](size_t level, const KeyType &key, page_id_t child_page_id) -> page_id_t {
+    if (open_pages[level] == nullptr || children[level].size() == node_size(level)) {
+      auto page = open_node(level, key);
+      if (open_pages[level] != nullptr) {
+        close_internal_node(level);
+      }
+      open_pages[level] = page;
+    }
+    children[level].emplace_back(key, child_page_id);
+    return open_pages[level]->GetPageId();
+  };
+
+  KeyType key;
+  ValueType value;
+  for (size_t i = 0; i < num_entries; ++i) {
+    [[maybe_unused]] bool has_next = next(&key, &value);
+    BUSTUB_ASSERT(has_next, "bulk load ran out of entries");
+    BUSTUB_ASSERT(leaf_entries.empty() || comparator_(leaf_entries.back().first, key) < 0,
+                  "bulk load entries are not in strictly ascending key order");
+    if (open_pages[0] == nullptr || leaf_entries.size() == node_size(0)) {
+      auto page = open_node(0, key);
+      if (open_pages[0] != nullptr) {
+        auto leaf_page = reinterpret_cast<LeafPage *>(open_pages[0]->GetData());
+        leaf_page->CopyDataFrom(leaf_entries, 0, static_cast<int>(leaf_entries.size()));
+        leaf_page->SetNextPageId(page->GetPageId());
+        leaf_chain_.Link(leaf_page->GetPageId(), page->GetPageId());
+        leaf_entries.clear();
+        buffer_pool_manager_->UnpinPage(leaf_page->GetPageId(), true);
+      }
+      open_pages[0] = page;
+    }
+    leaf_entries.emplace_back(key, value);
+  }
+
+  auto leaf_page = reinterpret_cast<LeafPage *>(open_pages[0]->GetData());
+  leaf_page->CopyDataFrom(leaf_entries, 0, static_cast<int>(leaf_entries.size()));
+  buffer_pool_manager_->UnpinPage(leaf_page->GetPageId(), true);
+  for (size_t level = 1; level < height; ++level) {
+    close_internal_node(level);
+  }
+  UpdateRootPageId(1);
+  TryUnlockRoot(OperType::INSERT);
+  return true;
+}
+
 /*****************************************************************************
  * REMOVE
  *****************************************************************************/
@@ -296,7 +489,31 @@ auto BPLUSTREE_TYPE::Insert(const KeyType &key, const ValueType &value, Transact
  */
 INDEX_TEMPLATE_ARGUMENTS
 void BPLUSTREE_TYPE::Remove(const KeyType &key, Transaction *transaction) {
+  if (optimistic_latching_) {
+    auto page = FindLeafPageOptimistic(key);
+    if (page == nullptr) {
+      return;
+    }
+    auto leaf_page = reinterpret_cast<LeafPage *>(page->GetData());
+    // 删除后叶子节点不会少于最小数量，或者key不存在，不需要合并或重新分配
+    auto exists = leaf_page->KeyIndex(key, comparator_) != -1;
+    if (!exists || leaf_page->IsSafe(OperType::DELETE)) {
+      if (exists) {
+        leaf_page->RemoveEntry(key, comparator_);
+      }
+      page->WUnlatch();
+      buffer_pool_manager_->UnpinPage(page->GetPageId(), exists);
+      return;
+    }
+    page->WUnlatch();
+    buffer_pool_manager_->UnpinPage(page->GetPageId(), false);
+    optimistic_restarts_++;
+  }
+
+  // 根节点可能被删除或替换，需要root_latch_的写锁
+  LockRoot(OperType::DELETE);
   if (IsEmpty()) {
+    TryUnlockRoot(OperType::DELETE);
     return;
   }
   // 此时leaf_page有写锁
@@ -421,6 +638,8 @@ auto BPLUSTREE_TYPE::Coalesce(BPlusTreePage *b_plus_tree_page, BPlusTreePage *ne
   right->MoveTo(left, key);
   if (left->IsLeafPage()) {
     reinterpret_cast<LeafPage *>(left)->SetNextPageId(reinterpret_cast<LeafPage *>(right)->GetNextPageId());
+    leaf_chain_.Link(left->GetPageId(), reinterpret_cast<LeafPage *>(right)->GetNextPageId());
+    leaf_chain_.Unlink(right->GetPageId());
   }
 
   if (!left->IsLeafPage()) {
@@ -472,7 +691,7 @@ auto BPLUSTREE_TYPE::Begin() -> INDEXITERATOR_TYPE {
   }
   auto b_plus_leaf_page = FindSmallestLeafPage(nullptr);
   TryUnlockRoot(OperType::READ);
-  return INDEXITERATOR_TYPE(buffer_pool_manager_, b_plus_leaf_page);
+  return INDEXITERATOR_TYPE(buffer_pool_manager_, b_plus_leaf_page, 0, false, &leaf_chain_);
 }
 
 /*
@@ -489,18 +708,12 @@ auto BPLUSTREE_TYPE::Begin(const KeyType &key) -> INDEXITERATOR_TYPE {
   }
   auto b_plus_leaf_page = FindLeafPage(key, OperType::READ, nullptr);
   TryUnlockRoot(OperType::READ);
-  int index = 0;
-  auto size = b_plus_leaf_page->GetSize();
-  for (; index < size; ++index) {
-    if (comparator_(key, b_plus_leaf_page->KeyAt(index)) == 0) {
-      break;
-    }
-  }
+  int index = b_plus_leaf_page->KeyIndex(key, comparator_);
   // key不存在
-  if (index == size) {
+  if (index == -1) {
     return End();
   }
-  return INDEXITERATOR_TYPE(buffer_pool_manager_, b_plus_leaf_page, index);
+  return INDEXITERATOR_TYPE(buffer_pool_manager_, b_plus_leaf_page, index, false, &leaf_chain_);
 }
 
 /*
@@ -0,0 +1,179 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// index_entry_sorter.cpp
+//
+// Identification: src/storage/index/index_entry_sorter.cpp
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <algorithm>
+
+#include "common/exception.h"
+#include "common/rid.h"
+#include "storage/index/generic_key.h"
+#include "storage/index/index_entry_sorter.h"
+
+namespace bustub {
+
+// bytes of every run that the merge reads at once
+static constexpr size_t RUN_BLOCK_SIZE = 16 * BUSTUB_PAGE_SIZE;
+
+INDEX_TEMPLATE_ARGUMENTS
+INDEX_ENTRY_SORTER_TYPE::IndexEntrySorter(const KeyComparator &comparator, size_t memory_budget)
+    : comparator_(comparator), buffer_capacity_(std::max<size_t>(memory_budget / sizeof(MappingType), 1)) {}
+
+INDEX_TEMPLATE_ARGUMENTS
+INDEX_ENTRY_SORTER_TYPE::~IndexEntrySorter() {
+  // temporary files are removed when closed
+  for (auto &run : runs_) {
+    std::fclose(run.file_);
+  }
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void INDEX_ENTRY_SORTER_TYPE::Add(const KeyType &key, const ValueType &value) {
+  BUSTUB_ASSERT(!finished_, "cannot add entries to a finished sort");
+  buffer_.emplace_back(key, value);
+  if (buffer_.size() >= buffer_capacity_) {
+    SpillRun();
+  }
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void INDEX_ENTRY_SORTER_TYPE::SortBuffer() {
+  // a stable sort keeps equal keys in insertion order, so that unique() keeps the first of them
+  std::stable_sort(buffer_.begin(), buffer_.end(), [this](const MappingType &left, const MappingType &right) {
+    return comparator_(left.first, right.first) < 0;
+  });
+  auto last = std::unique(buffer_.begin(), buffer_.end(), [this](const MappingType &left, const MappingType &right) {
+    return comparator_(left.first, right.first) == 0;
+  });
+  buffer_.erase(last, buffer_.end());
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void INDEX_ENTRY_SORTER_TYPE::SpillRun() {
+  SortBuffer();
+  std::FILE *file = std::tmpfile();
+  if (file == nullptr) {
+    throw Exception("cannot create a temporary file for an index build");
+  }
+  runs_.push_back({file, buffer_.size(), 0, {}, 0});
+  if (std::fwrite(buffer_.data(), sizeof(MappingType), buffer_.size(), file) != buffer_.size()) {
+    throw Exception("cannot write a sorted run of an index build");
+  }
+  buffer_.clear();
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void INDEX_ENTRY_SORTER_TYPE::Finish() {
+  BUSTUB_ASSERT(!finished_, "the sort is already finished");
+  finished_ = true;
+  if (runs_.empty()) {
+    SortBuffer();
+    num_entries_ = buffer_.size();
+    return;
+  }
+
+  if (!buffer_.empty()) {
+    SpillRun();
+  }
+  buffer_.shrink_to_fit();
+  // keys can repeat across runs, so counting takes a merge pass of its own
+  StartMerge();
+  KeyType key;
+  ValueType value;
+  while (MergeNext(&key, &value)) {
+    num_entries_++;
+  }
+  StartMerge();
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+auto INDEX_ENTRY_SORTER_TYPE::Next(KeyType *key, ValueType *value) -> bool {
+  BUSTUB_ASSERT(finished_, "finish the sort before reading it");
+  if (!runs_.empty()) {
+    return MergeNext(key, value);
+  }
+  if (buffer_pos_ == buffer_.size()) {
+    return false;
+  }
+  *key = buffer_[buffer_pos_].first;
+  *value = buffer_[buffer_pos_].second;
+  buffer_pos_++;
+  return true;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void INDEX_ENTRY_SORTER_TYPE::Refill(Run *run) {
+  auto count = std::min(std::max<size_t>(RUN_BLOCK_SIZE / sizeof(MappingType), 1), run->remaining_);
+  run->block_.resize(count);
+  if (std::fread(run->block_.data(), sizeof(MappingType), count, run->file_) != count) {
+    throw Exception("cannot read a sorted run of an index build");
+  }
+  run->remaining_ -= count;
+  run->pos_ = 0;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+auto INDEX_ENTRY_SORTER_TYPE::RunGreater(size_t left, size_t right) const -> bool {
+  auto cmp = comparator_(runs_[left].block_[runs_[left].pos_].first, runs_[right].block_[runs_[right].pos_].first);
+  return cmp > 0 || (cmp == 0 && left > right);
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void INDEX_ENTRY_SORTER_TYPE::StartMerge() {
+  heap_.clear();
+  for (size_t i = 0; i < runs_.size(); ++i) {
+    auto &run = runs_[i];
+    std::rewind(run.file_);
+    run.remaining_ = run.size_;
+    Refill(&run);
+    if (!run.block_.empty()) {
+      heap_.push_back(i);
+    }
+  }
+  std::make_heap(heap_.begin(), heap_.end(), [this](size_t left, size_t right) { return RunGreater(left, right); });
+  has_last_key_ = false;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+auto INDEX_ENTRY_SORTER_TYPE::MergeNext(KeyType *key, ValueType *value) -> bool {
+  auto greater = [this](size_t left, size_t right) { return RunGreater(left, right); };
+  while (!heap_.empty()) {
+    std::pop_heap(heap_.begin(), heap_.end(), greater);
+    auto &run = runs_[heap_.back()];
+    MappingType entry = run.block_[run.pos_++];
+    if (run.pos_ == run.block_.size()) {
+      Refill(&run);
+    }
+    if (run.block_.empty()) {
+      heap_.pop_back();
+    } else {
+      std::push_heap(heap_.begin(), heap_.end(), greater);
+    }
+
+    // a later run has the same key as an earlier one
+    if (has_last_key_ && comparator_(entry.first, last_key_) == 0) {
+      continue;
+    }
+    has_last_key_ = true;
+    last_key_ = entry.first;
+    *key = entry.first;
+    *value = entry.second;
+    return true;
+  }
+  return false;
+}
+
+template class IndexEntrySorter<GenericKey<4>, RID, GenericComparator<4>>;
+template class IndexEntrySorter<GenericKey<8>, RID, GenericComparator<8>>;
+template class IndexEntrySorter<GenericKey<16>, RID, GenericComparator<16>>;
+template class IndexEntrySorter<GenericKey<32>, RID, GenericComparator<32>>;
+template class IndexEntrySorter<GenericKey<64>, RID, GenericComparator<64>>;
+
+}  // namespace bustub
@@ -17,11 +17,16 @@ INDEXITERATOR_TYPE::IndexIterator() = default;
 
 INDEX_TEMPLATE_ARGUMENTS
 INDEXITERATOR_TYPE::IndexIterator(BufferPoolManager *buffer_pool_manager, LeafPage *current_leaf_page,
-                                  int current_index, bool is_end)
+                                  int current_index, bool is_end, LeafChain *leaf_chain)
     : buffer_pool_manager_(buffer_pool_manager),
       current_leaf_page_(current_leaf_page),
       current_index_(current_index),
-      is_end_(is_end) {}
+      is_end_(is_end),
+      leaf_chain_(leaf_chain) {
+  if (!is_end_ && current_leaf_page_ != nullptr) {
+    PrefetchLeaves();
+  }
+}
 
 INDEX_TEMPLATE_ARGUMENTS
 INDEXITERATOR_TYPE::~IndexIterator() = default;  // NOLINT
@@ -33,7 +38,8 @@ INDEX_TEMPLATE_ARGUMENTS
 auto INDEXITERATOR_TYPE::operator*() -> const MappingType & {
   BUSTUB_ASSERT(!IsEnd(), "Trying to access interator.end()");
   // LOG_INFO("current_index_: %d", current_index_);
-  return current_leaf_page_->GetKV(current_index_);
+  current_entry_ = current_leaf_page_->GetKV(current_index_);
+  return current_entry_;
 }
 
 INDEX_TEMPLATE_ARGUMENTS
@@ -62,9 +68,28 @@ auto INDEXITERATOR_TYPE::operator++() -> INDEXITERATOR_TYPE & {
   current_leaf_page_ = reinterpret_cast<LeafPage *>(new_page->GetData());
   // LOG_INFO("next_current_leaf_page size:%d", current_leaf_page_->GetSize());
   current_index_ = 0;
+  PrefetchLeaves();
   return *this;
 }
 
+INDEX_TEMPLATE_ARGUMENTS
+void INDEXITERATOR_TYPE::PrefetchLeaves() {
+  const size_t window = scan_prefetch_window;
+  if (window == 0) {
+    return;
+  }
+  // the current leaf is read-latched, so its sibling link cannot change under us
+  const page_id_t next_page_id = current_leaf_page_->GetNextPageId();
+  if (leaf_chain_ == nullptr) {
+    if (next_page_id != INVALID_PAGE_ID) {
+      buffer_pool_manager_->Prefetch(next_page_id);
+    }
+    return;
+  }
+  leaf_chain_->Link(current_leaf_page_->GetPageId(), next_page_id);
+  leaf_chain_->PrefetchAfter(buffer_pool_manager_, current_leaf_page_->GetPageId(), window);
+}
+
 INDEX_TEMPLATE_ARGUMENTS
 auto INDEXITERATOR_TYPE::operator==(const IndexIterator &itr) const -> bool {
   if (is_end_ && itr.is_end_) {
@@ -0,0 +1,40 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// leaf_chain.cpp
+//
+// Identification: src/storage/index/leaf_chain.cpp
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "storage/index/leaf_chain.h"
+
+namespace bustub {
+
+void LeafChain::Link(page_id_t leaf_page_id, page_id_t next_page_id) {
+  std::scoped_lock<std::mutex> lock(latch_);
+  next_leaf_[leaf_page_id] = next_page_id;
+}
+
+void LeafChain::Unlink(page_id_t leaf_page_id) {
+  std::scoped_lock<std::mutex> lock(latch_);
+  next_leaf_.erase(leaf_page_id);
+}
+
+void LeafChain::PrefetchAfter(BufferPoolManager *buffer_pool_manager, page_id_t leaf_page_id, size_t window) {
+  std::scoped_lock<std::mutex> lock(latch_);
+  auto page_id = leaf_page_id;
+  for (size_t i = 0; i < window; ++i) {
+    auto it = next_leaf_.find(page_id);
+    if (it == next_leaf_.end() || it->second == INVALID_PAGE_ID) {
+      return;
+    }
+    page_id = it->second;
+    buffer_pool_manager->Prefetch(page_id);
+  }
+}
+
+}  // namespace bustub
@@ -0,0 +1,113 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// b_link_tree_page.cpp
+//
+// Identification: src/storage/page/b_link_tree_page.cpp
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <algorithm>
+
+#include "common/rid.h"
+#include "storage/page/b_link_tree_page.h"
+
+namespace bustub {
+
+INDEX_TEMPLATE_ARGUMENTS
+void B_LINK_TREE_PAGE_TYPE::Init(page_id_t page_id, int level, int max_size) {
+  SetPageType(level == 0 ? IndexPageType::LEAF_PAGE : IndexPageType::INTERNAL_PAGE);
+  SetPageId(page_id);
+  SetParentPageId(INVALID_PAGE_ID);
+  SetMaxSize(max_size);
+  SetSize(0);
+  SetLSN();
+  right_page_id_ = INVALID_PAGE_ID;
+  level_ = level;
+  has_high_key_ = 0;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+auto B_LINK_TREE_PAGE_TYPE::IsBeyond(const KeyType &key, const KeyComparator &comparator) const -> bool {
+  return has_high_key_ != 0 && comparator(key, high_key_) >= 0;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+auto B_LINK_TREE_PAGE_TYPE::LowerBound(const KeyType &key, const KeyComparator &comparator, int first) const
+    -> int {
+  int low = first;
+  int high = GetSize();
+  while (low < high) {
+    int mid = low + (high - low) / 2;
+    if (comparator(array_[mid].first, key) < 0) {
+      low = mid + 1;
+    } else {
+      high = mid;
+    }
+  }
+  return low;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+auto B_LINK_TREE_PAGE_TYPE::LookupChild(const KeyType &key, const KeyComparator &comparator) const -> ValueType {
+  // the last entry whose key is not greater than key; KEY(0) stands for the low end of the node
+  int low = 1;
+  int high = GetSize();
+  while (low < high) {
+    int mid = low + (high - low) / 2;
+    if (comparator(array_[mid].first, key) <= 0) {
+      low = mid + 1;
+    } else {
+      high = mid;
+    }
+  }
+  return array_[low - 1].second;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void B_LINK_TREE_PAGE_TYPE::InsertAt(int index, const KeyType &key, const ValueType &value) {
+  std::move_backward(array_ + index, array_ + GetSize(), array_ + GetSize() + 1);
+  array_[index] = {key, value};
+  IncreaseSize(1);
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void B_LINK_TREE_PAGE_TYPE::RemoveAt(int index) {
+  std::move(array_ + index + 1, array_ + GetSize(), array_ + index);
+  IncreaseSize(-1);
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+auto B_LINK_TREE_PAGE_TYPE::MoveHalfTo(B_LINK_TREE_PAGE_TYPE *recipient) -> KeyType {
+  int size = GetSize();
+  int keep = size / 2;
+  std::copy(array_ + keep, array_ + size, recipient->array_);
+  recipient->SetSize(size - keep);
+  SetSize(keep);
+
+  recipient->right_page_id_ = right_page_id_;
+  recipient->has_high_key_ = has_high_key_;
+  recipient->high_key_ = high_key_;
+  right_page_id_ = recipient->GetPageId();
+  has_high_key_ = 1;
+  high_key_ = recipient->array_[0].first;
+  return high_key_;
+}
+
+template class BLinkTreePage<GenericKey<4>, RID, GenericComparator<4>>;
+template class BLinkTreePage<GenericKey<8>, RID, GenericComparator<8>>;
+template class BLinkTreePage<GenericKey<16>, RID, GenericComparator<16>>;
+template class BLinkTreePage<GenericKey<32>, RID, GenericComparator<32>>;
+template class BLinkTreePage<GenericKey<64>, RID, GenericComparator<64>>;
+
+// valuetype for internal nodes should be page_id_t
+template class BLinkTreePage<GenericKey<4>, page_id_t, GenericComparator<4>>;
+template class BLinkTreePage<GenericKey<8>, page_id_t, GenericComparator<8>>;
+template class BLinkTreePage<GenericKey<16>, page_id_t, GenericComparator<16>>;
+template class BLinkTreePage<GenericKey<32>, page_id_t, GenericComparator<32>>;
+template class BLinkTreePage<GenericKey<64>, page_id_t, GenericComparator<64>>;
+
+}  // namespace bustub
@@ -9,6 +9,7 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include <algorithm>
 #include <iostream>
 #include <sstream>
 
@@ -39,18 +40,18 @@ void B_PLUS_TREE_INTERNAL_PAGE_TYPE::Init(page_id_t page_id, page_id_t parent_id
 INDEX_TEMPLATE_ARGUMENTS
 auto B_PLUS_TREE_INTERNAL_PAGE_TYPE::KeyAt(int index) const -> KeyType {
   // replace with your own code
-  return array_[index].first;
+  return keys_[index];
 }
 
 INDEX_TEMPLATE_ARGUMENTS
-void B_PLUS_TREE_INTERNAL_PAGE_TYPE::SetKeyAt(int index, const KeyType &key) { array_[index].first = key; }
+void B_PLUS_TREE_INTERNAL_PAGE_TYPE::SetKeyAt(int index, const KeyType &key) { keys_[index] = key; }
 
 /*
  * Helper method to get the value associated with input "index"(a.k.a array
  * offset)
  */
 INDEX_TEMPLATE_ARGUMENTS
-auto B_PLUS_TREE_INTERNAL_PAGE_TYPE::ValueAt(int index) const -> ValueType { return array_[index].second; }
+auto B_PLUS_TREE_INTERNAL_PAGE_TYPE::ValueAt(int index) const -> ValueType { return values_[index]; }
 
 INDEX_TEMPLATE_ARGUMENTS
 auto B_PLUS_TREE_INTERNAL_PAGE_TYPE::Insert(const KeyType &key, const ValueType &value, const KeyComparator &comparator,
@@ -58,27 +59,22 @@ auto B_PLUS_TREE_INTERNAL_PAGE_TYPE::Insert(const KeyType &key, const ValueType
   int size = GetSize();
   if (position == -1) {
     // 按key插入
-    int index = 1;
-    for (; index < size; ++index) {
-      auto comp = comparator(key, array_[index].first);
-      if (comp == 0) {
-        return false;
-      }
-      if (comp == -1) {
-        break;
-      }
+    int index = LowerBound(key, comparator);
+    if (index < size && comparator(key, keys_[index]) == 0) {
+      return false;
     }
-
-    // BaseAddr = array_+1
-    std::move_backward(array_ + index - 1, array_ + size, array_ + size + 1);
-    array_[index] = std::make_pair(key, value);
+    std::move_backward(keys_ + index, keys_ + size, keys_ + size + 1);
+    std::move_backward(values_ + index, values_ + size, values_ + size + 1);
+    keys_[index] = key;
+    values_[index] = value;
     IncreaseSize(1);
     return true;
   }
 
   // 在末尾插入
   BUSTUB_ASSERT(position == size, "Wrong insert position In internal node insert.");
-  array_[position] = std::make_pair(key, value);
+  keys_[position] = key;
+  values_[position] = value;
   IncreaseSize(1);
   return true;
 }
@@ -86,24 +82,19 @@ auto B_PLUS_TREE_INTERNAL_PAGE_TYPE::Insert(const KeyType &key, const ValueType
 INDEX_TEMPLATE_ARGUMENTS
 auto B_PLUS_TREE_INTERNAL_PAGE_TYPE::GetDataCopy(std::vector<MappingType> &data_copy, const KeyType &key,
                                                  const ValueType &value, const KeyComparator &comparator) -> bool {
-  data_copy[0] = array_[0];
-  int i = 1;
   int size = GetSize();
   // 找到插入位置
-  for (; i < size; ++i) {
-    auto comp = comparator(key, array_[i].first);
-    if (comp == 0) {
-      // 重复key
-      return false;
-    }
-    if (comp == -1) {
-      break;
-    }
-    data_copy[i] = array_[i];
+  int index = LowerBound(key, comparator);
+  if (index < size && comparator(key, keys_[index]) == 0) {
+    // 重复key
+    return false;
+  }
+  for (int i = 0; i < index; ++i) {
+    data_copy[i] = {keys_[i], values_[i]};
   }
-  data_copy[i] = std::make_pair(key, value);
-  for (; i < size; ++i) {
-    data_copy[i + 1] = array_[i];
+  data_copy[index] = std::make_pair(key, value);
+  for (int i = index; i < size; ++i) {
+    data_copy[i + 1] = {keys_[i], values_[i]};
   }
   return true;
 }
@@ -112,43 +103,31 @@ INDEX_TEMPLATE_ARGUMENTS
 auto B_PLUS_TREE_INTERNAL_PAGE_TYPE::CopyDataFrom(std::vector<MappingType> &data_copy, int first, int last) -> void {
   auto amount = last - first;
   for (int i = 0; i < amount; ++i) {
-    array_[i] = data_copy[first + i];
+    keys_[i] = data_copy[first + i].first;
+    values_[i] = data_copy[first + i].second;
   }
   IncreaseSize(amount);
 }
 
 INDEX_TEMPLATE_ARGUMENTS
 auto B_PLUS_TREE_INTERNAL_PAGE_TYPE::RemoveEntry(const KeyType &key, const KeyComparator &comparator) -> void {
-  int index = 1;
   auto size = GetSize();
-  for (; index < size; ++index) {
-    if (comparator(key, array_[index].first) == 0) {
-      break;
-    }
-  }
-  if (index == size) {
+  int index = LowerBound(key, comparator);
+  if (index >= size || comparator(key, keys_[index]) != 0) {
     // key doesn't exits;
     return;
   }
-  if (index < size - 1) {
-    std::move(array_ + index + 1, array_ + size, array_ + index);
-  }
+  std::move(keys_ + index + 1, keys_ + size, keys_ + index);
+  std::move(values_ + index + 1, values_ + size, values_ + index);
   IncreaseSize(-1);
 }
 
 INDEX_TEMPLATE_ARGUMENTS
-auto B_PLUS_TREE_INTERNAL_PAGE_TYPE::KeyIndex(const KeyType &key, const KeyComparator &comparator) -> int {
-  int index = 1;
-  auto size = GetSize();
-  int comp;
-  for (; index < size; ++index) {
-    comp = comparator(key, array_[index].first);
-    if (comp < 0) {
-      return index - 1;
-    }
-    if (comp == 0) {
-      return index;
-    }
+auto B_PLUS_TREE_INTERNAL_PAGE_TYPE::KeyIndex(const KeyType &key, const KeyComparator &comparator) const -> int {
+  // the child whose range holds key: the last valid key not greater than key, or the first child
+  int index = LowerBound(key, comparator);
+  if (index < GetSize() && comparator(key, keys_[index]) == 0) {
+    return index;
   }
   return index - 1;
 }
@@ -157,19 +136,22 @@ INDEX_TEMPLATE_ARGUMENTS
 auto B_PLUS_TREE_INTERNAL_PAGE_TYPE::MoveFirstToEnd(B_PLUS_TREE_INTERNAL_PAGE_TYPE *b_plus_leaf_page,
                                                     const KeyType &key) -> void {
   auto size = b_plus_leaf_page->GetSize();
-  b_plus_leaf_page->array_[size] = array_[0];
-  b_plus_leaf_page->array_[size].first = key;
+  b_plus_leaf_page->keys_[size] = key;
+  b_plus_leaf_page->values_[size] = values_[0];
   b_plus_leaf_page->IncreaseSize(1);
-  std::move(array_ + 1, array_ + GetSize(), array_);
+  std::move(keys_ + 1, keys_ + GetSize(), keys_);
+  std::move(values_ + 1, values_ + GetSize(), values_);
   IncreaseSize(-1);
 }
 
 INDEX_TEMPLATE_ARGUMENTS
 auto B_PLUS_TREE_INTERNAL_PAGE_TYPE::MoveLastToFront(B_PLUS_TREE_INTERNAL_PAGE_TYPE *b, const KeyType &key) -> void {
   auto size = b->GetSize();
-  std::move_backward(b->array_, b->array_ + size, b->array_ + size + 1);
-  b->array_[0] = array_[GetSize() - 1];
-  (b->array_ + 1)->first = key;
+  std::move_backward(b->keys_, b->keys_ + size, b->keys_ + size + 1);
+  std::move_backward(b->values_, b->values_ + size, b->values_ + size + 1);
+  b->keys_[0] = keys_[GetSize() - 1];
+  b->values_[0] = values_[GetSize() - 1];
+  b->keys_[1] = key;
   b->IncreaseSize(1);
   IncreaseSize(-1);
 }
@@ -178,10 +160,9 @@ INDEX_TEMPLATE_ARGUMENTS
 auto B_PLUS_TREE_INTERNAL_PAGE_TYPE::MoveTo(B_PLUS_TREE_INTERNAL_PAGE_TYPE *left, const KeyType &key) -> void {
   auto size = GetSize();
   auto l_size = left->GetSize();
-  for (int i = 0; i < size; ++i) {
-    left->array_[l_size + i] = array_[i];
-  }
-  left->array_[l_size].first = key;
+  std::copy(keys_, keys_ + size, left->keys_ + l_size);
+  std::copy(values_, values_ + size, left->values_ + l_size);
+  left->keys_[l_size] = key;
   left->IncreaseSize(size);
   IncreaseSize(-size);
 }
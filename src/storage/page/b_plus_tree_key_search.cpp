@@ -0,0 +1,214 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// b_plus_tree_key_search.cpp
+//
+// Identification: src/storage/page/b_plus_tree_key_search.cpp
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+
+#include "storage/page/b_plus_tree_key_search.h"
+
+#if defined(__x86_64__) && defined(__GNUC__)
+#include <immintrin.h>
+#define BUSTUB_KEY_SEARCH_SIMD
+#endif
+
+namespace bustub {
+
+namespace {
+
+// the binary search stops at this many keys, which are then compared all at once
+constexpr int SEARCH_WINDOW_32 = 64;
+constexpr int SEARCH_WINDOW_64 = 32;
+
+// A normalized key read as a native integer. Flipping the sign bit lets signed comparisons, the only ones SIMD has
+// for every lane width, order the keys like memcmp.
+auto LoadKey32(const char *key) -> int32_t {
+  uint32_t value;
+  memcpy(&value, key, sizeof(value));
+  return static_cast<int32_t>(__builtin_bswap32(value) ^ (uint32_t{1} << 31));
+}
+
+auto LoadKey64(const char *key) -> int64_t {
+  uint64_t value;
+  memcpy(&value, key, sizeof(value));
+  return static_cast<int64_t>(__builtin_bswap64(value) ^ (uint64_t{1} << 63));
+}
+
+// Binary search until at most window keys are left in [*low, *high), which then holds the lower bound: the keys
+// before *low are less than target, those from *high on are not.
+template <typename Int, Int (*Load)(const char *)>
+void Narrow(const char *keys, Int target, int window, int *low, int *high) {
+  while (*high - *low > window) {
+    int mid = *low + (*high - *low) / 2;
+    if (Load(keys + mid * sizeof(Int)) < target) {
+      *low = mid + 1;
+    } else {
+      *high = mid;
+    }
+  }
+}
+
+// The first key from index on that is not less than target, or high.
+template <typename Int, Int (*Load)(const char *)>
+auto Scan(const char *keys, Int target, int index, int high) -> int {
+  while (index < high && Load(keys + index * sizeof(Int)) < target) {
+    index++;
+  }
+  return index;
+}
+
+template <typename Int, Int (*Load)(const char *)>
+auto LowerBoundScalar(const char *keys, int size, Int target) -> int {
+  int low = 0;
+  int high = size;
+  Narrow<Int, Load>(keys, target, 0, &low, &high);
+  return low;
+}
+
+#ifdef BUSTUB_KEY_SEARCH_SIMD
+
+// Within the window the keys are sorted, so the lanes that are less than the target come first and their count is
+// the position of the lower bound in the vector.
+
+__attribute__((target("sse4.2"))) auto LowerBound32Sse42(const char *keys, int size, int32_t target) -> int {
+  int low = 0;
+  int high = size;
+  Narrow<int32_t, LoadKey32>(keys, target, SEARCH_WINDOW_32, &low, &high);
+  const __m128i bswap = _mm_setr_epi8(3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12);
+  const __m128i sign = _mm_set1_epi32(INT32_MIN);
+  const __m128i needle = _mm_set1_epi32(target);
+  int index = low;
+  for (; index + 4 <= high; index += 4) {
+    __m128i lanes = _mm_loadu_si128(reinterpret_cast<const __m128i *>(keys + index * 4));
+    lanes = _mm_xor_si128(_mm_shuffle_epi8(lanes, bswap), sign);
+    auto mask = _mm_movemask_ps(_mm_castsi128_ps(_mm_cmpgt_epi32(needle, lanes)));
+    if (mask != 0xF) {
+      return index + __builtin_popcount(mask);
+    }
+  }
+  return Scan<int32_t, LoadKey32>(keys, target, index, high);
+}
+
+__attribute__((target("sse4.2"))) auto LowerBound64Sse42(const char *keys, int size, int64_t target) -> int {
+  int low = 0;
+  int high = size;
+  Narrow<int64_t, LoadKey64>(keys, target, SEARCH_WINDOW_64, &low, &high);
+  const __m128i bswap = _mm_setr_epi8(7, 6, 5, 4, 3, 2, 1, 0, 15, 14, 13, 12, 11, 10, 9, 8);
+  const __m128i sign = _mm_set1_epi64x(INT64_MIN);
+  const __m128i needle = _mm_set1_epi64x(target);
+  int index = low;
+  for (; index + 2 <= high; index += 2) {
+    __m128i lanes = _mm_loadu_si128(reinterpret_cast<const __m128i *>(keys + index * 8));
+    lanes = _mm_xor_si128(_mm_shuffle_epi8(lanes, bswap), sign);
+    auto mask = _mm_movemask_pd(_mm_castsi128_pd(_mm_cmpgt_epi64(needle, lanes)));
+    if (mask != 0x3) {
+      return index + __builtin_popcount(mask);
+    }
+  }
+  return Scan<int64_t, LoadKey64>(keys, target, index, high);
+}
+
+__attribute__((target("avx2"))) auto LowerBound32Avx2(const char *keys, int size, int32_t target) -> int {
+  int low = 0;
+  int high = size;
+  Narrow<int32_t, LoadKey32>(keys, target, SEARCH_WINDOW_32, &low, &high);
+  // the byte shuffle works within each 128 bit half
+  const __m256i bswap = _mm256_setr_epi8(3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12, 3, 2, 1, 0, 7, 6, 5, 4,
+                                         11, 10, 9, 8, 15, 14, 13, 12);
+  const __m256i sign = _mm256_set1_epi32(INT32_MIN);
+  const __m256i needle = _mm256_set1_epi32(target);
+  int index = low;
+  for (; index + 8 <= high; index += 8) {
+    __m256i lanes = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(keys + index * 4));
+    lanes = _mm256_xor_si256(_mm256_shuffle_epi8(lanes, bswap), sign);
+    auto mask = _mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpgt_epi32(needle, lanes)));
+    if (mask != 0xFF) {
+      return index + __builtin_popcount(mask);
+    }
+  }
+  return Scan<int32_t, LoadKey32>(keys, target, index, high);
+}
+
+__attribute__((target("avx2"))) auto LowerBound64Avx2(const char *keys, int size, int64_t target) -> int {
+  int low = 0;
+  int high = size;
+  Narrow<int64_t, LoadKey64>(keys, target, SEARCH_WINDOW_64, &low, &high);
+  const __m256i bswap = _mm256_setr_epi8(7, 6, 5, 4, 3, 2, 1, 0, 15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1, 0,
+                                         15, 14, 13, 12, 11, 10, 9, 8);
+  const __m256i sign = _mm256_set1_epi64x(INT64_MIN);
+  const __m256i needle = _mm256_set1_epi64x(target);
+  int index = low;
+  for (; index + 4 <= high; index += 4) {
+    __m256i lanes = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(keys + index * 8));
+    lanes = _mm256_xor_si256(_mm256_shuffle_epi8(lanes, bswap), sign);
+    auto mask = _mm256_movemask_pd(_mm256_castsi256_pd(_mm256_cmpgt_epi64(needle, lanes)));
+    if (mask != 0xF) {
+      return index + __builtin_popcount(mask);
+    }
+  }
+  return Scan<int64_t, LoadKey64>(keys, target, index, high);
+}
+
+#endif
+
+auto SupportedKeySearchIsa() -> KeySearchIsa {
+#ifdef BUSTUB_KEY_SEARCH_SIMD
+  // this runs during static initialization, possibly before the CPU model is set up by the runtime
+  __builtin_cpu_init();
+  if (__builtin_cpu_supports("avx2") != 0) {
+    return KeySearchIsa::AVX2;
+  }
+  if (__builtin_cpu_supports("sse4.2") != 0) {
+    return KeySearchIsa::SSE42;
+  }
+#endif
+  return KeySearchIsa::SCALAR;
+}
+
+const KeySearchIsa SUPPORTED_KEY_SEARCH_ISA = SupportedKeySearchIsa();
+std::atomic<KeySearchIsa> key_search_isa{SUPPORTED_KEY_SEARCH_ISA};
+
+}  // namespace
+
+auto GetKeySearchIsa() -> KeySearchIsa { return key_search_isa.load(std::memory_order_relaxed); }
+
+void SetKeySearchIsa(KeySearchIsa isa) { key_search_isa = std::min(isa, SUPPORTED_KEY_SEARCH_ISA); }
+
+auto LowerBoundNormalized32(const char *keys, int size, const char *key) -> int {
+  auto target = LoadKey32(key);
+  switch (GetKeySearchIsa()) {
+#ifdef BUSTUB_KEY_SEARCH_SIMD
+    case KeySearchIsa::AVX2:
+      return LowerBound32Avx2(keys, size, target);
+    case KeySearchIsa::SSE42:
+      return LowerBound32Sse42(keys, size, target);
+#endif
+    default:
+      return LowerBoundScalar<int32_t, LoadKey32>(keys, size, target);
+  }
+}
+
+auto LowerBoundNormalized64(const char *keys, int size, const char *key) -> int {
+  auto target = LoadKey64(key);
+  switch (GetKeySearchIsa()) {
+#ifdef BUSTUB_KEY_SEARCH_SIMD
+    case KeySearchIsa::AVX2:
+      return LowerBound64Avx2(keys, size, target);
+    case KeySearchIsa::SSE42:
+      return LowerBound64Sse42(keys, size, target);
+#endif
+    default:
+      return LowerBoundScalar<int64_t, LoadKey64>(keys, size, target);
+  }
+}
+
+}  // namespace bustub
@@ -9,6 +9,7 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include <algorithm>
 #include <cstring>
 #include <sstream>
 
@@ -54,33 +55,31 @@ void B_PLUS_TREE_LEAF_PAGE_TYPE::SetNextPageId(page_id_t next_page_id) { next_pa
 INDEX_TEMPLATE_ARGUMENTS
 auto B_PLUS_TREE_LEAF_PAGE_TYPE::KeyAt(int index) const -> KeyType {
   // replace with your own code
-  return array_[index].first;
+  return keys_[index];
 }
 
 INDEX_TEMPLATE_ARGUMENTS
-auto B_PLUS_TREE_LEAF_PAGE_TYPE::GetKV(int index) -> const MappingType & {
+auto B_PLUS_TREE_LEAF_PAGE_TYPE::GetKV(int index) const -> MappingType {
   // LOG_INFO("current_index_: %d, size:%d", index, GetSize());
   // BUSTUB_ASSERT(index < GetSize(), "wrong index in leaf Get KV_pair");
-  return array_[index];
+  return {keys_[index], values_[index]};
 }
 
 INDEX_TEMPLATE_ARGUMENTS
 auto B_PLUS_TREE_LEAF_PAGE_TYPE::GetValue(const KeyType &key, std::vector<ValueType> *result,
                                           const KeyComparator &keyComparator) -> bool {
-  for (int i = 0; i < GetSize(); ++i) {
-    if (keyComparator(key, array_[i].first) == 0) {
-      result->push_back(array_[i].second);
-    }
+  auto index = KeyIndex(key, keyComparator);
+  if (index != -1) {
+    result->push_back(values_[index]);
   }
   return !result->empty();
 }
 
 INDEX_TEMPLATE_ARGUMENTS
 auto B_PLUS_TREE_LEAF_PAGE_TYPE::KeyIndex(const KeyType &key, const KeyComparator &comparator) const -> int {
-  for (int i = 0; i < GetSize(); ++i) {
-    if (comparator(key, array_[i].first) == 0) {
-      return i;
-    }
+  auto index = LowerBound(key, comparator);
+  if (index < GetSize() && comparator(key, keys_[index]) == 0) {
+    return index;
   }
   return -1;
 }
@@ -88,23 +87,17 @@ auto B_PLUS_TREE_LEAF_PAGE_TYPE::KeyIndex(const KeyType &key, const KeyComparato
 INDEX_TEMPLATE_ARGUMENTS
 auto B_PLUS_TREE_LEAF_PAGE_TYPE::Insert(const KeyType &key, const ValueType &value, const KeyComparator &comparator)
     -> bool {
-  int i = 0;
   int size = GetSize();
   // 找到插入位置
-  for (; i < size; ++i) {
-    auto comp = comparator(key, array_[i].first);
-    if (comp == 0) {
-      // 重复key
-      return false;
-    }
-    if (comp == -1) {
-      break;
-    }
+  int i = LowerBound(key, comparator);
+  if (i < size && comparator(key, keys_[i]) == 0) {
+    // 重复key
+    return false;
   }
-  // TODO(me): memcpy?
-  std::move_backward(array_ + i, array_ + size, array_ + size + 1);
-  array_[i].first = key;
-  array_[i].second = value;
+  std::move_backward(keys_ + i, keys_ + size, keys_ + size + 1);
+  std::move_backward(values_ + i, values_ + size, values_ + size + 1);
+  keys_[i] = key;
+  values_[i] = value;
   IncreaseSize(1);
   return true;
 }
@@ -112,11 +105,9 @@ auto B_PLUS_TREE_LEAF_PAGE_TYPE::Insert(const KeyType &key, const ValueType &val
 INDEX_TEMPLATE_ARGUMENTS
 auto B_PLUS_TREE_LEAF_PAGE_TYPE::GetDataCopy(std::vector<MappingType> &data_copy, const KeyComparator &comparator)
     -> bool {
-  int i = 0;
   int size = GetSize();
-  // 找到插入位置
-  for (; i < size; ++i) {
-    data_copy[i] = array_[i];
+  for (int i = 0; i < size; ++i) {
+    data_copy[i] = {keys_[i], values_[i]};
   }
   return true;
 }
@@ -125,50 +116,49 @@ INDEX_TEMPLATE_ARGUMENTS
 auto B_PLUS_TREE_LEAF_PAGE_TYPE::CopyDataFrom(std::vector<MappingType> &data_copy, int first, int last) -> void {
   auto amount = last - first;
   for (int i = 0; i < amount; ++i) {
-    array_[i] = data_copy[first + i];
+    keys_[i] = data_copy[first + i].first;
+    values_[i] = data_copy[first + i].second;
   }
   IncreaseSize(amount);
 }
 
 INDEX_TEMPLATE_ARGUMENTS
 auto B_PLUS_TREE_LEAF_PAGE_TYPE::RemoveEntry(const KeyType &key, const KeyComparator &comparator) -> void {
-  int index = 0;
   auto size = GetSize();
-  for (; index < size; ++index) {
-    if (comparator(key, array_[index].first) == 0) {
-      break;
-    }
-  }
-  if (index == size) {
+  auto index = KeyIndex(key, comparator);
+  if (index == -1) {
     return;
   }
-  if (index < size - 1) {
-    std::move(array_ + index + 1, array_ + size, array_ + index);
-  }
+  std::move(keys_ + index + 1, keys_ + size, keys_ + index);
+  std::move(values_ + index + 1, values_ + size, values_ + index);
   IncreaseSize(-1);
 }
 
 INDEX_TEMPLATE_ARGUMENTS
 auto B_PLUS_TREE_LEAF_PAGE_TYPE::ValueAt(int index) const -> ValueType {
   BUSTUB_ASSERT(index < GetSize(), "index > GetSize()");
-  return array_[index].second;
+  return values_[index];
 }
 
 INDEX_TEMPLATE_ARGUMENTS
 auto B_PLUS_TREE_LEAF_PAGE_TYPE::MoveFirstToEnd(B_PLUS_TREE_LEAF_PAGE_TYPE *b_plus_leaf_page, const KeyType &key)
     -> void {
   auto size = b_plus_leaf_page->GetSize();
-  b_plus_leaf_page->array_[size] = array_[0];
+  b_plus_leaf_page->keys_[size] = keys_[0];
+  b_plus_leaf_page->values_[size] = values_[0];
   b_plus_leaf_page->IncreaseSize(1);
-  std::move(array_ + 1, array_ + GetSize(), array_);
+  std::move(keys_ + 1, keys_ + GetSize(), keys_);
+  std::move(values_ + 1, values_ + GetSize(), values_);
   IncreaseSize(-1);
 }
 
 INDEX_TEMPLATE_ARGUMENTS
 auto B_PLUS_TREE_LEAF_PAGE_TYPE::MoveLastToFront(B_PLUS_TREE_LEAF_PAGE_TYPE *b, const KeyType &key) -> void {
   auto size = b->GetSize();
-  std::move_backward(b->array_, (b->array_) + size, (b->array_) + (size + 1));
-  b->array_[0] = array_[GetSize() - 1];
+  std::move_backward(b->keys_, b->keys_ + size, b->keys_ + size + 1);
+  std::move_backward(b->values_, b->values_ + size, b->values_ + size + 1);
+  b->keys_[0] = keys_[GetSize() - 1];
+  b->values_[0] = values_[GetSize() - 1];
   b->IncreaseSize(1);
   IncreaseSize(-1);
 }
@@ -177,9 +167,8 @@ INDEX_TEMPLATE_ARGUMENTS
 auto B_PLUS_TREE_LEAF_PAGE_TYPE::MoveTo(B_PLUS_TREE_LEAF_PAGE_TYPE *left, const KeyType &key) -> void {
   auto size = GetSize();
   auto l_size = left->GetSize();
-  for (int i = 0; i < size; ++i) {
-    left->array_[l_size + i] = array_[i];
-  }
+  std::copy(keys_, keys_ + size, left->keys_ + l_size);
+  std::copy(values_, values_ + size, left->values_ + l_size);
   left->IncreaseSize(size);
   IncreaseSize(-size);
 }
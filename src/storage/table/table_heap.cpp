@@ -23,7 +23,9 @@ TableHeap::TableHeap(BufferPoolManager *buffer_pool_manager, LockManager *lock_m
     : buffer_pool_manager_(buffer_pool_manager),
       lock_manager_(lock_manager),
       log_manager_(log_manager),
-      first_page_id_(first_page_id) {}
+      first_page_id_(first_page_id),
+      page_ids_{first_page_id},
+      page_index_{{first_page_id, 0}} {}
 
 TableHeap::TableHeap(BufferPoolManager *buffer_pool_manager, LockManager *lock_manager, LogManager *log_manager,
                      Transaction *txn)
@@ -33,16 +35,24 @@ TableHeap::TableHeap(BufferPoolManager *buffer_pool_manager, LockManager *lock_m
   BUSTUB_ASSERT(first_page != nullptr,
                 "Couldn't create a page for the table heap. Have you completed the buffer pool manager project?");
   first_page->Init(first_page_id_, BUSTUB_PAGE_SIZE, INVALID_LSN, log_manager_, txn);
+  page_ids_.push_back(first_page_id_);
+  page_index_[first_page_id_] = 0;
   buffer_pool_manager_->UnpinPage(first_page_id_, true);
 }
 
-auto TableHeap::InsertTuple(const Tuple &tuple, RID *rid, Transaction *txn) -> bool {
+auto TableHeap::InsertTuple(const Tuple &tuple, RID *rid, Transaction *txn, BufferAccessStrategy *strategy) -> bool {
   if (tuple.size_ + 32 > BUSTUB_PAGE_SIZE) {  // larger than one page size
     txn->SetState(TransactionState::ABORTED);
     return false;
   }
 
-  auto cur_page = static_cast<TablePage *>(buffer_pool_manager_->FetchPage(first_page_id_));
+  page_id_t start_page_id = first_page_id_;
+  if (strategy != nullptr) {
+    // a bulk insert appends; rescanning the whole table for holes would cycle it through the strategy's ring
+    std::scoped_lock<std::mutex> lock(page_ids_latch_);
+    start_page_id = page_ids_.back();
+  }
+  auto cur_page = FetchTablePage(start_page_id, strategy);
   if (cur_page == nullptr) {
     txn->SetState(TransactionState::ABORTED);
     return false;
@@ -56,7 +66,7 @@ auto TableHeap::InsertTuple(const Tuple &tuple, RID *rid, Transaction *txn) -> b
     auto next_page_id = cur_page->GetNextPageId();
     // If the next page is a valid page,
     if (next_page_id != INVALID_PAGE_ID) {
-      auto next_page = static_cast<TablePage *>(buffer_pool_manager_->FetchPage(next_page_id));
+      auto next_page = FetchTablePage(next_page_id, strategy);
       next_page->WLatch();
       // Unlatch and unpin the current page.
       cur_page->WUnlatch();
@@ -64,7 +74,9 @@ auto TableHeap::InsertTuple(const Tuple &tuple, RID *rid, Transaction *txn) -> b
       cur_page = next_page;
     } else {
       // Otherwise we have run out of valid pages. We need to create a new page.
-      auto new_page = static_cast<TablePage *>(buffer_pool_manager_->NewPage(&next_page_id));
+      auto new_page =
+          static_cast<TablePage *>(strategy == nullptr ? buffer_pool_manager_->NewPage(&next_page_id)
+                                                       : buffer_pool_manager_->NewPage(&next_page_id, *strategy));
       // If we could not create a new page,
       if (new_page == nullptr) {
         // Then life sucks and we abort the transaction.
@@ -77,6 +89,7 @@ auto TableHeap::InsertTuple(const Tuple &tuple, RID *rid, Transaction *txn) -> b
       new_page->WLatch();
       cur_page->SetNextPageId(next_page_id);
       new_page->Init(next_page_id, BUSTUB_PAGE_SIZE, cur_page->GetTablePageId(), log_manager_, txn);
+      AppendPageId(cur_page->GetTablePageId(), next_page_id);
       cur_page->WUnlatch();
       buffer_pool_manager_->UnpinPage(cur_page->GetTablePageId(), true);
       cur_page = new_page;
@@ -156,9 +169,10 @@ void TableHeap::RollbackDelete(const RID &rid, Transaction *txn) {
   buffer_pool_manager_->UnpinPage(page->GetTablePageId(), true);
 }
 
-auto TableHeap::GetTuple(const RID &rid, Tuple *tuple, Transaction *txn, bool acquire_read_lock) -> bool {
+auto TableHeap::GetTuple(const RID &rid, Tuple *tuple, Transaction *txn, bool acquire_read_lock,
+                         BufferAccessStrategy *strategy) -> bool {
   // Find the page which contains the tuple.
-  auto page = static_cast<TablePage *>(buffer_pool_manager_->FetchPage(rid.GetPageId()));
+  auto page = FetchTablePage(rid.GetPageId(), strategy);
   // If the page could not be found, then abort the transaction.
   if (page == nullptr) {
     txn->SetState(TransactionState::ABORTED);
@@ -176,13 +190,14 @@ auto TableHeap::GetTuple(const RID &rid, Tuple *tuple, Transaction *txn, bool ac
   return res;
 }
 
-auto TableHeap::Begin(Transaction *txn) -> TableIterator {
+auto TableHeap::Begin(Transaction *txn, BufferAccessStrategy *strategy) -> TableIterator {
   // Start an iterator from the first page.
   // TODO(Wuwen): Hacky fix for now. Removing empty pages is a better way to handle this.
   RID rid;
   auto page_id = first_page_id_;
+  PrefetchAfter(page_id, scan_prefetch_window, strategy == nullptr ? BufferAccessType::NORMAL : strategy->GetType());
   while (page_id != INVALID_PAGE_ID) {
-    auto page = static_cast<TablePage *>(buffer_pool_manager_->FetchPage(page_id));
+    auto page = FetchTablePage(page_id, strategy);
     page->RLatch();
     // If this fails because there is no tuple, then RID will be the default-constructed value, which means EOF.
     auto found_tuple = page->GetFirstTupleRid(&rid);
@@ -193,7 +208,36 @@ auto TableHeap::Begin(Transaction *txn) -> TableIterator {
     }
     page_id = page->GetNextPageId();
   }
-  return {this, rid, txn};
+  return {this, rid, txn, strategy};
+}
+
+void TableHeap::AppendPageId(page_id_t page_id, page_id_t next_page_id) {
+  std::scoped_lock<std::mutex> lock(page_ids_latch_);
+  if (page_ids_.back() == page_id && page_index_.count(next_page_id) == 0) {
+    page_index_[next_page_id] = page_ids_.size();
+    page_ids_.push_back(next_page_id);
+  }
+}
+
+auto TableHeap::GetKnownPageCount() -> size_t {
+  std::scoped_lock<std::mutex> lock(page_ids_latch_);
+  return page_ids_.size();
+}
+
+void TableHeap::PrefetchAfter(page_id_t page_id, size_t window, BufferAccessType access_type) {
+  std::scoped_lock<std::mutex> lock(page_ids_latch_);
+  auto it = page_index_.find(page_id);
+  if (it == page_index_.end()) {
+    return;
+  }
+  for (size_t i = it->second + 1; i < page_ids_.size() && i <= it->second + window; ++i) {
+    buffer_pool_manager_->Prefetch(page_ids_[i], access_type);
+  }
+}
+
+auto TableHeap::FetchTablePage(page_id_t page_id, BufferAccessStrategy *strategy) -> TablePage * {
+  return static_cast<TablePage *>(strategy == nullptr ? buffer_pool_manager_->FetchPage(page_id)
+                                                      : buffer_pool_manager_->FetchPage(page_id, *strategy));
 }
 
 auto TableHeap::End() -> TableIterator { return {this, RID(INVALID_PAGE_ID, 0), nullptr}; }
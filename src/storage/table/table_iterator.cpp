@@ -12,16 +12,17 @@
 
 #include <cassert>
 
+#include "common/config.h"
 #include "common/exception.h"
 #include "concurrency/transaction.h"
 #include "storage/table/table_heap.h"
 
 namespace bustub {
 
-TableIterator::TableIterator(TableHeap *table_heap, RID rid, Transaction *txn)
-    : table_heap_(table_heap), tuple_(new Tuple(rid)), txn_(txn) {
+TableIterator::TableIterator(TableHeap *table_heap, RID rid, Transaction *txn, BufferAccessStrategy *strategy)
+    : table_heap_(table_heap), tuple_(new Tuple(rid)), txn_(txn), strategy_(strategy) {
   if (rid.GetPageId() != INVALID_PAGE_ID) {
-    if (!table_heap_->GetTuple(tuple_->rid_, tuple_, txn_)) {
+    if (!table_heap_->GetTuple(tuple_->rid_, tuple_, txn_, true, strategy_)) {
       throw bustub::Exception("read non-existing tuple");
     }
   }
@@ -39,7 +40,8 @@ auto TableIterator::operator->() -> Tuple * {
 
 auto TableIterator::operator++() -> TableIterator & {
   BufferPoolManager *buffer_pool_manager = table_heap_->buffer_pool_manager_;
-  auto cur_page = static_cast<TablePage *>(buffer_pool_manager->FetchPage(tuple_->rid_.GetPageId()));
+  const auto access_type = strategy_ == nullptr ? BufferAccessType::NORMAL : strategy_->GetType();
+  auto cur_page = table_heap_->FetchTablePage(tuple_->rid_.GetPageId(), strategy_);
   BUSTUB_ENSURE(cur_page != nullptr, "BPM full");  // all pages are pinned
 
   cur_page->RLatch();
@@ -47,11 +49,19 @@ auto TableIterator::operator++() -> TableIterator & {
   if (!cur_page->GetNextTupleRid(tuple_->rid_,
                                  &next_tuple_rid)) {  // end of this page
     while (cur_page->GetNextPageId() != INVALID_PAGE_ID) {
-      auto next_page = static_cast<TablePage *>(buffer_pool_manager->FetchPage(cur_page->GetNextPageId()));
+      // keep the following pages in flight while this one is read
+      auto next_page_id = cur_page->GetNextPageId();
+      table_heap_->AppendPageId(cur_page->GetTablePageId(), next_page_id);
+      table_heap_->PrefetchAfter(next_page_id, scan_prefetch_window, access_type);
+      auto next_page = table_heap_->FetchTablePage(next_page_id, strategy_);
       cur_page->RUnlatch();
       buffer_pool_manager->UnpinPage(cur_page->GetTablePageId(), false);
       cur_page = next_page;
       cur_page->RLatch();
+      if (scan_prefetch_window > 0) {
+        // the chain beyond the known prefix is only discovered one page at a time
+        buffer_pool_manager->Prefetch(cur_page->GetNextPageId(), access_type);
+      }
       if (cur_page->GetFirstTupleRid(&next_tuple_rid)) {
         break;
       }
@@ -62,7 +72,7 @@ auto TableIterator::operator++() -> TableIterator & {
   if (*this != table_heap_->End()) {
     // DO NOT ACQUIRE READ LOCK twice in a single thread otherwise it may deadlock.
     // See https://users.rust-lang.org/t/how-bad-is-the-potential-deadlock-mentioned-in-rwlocks-document/67234
-    if (!table_heap_->GetTuple(tuple_->rid_, tuple_, txn_, false)) {
+    if (!table_heap_->GetTuple(tuple_->rid_, tuple_, txn_, false, strategy_)) {
       cur_page->RUnlatch();
       buffer_pool_manager->UnpinPage(cur_page->GetTablePageId(), false);
       throw bustub::Exception("read non-existing tuple");
@@ -0,0 +1,56 @@
+/**
+ * arc_replacer_test.cpp
+ */
+
+#include "buffer/arc_replacer.h"
+
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace bustub {
+
+TEST(ARCReplacerTest, SampleTest) {
+  ARCReplacer replacer(4);
+
+  // Scenario: load four pages into T1. The target size of T1 starts at 0, so T1 is evicted first, in LRU order.
+  for (frame_id_t frame_id = 0; frame_id < 4; ++frame_id) {
+    replacer.RecordLoad(frame_id, 1 + frame_id);
+    replacer.SetEvictable(frame_id, true);
+  }
+  ASSERT_EQ(4, replacer.Size());
+  EXPECT_EQ((std::vector<frame_id_t>{0, 1, 2, 3}), replacer.EvictionCandidates(4));
+  frame_id_t frame_id;
+  ASSERT_TRUE(replacer.Evict(&frame_id));
+  EXPECT_EQ(0, frame_id);
+
+  // Scenario: page 1 comes back while B1 remembers it. T1 was too small, so its target grows, and page 1 is frequent
+  // now. A hit on page 2 makes it frequent as well.
+  replacer.RecordLoad(0, 1);
+  replacer.SetEvictable(0, true);
+  EXPECT_EQ(1, replacer.GetTargetT1Size());
+  replacer.RecordAccess(1);
+
+  // Scenario: T1 = [2, 3] is larger than its target and gives up a page first; once it is at its target, T2 = [0, 1]
+  // gives up its LRU page.
+  EXPECT_EQ((std::vector<frame_id_t>{2, 0, 1, 3}), replacer.EvictionCandidates(4));
+  ASSERT_TRUE(replacer.Evict(&frame_id));
+  EXPECT_EQ(2, frame_id);
+  ASSERT_TRUE(replacer.Evict(&frame_id));
+  EXPECT_EQ(0, frame_id);
+
+  // Scenario: page 1 comes back while B2 remembers it. T2 was too small, so the target of T1 shrinks again.
+  replacer.RecordLoad(0, 1);
+  replacer.SetEvictable(0, true);
+  EXPECT_EQ(0, replacer.GetTargetT1Size());
+
+  // Scenario: pinned frames are skipped, removed frames are forgotten.
+  replacer.SetEvictable(3, false);
+  ASSERT_TRUE(replacer.Evict(&frame_id));
+  EXPECT_EQ(1, frame_id);
+  replacer.Remove(0);
+  EXPECT_EQ(0, replacer.Size());
+  EXPECT_FALSE(replacer.Evict(&frame_id));
+}
+
+}  // namespace bustub
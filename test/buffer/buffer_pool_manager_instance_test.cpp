@@ -12,12 +12,23 @@
 
 #include "buffer/buffer_pool_manager_instance.h"
 
+#include <atomic>
+#include <condition_variable>  // NOLINT
 #include <cstdio>
+#include <cstring>
+#include <future>  // NOLINT
+#include <mutex>   // NOLINT
 #include <random>
 #include <string>
+#include <thread>  // NOLINT
+#include <vector>
 
 #include "buffer/buffer_pool_manager.h"
+#include "common/exception.h"
 #include "gtest/gtest.h"
+#include "storage/disk/disk_manager_memory.h"
+#include "storage/disk/disk_manager_mmap.h"
+#include "storage/disk/disk_manager_posix.h"
 
 namespace bustub {
 
@@ -145,4 +156,885 @@ TEST(BufferPoolManagerInstanceTest, SampleTest) {
   delete disk_manager;
 }
 
+// A disk manager whose reads of one page block until the test releases them.
+class BlockingDiskManager : public DiskManagerUnlimitedMemory {
+ public:
+  explicit BlockingDiskManager(page_id_t blocked_page_id) : blocked_page_id_(blocked_page_id) {}
+
+  void ReadPage(page_id_t page_id, char *page_data) override {
+    if (page_id == blocked_page_id_) {
+      std::unique_lock<std::mutex> lock(mutex_);
+      reading_ = true;
+      cv_.notify_all();
+      cv_.wait(lock, [this] { return released_; });
+    }
+    DiskManagerUnlimitedMemory::ReadPage(page_id, page_data);
+  }
+
+  void WaitUntilReading() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    cv_.wait(lock, [this] { return reading_; });
+  }
+
+  void Release() {
+    std::scoped_lock<std::mutex> lock(mutex_);
+    released_ = true;
+    cv_.notify_all();
+  }
+
+ private:
+  const page_id_t blocked_page_id_;
+  std::mutex mutex_;
+  std::condition_variable cv_;
+  bool reading_{false};
+  bool released_{false};
+};
+
+// NOLINTNEXTLINE
+TEST(BufferPoolManagerInstanceTest, IoOutsideLatchTest) {
+  const size_t buffer_pool_size = 3;
+  auto *disk_manager = new BlockingDiskManager(0);
+  auto *bpm = new BufferPoolManagerInstance(buffer_pool_size, disk_manager);
+
+  // Page 0 is written out and evicted, page 1 stays resident.
+  page_id_t page_id_temp;
+  auto *page0 = bpm->NewPage(&page_id_temp);
+  ASSERT_NE(nullptr, page0);
+  snprintf(page0->GetData(), BUSTUB_PAGE_SIZE, "Hello");
+  ASSERT_NE(nullptr, bpm->NewPage(&page_id_temp));
+  EXPECT_TRUE(bpm->UnpinPage(0, true));
+  EXPECT_TRUE(bpm->FlushPage(0));
+  EXPECT_TRUE(bpm->DeletePage(0));
+
+  // Scenario: while one thread is stuck reading page 0, the pool stays usable for other pages.
+  std::thread loader([bpm] {
+    auto *page = bpm->FetchPage(0);
+    ASSERT_NE(nullptr, page);
+    EXPECT_EQ(0, strcmp(page->GetData(), "Hello"));
+    EXPECT_TRUE(bpm->UnpinPage(0, false));
+  });
+  disk_manager->WaitUntilReading();
+  auto *page1 = bpm->FetchPage(1);
+  ASSERT_NE(nullptr, page1);
+  EXPECT_EQ(2, page1->GetPinCount());
+  EXPECT_NE(nullptr, bpm->NewPage(&page_id_temp));
+
+  // Scenario: a second reader of page 0 waits for the load instead of reading the frame early.
+  std::thread waiter([bpm] {
+    auto *page = bpm->FetchPage(0);
+    ASSERT_NE(nullptr, page);
+    EXPECT_EQ(0, strcmp(page->GetData(), "Hello"));
+    EXPECT_TRUE(bpm->UnpinPage(0, false));
+  });
+  disk_manager->Release();
+  loader.join();
+  waiter.join();
+
+  delete bpm;
+  delete disk_manager;
+}
+
+// Exposes the pool latch so a test can hold it.
+class LatchedBufferPoolManagerInstance : public BufferPoolManagerInstance {
+ public:
+  using BufferPoolManagerInstance::BufferPoolManagerInstance;
+  auto GetLatch() -> std::mutex & { return latch_; }
+};
+
+// NOLINTNEXTLINE
+TEST(BufferPoolManagerInstanceTest, HitPathWithoutLatchTest) {
+  const size_t buffer_pool_size = 4;
+  auto *disk_manager = new DiskManagerUnlimitedMemory();
+  auto *bpm = new LatchedBufferPoolManagerInstance(buffer_pool_size, disk_manager);
+
+  page_id_t page_id_temp;
+  auto *page0 = bpm->NewPage(&page_id_temp);
+  ASSERT_NE(nullptr, page0);
+  snprintf(page0->GetData(), BUSTUB_PAGE_SIZE, "Hello");
+  EXPECT_TRUE(bpm->UnpinPage(0, true));
+
+  // Scenario: with the pool latch held elsewhere, a resident page can still be fetched and unpinned.
+  std::unique_lock<std::mutex> lock(bpm->GetLatch());
+  auto hit = std::async(std::launch::async, [bpm] {
+    auto *page = bpm->FetchPage(0);
+    bool ok = page != nullptr && strcmp(page->GetData(), "Hello") == 0 && page->GetPinCount() == 1;
+    return bpm->UnpinPage(0, false) && ok;
+  });
+  bool finished = hit.wait_for(std::chrono::seconds(10)) == std::future_status::ready;
+  lock.unlock();
+  EXPECT_TRUE(finished) << "FetchPage on a resident page waited for the pool latch";
+  EXPECT_TRUE(hit.get());
+
+  // Scenario: the unpin above was made without the latch, the page must still be evictable afterwards.
+  for (size_t i = 0; i < buffer_pool_size; ++i) {
+    EXPECT_NE(nullptr, bpm->NewPage(&page_id_temp));
+  }
+  EXPECT_EQ(nullptr, bpm->NewPage(&page_id_temp));
+  for (size_t i = 1; i <= buffer_pool_size; ++i) {
+    EXPECT_TRUE(bpm->UnpinPage(static_cast<page_id_t>(i), false));
+  }
+  page0 = bpm->FetchPage(0);
+  ASSERT_NE(nullptr, page0);
+  EXPECT_EQ(0, strcmp(page0->GetData(), "Hello"));
+  EXPECT_TRUE(bpm->UnpinPage(0, false));
+
+  delete bpm;
+  delete disk_manager;
+}
+
+// NOLINTNEXTLINE
+TEST(BufferPoolManagerInstanceTest, BackgroundFlusherTest) {
+  const size_t buffer_pool_size = 10;
+  auto *disk_manager = new DiskManagerUnlimitedMemory();
+  auto *bpm = new BufferPoolManagerInstance(buffer_pool_size, disk_manager);
+
+  // Fill the pool with dirty, unpinned pages.
+  page_id_t page_id_temp;
+  for (size_t i = 0; i < buffer_pool_size; ++i) {
+    auto *page = bpm->NewPage(&page_id_temp);
+    ASSERT_NE(nullptr, page);
+    snprintf(page->GetData(), BUSTUB_PAGE_SIZE, "page %d", page_id_temp);
+    EXPECT_TRUE(bpm->UnpinPage(page_id_temp, true));
+  }
+
+  // Scenario: the flusher cleans the whole pool ahead of the replacer.
+  bpm->StartBackgroundFlusher(1.0, 1000);
+  for (int i = 0; i < 500 && bpm->GetWriteStats().background_writes_ < buffer_pool_size; ++i) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  }
+  bpm->StopBackgroundFlusher();
+  EXPECT_EQ(buffer_pool_size, bpm->GetWriteStats().background_writes_);
+
+  // Scenario: foreground evictions no longer have to write.
+  for (size_t i = 0; i < buffer_pool_size; ++i) {
+    ASSERT_NE(nullptr, bpm->NewPage(&page_id_temp));
+    EXPECT_TRUE(bpm->UnpinPage(page_id_temp, false));
+  }
+  auto stats = bpm->GetWriteStats();
+  EXPECT_EQ(0, stats.dirty_evictions_);
+  EXPECT_EQ(buffer_pool_size, stats.clean_evictions_);
+
+  // Scenario: the flushed contents can be read back.
+  auto *page0 = bpm->FetchPage(0);
+  ASSERT_NE(nullptr, page0);
+  EXPECT_EQ(0, strcmp(page0->GetData(), "page 0"));
+  EXPECT_TRUE(bpm->UnpinPage(0, false));
+
+  delete bpm;
+  delete disk_manager;
+}
+
+// A disk manager that counts page reads.
+class CountingDiskManager : public DiskManagerUnlimitedMemory {
+ public:
+  void ReadPage(page_id_t page_id, char *page_data) override {
+    num_reads_++;
+    DiskManagerUnlimitedMemory::ReadPage(page_id, page_data);
+  }
+
+  std::atomic<int> num_reads_{0};
+};
+
+// NOLINTNEXTLINE
+TEST(BufferPoolManagerInstanceTest, PrefetchTest) {
+  const size_t buffer_pool_size = 10;
+  auto *disk_manager = new CountingDiskManager();
+  auto *bpm = new BufferPoolManagerInstance(buffer_pool_size, disk_manager);
+
+  // Create twice as many pages as there are frames, so that pages 0..9 are only on disk.
+  page_id_t page_id_temp;
+  for (size_t i = 0; i < 2 * buffer_pool_size; ++i) {
+    auto *page = bpm->NewPage(&page_id_temp);
+    ASSERT_NE(nullptr, page);
+    snprintf(page->GetData(), BUSTUB_PAGE_SIZE, "page %d", page_id_temp);
+    EXPECT_TRUE(bpm->UnpinPage(page_id_temp, true));
+  }
+  ASSERT_EQ(0, disk_manager->num_reads_);
+
+  // Scenario: resident pages and pages that were never allocated are not read.
+  bpm->Prefetch(2 * buffer_pool_size - 1);
+  bpm->Prefetch(2 * buffer_pool_size);
+  bpm->Prefetch(INVALID_PAGE_ID);
+
+  // Scenario: prefetched pages are read in the background, and the fetches that follow hit.
+  bpm->PrefetchRange(0, 4);
+  for (int i = 0; i < 500 && disk_manager->num_reads_ < 4; ++i) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  }
+  EXPECT_EQ(4, disk_manager->num_reads_);
+  for (page_id_t page_id = 0; page_id < 4; ++page_id) {
+    auto *page = bpm->FetchPage(page_id);
+    ASSERT_NE(nullptr, page);
+    EXPECT_EQ(0, strcmp(page->GetData(), ("page " + std::to_string(page_id)).c_str()));
+    EXPECT_EQ(1, page->GetPinCount());
+    EXPECT_TRUE(bpm->UnpinPage(page_id, false));
+  }
+  EXPECT_EQ(4, disk_manager->num_reads_);
+
+  delete bpm;
+  delete disk_manager;
+}
+
+TEST(BufferPoolManagerInstanceTest, BufferAccessStrategyTest) {
+  const size_t buffer_pool_size = 64;
+  const size_t num_hot_pages = 32;
+  const size_t num_cold_pages = 200;
+  auto *disk_manager = new CountingDiskManager();
+  auto *bpm = new BufferPoolManagerInstance(buffer_pool_size, disk_manager, 2);
+
+  // Half of the pool holds pages that were accessed twice, e.g. the inner pages of an index.
+  std::vector<page_id_t> hot_pages(num_hot_pages);
+  for (auto &page_id : hot_pages) {
+    ASSERT_NE(nullptr, bpm->NewPage(&page_id));
+    EXPECT_TRUE(bpm->UnpinPage(page_id, true));
+    ASSERT_NE(nullptr, bpm->FetchPage(page_id));
+    EXPECT_TRUE(bpm->UnpinPage(page_id, false));
+  }
+  auto hot_pages_resident = [&] {
+    const int reads = disk_manager->num_reads_;
+    for (auto page_id : hot_pages) {
+      EXPECT_NE(nullptr, bpm->FetchPage(page_id));
+      EXPECT_TRUE(bpm->UnpinPage(page_id, false));
+    }
+    return reads == disk_manager->num_reads_;
+  };
+
+  // Scenario: a bulk load cycles through its ring and leaves the hot pages alone.
+  std::vector<page_id_t> cold_pages(num_cold_pages);
+  {
+    BufferAccessStrategy strategy(BufferAccessType::BULK_WRITE);
+    for (auto &page_id : cold_pages) {
+      auto *page = bpm->NewPage(&page_id, strategy);
+      ASSERT_NE(nullptr, page);
+      snprintf(page->GetData(), BUSTUB_PAGE_SIZE, "page %d", page_id);
+      EXPECT_TRUE(bpm->UnpinPage(page_id, true));
+    }
+  }
+  EXPECT_TRUE(hot_pages_resident());
+
+  // Scenario: a scan that reads every page several times, like a table iterator does, leaves the hot pages alone as
+  // well, and reads back what the bulk load wrote.
+  {
+    BufferAccessStrategy strategy(BufferAccessType::BULK_READ);
+    for (auto page_id : cold_pages) {
+      for (int i = 0; i < 3; ++i) {
+        auto *page = bpm->FetchPage(page_id, strategy);
+        ASSERT_NE(nullptr, page);
+        EXPECT_EQ(0, strcmp(page->GetData(), ("page " + std::to_string(page_id)).c_str()));
+        EXPECT_TRUE(bpm->UnpinPage(page_id, false));
+      }
+    }
+  }
+  EXPECT_TRUE(hot_pages_resident());
+
+  // Scenario: the same scan without a strategy makes the scanned pages look hotter than the hot pages.
+  for (auto page_id : cold_pages) {
+    for (int i = 0; i < 3; ++i) {
+      ASSERT_NE(nullptr, bpm->FetchPage(page_id));
+      EXPECT_TRUE(bpm->UnpinPage(page_id, false));
+    }
+  }
+  EXPECT_FALSE(hot_pages_resident());
+
+  delete bpm;
+  delete disk_manager;
+}
+
+// Every replacement policy must keep pinned pages resident and bring evicted pages back intact.
+TEST(BufferPoolManagerInstanceTest, ReplacerPolicyTest) {
+  const size_t buffer_pool_size = 8;
+  const int num_pages = 32;
+
+  for (auto policy : {ReplacerPolicy::LRU_K, ReplacerPolicy::LRU, ReplacerPolicy::CLOCK, ReplacerPolicy::TWO_Q,
+                      ReplacerPolicy::ARC}) {
+    SCOPED_TRACE(ReplacerPolicyToString(policy));
+    auto *disk_manager = new DiskManagerMemory(num_pages);
+    auto *bpm = new BufferPoolManagerInstance(buffer_pool_size, disk_manager, 2, nullptr, policy);
+
+    page_id_t page_id;
+    auto *pinned = bpm->NewPage(&page_id);
+    ASSERT_NE(nullptr, pinned);
+    snprintf(pinned->GetData(), BUSTUB_PAGE_SIZE, "pinned");
+    for (int i = 1; i < num_pages; ++i) {
+      auto *page = bpm->NewPage(&page_id);
+      ASSERT_NE(nullptr, page);
+      snprintf(page->GetData(), BUSTUB_PAGE_SIZE, "page %d", i);
+      EXPECT_TRUE(bpm->UnpinPage(page_id, true));
+    }
+
+    // Re-read everything twice so the policies that promote on a second access see some repeated pages.
+    for (int round = 0; round < 2; ++round) {
+      for (int i = 1; i < num_pages; ++i) {
+        auto *page = bpm->FetchPage(i);
+        ASSERT_NE(nullptr, page);
+        EXPECT_EQ("page " + std::to_string(i), std::string(page->GetData()));
+        EXPECT_TRUE(bpm->UnpinPage(i, false));
+      }
+    }
+    EXPECT_EQ(std::string("pinned"), std::string(pinned->GetData()));
+    EXPECT_TRUE(bpm->UnpinPage(0, true));
+
+    // Fill the pool with pinned pages: with nothing evictable, a further fetch has to fail.
+    for (int i = 0; i < static_cast<int>(buffer_pool_size); ++i) {
+      EXPECT_NE(nullptr, bpm->FetchPage(i));
+    }
+    EXPECT_EQ(nullptr, bpm->FetchPage(num_pages - 1));
+
+    delete bpm;
+    delete disk_manager;
+  }
+}
+
+// The metrics snapshot counts hits, misses, evictions, failed pins and disk latencies.
+TEST(BufferPoolManagerInstanceTest, MetricsTest) {
+  auto *disk_manager = new DiskManagerMemory(8);
+  auto *bpm = new BufferPoolManagerInstance(2, disk_manager);
+
+  auto metrics = bpm->GetMetrics();
+  EXPECT_EQ(2, metrics.pool_size_);
+  EXPECT_EQ(0, metrics.hits_ + metrics.misses_ + metrics.pinned_frames_ + metrics.pin_wait_failures_);
+  EXPECT_EQ(0, metrics.HitRatio());
+
+  page_id_t page_id;
+  ASSERT_NE(nullptr, bpm->NewPage(&page_id));
+  ASSERT_NE(nullptr, bpm->NewPage(&page_id));
+  ASSERT_NE(nullptr, bpm->FetchPage(0));
+  EXPECT_EQ(nullptr, bpm->NewPage(&page_id));
+  metrics = bpm->GetMetrics();
+  EXPECT_EQ(2, metrics.pinned_frames_);
+  EXPECT_EQ(1, metrics.hits_);
+  EXPECT_EQ(0, metrics.misses_);
+  EXPECT_EQ(1, metrics.pin_wait_failures_);
+
+  // page 0 is written back dirty to make room for page 2, page 1 is evicted clean to read page 0 back
+  EXPECT_TRUE(bpm->UnpinPage(0, true));
+  EXPECT_TRUE(bpm->UnpinPage(0, false));
+  ASSERT_NE(nullptr, bpm->NewPage(&page_id));
+  EXPECT_TRUE(bpm->UnpinPage(1, false));
+  ASSERT_NE(nullptr, bpm->FetchPage(0));
+  metrics = bpm->GetMetrics();
+  EXPECT_EQ(2, metrics.pinned_frames_);
+  EXPECT_EQ(1, metrics.hits_);
+  EXPECT_EQ(1, metrics.misses_);
+  EXPECT_DOUBLE_EQ(0.5, metrics.HitRatio());
+  EXPECT_EQ(1, metrics.dirty_evictions_);
+  EXPECT_EQ(1, metrics.clean_evictions_);
+  EXPECT_EQ(1, metrics.read_latency_.count_);
+  EXPECT_EQ(1, metrics.write_latency_.count_);
+  EXPECT_GT(metrics.read_latency_.QuantileMicros(0.99), 0);
+
+  delete bpm;
+  delete disk_manager;
+}
+
+// The pool grows and shrinks online: pages of dropped frames are written back, and a pinned frame stops a shrink.
+TEST(BufferPoolManagerInstanceTest, ResizeTest) {
+  const int num_pages = 200;
+  auto *disk_manager = new DiskManagerMemory(num_pages);
+  auto *bpm = new BufferPoolManagerInstance(10, disk_manager);
+
+  page_id_t page_id;
+  for (int i = 0; i < 10; ++i) {
+    auto *page = bpm->NewPage(&page_id);
+    ASSERT_NE(nullptr, page);
+    snprintf(page->GetData(), BUSTUB_PAGE_SIZE, "page %d", page_id);
+  }
+  EXPECT_EQ(nullptr, bpm->NewPage(&page_id));
+
+  // Growing across several frame chunks makes room for new pages while the old ones stay pinned.
+  EXPECT_EQ(100, bpm->SetPoolSize(100));
+  EXPECT_EQ(100, bpm->GetPoolSize());
+  for (int i = 10; i < 100; ++i) {
+    auto *page = bpm->NewPage(&page_id);
+    ASSERT_NE(nullptr, page);
+    snprintf(page->GetData(), BUSTUB_PAGE_SIZE, "page %d", page_id);
+  }
+  EXPECT_EQ(nullptr, bpm->NewPage(&page_id));
+  for (int i = 0; i < 100; ++i) {
+    EXPECT_TRUE(bpm->UnpinPage(i, true));
+  }
+
+  // Shrinking writes the dirty pages of the dropped frames back; they read back from disk.
+  EXPECT_EQ(5, bpm->SetPoolSize(5));
+  EXPECT_EQ(5, bpm->GetMetrics().pool_size_);
+  for (int i = 0; i < 100; ++i) {
+    auto *page = bpm->FetchPage(i);
+    ASSERT_NE(nullptr, page);
+    EXPECT_EQ("page " + std::to_string(i), std::string(page->GetData()));
+    EXPECT_TRUE(bpm->UnpinPage(i, false));
+  }
+
+  // A pinned page in the tail frames stops the shrink at its frame.
+  std::vector<Page *> pinned;
+  for (int i = 0; i < 5; ++i) {
+    pinned.push_back(bpm->FetchPage(i));
+    ASSERT_NE(nullptr, pinned.back());
+  }
+  EXPECT_EQ(5, bpm->SetPoolSize(2));
+  EXPECT_EQ(nullptr, bpm->FetchPage(5));
+  for (int i = 0; i < 5; ++i) {
+    EXPECT_TRUE(bpm->UnpinPage(i, false));
+  }
+  EXPECT_EQ(2, bpm->SetPoolSize(2));
+  EXPECT_THROW(bpm->SetPoolSize(0), Exception);
+
+  delete bpm;
+  delete disk_manager;
+}
+
+// Resizing while other threads fetch and unpin pages neither loses data nor touches freed frames.
+TEST(BufferPoolManagerInstanceTest, ConcurrentResizeTest) {
+  const int num_pages = 64;
+  const int num_threads = 4;
+  auto *disk_manager = new DiskManagerMemory(num_pages);
+  auto *bpm = new BufferPoolManagerInstance(16, disk_manager);
+
+  page_id_t page_id;
+  for (int i = 0; i < num_pages; ++i) {
+    auto *page = bpm->NewPage(&page_id);
+    ASSERT_NE(nullptr, page);
+    snprintf(page->GetData(), BUSTUB_PAGE_SIZE, "page %d", page_id);
+    EXPECT_TRUE(bpm->UnpinPage(page_id, true));
+  }
+
+  std::atomic<bool> done{false};
+  std::atomic<int> mismatches{0};
+  std::vector<std::thread> threads;
+  for (int t = 0; t < num_threads; ++t) {
+    threads.emplace_back([&, t] {
+      std::mt19937 gen(t);
+      while (!done) {
+        const page_id_t target = static_cast<page_id_t>(gen() % num_pages);
+        auto *page = bpm->FetchPage(target);
+        if (page == nullptr) {
+          continue;
+        }
+        if ("page " + std::to_string(target) != std::string(page->GetData())) {
+          mismatches++;
+        }
+        bpm->UnpinPage(target, false);
+      }
+    });
+  }
+  for (size_t size : {64, 8, 40, 4, 100, 16}) {
+    for (int attempt = 0; attempt < 100 && bpm->SetPoolSize(size) != size; ++attempt) {
+      std::this_thread::yield();
+    }
+  }
+  done = true;
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  EXPECT_EQ(0, mismatches);
+  EXPECT_EQ(16, bpm->GetPoolSize());
+
+  delete bpm;
+  delete disk_manager;
+}
+
+// Page data lives in one contiguous, page-aligned arena, and the page objects holding the metadata are cache-line
+// aligned, with or without huge pages.
+TEST(BufferPoolManagerInstanceTest, FrameArenaTest) {
+  for (bool huge_pages : {false, true}) {
+    SCOPED_TRACE(huge_pages ? "huge pages" : "base pages");
+    auto *disk_manager = new DiskManagerMemory(128);
+    FrameArenaOptions options;
+    options.huge_pages_ = huge_pages;
+    options.numa_node_ = 0;
+    auto *bpm = new BufferPoolManagerInstance(40, disk_manager, 2, nullptr, ReplacerPolicy::LRU_K, options);
+
+    char *base = bpm->GetFrame(0)->GetData();
+    EXPECT_EQ(0, reinterpret_cast<uintptr_t>(base) % BUSTUB_PAGE_SIZE);
+    for (frame_id_t i = 0; i < 40; ++i) {
+      EXPECT_EQ(base + i * BUSTUB_PAGE_SIZE, bpm->GetFrame(i)->GetData());
+      EXPECT_EQ(0, reinterpret_cast<uintptr_t>(bpm->GetFrame(i)) % 64);
+    }
+
+    // frames keep their place in the arena across a shrink and a grow, and come back zeroed
+    page_id_t page_id;
+    for (int i = 0; i < 40; ++i) {
+      auto *page = bpm->NewPage(&page_id);
+      ASSERT_NE(nullptr, page);
+      snprintf(page->GetData(), BUSTUB_PAGE_SIZE, "page %d", page_id);
+      EXPECT_TRUE(bpm->UnpinPage(page_id, true));
+    }
+    EXPECT_EQ(8, bpm->SetPoolSize(8));
+    EXPECT_EQ(100, bpm->SetPoolSize(100));
+    EXPECT_EQ(base + 99 * BUSTUB_PAGE_SIZE, bpm->GetFrame(99)->GetData());
+    EXPECT_EQ(0, bpm->GetFrame(99)->GetData()[0]);
+    for (int i = 0; i < 40; ++i) {
+      auto *page = bpm->FetchPage(i);
+      ASSERT_NE(nullptr, page);
+      EXPECT_EQ("page " + std::to_string(i), std::string(page->GetData()));
+      EXPECT_TRUE(bpm->UnpinPage(i, false));
+    }
+
+    delete bpm;
+    delete disk_manager;
+  }
+}
+
+// Flushes and prefetches go to the disk manager in batches, which DiskManagerPosix runs asynchronously.
+TEST(BufferPoolManagerInstanceTest, AsyncDiskBatchTest) {
+  const size_t buffer_pool_size = 32;
+  for (auto backend : {AsyncIoBackend::IO_URING, AsyncIoBackend::THREAD_POOL}) {
+    SCOPED_TRACE(AsyncIoBackendToString(backend));
+    remove("test.db");
+    auto *disk_manager = new DiskManagerPosix("test.db", true, backend);
+    auto *bpm = new BufferPoolManagerInstance(buffer_pool_size, disk_manager);
+
+    page_id_t page_id;
+    for (size_t i = 0; i < buffer_pool_size; ++i) {
+      auto *page = bpm->NewPage(&page_id);
+      ASSERT_NE(nullptr, page);
+      snprintf(page->GetData(), BUSTUB_PAGE_SIZE, "page %d", page_id);
+      EXPECT_TRUE(bpm->UnpinPage(page_id, true));
+    }
+    bpm->FlushAllPages();
+    EXPECT_EQ(buffer_pool_size, disk_manager->GetNumWrites());
+    char buf[BUSTUB_PAGE_SIZE];
+    disk_manager->ReadPage(buffer_pool_size - 1, buf);
+    EXPECT_EQ("page " + std::to_string(buffer_pool_size - 1), std::string(buf));
+
+    // Replace every page, then prefetch the first ones back in one batch.
+    for (size_t i = 0; i < buffer_pool_size; ++i) {
+      ASSERT_NE(nullptr, bpm->NewPage(&page_id));
+      EXPECT_TRUE(bpm->UnpinPage(page_id, true));
+    }
+    bpm->PrefetchRange(0, buffer_pool_size / 2);
+    for (int i = 0; i < 500 && bpm->GetMetrics().read_latency_.count_ < buffer_pool_size / 2; ++i) {
+      std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    const auto misses = bpm->GetMetrics().misses_;
+    for (page_id_t i = 0; i < static_cast<page_id_t>(buffer_pool_size / 2); ++i) {
+      auto *page = bpm->FetchPage(i);
+      ASSERT_NE(nullptr, page);
+      EXPECT_EQ("page " + std::to_string(i), std::string(page->GetData()));
+      EXPECT_TRUE(bpm->UnpinPage(i, false));
+    }
+    EXPECT_EQ(misses, bpm->GetMetrics().misses_);
+
+    delete bpm;
+    delete disk_manager;
+  }
+  remove("test.db");
+  remove("test.log");
+}
+
+// NOLINTNEXTLINE
+TEST(BufferPoolManagerInstanceTest, FreeSpaceMapTest) {
+  const size_t buffer_pool_size = 4;
+  remove("test.db");
+  remove("test.fsm");
+  auto *disk_manager = new DiskManagerPosix("test.db");
+  disk_manager->EnableFreeSpaceMap();
+  auto *bpm = new BufferPoolManagerInstance(buffer_pool_size, disk_manager);
+
+  page_id_t page_id;
+  for (page_id_t i = 0; i < 10; ++i) {
+    auto *page = bpm->NewPage(&page_id);
+    ASSERT_NE(nullptr, page);
+    EXPECT_EQ(i, page_id);
+    snprintf(page->GetData(), BUSTUB_PAGE_SIZE, "page %d", page_id);
+    EXPECT_TRUE(bpm->UnpinPage(page_id, true));
+  }
+  bpm->FlushAllPages();
+
+  // page 2 was evicted, page 9 is resident; both are reused, lowest first
+  EXPECT_TRUE(bpm->DeletePage(2));
+  EXPECT_TRUE(bpm->DeletePage(9));
+  EXPECT_EQ(2, disk_manager->GetFreeSpaceMap()->GetNumFreePages());
+  ASSERT_NE(nullptr, bpm->NewPage(&page_id));
+  EXPECT_EQ(2, page_id);
+  EXPECT_TRUE(bpm->UnpinPage(page_id, false));
+
+  // the reused page reads back as a new, empty page once it was evicted, not as the page it replaced
+  for (page_id_t i = 3; i < 3 + static_cast<page_id_t>(buffer_pool_size); ++i) {
+    ASSERT_NE(nullptr, bpm->FetchPage(i));
+    EXPECT_TRUE(bpm->UnpinPage(i, false));
+  }
+  auto *page = bpm->FetchPage(2);
+  ASSERT_NE(nullptr, page);
+  EXPECT_EQ(0, page->GetData()[0]);
+  EXPECT_TRUE(bpm->UnpinPage(2, false));
+
+  // the free pages at the end of the file are truncated
+  EXPECT_TRUE(bpm->DeletePage(8));
+  EXPECT_TRUE(bpm->DeletePage(6));
+  EXPECT_EQ(2, disk_manager->TruncateFreePages());
+  EXPECT_EQ(8 * BUSTUB_PAGE_SIZE, disk_manager->GetDbFileSize());
+  EXPECT_EQ(1, disk_manager->GetFreeSpaceMap()->GetNumFreePages());
+  ASSERT_NE(nullptr, bpm->NewPage(&page_id));
+  EXPECT_EQ(6, page_id);
+  EXPECT_TRUE(bpm->UnpinPage(page_id, false));
+  delete bpm;
+  disk_manager->ShutDown();
+  delete disk_manager;
+
+  // a new buffer pool on the same files continues where the old one stopped
+  disk_manager = new DiskManagerPosix("test.db");
+  disk_manager->EnableFreeSpaceMap();
+  bpm = new BufferPoolManagerInstance(buffer_pool_size, disk_manager);
+  ASSERT_NE(nullptr, bpm->NewPage(&page_id));
+  EXPECT_EQ(8, page_id);
+  EXPECT_TRUE(bpm->UnpinPage(page_id, false));
+  page = bpm->FetchPage(5);
+  ASSERT_NE(nullptr, page);
+  EXPECT_EQ("page 5", std::string(page->GetData()));
+  EXPECT_TRUE(bpm->UnpinPage(5, false));
+
+  delete bpm;
+  delete disk_manager;
+  remove("test.db");
+  remove("test.fsm");
+  remove("test.log");
+}
+
+// NOLINTNEXTLINE
+TEST(BufferPoolManagerInstanceTest, FreeSpaceMapNewPageWritesTest) {
+  const size_t buffer_pool_size = 4;
+  remove("test.db");
+  remove("test.fsm");
+  auto *disk_manager = new DiskManagerPosix("test.db");
+  disk_manager->EnableFreeSpaceMap();
+  auto *bpm = new BufferPoolManagerInstance(buffer_pool_size, disk_manager);
+
+  // new pages at the end of the file that nobody writes to are evicted without a write, and read back as zeros
+  page_id_t page_id;
+  for (page_id_t i = 0; i < 2 * static_cast<page_id_t>(buffer_pool_size); ++i) {
+    ASSERT_NE(nullptr, bpm->NewPage(&page_id));
+    EXPECT_TRUE(bpm->UnpinPage(page_id, false));
+  }
+  EXPECT_EQ(0, disk_manager->GetNumWrites());
+  auto *page = bpm->FetchPage(0);
+  ASSERT_NE(nullptr, page);
+  EXPECT_EQ(std::string(BUSTUB_PAGE_SIZE, '\0'), std::string(page->GetData(), BUSTUB_PAGE_SIZE));
+  snprintf(page->GetData(), BUSTUB_PAGE_SIZE, "page 0");
+  EXPECT_TRUE(bpm->UnpinPage(0, true));
+  bpm->FlushAllPages();
+  EXPECT_EQ(1, disk_manager->GetNumWrites());
+
+  // a deleted page is not written, and its reuse starts dirty so that it is zeroed on disk
+  EXPECT_TRUE(bpm->DeletePage(0));
+  EXPECT_EQ(1, disk_manager->GetNumWrites());
+  ASSERT_NE(nullptr, bpm->NewPage(&page_id));
+  EXPECT_EQ(0, page_id);
+  EXPECT_TRUE(bpm->UnpinPage(page_id, false));
+  bpm->FlushAllPages();
+  EXPECT_EQ(2, disk_manager->GetNumWrites());
+  char data[BUSTUB_PAGE_SIZE];
+  disk_manager->ReadPage(0, data);
+  EXPECT_EQ(std::string(BUSTUB_PAGE_SIZE, '\0'), std::string(data, BUSTUB_PAGE_SIZE));
+
+  // deleting a reused page before anyone touched it costs no write either
+  EXPECT_TRUE(bpm->DeletePage(0));
+  ASSERT_NE(nullptr, bpm->NewPage(&page_id));
+  EXPECT_EQ(0, page_id);
+  EXPECT_TRUE(bpm->UnpinPage(page_id, false));
+  EXPECT_TRUE(bpm->DeletePage(0));
+  EXPECT_EQ(2, disk_manager->GetNumWrites());
+
+  delete bpm;
+  delete disk_manager;
+  remove("test.db");
+  remove("test.fsm");
+  remove("test.log");
+}
+
+// NOLINTNEXTLINE
+TEST(BufferPoolManagerInstanceTest, FreeSpaceMapStalePrefetchTest) {
+  const size_t buffer_pool_size = 4;
+  remove("test.db");
+  remove("test.fsm");
+  auto *disk_manager = new DiskManagerPosix("test.db");
+  disk_manager->EnableFreeSpaceMap();
+  auto *bpm = new BufferPoolManagerInstance(buffer_pool_size, disk_manager);
+
+  // pages 0 and 1 are evicted to disk, 2..5 stay resident
+  page_id_t page_id;
+  for (page_id_t i = 0; i < 6; ++i) {
+    auto *page = bpm->NewPage(&page_id);
+    ASSERT_NE(nullptr, page);
+    snprintf(page->GetData(), BUSTUB_PAGE_SIZE, "page %d", page_id);
+    EXPECT_TRUE(bpm->UnpinPage(page_id, true));
+  }
+
+  // Scenario: a prefetch hint for a deleted page does not read it back in. Page 0 is hinted after it, and is read
+  // once the hint for page 2 was dealt with.
+  EXPECT_TRUE(bpm->DeletePage(2));
+  const auto reads = bpm->GetMetrics().read_latency_.count_;
+  bpm->Prefetch(2);
+  bpm->Prefetch(0);
+  for (int i = 0; i < 500 && bpm->GetMetrics().read_latency_.count_ == reads; ++i) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  }
+  auto *page = bpm->FetchPage(0);
+  ASSERT_NE(nullptr, page);
+  EXPECT_TRUE(bpm->UnpinPage(0, false));
+  EXPECT_EQ(reads + 1, bpm->GetMetrics().read_latency_.count_);
+
+  // Scenario: the reuse of the deleted page stays the only copy of it while other pages come and go.
+  auto *reused = bpm->NewPage(&page_id);
+  ASSERT_NE(nullptr, reused);
+  ASSERT_EQ(2, page_id);
+  snprintf(reused->GetData(), BUSTUB_PAGE_SIZE, "reused");
+  for (int i = 0; i < 8; ++i) {
+    ASSERT_NE(nullptr, bpm->NewPage(&page_id));
+    EXPECT_TRUE(bpm->UnpinPage(page_id, false));
+  }
+  EXPECT_EQ(reused, bpm->FetchPage(2));
+  EXPECT_STREQ("reused", reused->GetData());
+  EXPECT_TRUE(bpm->UnpinPage(2, true));
+  EXPECT_TRUE(bpm->UnpinPage(2, true));
+
+  delete bpm;
+  delete disk_manager;
+  remove("test.db");
+  remove("test.fsm");
+  remove("test.log");
+}
+
+// NOLINTNEXTLINE
+TEST(BufferPoolManagerInstanceTest, DeleteDirtyPageTest) {
+  remove("test.db");
+  auto *disk_manager = new DiskManagerPosix("test.db");
+  auto *bpm = new BufferPoolManagerInstance(4, disk_manager);
+
+  // the contents of a deleted page are dead, also without a free-space map: a dirty one is dropped unwritten
+  page_id_t page_id;
+  auto *page = bpm->NewPage(&page_id);
+  ASSERT_NE(nullptr, page);
+  snprintf(page->GetData(), BUSTUB_PAGE_SIZE, "deleted");
+  EXPECT_TRUE(bpm->UnpinPage(page_id, true));
+  EXPECT_TRUE(bpm->DeletePage(page_id));
+  bpm->FlushAllPages();
+  EXPECT_EQ(0, disk_manager->GetNumWrites());
+
+  delete bpm;
+  delete disk_manager;
+  remove("test.db");
+  remove("test.log");
+}
+
+// NOLINTNEXTLINE
+TEST(BufferPoolManagerInstanceTest, ZeroCopyReadTest) {
+  const size_t buffer_pool_size = 4;
+  const page_id_t num_pages = 10;
+  remove("test.db");
+  {
+    DiskManagerPosix writer("test.db");
+    char data[BUSTUB_PAGE_SIZE] = {0};
+    for (page_id_t i = 0; i < num_pages; ++i) {
+      snprintf(data, sizeof(data), "page %d", i);
+      writer.WritePage(i, data);
+    }
+    writer.ShutDown();
+  }
+
+  auto *disk_manager = new DiskManagerMmap("test.db");
+  auto *bpm = new BufferPoolManagerInstance(buffer_pool_size, disk_manager);
+  // copied into the frame by default
+  auto *page = bpm->FetchPage(0);
+  ASSERT_NE(nullptr, page);
+  EXPECT_EQ("page 0", std::string(page->GetData()));
+  EXPECT_NE(disk_manager->GetMappedPage(0), page->GetData());
+  EXPECT_TRUE(bpm->UnpinPage(0, false));
+
+  // zero-copy: the frames point into the mapping, also after evictions and for prefetched pages
+  bpm->SetZeroCopyReads(true);
+  for (int round = 0; round < 2; ++round) {
+    for (page_id_t i = 1; i < num_pages; ++i) {
+      page = bpm->FetchPage(i);
+      ASSERT_NE(nullptr, page);
+      EXPECT_EQ(disk_manager->GetMappedPage(i), page->GetData());
+      EXPECT_EQ("page " + std::to_string(i), std::string(page->GetData()));
+      EXPECT_TRUE(bpm->UnpinPage(i, false));
+    }
+  }
+  // a fetch racing the prefetch waits for it
+  bpm->PrefetchRange(0, 2);
+  page = bpm->FetchPage(1);
+  ASSERT_NE(nullptr, page);
+  EXPECT_EQ(disk_manager->GetMappedPage(1), page->GetData());
+  // a mapped page cannot be dirtied, and the rejected unpin leaves it pinned
+  EXPECT_THROW(bpm->UnpinPage(1, true), Exception);
+  EXPECT_EQ(1, page->GetPinCount());
+  EXPECT_FALSE(page->IsDirty());
+  EXPECT_TRUE(bpm->UnpinPage(1, false));
+
+  // pages past the end of the file are not mapped, they are read into the frame
+  page = bpm->FetchPage(num_pages + 1);
+  ASSERT_NE(nullptr, page);
+  EXPECT_EQ(0, page->GetData()[0]);
+  EXPECT_TRUE(bpm->UnpinPage(num_pages + 1, false));
+  // a frame that held a mapped page gets its own memory back for a new page
+  bpm->SetZeroCopyReads(false);
+  page_id_t page_id;
+  for (size_t i = 0; i < buffer_pool_size; ++i) {
+    page = bpm->NewPage(&page_id);
+    ASSERT_NE(nullptr, page);
+    EXPECT_EQ(nullptr, std::memchr(page->GetData(), 'p', BUSTUB_PAGE_SIZE));
+    snprintf(page->GetData(), BUSTUB_PAGE_SIZE, "new");
+  }
+
+  delete bpm;
+  delete disk_manager;
+  remove("test.db");
+}
+
+// NOLINTNEXTLINE
+TEST(BufferPoolManagerInstanceTest, CompressedCacheTest) {
+  const size_t buffer_pool_size = 4;
+  const page_id_t num_pages = 12;
+  auto *disk_manager = new CountingDiskManager();
+  disk_manager->EnableCompressedCache(1 << 20);
+  auto *bpm = new BufferPoolManagerInstance(buffer_pool_size, disk_manager);
+
+  page_id_t page_id;
+  for (page_id_t i = 0; i < num_pages; ++i) {
+    auto *page = bpm->NewPage(&page_id);
+    ASSERT_NE(nullptr, page);
+    snprintf(page->GetData(), BUSTUB_PAGE_SIZE, "page %d", page_id);
+    EXPECT_TRUE(bpm->UnpinPage(page_id, true));
+  }
+  // the evicted pages, clean and dirty, are served from the cache
+  for (int round = 0; round < 3; ++round) {
+    for (page_id_t i = 0; i < num_pages; ++i) {
+      auto *page = bpm->FetchPage(i);
+      ASSERT_NE(nullptr, page);
+      EXPECT_EQ("page " + std::to_string(i), std::string(page->GetData()));
+      EXPECT_TRUE(bpm->UnpinPage(i, round == 0));
+    }
+  }
+  EXPECT_EQ(0, disk_manager->num_reads_);
+  auto metrics = bpm->GetMetrics();
+  EXPECT_EQ(3 * num_pages, metrics.compressed_cache_hits_);
+  EXPECT_EQ(0, metrics.compressed_cache_misses_);
+  EXPECT_DOUBLE_EQ(1, metrics.CompressedCacheHitRatio());
+  // the cache is exclusive: only the pages that are not resident are in it
+  EXPECT_EQ(num_pages - buffer_pool_size, disk_manager->GetCompressedCache()->GetStats().pages_);
+
+  // a deleted page leaves the cache; a page dropped from the cache is read from disk, and evicts another one into it
+  EXPECT_TRUE(bpm->DeletePage(0));
+  disk_manager->GetCompressedCache()->Remove(1);
+  auto *page = bpm->FetchPage(1);
+  ASSERT_NE(nullptr, page);
+  EXPECT_EQ("page 1", std::string(page->GetData()));
+  EXPECT_TRUE(bpm->UnpinPage(1, false));
+  EXPECT_EQ(1, disk_manager->num_reads_);
+  EXPECT_EQ(1, bpm->GetMetrics().compressed_cache_misses_);
+  EXPECT_EQ(num_pages - buffer_pool_size - 1, disk_manager->GetCompressedCache()->GetStats().pages_);
+
+  // prefetched pages come from the cache too
+  bpm->PrefetchRange(2, 2);
+  for (int i = 0; i < 500 && bpm->GetMetrics().compressed_cache_hits_ < 3 * num_pages + 2; ++i) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  }
+  EXPECT_EQ(3 * num_pages + 2, bpm->GetMetrics().compressed_cache_hits_);
+  EXPECT_EQ(1, disk_manager->num_reads_);
+
+  delete bpm;
+  delete disk_manager;
+}
+
 }  // namespace bustub
@@ -10,53 +10,56 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include "buffer/clock_replacer.h"
+
 #include <cstdio>
 #include <thread>  // NOLINT
 #include <vector>
 
-#include "buffer/clock_replacer.h"
 #include "gtest/gtest.h"
 
 namespace bustub {
 
-TEST(ClockReplacerTest, DISABLED_SampleTest) {
+TEST(ClockReplacerTest, SampleTest) {
   ClockReplacer clock_replacer(7);
 
-  // Scenario: unpin six elements, i.e. add them to the replacer.
-  clock_replacer.Unpin(1);
-  clock_replacer.Unpin(2);
-  clock_replacer.Unpin(3);
-  clock_replacer.Unpin(4);
-  clock_replacer.Unpin(5);
-  clock_replacer.Unpin(6);
-  clock_replacer.Unpin(1);
+  // Scenario: access six elements and make them evictable, i.e. add them to the replacer.
+  for (frame_id_t frame_id = 1; frame_id <= 6; ++frame_id) {
+    clock_replacer.RecordAccess(frame_id);
+    clock_replacer.SetEvictable(frame_id, true);
+  }
+  clock_replacer.RecordAccess(1);
   EXPECT_EQ(6, clock_replacer.Size());
 
-  // Scenario: get three victims from the clock.
+  // Scenario: get three victims from the clock. The first turn clears every reference bit.
   int value;
-  clock_replacer.Victim(&value);
+  clock_replacer.Evict(&value);
   EXPECT_EQ(1, value);
-  clock_replacer.Victim(&value);
+  clock_replacer.Evict(&value);
   EXPECT_EQ(2, value);
-  clock_replacer.Victim(&value);
+  clock_replacer.Evict(&value);
   EXPECT_EQ(3, value);
 
   // Scenario: pin elements in the replacer.
   // Note that 3 has already been victimized, so pinning 3 should have no effect.
-  clock_replacer.Pin(3);
-  clock_replacer.Pin(4);
+  clock_replacer.SetEvictable(3, false);
+  clock_replacer.SetEvictable(4, false);
   EXPECT_EQ(2, clock_replacer.Size());
 
-  // Scenario: unpin 4. We expect that the reference bit of 4 will be set to 1.
-  clock_replacer.Unpin(4);
+  // Scenario: access and unpin 4. We expect that the reference bit of 4 will be set to 1.
+  clock_replacer.RecordAccess(4);
+  clock_replacer.SetEvictable(4, true);
+  EXPECT_EQ((std::vector<frame_id_t>{5, 6, 4}), clock_replacer.EvictionCandidates(7));
 
   // Scenario: continue looking for victims. We expect these victims.
-  clock_replacer.Victim(&value);
+  clock_replacer.Evict(&value);
   EXPECT_EQ(5, value);
-  clock_replacer.Victim(&value);
+  clock_replacer.Evict(&value);
   EXPECT_EQ(6, value);
-  clock_replacer.Victim(&value);
+  clock_replacer.Evict(&value);
   EXPECT_EQ(4, value);
+  EXPECT_FALSE(clock_replacer.Evict(&value));
+  EXPECT_EQ(0, clock_replacer.Size());
 }
 
 }  // namespace bustub
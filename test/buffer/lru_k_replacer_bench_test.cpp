@@ -0,0 +1,179 @@
+/**
+ * lru_k_replacer_bench_test.cpp
+ *
+ * Compares the LRUKReplacer against the previous list based implementation on a buffer-pool-like reference stream.
+ */
+
+#include <chrono>  // NOLINT
+#include <iomanip>
+#include <iostream>
+#include <list>
+#include <memory>
+#include <mutex>  // NOLINT
+#include <random>
+#include <sstream>
+#include <unordered_map>
+#include <vector>
+
+#include "buffer/lru_k_replacer.h"
+#include "gtest/gtest.h"
+
+namespace bustub {
+
+/**
+ * The list based LRU-K replacer that LRUKReplacer replaced, kept as a baseline. Frames with less than k accesses are
+ * kept in FIFO order and the others in LRU order; every access and every eviction walks a list.
+ */
+class ListLRUKReplacer {
+ public:
+  ListLRUKReplacer(size_t num_frames, size_t k) : replacer_size_(num_frames), k_(k) {}
+
+  auto Evict(frame_id_t *frame_id) -> bool {
+    std::scoped_lock<std::mutex> lock(latch_);
+    if (curr_size_ == 0) {
+      return false;
+    }
+    for (auto *list : {&history_, &cache_}) {
+      for (auto itor = list->begin(); itor != list->end(); ++itor) {
+        if ((*itor)->is_evictable_) {
+          *frame_id = (*itor)->frame_id_;
+          frames_.erase(*frame_id);
+          list->erase(itor);
+          curr_size_--;
+          return true;
+        }
+      }
+    }
+    return false;
+  }
+
+  void RecordAccess(frame_id_t frame_id) {
+    std::scoped_lock<std::mutex> lock(latch_);
+    auto kv = frames_.find(frame_id);
+    current_timestamp_++;
+    if (kv == frames_.end()) {
+      auto frame_meta = std::make_shared<FrameMeta>(frame_id, current_timestamp_);
+      frames_.insert(std::make_pair(frame_id, frame_meta));
+      if (frame_meta->cur_ >= k_) {
+        cache_.push_back(frame_meta);
+      } else {
+        history_.push_back(frame_meta);
+      }
+      return;
+    }
+    auto frame_ptr = kv->second;
+    frame_ptr->timestamps_ = current_timestamp_;
+    frame_ptr->cur_++;
+    if (frame_ptr->cur_ == k_) {
+      history_.remove(frame_ptr);
+      cache_.push_back(frame_ptr);
+    } else if (frame_ptr->cur_ > k_) {
+      cache_.remove(frame_ptr);
+      cache_.push_back(frame_ptr);
+    }
+  }
+
+  void SetEvictable(frame_id_t frame_id, bool set_evictable) {
+    std::scoped_lock<std::mutex> lock(latch_);
+    auto kv = frames_.find(frame_id);
+    if (kv != frames_.end() && kv->second->is_evictable_ != set_evictable) {
+      kv->second->is_evictable_ = set_evictable;
+      curr_size_ = set_evictable ? curr_size_ + 1 : curr_size_ - 1;
+    }
+  }
+
+  auto Size() -> size_t {
+    std::scoped_lock<std::mutex> lock(latch_);
+    return curr_size_;
+  }
+
+ private:
+  struct FrameMeta {
+    FrameMeta(const frame_id_t frame_id, const size_t timestamps) : frame_id_(frame_id), timestamps_(timestamps) {}
+    frame_id_t frame_id_;
+    size_t cur_{1};
+    size_t timestamps_;
+    bool is_evictable_{false};
+  };
+
+  size_t current_timestamp_{0};
+  size_t curr_size_{0};
+  [[maybe_unused]] size_t replacer_size_;
+  size_t k_;
+  std::unordered_map<frame_id_t, std::shared_ptr<FrameMeta>> frames_;
+  std::list<std::shared_ptr<FrameMeta>> history_;
+  std::list<std::shared_ptr<FrameMeta>> cache_;
+  std::mutex latch_;
+};
+
+/**
+ * Drive a replacer the way BufferPoolManagerInstance does: every reference pins (RecordAccess + non-evictable) and
+ * unpins (evictable) a frame, and a miss on a full pool evicts a victim first. Page references are skewed so that
+ * 20% of the pages receive 80% of the references. Returns replacer operations per second and sets *hits.
+ */
+template <typename ReplacerType>
+auto RunReplacerBenchmark(size_t num_frames, size_t k, size_t num_pages, size_t num_refs, size_t *hits) -> double {
+  ReplacerType replacer(num_frames, k);
+  std::unordered_map<size_t, frame_id_t> page_table;
+  std::vector<size_t> frame_to_page(num_frames);
+  std::mt19937_64 rng(15445);
+  std::uniform_int_distribution<size_t> hot(0, num_pages / 5 - 1);
+  std::uniform_int_distribution<size_t> cold(num_pages / 5, num_pages - 1);
+  std::uniform_int_distribution<int> coin(0, 9);
+  std::vector<size_t> refs(num_refs);
+  for (auto &ref : refs) {
+    ref = coin(rng) < 8 ? hot(rng) : cold(rng);
+  }
+
+  size_t ops = 0;
+  *hits = 0;
+  size_t next_free = 0;
+  auto start = std::chrono::steady_clock::now();
+  for (auto page : refs) {
+    frame_id_t frame_id;
+    auto kv = page_table.find(page);
+    if (kv != page_table.end()) {
+      frame_id = kv->second;
+      ++*hits;
+    } else if (next_free < num_frames) {
+      frame_id = static_cast<frame_id_t>(next_free++);
+    } else {
+      EXPECT_TRUE(replacer.Evict(&frame_id));
+      page_table.erase(frame_to_page[frame_id]);
+      ++ops;
+    }
+    page_table[page] = frame_id;
+    frame_to_page[frame_id] = page;
+    replacer.RecordAccess(frame_id);
+    replacer.SetEvictable(frame_id, false);
+    replacer.SetEvictable(frame_id, true);
+    ops += 3;
+  }
+  auto elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+  return static_cast<double>(ops) / elapsed;
+}
+
+/*
+ * Benchmark: replacer throughput for increasing pool sizes. The list based replacer degrades linearly with the
+ * number of frames; LRUKReplacer should stay roughly flat.
+ */
+TEST(LRUKReplacerTest, DISABLED_ReplacerBenchmark) {  // NOLINT
+  const size_t k = 2;
+  const size_t num_refs = 50000;
+  std::stringstream ss;
+  ss << "[BENCHMARK: LRUKReplacerTest.ReplacerBenchmark] replacer ops/s" << std::endl;
+  ss << std::setw(8) << "frames" << std::setw(16) << "list" << std::setw(16) << "heap" << std::setw(12) << "list hit%"
+     << std::setw(12) << "heap hit%" << std::endl;
+  for (size_t num_frames : {256, 1024, 4096}) {
+    size_t list_hits;
+    size_t heap_hits;
+    auto list_ops = RunReplacerBenchmark<ListLRUKReplacer>(num_frames, k, num_frames * 4, num_refs, &list_hits);
+    auto heap_ops = RunReplacerBenchmark<LRUKReplacer>(num_frames, k, num_frames * 4, num_refs, &heap_hits);
+    ss << std::setw(8) << num_frames << std::setw(16) << std::fixed << std::setprecision(0) << list_ops
+       << std::setw(16) << heap_ops << std::setw(12) << std::setprecision(1) << 100.0 * list_hits / num_refs
+       << std::setw(12) << 100.0 * heap_hits / num_refs << std::endl;
+  }
+  std::cout << ss.str();
+}
+
+}  // namespace bustub
@@ -97,4 +97,55 @@ TEST(LRUKReplacerTest, SampleTest) {
   lru_replacer.Remove(1);
   ASSERT_EQ(0, lru_replacer.Size());
 }
+
+TEST(LRUKReplacerTest, EvictionCandidatesTest) {
+  LRUKReplacer lru_replacer(16, 2);
+
+  // Frames 0..9 get one access, even frames get a second one. Frame 9 is pinned.
+  for (int i = 0; i < 10; ++i) {
+    lru_replacer.RecordAccess(i);
+  }
+  for (int i = 0; i < 10; i += 2) {
+    lru_replacer.RecordAccess(i);
+  }
+  for (int i = 0; i < 9; ++i) {
+    lru_replacer.SetEvictable(i, true);
+  }
+
+  // Scenario: candidates come in eviction order and are not evicted.
+  std::vector<frame_id_t> expected{1, 3, 5, 7, 0, 2, 4, 6, 8};
+  ASSERT_EQ(expected, lru_replacer.EvictionCandidates(100));
+  ASSERT_EQ(std::vector<frame_id_t>(expected.begin(), expected.begin() + 3), lru_replacer.EvictionCandidates(3));
+  ASSERT_EQ(9, lru_replacer.Size());
+  for (auto frame_id : expected) {
+    int value;
+    ASSERT_TRUE(lru_replacer.Evict(&value));
+    ASSERT_EQ(frame_id, value);
+  }
+  ASSERT_TRUE(lru_replacer.EvictionCandidates(100).empty());
+}
+TEST(LRUKReplacerTest, ResizeTest) {
+  LRUKReplacer lru_replacer(4, 2);
+  for (int i = 0; i < 4; ++i) {
+    lru_replacer.RecordAccess(i);
+    lru_replacer.SetEvictable(i, true);
+  }
+
+  // Scenario: growing keeps the history of the existing frames, new frames can be tracked right away.
+  lru_replacer.Resize(8);
+  lru_replacer.RecordAccess(7);
+  lru_replacer.RecordAccess(7);
+  lru_replacer.SetEvictable(7, true);
+  ASSERT_EQ(5, lru_replacer.Size());
+  int value;
+  ASSERT_TRUE(lru_replacer.Evict(&value));
+  ASSERT_EQ(0, value);
+
+  // Scenario: shrinking to frames that are no longer tracked keeps the remaining ones.
+  lru_replacer.Remove(7);
+  lru_replacer.Remove(3);
+  lru_replacer.Resize(3);
+  ASSERT_EQ(2, lru_replacer.Size());
+  ASSERT_EQ((std::vector<frame_id_t>{1, 2}), lru_replacer.EvictionCandidates(100));
+}
 }  // namespace bustub
@@ -0,0 +1,149 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// page_trace_test.cpp
+//
+// Identification: test/buffer/page_trace_test.cpp
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "buffer/page_trace.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "buffer/buffer_pool_manager_instance.h"
+#include "buffer/replacer_simulator.h"
+#include "gtest/gtest.h"
+#include "storage/disk/disk_manager_memory.h"
+
+namespace bustub {
+
+TEST(PageTraceTest, RecordBufferPoolCalls) {
+  const std::string trace_name = "page_trace_test.trace";
+  auto *disk_manager = new DiskManagerMemory(16);
+  auto *bpm = new BufferPoolManagerInstance(2, disk_manager);
+  auto *recorder = new PageTraceRecorder(trace_name);
+
+  page_id_t page_id;
+  // not traced yet
+  ASSERT_NE(nullptr, bpm->NewPage(&page_id));
+  bpm->UnpinPage(page_id, true);
+
+  bpm->SetTraceRecorder(recorder);
+  ASSERT_NE(nullptr, bpm->FetchPage(0));   // hit
+  ASSERT_NE(nullptr, bpm->NewPage(&page_id));  // page 1
+  EXPECT_EQ(nullptr, bpm->NewPage(&page_id));  // both frames pinned
+  EXPECT_TRUE(bpm->UnpinPage(0, false));
+  EXPECT_TRUE(bpm->UnpinPage(1, true));
+  EXPECT_FALSE(bpm->UnpinPage(1, false));  // pin count already 0
+  EXPECT_TRUE(bpm->DeletePage(1));
+  ASSERT_NE(nullptr, bpm->NewPage(&page_id));  // page 2
+  ASSERT_NE(nullptr, bpm->FetchPage(1));   // miss, page 1 was deleted from the pool
+  bpm->SetTraceRecorder(nullptr);
+  EXPECT_TRUE(bpm->UnpinPage(1, false));
+  EXPECT_EQ(9, recorder->GetRecordCount());
+  delete recorder;
+
+  auto records = ReadPageTrace(trace_name);
+  struct Expected {
+    PageTraceEvent event_;
+    page_id_t page_id_;
+    uint8_t flags_;
+  };
+  std::vector<Expected> expected = {
+      {PageTraceEvent::FETCH, 0, PAGE_TRACE_HIT},
+      {PageTraceEvent::NEW, 1, 0},
+      {PageTraceEvent::NEW, INVALID_PAGE_ID, PAGE_TRACE_FAILED},
+      {PageTraceEvent::UNPIN, 0, 0},
+      {PageTraceEvent::UNPIN, 1, PAGE_TRACE_DIRTY},
+      {PageTraceEvent::UNPIN, 1, PAGE_TRACE_FAILED},
+      {PageTraceEvent::DELETE, 1, 0},
+      {PageTraceEvent::NEW, 2, 0},
+      {PageTraceEvent::FETCH, 1, 0},
+  };
+  ASSERT_EQ(expected.size(), records.size());
+  for (size_t i = 0; i < expected.size(); i++) {
+    EXPECT_EQ(expected[i].event_, records[i].event_) << i;
+    EXPECT_EQ(expected[i].page_id_, records[i].page_id_) << i;
+    EXPECT_EQ(expected[i].flags_, records[i].flags_) << i;
+    EXPECT_EQ(records[0].thread_id_, records[i].thread_id_) << i;
+    if (i > 0) {
+      EXPECT_LE(records[i - 1].timestamp_ns_, records[i].timestamp_ns_) << i;
+    }
+  }
+  EXPECT_EQ((std::vector<page_id_t>{0, 1, 2, 1}), PageTraceReferences(records));
+
+  remove(trace_name.c_str());
+  delete bpm;
+  delete disk_manager;
+}
+
+TEST(PageTraceTest, ConcurrentRecordAndReplay) {
+  const std::string trace_name = "page_trace_test.trace";
+  const int num_threads = 4;
+  const int num_fetches = 1000;
+  const int num_pages = 32;
+  auto *disk_manager = new DiskManagerMemory(num_pages);
+  auto *bpm = new BufferPoolManagerInstance(8, disk_manager);
+  page_id_t page_id;
+  for (int i = 0; i < num_pages; i++) {
+    ASSERT_NE(nullptr, bpm->NewPage(&page_id));
+    bpm->UnpinPage(page_id, false);
+  }
+
+  auto *recorder = new PageTraceRecorder(trace_name);
+  bpm->SetTraceRecorder(recorder);
+  std::vector<std::thread> threads;
+  for (int tid = 0; tid < num_threads; tid++) {
+    threads.emplace_back([bpm, tid] {
+      for (int i = 0; i < num_fetches; i++) {
+        // every thread loops over 7 pages of its own, every other fetch goes to a hot set of 4 shared pages
+        page_id_t page_id = i % 2 == 0 ? i / 2 % 4 : 4 + tid * 7 + i % 7;
+        if (bpm->FetchPage(page_id) != nullptr) {
+          bpm->UnpinPage(page_id, false);
+        }
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  bpm->SetTraceRecorder(nullptr);
+  delete recorder;
+
+  auto records = ReadPageTrace(trace_name);
+  EXPECT_EQ(2 * num_threads * num_fetches, records.size());
+  std::vector<uint16_t> thread_ids;
+  for (const auto &record : records) {
+    if (std::find(thread_ids.begin(), thread_ids.end(), record.thread_id_) == thread_ids.end()) {
+      thread_ids.push_back(record.thread_id_);
+    }
+  }
+  EXPECT_EQ(num_threads, thread_ids.size());
+
+  // a pool that holds all 32 pages only misses on the first reference of each page
+  auto references = PageTraceReferences(records);
+  auto result = SimulateReplacer(ReplacerPolicy::LRU_K, num_pages, references, 2);
+  EXPECT_EQ(4 + num_threads * 7, result.misses_);
+
+  remove(trace_name.c_str());
+  delete bpm;
+  delete disk_manager;
+}
+
+TEST(PageTraceTest, RejectBadFiles) {
+  EXPECT_THROW(ReadPageTrace("page_trace_test.missing"), Exception);
+  FILE *file = fopen("page_trace_test.bad", "w");
+  fputs("not a trace", file);
+  fclose(file);
+  EXPECT_THROW(ReadPageTrace("page_trace_test.bad"), Exception);
+  remove("page_trace_test.bad");
+}
+
+}  // namespace bustub
@@ -0,0 +1,232 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// parallel_buffer_pool_manager_test.cpp
+//
+// Identification: test/buffer/parallel_buffer_pool_manager_test.cpp
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "buffer/parallel_buffer_pool_manager.h"
+
+#include <cstdio>
+#include <string>
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "buffer/buffer_pool_manager.h"
+#include "common/exception.h"
+#include "gtest/gtest.h"
+#include "storage/disk/disk_manager_memory.h"
+#include "storage/disk/disk_manager_posix.h"
+
+namespace bustub {
+
+// NOLINTNEXTLINE
+TEST(ParallelBufferPoolManagerTest, SampleTest) {
+  const std::string db_name = "test.db";
+  const size_t buffer_pool_size = 5;
+  const size_t num_instances = 5;
+  const size_t k = 5;
+
+  auto *disk_manager = new DiskManager(db_name);
+  auto *bpm = new ParallelBufferPoolManager(num_instances, buffer_pool_size, disk_manager, k);
+  EXPECT_EQ(num_instances * buffer_pool_size, bpm->GetPoolSize());
+
+  page_id_t page_id_temp;
+  auto *page0 = bpm->NewPage(&page_id_temp);
+
+  // Scenario: The buffer pool is empty. We should be able to create a new page.
+  ASSERT_NE(nullptr, page0);
+  EXPECT_EQ(0, page_id_temp);
+
+  // Scenario: Once we have a page, we should be able to read and write content.
+  snprintf(page0->GetData(), BUSTUB_PAGE_SIZE, "Hello");
+  EXPECT_EQ(0, strcmp(page0->GetData(), "Hello"));
+
+  // Scenario: We should be able to create new pages until we fill up the buffer pool. Page ids are handed out
+  // round-robin across the instances, so they are still dense.
+  for (size_t i = 1; i < buffer_pool_size * num_instances; ++i) {
+    EXPECT_NE(nullptr, bpm->NewPage(&page_id_temp));
+    EXPECT_EQ(static_cast<page_id_t>(i), page_id_temp);
+  }
+
+  // Scenario: Once the buffer pool is full, we should not be able to create any new pages.
+  for (size_t i = buffer_pool_size * num_instances; i < buffer_pool_size * num_instances * 2; ++i) {
+    EXPECT_EQ(nullptr, bpm->NewPage(&page_id_temp));
+  }
+
+  // Scenario: After unpinning pages {0, 1, 2, 3, 4}, every instance has exactly one evictable frame. Fetching page 0
+  // is still a hit.
+  for (int i = 0; i < 5; ++i) {
+    EXPECT_EQ(true, bpm->UnpinPage(i, true));
+  }
+  page0 = bpm->FetchPage(0);
+  ASSERT_NE(nullptr, page0);
+  EXPECT_EQ(0, strcmp(page0->GetData(), "Hello"));
+  EXPECT_EQ(true, bpm->UnpinPage(0, false));
+
+  // Scenario: Creating one new page per instance evicts the unpinned pages, so page 0 can no longer be fetched.
+  page_id_t page_on_instance_zero = INVALID_PAGE_ID;
+  for (size_t i = 0; i < num_instances; ++i) {
+    EXPECT_NE(nullptr, bpm->NewPage(&page_id_temp));
+    if (page_id_temp % num_instances == 0) {
+      page_on_instance_zero = page_id_temp;
+    }
+  }
+  ASSERT_NE(INVALID_PAGE_ID, page_on_instance_zero);
+  EXPECT_EQ(nullptr, bpm->FetchPage(0));
+
+  // Scenario: Freeing a frame on the instance that owns page 0 lets us read it back from disk.
+  EXPECT_EQ(true, bpm->UnpinPage(page_on_instance_zero, false));
+  page0 = bpm->FetchPage(0);
+  ASSERT_NE(nullptr, page0);
+  EXPECT_EQ(0, strcmp(page0->GetData(), "Hello"));
+  EXPECT_EQ(true, bpm->UnpinPage(0, false));
+
+  // Shutdown the disk manager and remove the temporary file we created.
+  disk_manager->ShutDown();
+  remove("test.db");
+
+  delete bpm;
+  delete disk_manager;
+}
+
+// NOLINTNEXTLINE
+TEST(ParallelBufferPoolManagerTest, ResizeTest) {
+  const size_t num_instances = 4;
+  auto *disk_manager = new DiskManagerUnlimitedMemory();
+  auto *bpm = new ParallelBufferPoolManager(num_instances, 4, disk_manager);
+
+  // Scenario: a size that leaves an instance without frames, or one too large for an instance, resizes nothing.
+  EXPECT_THROW(bpm->SetPoolSize(num_instances - 1), Exception);
+  EXPECT_THROW(bpm->SetPoolSize(num_instances * BufferPoolManagerInstance::MAX_POOL_SIZE + 1), Exception);
+  EXPECT_EQ(16, bpm->GetPoolSize());
+
+  // Scenario: the new size is split as evenly as possible.
+  EXPECT_EQ(10, bpm->SetPoolSize(10));
+  EXPECT_EQ(10, bpm->GetPoolSize());
+  EXPECT_EQ(num_instances, bpm->SetPoolSize(num_instances));
+
+  delete bpm;
+  delete disk_manager;
+}
+
+// NOLINTNEXTLINE
+TEST(ParallelBufferPoolManagerTest, ConcurrencyTest) {
+  const size_t num_threads = 8;
+  const size_t num_instances = 4;
+  const size_t buffer_pool_size = 16;
+  const int pages_per_thread = 100;
+
+  auto *disk_manager = new DiskManagerUnlimitedMemory();
+  auto *bpm = new ParallelBufferPoolManager(num_instances, buffer_pool_size, disk_manager);
+
+  std::vector<std::thread> threads;
+  for (size_t tid = 0; tid < num_threads; ++tid) {
+    threads.emplace_back([bpm] {
+      std::vector<page_id_t> page_ids;
+      for (int i = 0; i < pages_per_thread; ++i) {
+        page_id_t page_id;
+        auto *page = bpm->NewPage(&page_id);
+        ASSERT_NE(nullptr, page);
+        snprintf(page->GetData(), BUSTUB_PAGE_SIZE, "%d", page_id);
+        EXPECT_TRUE(bpm->UnpinPage(page_id, true));
+        page_ids.push_back(page_id);
+      }
+      for (auto page_id : page_ids) {
+        auto *page = bpm->FetchPage(page_id);
+        ASSERT_NE(nullptr, page);
+        EXPECT_EQ(std::to_string(page_id), std::string(page->GetData()));
+        EXPECT_TRUE(bpm->UnpinPage(page_id, false));
+      }
+      for (auto page_id : page_ids) {
+        EXPECT_TRUE(bpm->DeletePage(page_id));
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+
+  delete bpm;
+  delete disk_manager;
+}
+
+// With NUMA sub-pools, every instance is bound to a node and new pages still fill every instance.
+TEST(ParallelBufferPoolManagerTest, NumaSubPoolsTest) {
+  const size_t num_instances = 4;
+  const size_t buffer_pool_size = 4;
+
+  auto *disk_manager = new DiskManagerUnlimitedMemory();
+  FrameArenaOptions options;
+  options.numa_sub_pools_ = true;
+  auto *bpm = new ParallelBufferPoolManager(num_instances, buffer_pool_size, disk_manager, LRUK_REPLACER_K, nullptr,
+                                            ReplacerPolicy::LRU_K, options);
+  EXPECT_GE(bpm->GetNumNumaNodes(), 1);
+  EXPECT_LE(bpm->GetNumNumaNodes(), num_instances);
+
+  // the local instances are tried first, then the others, so the whole pool can be filled
+  std::vector<page_id_t> page_ids;
+  for (size_t i = 0; i < num_instances * buffer_pool_size; ++i) {
+    page_id_t page_id;
+    auto *page = bpm->NewPage(&page_id);
+    ASSERT_NE(nullptr, page);
+    snprintf(page->GetData(), BUSTUB_PAGE_SIZE, "%d", page_id);
+    page_ids.push_back(page_id);
+  }
+  page_id_t page_id;
+  EXPECT_EQ(nullptr, bpm->NewPage(&page_id));
+  for (auto id : page_ids) {
+    EXPECT_EQ(std::to_string(id), std::string(bpm->FetchPage(id)->GetData()));
+    EXPECT_TRUE(bpm->UnpinPage(id, false));
+    EXPECT_TRUE(bpm->UnpinPage(id, true));
+  }
+
+  delete bpm;
+  delete disk_manager;
+}
+
+// NOLINTNEXTLINE
+TEST(ParallelBufferPoolManagerTest, CoalescedFlushTest) {
+  const std::string db_name = "test.db";
+  const size_t num_instances = 4;
+  const size_t buffer_pool_size = 16;
+
+  auto *disk_manager = new DiskManagerPosix(db_name);
+  auto *bpm = new ParallelBufferPoolManager(num_instances, buffer_pool_size, disk_manager);
+  std::vector<page_id_t> page_ids;
+  for (size_t i = 0; i < num_instances * buffer_pool_size; ++i) {
+    page_id_t page_id;
+    auto *page = bpm->NewPage(&page_id);
+    ASSERT_NE(nullptr, page);
+    snprintf(page->GetData(), BUSTUB_PAGE_SIZE, "%d", page_id);
+    page_ids.push_back(page_id);
+  }
+  for (auto id : page_ids) {
+    EXPECT_TRUE(bpm->UnpinPage(id, true));
+  }
+
+  // consecutive pages belong to different instances, still they are written with a single vectored write
+  bpm->FlushAllPages();
+  EXPECT_EQ(1, disk_manager->GetNumFileWrites());
+  EXPECT_EQ(static_cast<int>(page_ids.size()), disk_manager->GetNumWrites());
+  char buf[BUSTUB_PAGE_SIZE];
+  for (auto id : page_ids) {
+    disk_manager->ReadPage(id, buf);
+    EXPECT_EQ(std::to_string(id), std::string(buf));
+  }
+  // the pages are clean now, there is nothing left to flush
+  bpm->FlushAllPages();
+  EXPECT_EQ(1, disk_manager->GetNumFileWrites());
+
+  delete bpm;
+  disk_manager->ShutDown();
+  remove(db_name.c_str());
+  delete disk_manager;
+}
+
+}  // namespace bustub
@@ -0,0 +1,167 @@
+/**
+ * replacer_comparison_test.cpp
+ *
+ * Trace-driven comparison of the replacement policies: every policy replays the same page reference traces through
+ * SimulateReplacer(), and the harness reports hit ratios and the cost of a replacer call. A second benchmark replays a
+ * trace through a buffer pool on simulated devices, and reports the time its misses take on each of them.
+ */
+
+#include <algorithm>
+#include <chrono>  // NOLINT
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "buffer/buffer_pool_manager_instance.h"
+#include "buffer/replacer_simulator.h"
+#include "gtest/gtest.h"
+#include "storage/disk/disk_manager_memory.h"
+#include "storage/disk/disk_manager_simulated.h"
+
+namespace bustub {
+
+namespace {
+
+const std::vector<ReplacerPolicy> POLICIES = {ReplacerPolicy::LRU_K, ReplacerPolicy::LRU, ReplacerPolicy::CLOCK,
+                                              ReplacerPolicy::TWO_Q, ReplacerPolicy::ARC};
+
+/** 80% of the references go to 20% of the pages. */
+auto HotColdTrace(size_t num_pages, size_t num_refs) -> std::vector<page_id_t> {
+  std::mt19937 rng(15445);
+  std::uniform_int_distribution<page_id_t> hot(0, static_cast<page_id_t>(num_pages / 5) - 1);
+  std::uniform_int_distribution<page_id_t> cold(static_cast<page_id_t>(num_pages / 5),
+                                                static_cast<page_id_t>(num_pages) - 1);
+  std::uniform_int_distribution<int> coin(0, 9);
+  std::vector<page_id_t> trace(num_refs);
+  for (auto &page_id : trace) {
+    page_id = coin(rng) < 8 ? hot(rng) : cold(rng);
+  }
+  return trace;
+}
+
+/** Random references to a small hot set, interrupted by sequential scans over pages that are never reused. */
+auto HotSetWithScansTrace(size_t num_hot_pages, size_t scan_length, size_t num_refs) -> std::vector<page_id_t> {
+  std::mt19937 rng(15445);
+  std::uniform_int_distribution<page_id_t> hot(0, static_cast<page_id_t>(num_hot_pages) - 1);
+  std::vector<page_id_t> trace;
+  trace.reserve(num_refs);
+  auto next_scan_page = static_cast<page_id_t>(num_hot_pages);
+  while (trace.size() < num_refs) {
+    for (size_t i = 0; i < 4 * num_hot_pages && trace.size() < num_refs; ++i) {
+      trace.push_back(hot(rng));
+    }
+    for (size_t i = 0; i < scan_length && trace.size() < num_refs; ++i) {
+      trace.push_back(next_scan_page++);
+    }
+  }
+  return trace;
+}
+
+/** Repeated sequential passes over a set of pages slightly larger than the pool, the worst case of LRU. */
+auto LoopTrace(size_t num_pages, size_t num_refs) -> std::vector<page_id_t> {
+  std::vector<page_id_t> trace(num_refs);
+  for (size_t i = 0; i < num_refs; ++i) {
+    trace[i] = static_cast<page_id_t>(i % num_pages);
+  }
+  return trace;
+}
+
+}  // namespace
+
+/*
+ * Benchmark: hit ratio and replacer cost of every policy on three synthetic traces.
+ */
+TEST(ReplacerComparisonTest, TraceComparison) {
+  const size_t num_frames = 256;
+  const size_t num_refs = 100000;
+  struct Trace {
+    std::string name_;
+    std::vector<page_id_t> pages_;
+    /** Policies that must get a better hit ratio than plain LRU on this trace. */
+    std::vector<ReplacerPolicy> beat_lru_;
+  };
+  const std::vector<Trace> traces = {
+      {"hot/cold",
+       HotColdTrace(num_frames * 4, num_refs),
+       {ReplacerPolicy::LRU_K, ReplacerPolicy::TWO_Q, ReplacerPolicy::ARC}},
+      // without pressure between the scans, full 2Q never promotes the hot set out of A1in
+      {"hot+scans",
+       HotSetWithScansTrace(num_frames / 2, num_frames * 2, num_refs),
+       {ReplacerPolicy::LRU_K, ReplacerPolicy::ARC}},
+      {"loop", LoopTrace(num_frames + num_frames / 4, num_refs), {ReplacerPolicy::TWO_Q}},
+  };
+
+  std::stringstream ss;
+  ss << "[BENCHMARK: ReplacerComparisonTest.TraceComparison] " << num_frames << " frames, " << num_refs
+     << " references per trace" << std::endl;
+  ss << std::setw(12) << "trace" << std::setw(8) << "policy" << std::setw(10) << "hit%" << std::setw(10) << "ns/op"
+     << std::endl;
+  for (const auto &trace : traces) {
+    std::vector<ReplacerSimulationResult> results;
+    for (auto policy : POLICIES) {
+      results.push_back(SimulateReplacer(policy, num_frames, trace.pages_, 2));
+      ss << std::setw(12) << trace.name_ << std::setw(8) << ReplacerPolicyToString(policy) << std::setw(10)
+         << std::fixed << std::setprecision(1) << 100 * results.back().HitRatio() << std::setw(10)
+         << results.back().ns_per_op_ << std::endl;
+      EXPECT_EQ(trace.pages_.size(), results.back().hits_ + results.back().misses_);
+    }
+    for (auto policy : trace.beat_lru_) {
+      EXPECT_GT(results[static_cast<size_t>(policy)].HitRatio(),
+                results[static_cast<size_t>(ReplacerPolicy::LRU)].HitRatio())
+          << ReplacerPolicyToString(policy) << " on " << trace.name_;
+    }
+  }
+  std::cout << ss.str();
+}
+
+/*
+ * Benchmark: the hot set with scans trace through a buffer pool on a simulated SSD and HDD, in virtual time. On the
+ * disk, the misses on the hot set are random reads that each pay a seek, while the scans read sequentially; a policy
+ * that keeps the hot set resident through the scans saves most of the I/O time.
+ */
+TEST(ReplacerComparisonTest, SimulatedDeviceComparison) {
+  const size_t num_frames = 128;
+  const auto trace = HotSetWithScansTrace(num_frames / 2, num_frames * 2, 20000);
+  const page_id_t num_pages = *std::max_element(trace.begin(), trace.end()) + 1;
+  const std::vector<std::pair<std::string, SimulatedDeviceProfile>> devices = {
+      {"ssd", SimulatedDeviceProfile::Ssd()}, {"hdd", SimulatedDeviceProfile::Hdd()}};
+
+  std::stringstream ss;
+  ss << "[BENCHMARK: ReplacerComparisonTest.SimulatedDeviceComparison] " << num_frames << " frames, " << trace.size()
+     << " references, simulated I/O time" << std::endl;
+  ss << std::setw(8) << "device" << std::setw(8) << "policy" << std::setw(10) << "hit%" << std::setw(10) << "reads"
+     << std::setw(10) << "seeks" << std::setw(12) << "io_ms" << std::endl;
+  std::vector<std::vector<double>> io_ms(devices.size());
+  for (size_t d = 0; d < devices.size(); ++d) {
+    for (auto policy : POLICIES) {
+      DiskManagerUnlimitedMemory memory;
+      char data[BUSTUB_PAGE_SIZE] = {0};
+      for (page_id_t page_id = 0; page_id < num_pages; ++page_id) {
+        memory.WritePage(page_id, data);
+      }
+      DiskManagerSimulated device(&memory, devices[d].second, false);
+      BufferPoolManagerInstance bpm(num_frames, &device, 2, nullptr, policy);
+      for (auto page_id : trace) {
+        ASSERT_NE(nullptr, bpm.FetchPage(page_id));
+        bpm.UnpinPage(page_id, false);
+      }
+      const auto stats = device.GetStats();
+      io_ms[d].push_back(std::chrono::duration<double, std::milli>(device.GetSimulatedTime()).count());
+      ss << std::setw(8) << devices[d].first << std::setw(8) << ReplacerPolicyToString(policy) << std::setw(10)
+         << std::fixed << std::setprecision(1) << 100 * bpm.GetMetrics().HitRatio() << std::setw(10) << stats.reads_
+         << std::setw(10) << stats.seeks_ << std::setw(12) << io_ms[d].back() << std::endl;
+      EXPECT_EQ(bpm.GetMetrics().misses_, stats.reads_);
+    }
+  }
+  // random reads are what the disk is slow at
+  for (size_t i = 0; i < POLICIES.size(); ++i) {
+    EXPECT_GT(io_ms[1][i], io_ms[0][i]);
+  }
+  EXPECT_LT(io_ms[1][static_cast<size_t>(ReplacerPolicy::LRU_K)], io_ms[1][static_cast<size_t>(ReplacerPolicy::LRU)]);
+  std::cout << ss.str();
+}
+
+}  // namespace bustub
@@ -0,0 +1,60 @@
+/**
+ * two_q_replacer_test.cpp
+ */
+
+#include "buffer/two_q_replacer.h"
+
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace bustub {
+
+TEST(TwoQReplacerTest, SampleTest) {
+  // 8 frames: A1in targets 2 frames, A1out remembers 4 pages.
+  TwoQReplacer replacer(8);
+
+  // Scenario: load four pages. They all enter A1in, which is over its target, so it is evicted in FIFO order and
+  // repeated accesses to a page in A1in do not change that.
+  for (frame_id_t frame_id = 0; frame_id < 4; ++frame_id) {
+    replacer.RecordLoad(frame_id, 100 + frame_id);
+    replacer.SetEvictable(frame_id, true);
+  }
+  replacer.RecordAccess(0);
+  replacer.RecordAccess(0);
+  ASSERT_EQ(4, replacer.Size());
+  frame_id_t frame_id;
+  ASSERT_TRUE(replacer.Evict(&frame_id));
+  EXPECT_EQ(0, frame_id);
+
+  // Scenario: page 100 comes back while A1out remembers it, so it goes to Am and is protected from A1in churn.
+  replacer.RecordLoad(0, 100);
+  replacer.SetEvictable(0, true);
+  EXPECT_EQ((std::vector<frame_id_t>{1, 0, 2, 3}), replacer.EvictionCandidates(8));
+  ASSERT_TRUE(replacer.Evict(&frame_id));
+  EXPECT_EQ(1, frame_id);
+
+  // Scenario: A1in is back at its target, so Am gives up its LRU page next. Pinned frames are skipped.
+  replacer.SetEvictable(0, false);
+  ASSERT_TRUE(replacer.Evict(&frame_id));
+  EXPECT_EQ(2, frame_id);
+  replacer.SetEvictable(0, true);
+  ASSERT_TRUE(replacer.Evict(&frame_id));
+  EXPECT_EQ(0, frame_id);
+  ASSERT_EQ(1, replacer.Size());
+
+  // Scenario: a page evicted from Am is not remembered and starts over in A1in, a page evicted from A1in is.
+  replacer.RecordLoad(0, 100);
+  replacer.RecordLoad(1, 101);
+  replacer.SetEvictable(0, true);
+  replacer.SetEvictable(1, true);
+  EXPECT_EQ((std::vector<frame_id_t>{1, 3, 0}), replacer.EvictionCandidates(8));
+
+  // Scenario: removing a frame forgets it without remembering its page.
+  replacer.Remove(3);
+  EXPECT_EQ(2, replacer.Size());
+  replacer.Remove(3);
+  EXPECT_EQ(2, replacer.Size());
+}
+
+}  // namespace bustub
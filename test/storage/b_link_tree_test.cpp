@@ -0,0 +1,147 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// b_link_tree_test.cpp
+//
+// Identification: test/storage/b_link_tree_test.cpp
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <algorithm>
+#include <cstdio>
+#include <random>
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "buffer/buffer_pool_manager_instance.h"
+#include "gtest/gtest.h"
+#include "storage/disk/disk_manager_memory.h"
+#include "storage/index/b_link_tree.h"
+#include "test_util.h"  // NOLINT
+
+namespace bustub {
+
+using BLinkTestTree = BLinkTree<GenericKey<8>, RID, GenericComparator<8>>;
+
+TEST(BLinkTreeTest, InsertRemoveTest) {
+  auto key_schema = ParseCreateStatement("a bigint");
+  GenericComparator<8> comparator(key_schema.get());
+  auto *disk_manager = new DiskManagerUnlimitedMemory();
+  auto *bpm = new BufferPoolManagerInstance(50, disk_manager);
+  page_id_t page_id;
+  ASSERT_NE(nullptr, bpm->NewPage(&page_id));
+  ASSERT_EQ(HEADER_PAGE_ID, page_id);
+
+  // tiny nodes, so that the tree gets a few levels
+  BLinkTestTree tree("foo_pk", bpm, comparator, 3, 3);
+  EXPECT_TRUE(tree.IsEmpty());
+
+  std::vector<int64_t> keys(500);
+  for (size_t i = 0; i < keys.size(); ++i) {
+    keys[i] = static_cast<int64_t>(i) + 1;
+  }
+  std::shuffle(keys.begin(), keys.end(), std::mt19937(0));
+  GenericKey<8> index_key;
+  RID rid;
+  for (auto key : keys) {
+    rid.Set(static_cast<int32_t>(key >> 32), static_cast<int32_t>(key & 0xFFFFFFFF));
+    index_key.SetFromInteger(key);
+    EXPECT_TRUE(tree.Insert(index_key, rid));
+  }
+  index_key.SetFromInteger(keys[0]);
+  EXPECT_FALSE(tree.Insert(index_key, rid));
+
+  std::vector<RID> result;
+  for (auto key : keys) {
+    index_key.SetFromInteger(key);
+    result.clear();
+    ASSERT_TRUE(tree.GetValue(index_key, &result));
+    EXPECT_EQ(key, result[0].GetSlotNum());
+  }
+
+  // the leaves are linked in key order
+  auto entries = tree.ScanAll();
+  ASSERT_EQ(keys.size(), entries.size());
+  for (size_t i = 0; i < entries.size(); ++i) {
+    EXPECT_EQ(static_cast<int64_t>(i) + 1, entries[i].second.GetSlotNum());
+  }
+
+  // remove the odd keys
+  for (auto key : keys) {
+    if (key % 2 == 1) {
+      index_key.SetFromInteger(key);
+      tree.Remove(index_key);
+    }
+  }
+  for (auto key : keys) {
+    index_key.SetFromInteger(key);
+    result.clear();
+    EXPECT_EQ(key % 2 == 0, tree.GetValue(index_key, &result));
+  }
+  EXPECT_EQ(keys.size() / 2, tree.ScanAll().size());
+
+  bpm->UnpinPage(HEADER_PAGE_ID, true);
+  delete bpm;
+  delete disk_manager;
+}
+
+TEST(BLinkTreeTest, ConcurrentInsertLookupTest) {
+  auto key_schema = ParseCreateStatement("a bigint");
+  GenericComparator<8> comparator(key_schema.get());
+  auto *disk_manager = new DiskManagerUnlimitedMemory();
+  auto *bpm = new BufferPoolManagerInstance(256, disk_manager);
+  page_id_t page_id;
+  ASSERT_NE(nullptr, bpm->NewPage(&page_id));
+
+  BLinkTestTree tree("foo_pk", bpm, comparator, 4, 4);
+  const size_t num_threads = 8;
+  const int64_t keys_per_thread = 1000;
+
+  // writers insert interleaved keys, so that they split the same nodes; readers look up the keys written so far
+  std::vector<std::thread> threads;
+  for (size_t tid = 0; tid < num_threads; ++tid) {
+    threads.emplace_back([&tree, tid] {
+      GenericKey<8> index_key;
+      RID rid;
+      std::vector<RID> result;
+      for (int64_t i = 0; i < keys_per_thread; ++i) {
+        int64_t key = i * num_threads + tid;
+        rid.Set(0, static_cast<int32_t>(key));
+        index_key.SetFromInteger(key);
+        EXPECT_TRUE(tree.Insert(index_key, rid));
+        result.clear();
+        EXPECT_TRUE(tree.GetValue(index_key, &result));
+      }
+      // remove half of the own keys again while the others still insert
+      for (int64_t i = 0; i < keys_per_thread; i += 2) {
+        index_key.SetFromInteger(i * num_threads + tid);
+        tree.Remove(index_key);
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+
+  GenericKey<8> index_key;
+  std::vector<RID> result;
+  for (int64_t key = 0; key < keys_per_thread * static_cast<int64_t>(num_threads); ++key) {
+    index_key.SetFromInteger(key);
+    result.clear();
+    EXPECT_EQ((key / static_cast<int64_t>(num_threads)) % 2 == 1, tree.GetValue(index_key, &result));
+  }
+  auto entries = tree.ScanAll();
+  EXPECT_EQ(keys_per_thread * num_threads / 2, entries.size());
+  EXPECT_TRUE(std::is_sorted(entries.begin(), entries.end(), [](const auto &a, const auto &b) {
+    return a.second.GetSlotNum() < b.second.GetSlotNum();
+  }));
+
+  bpm->UnpinPage(HEADER_PAGE_ID, true);
+  delete bpm;
+  delete disk_manager;
+}
+
+}  // namespace bustub
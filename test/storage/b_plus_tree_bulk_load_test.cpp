@@ -0,0 +1,249 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// b_plus_tree_bulk_load_test.cpp
+//
+// Identification: test/storage/b_plus_tree_bulk_load_test.cpp
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <algorithm>
+#include <chrono>  // NOLINT
+#include <cstdio>
+#include <iostream>
+#include <random>
+#include <vector>
+
+#include "buffer/buffer_pool_manager_instance.h"
+#include "gtest/gtest.h"
+#include "storage/disk/disk_manager_memory.h"
+#include "storage/index/b_plus_tree.h"
+#include "storage/index/index_entry_sorter.h"
+#include "test_util.h"  // NOLINT
+
+namespace bustub {
+
+using BulkLoadTestTree = BPlusTree<GenericKey<8>, RID, GenericComparator<8>>;
+using BulkLoadTestInternal = BPlusTreeInternalPage<GenericKey<8>, page_id_t, GenericComparator<8>>;
+
+// Walk the subtree, check the parent links and that no node but the root is underfull, and collect the leaf sizes from
+// left to right and the depth of every leaf.
+void CollectLeaves(BufferPoolManager *bpm, page_id_t page_id, page_id_t parent_page_id, int depth,
+                   std::vector<int> *leaf_sizes, std::vector<int> *leaf_depths) {
+  auto page = reinterpret_cast<BPlusTreePage *>(bpm->FetchPage(page_id)->GetData());
+  EXPECT_EQ(parent_page_id, page->GetParentPageId());
+  if (parent_page_id != INVALID_PAGE_ID) {
+    EXPECT_GE(page->GetSize(), page->GetMinSize());
+  }
+  if (page->IsLeafPage()) {
+    leaf_sizes->push_back(page->GetSize());
+    leaf_depths->push_back(depth);
+  } else {
+    auto internal = reinterpret_cast<BulkLoadTestInternal *>(page);
+    EXPECT_GE(internal->GetSize(), 2);
+    EXPECT_LE(internal->GetSize(), internal->GetMaxSize());
+    for (int i = 0; i < internal->GetSize(); ++i) {
+      CollectLeaves(bpm, internal->ValueAt(i), page_id, depth + 1, leaf_sizes, leaf_depths);
+    }
+  }
+  bpm->UnpinPage(page_id, false);
+}
+
+// Bulk load the keys first, first + step, ... from a sorted vector.
+auto BulkLoadKeys(BulkLoadTestTree *tree, int64_t first, int64_t count, int64_t step, int fill_factor) -> bool {
+  std::vector<int64_t> keys;
+  for (int64_t i = 0; i < count; ++i) {
+    keys.push_back(first + i * step);
+  }
+  size_t next = 0;
+  return tree->BulkLoad(
+      keys.size(),
+      [&](GenericKey<8> *key, RID *rid) {
+        key->SetFromInteger(keys[next]);
+        rid->Set(static_cast<int32_t>(keys[next] >> 32), static_cast<int32_t>(keys[next] & 0xFFFFFFFF));
+        next++;
+        return true;
+      },
+      fill_factor);
+}
+
+TEST(BPlusTreeBulkLoadTest, BuildTest) {
+  auto key_schema = ParseCreateStatement("a bigint");
+  GenericComparator<8> comparator(key_schema.get());
+  auto *disk_manager = new DiskManagerUnlimitedMemory();
+  auto *bpm = new BufferPoolManagerInstance(50, disk_manager);
+  page_id_t page_id;
+  ASSERT_NE(nullptr, bpm->NewPage(&page_id));
+
+  for (int64_t count : {1, 2, 5, 17, 1000}) {
+    for (int fill_factor : {10, 50, 100}) {
+      BulkLoadTestTree tree("foo_pk", bpm, comparator, 5, 4);
+      ASSERT_TRUE(BulkLoadKeys(&tree, 1, count, 2, fill_factor));
+      ASSERT_FALSE(BulkLoadKeys(&tree, 1, count, 2, fill_factor));
+
+      // every leaf at the same depth and within its bounds, none of them underfull
+      std::vector<int> leaf_sizes;
+      std::vector<int> leaf_depths;
+      CollectLeaves(bpm, tree.GetRootPageId(), INVALID_PAGE_ID, 0, &leaf_sizes, &leaf_depths);
+      EXPECT_EQ(leaf_depths.size(), std::count(leaf_depths.begin(), leaf_depths.end(), leaf_depths[0]));
+      for (auto size : leaf_sizes) {
+        EXPECT_LE(size, 4);
+        EXPECT_GE(size, std::min<int64_t>(count, 2));
+      }
+      // 4 or 2 entries per leaf, a leaf holds at least 2 whatever the fill factor
+      auto expected_leaves = fill_factor == 100 ? (count + 3) / 4 : std::max<int64_t>({count / 2, (count + 3) / 4, 1});
+      EXPECT_EQ(expected_leaves, leaf_sizes.size());
+
+      int64_t expected = 1;
+      for (auto iter = tree.Begin(); iter != tree.End(); ++iter) {
+        EXPECT_EQ(expected, (*iter).second.GetSlotNum());
+        expected += 2;
+      }
+      EXPECT_EQ(1 + count * 2, expected);
+
+      // the tree keeps working: fill the gaps and remove the loaded keys again
+      GenericKey<8> index_key;
+      RID rid;
+      Transaction transaction(0);
+      for (int64_t key = 2; key <= count * 2; key += 2) {
+        index_key.SetFromInteger(key);
+        rid.Set(0, static_cast<int32_t>(key));
+        EXPECT_TRUE(tree.Insert(index_key, rid, &transaction));
+      }
+      for (int64_t key = 1; key < count * 2; key += 2) {
+        index_key.SetFromInteger(key);
+        tree.Remove(index_key, &transaction);
+      }
+      std::vector<RID> result;
+      for (int64_t key = 1; key <= count * 2; ++key) {
+        index_key.SetFromInteger(key);
+        result.clear();
+        EXPECT_EQ(key % 2 == 0, tree.GetValue(index_key, &result));
+      }
+      for (int64_t key = 2; key <= count * 2; key += 2) {
+        index_key.SetFromInteger(key);
+        tree.Remove(index_key, &transaction);
+      }
+      EXPECT_TRUE(tree.IsEmpty());
+    }
+  }
+
+  bpm->UnpinPage(HEADER_PAGE_ID, true);
+  delete bpm;
+  delete disk_manager;
+}
+
+TEST(BPlusTreeBulkLoadTest, LowFillFactorTest) {
+  auto key_schema = ParseCreateStatement("a bigint");
+  GenericComparator<8> comparator(key_schema.get());
+  auto *disk_manager = new DiskManagerUnlimitedMemory();
+  auto *bpm = new BufferPoolManagerInstance(50, disk_manager);
+  page_id_t page_id;
+  ASSERT_NE(nullptr, bpm->NewPage(&page_id));
+
+  // 10% of these nodes is far below their minimum sizes of 10 entries and 11 children
+  BulkLoadTestTree tree("foo_pk", bpm, comparator, 20, 21);
+  const int64_t count = 5000;
+  ASSERT_TRUE(BulkLoadKeys(&tree, 1, count, 1, 10));
+  std::vector<int> leaf_sizes;
+  std::vector<int> leaf_depths;
+  CollectLeaves(bpm, tree.GetRootPageId(), INVALID_PAGE_ID, 0, &leaf_sizes, &leaf_depths);
+  EXPECT_EQ(leaf_depths.size(), std::count(leaf_depths.begin(), leaf_depths.end(), leaf_depths[0]));
+  EXPECT_EQ(count / 10, leaf_sizes.size());
+
+  int64_t expected = 1;
+  for (auto iter = tree.Begin(); iter != tree.End(); ++iter) {
+    EXPECT_EQ(expected, (*iter).second.GetSlotNum());
+    expected++;
+  }
+  EXPECT_EQ(count + 1, expected);
+
+  bpm->UnpinPage(HEADER_PAGE_ID, true);
+  delete bpm;
+  delete disk_manager;
+}
+
+TEST(BPlusTreeBulkLoadTest, ExternalSortTest) {
+  auto key_schema = ParseCreateStatement("a bigint");
+  GenericComparator<8> comparator(key_schema.get());
+
+  // every key twice, in random order; the first one added must win
+  std::vector<int64_t> keys;
+  for (int64_t key = 0; key < 10000; ++key) {
+    keys.push_back(key);
+    keys.push_back(key);
+  }
+  std::shuffle(keys.begin(), keys.end(), std::mt19937(0));
+
+  for (size_t memory_budget : {size_t{1} << 20, 1000 * sizeof(std::pair<GenericKey<8>, RID>)}) {
+    IndexEntrySorter<GenericKey<8>, RID, GenericComparator<8>> sorter(comparator, memory_budget);
+    GenericKey<8> index_key;
+    std::vector<bool> seen(10000, false);
+    for (size_t i = 0; i < keys.size(); ++i) {
+      index_key.SetFromInteger(keys[i]);
+      // the first copy of a key gets slot 0, the second slot 1
+      sorter.Add(index_key, RID(static_cast<page_id_t>(keys[i]), seen[keys[i]] ? 1 : 0));
+      seen[keys[i]] = true;
+    }
+    sorter.Finish();
+    EXPECT_EQ(memory_budget == size_t{1} << 20 ? 0 : 20, sorter.GetNumRuns());
+    EXPECT_EQ(10000, sorter.GetNumEntries());
+
+    RID rid;
+    int64_t expected = 0;
+    while (sorter.Next(&index_key, &rid)) {
+      EXPECT_EQ(expected, rid.GetPageId());
+      EXPECT_EQ(0, rid.GetSlotNum());
+      expected++;
+    }
+    EXPECT_EQ(10000, expected);
+  }
+}
+
+TEST(BPlusTreeBulkLoadTest, DISABLED_BulkLoadBenchmark) {
+  auto key_schema = ParseCreateStatement("a bigint");
+  GenericComparator<8> comparator(key_schema.get());
+  const int64_t num_keys = 200000;
+  std::vector<int64_t> keys(num_keys);
+  for (int64_t i = 0; i < num_keys; ++i) {
+    keys[i] = i;
+  }
+  std::shuffle(keys.begin(), keys.end(), std::mt19937(0));
+
+  for (bool bulk_load : {false, true}) {
+    auto *disk_manager = new DiskManagerUnlimitedMemory();
+    auto *bpm = new BufferPoolManagerInstance(256, disk_manager);
+    page_id_t page_id;
+    bpm->NewPage(&page_id);
+    BulkLoadTestTree tree("foo_pk", bpm, comparator);
+
+    auto start = std::chrono::steady_clock::now();
+    GenericKey<8> index_key;
+    Transaction transaction(0);
+    if (bulk_load) {
+      IndexEntrySorter<GenericKey<8>, RID, GenericComparator<8>> sorter(comparator, 1 << 20);
+      for (auto key : keys) {
+        index_key.SetFromInteger(key);
+        sorter.Add(index_key, RID(key));
+      }
+      sorter.Finish();
+      tree.BulkLoad(sorter.GetNumEntries(), [&](GenericKey<8> *key, RID *rid) { return sorter.Next(key, rid); });
+    } else {
+      for (auto key : keys) {
+        index_key.SetFromInteger(key);
+        tree.Insert(index_key, RID(key), &transaction);
+      }
+    }
+    auto elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::cout << (bulk_load ? "bulk load: " : "insert: ") << num_keys << " keys in " << elapsed << " s" << std::endl;
+
+    bpm->UnpinPage(HEADER_PAGE_ID, true);
+    delete bpm;
+    delete disk_manager;
+  }
+}
+
+}  // namespace bustub
@@ -17,7 +17,8 @@
 
 namespace bustub {
 
-bool BPlusTreeLockBenchmarkCall(size_t num_threads, int leaf_node_size, bool with_global_mutex) {
+bool BPlusTreeLockBenchmarkCall(size_t num_threads, int leaf_node_size, bool with_global_mutex,
+                                bool optimistic = true) {
   bool success = true;
   std::vector<int64_t> insert_keys;
 
@@ -28,6 +29,7 @@ bool BPlusTreeLockBenchmarkCall(size_t num_threads, int leaf_node_size, bool wit
   BufferPoolManager *bpm = new BufferPoolManagerInstance(64, disk_manager);
   // create b+ tree
   BPlusTree<GenericKey<8>, RID, GenericComparator<8>> tree("foo_pk", bpm, comparator, leaf_node_size, 10);
+  tree.SetOptimisticLatching(optimistic);
   // create and fetch header_page
   page_id_t page_id;
   auto *header_page = bpm->NewPage(&page_id);
@@ -67,6 +69,17 @@ bool BPlusTreeLockBenchmarkCall(size_t num_threads, int leaf_node_size, bool wit
     thread.join();
   }
 
+  // every key has to be there, whichever way the writers latched
+  GenericKey<8> index_key;
+  std::vector<RID> result;
+  for (size_t i = 0; i < num_threads; i++) {
+    for (auto key = i * keys_stride; key < i * keys_stride + keys_per_thread; key += 97) {
+      index_key.SetFromInteger(key);
+      result.clear();
+      success = success && tree.GetValue(index_key, &result);
+    }
+  }
+
   bpm->UnpinPage(HEADER_PAGE_ID, true);
   delete disk_manager;
   delete bpm;
@@ -74,6 +87,68 @@ bool BPlusTreeLockBenchmarkCall(size_t num_threads, int leaf_node_size, bool wit
   return success;
 }
 
+TEST(BPlusTreeTest, OptimisticLatchingInsertRemoveTest) {  // NOLINT
+  auto key_schema = ParseCreateStatement("a bigint");
+  GenericComparator<8> comparator(key_schema.get());
+  auto *disk_manager = new DiskManagerMemory(256 << 10);
+  BufferPoolManager *bpm = new BufferPoolManagerInstance(64, disk_manager);
+  // small nodes, so that the optimistic paths keep restarting on splits and merges
+  BPlusTree<GenericKey<8>, RID, GenericComparator<8>> tree("foo_pk", bpm, comparator, 3, 5);
+  tree.SetOptimisticLatching(true);
+  page_id_t page_id;
+  auto *header_page = bpm->NewPage(&page_id);
+  (void)header_page;
+
+  const int64_t num_threads = 8;
+  const int64_t keys_per_thread = 2000;
+  auto rid_for = [](int64_t key) { return RID(static_cast<int32_t>(key >> 32), static_cast<uint32_t>(key)); };
+
+  // every thread inserts its keys interleaved with the other threads' keys and removes the odd ones again right away
+  std::vector<std::thread> threads;
+  for (int64_t i = 0; i < num_threads; i++) {
+    threads.emplace_back([&tree, &rid_for, i]() {
+      GenericKey<8> index_key;
+      auto *transaction = new Transaction(static_cast<txn_id_t>(i + 1));
+      for (int64_t n = 0; n < keys_per_thread; n++) {
+        int64_t key = n * num_threads + i;
+        index_key.SetFromInteger(key);
+        tree.Insert(index_key, rid_for(key), transaction);
+        if (n % 2 == 1) {
+          tree.Remove(index_key, transaction);
+        }
+        if (n % 2 == 0 && n >= 2) {
+          // remove a key inserted earlier, so that removes also race with inserts into the same leaves
+          index_key.SetFromInteger(key - 2 * num_threads);
+          tree.Remove(index_key, transaction);
+          tree.Insert(index_key, rid_for(key - 2 * num_threads), transaction);
+        }
+      }
+      delete transaction;
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+
+  GenericKey<8> index_key;
+  std::vector<RID> result;
+  for (int64_t key = 0; key < keys_per_thread * num_threads; key++) {
+    index_key.SetFromInteger(key);
+    result.clear();
+    if ((key / num_threads) % 2 == 0) {
+      ASSERT_TRUE(tree.GetValue(index_key, &result)) << key;
+      ASSERT_EQ(1, result.size());
+      EXPECT_EQ(rid_for(key), result[0]);
+    } else {
+      EXPECT_FALSE(tree.GetValue(index_key, &result)) << key;
+    }
+  }
+
+  bpm->UnpinPage(HEADER_PAGE_ID, true);
+  delete disk_manager;
+  delete bpm;
+}
+
 TEST(BPlusTreeTest, BPlusTreeContentionBenchmark) {  // NOLINT
   std::vector<size_t> time_ms_with_mutex;
   std::vector<size_t> time_ms_wo_mutex;
@@ -154,4 +229,41 @@ TEST(BPlusTreeTest, BPlusTreeContentionBenchmark2) {  // NOLINT
             << std::endl;
 }
 
+TEST(BPlusTreeTest, DISABLED_BPlusTreeOptimisticLatchingBenchmark) {  // NOLINT
+  std::vector<size_t> time_ms_optimistic;
+  std::vector<size_t> time_ms_pessimistic;
+  for (size_t iter = 0; iter < 20; iter++) {
+    bool optimistic = iter % 2 == 0;
+    auto clock_start = std::chrono::system_clock::now();
+    ASSERT_TRUE(BPlusTreeLockBenchmarkCall(32, 10, false, optimistic));
+    auto clock_end = std::chrono::system_clock::now();
+    auto dur = std::chrono::duration_cast<std::chrono::milliseconds>(clock_end - clock_start);
+    if (optimistic) {
+      time_ms_optimistic.push_back(dur.count());
+    } else {
+      time_ms_pessimistic.push_back(dur.count());
+    }
+  }
+  std::cout << "This test will see how optimistic latching differs from write latch crabbing on the same workload."
+            << std::endl;
+  std::cout << "<<< BEGIN3" << std::endl;
+  std::cout << "Optimistic Access Time: ";
+  double ratio_1 = 0;
+  double ratio_2 = 0;
+  for (auto x : time_ms_optimistic) {
+    std::cout << x << " ";
+    ratio_1 += x;
+  }
+  std::cout << std::endl;
+
+  std::cout << "Crabbing Access Time: ";
+  for (auto x : time_ms_pessimistic) {
+    std::cout << x << " ";
+    ratio_2 += x;
+  }
+  std::cout << std::endl;
+  std::cout << "Ratio: " << ratio_1 / ratio_2 << std::endl;
+  std::cout << ">>> END3" << std::endl;
+}
+
 }  // namespace bustub
@@ -0,0 +1,111 @@
+/**
+ * b_plus_tree_insert_bench_test.cpp
+ *
+ * Measures how B+ tree insert throughput scales with the number of threads, comparing optimistic latching (read
+ * latches on the inner nodes, a write latch on the leaf) against write latch crabbing from the root.
+ */
+
+#include <algorithm>
+#include <chrono>  // NOLINT
+#include <cstdio>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "buffer/buffer_pool_manager_instance.h"
+#include "gtest/gtest.h"
+#include "storage/disk/disk_manager_memory.h"
+#include "storage/index/b_plus_tree.h"
+#include "test_util.h"  // NOLINT
+
+namespace bustub {
+
+using InsertBenchTree = BPlusTree<GenericKey<8>, RID, GenericComparator<8>>;
+
+struct InsertBenchResult {
+  double inserts_per_second_;
+  uint64_t restarts_;
+};
+
+// Insert total_keys shuffled keys with num_threads threads into an empty tree, check them, return the throughput.
+auto InsertBenchRun(size_t num_threads, int64_t total_keys, bool optimistic) -> InsertBenchResult {
+  auto key_schema = ParseCreateStatement("a bigint");
+  GenericComparator<8> comparator(key_schema.get());
+  auto *disk_manager = new DiskManagerUnlimitedMemory();
+  auto *bpm = new BufferPoolManagerInstance(4096, disk_manager);
+  InsertBenchTree tree("foo_pk", bpm, comparator);
+  tree.SetOptimisticLatching(optimistic);
+  page_id_t page_id;
+  auto *header_page = bpm->NewPage(&page_id);
+  EXPECT_NE(nullptr, header_page);
+
+  std::vector<int64_t> keys(total_keys);
+  for (int64_t i = 0; i < total_keys; ++i) {
+    keys[i] = i + 1;
+  }
+  std::shuffle(keys.begin(), keys.end(), std::mt19937_64(0));
+
+  std::vector<std::thread> threads;
+  auto start = std::chrono::steady_clock::now();
+  for (size_t tid = 0; tid < num_threads; ++tid) {
+    threads.emplace_back([&tree, &keys, tid, num_threads] {
+      auto *transaction = new Transaction(static_cast<txn_id_t>(tid + 1));
+      GenericKey<8> index_key;
+      RID rid;
+      for (size_t i = tid; i < keys.size(); i += num_threads) {
+        rid.Set(static_cast<int32_t>(keys[i] >> 32), static_cast<int32_t>(keys[i] & 0xFFFFFFFF));
+        index_key.SetFromInteger(keys[i]);
+        EXPECT_TRUE(tree.Insert(index_key, rid, transaction));
+      }
+      delete transaction;
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  auto elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+  GenericKey<8> index_key;
+  std::vector<RID> result;
+  for (int64_t key = 1; key <= total_keys; ++key) {
+    index_key.SetFromInteger(key);
+    result.clear();
+    EXPECT_TRUE(tree.GetValue(index_key, &result));
+  }
+
+  InsertBenchResult res{static_cast<double>(total_keys) / elapsed, tree.GetOptimisticRestarts()};
+  bpm->UnpinPage(HEADER_PAGE_ID, true);
+  delete bpm;
+  delete disk_manager;
+  return res;
+}
+
+/*
+ * Benchmark: random inserts into an empty tree that fits in the buffer pool, with an increasing number of threads.
+ * Reports inserts per second with and without optimistic latching, and how many optimistic inserts restarted.
+ */
+TEST(BPlusTreeTest, DISABLED_ConcurrentInsertBenchmark) {  // NOLINT
+  const std::vector<size_t> thread_counts{1, 2, 4, 8, 16};
+  const int64_t total_keys = 50000;
+
+  std::stringstream ss;
+  ss << "[BENCHMARK: BPlusTreeTest.ConcurrentInsertBenchmark] inserts/s" << std::endl;
+  ss << std::setw(8) << "threads" << std::setw(16) << "crabbing" << std::setw(16) << "optimistic" << std::setw(12)
+     << "restarts" << std::endl;
+  for (auto num_threads : thread_counts) {
+    auto crabbing = InsertBenchRun(num_threads, total_keys, false);
+    auto optimistic = InsertBenchRun(num_threads, total_keys, true);
+    EXPECT_EQ(0, crabbing.restarts_);
+    EXPECT_LT(optimistic.restarts_, static_cast<uint64_t>(total_keys));
+    ss << std::setw(8) << num_threads << std::setw(16) << std::fixed << std::setprecision(0)
+       << crabbing.inserts_per_second_ << std::setw(16) << optimistic.inserts_per_second_ << std::setw(12)
+       << optimistic.restarts_ << std::endl;
+  }
+  std::cout << ss.str();
+}
+
+}  // namespace bustub
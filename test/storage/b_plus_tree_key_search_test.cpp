@@ -0,0 +1,167 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// b_plus_tree_key_search_test.cpp
+//
+// Identification: test/storage/b_plus_tree_key_search_test.cpp
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <algorithm>
+#include <chrono>  // NOLINT
+#include <iostream>
+#include <random>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "storage/page/b_plus_tree_key_search.h"
+#include "storage/page/b_plus_tree_leaf_page.h"
+#include "test_util.h"  // NOLINT
+
+namespace bustub {
+
+// Check the lower bound over sorted random keys of every node size against std::lower_bound, with each instruction
+// set the CPU supports.
+template <size_t KeySize>
+void CheckLowerBound() {
+  auto key_schema = ParseCreateStatement("a bigint");
+  GenericComparator<KeySize> comparator(key_schema.get());
+  auto less = [&comparator](const GenericKey<KeySize> &lhs, const GenericKey<KeySize> &rhs) {
+    return comparator(lhs, rhs) < 0;
+  };
+  std::mt19937_64 rng(0);
+  auto original_isa = GetKeySearchIsa();
+
+  for (auto isa : {KeySearchIsa::SCALAR, KeySearchIsa::SSE42, KeySearchIsa::AVX2}) {
+    SetKeySearchIsa(isa);
+    // up to as many keys as a page holds
+    for (int size = 0; size <= static_cast<int>(BUSTUB_PAGE_SIZE / KeySize); size += size < 80 ? 1 : 37) {
+      // negative and positive keys; GenericKey<4> keeps the upper half of a bigint, so the range is wide
+      std::vector<GenericKey<KeySize>> keys(size);
+      for (auto &key : keys) {
+        key.SetFromInteger((static_cast<int64_t>(rng() % 2000000) - 1000000) * (int64_t{1} << 24));
+      }
+      std::sort(keys.begin(), keys.end(), less);
+      for (int i = 0; i < 50; i++) {
+        GenericKey<KeySize> key;
+        if (size > 0 && i % 2 == 0) {
+          key = keys[rng() % size];
+        } else {
+          key.SetFromInteger((static_cast<int64_t>(rng() % 2000002) - 1000001) * (int64_t{1} << 24));
+        }
+        auto expected = std::lower_bound(keys.begin(), keys.end(), key, less) - keys.begin();
+        ASSERT_EQ(expected, (KeySearch<GenericKey<KeySize>, GenericComparator<KeySize>>::LowerBound(
+                                keys.data(), size, key, comparator)))
+            << "size " << size << " isa " << static_cast<int>(GetKeySearchIsa());
+      }
+    }
+  }
+  SetKeySearchIsa(original_isa);
+}
+
+TEST(BPlusTreeKeySearchTest, LowerBoundTest) {
+  CheckLowerBound<4>();
+  CheckLowerBound<8>();
+  CheckLowerBound<16>();
+}
+
+TEST(BPlusTreeKeySearchTest, LeafPageTest) {
+  auto key_schema = ParseCreateStatement("a bigint");
+  GenericComparator<8> comparator(key_schema.get());
+  std::vector<char> data(BUSTUB_PAGE_SIZE);
+  auto *leaf = reinterpret_cast<BPlusTreeLeafPage<GenericKey<8>, RID, GenericComparator<8>> *>(data.data());
+  leaf->Init(1);
+  ASSERT_LE(sizeof(*leaf), BUSTUB_PAGE_SIZE);
+
+  // fill the page up in random order; the values stay with their keys
+  std::vector<int64_t> keys(leaf->GetMaxSize());
+  for (size_t i = 0; i < keys.size(); i++) {
+    keys[i] = static_cast<int64_t>(i * 2) - static_cast<int64_t>(keys.size());
+  }
+  std::shuffle(keys.begin(), keys.end(), std::mt19937(0));
+  GenericKey<8> index_key;
+  for (auto key : keys) {
+    index_key.SetFromInteger(key);
+    EXPECT_TRUE(leaf->Insert(index_key, RID(static_cast<page_id_t>(key), 0), comparator));
+  }
+  EXPECT_FALSE(leaf->Insert(index_key, RID(), comparator));
+  ASSERT_EQ(keys.size(), leaf->GetSize());
+
+  std::sort(keys.begin(), keys.end());
+  std::vector<RID> result;
+  for (size_t i = 0; i < keys.size(); i++) {
+    EXPECT_EQ(keys[i], leaf->GetKV(static_cast<int>(i)).second.GetPageId());
+    index_key.SetFromInteger(keys[i]);
+    EXPECT_EQ(i, leaf->KeyIndex(index_key, comparator));
+    // the odd keys in between are not there
+    index_key.SetFromInteger(keys[i] + 1);
+    EXPECT_EQ(-1, leaf->KeyIndex(index_key, comparator));
+    result.clear();
+    EXPECT_FALSE(leaf->GetValue(index_key, &result, comparator));
+  }
+
+  for (size_t i = 0; i < keys.size(); i += 2) {
+    index_key.SetFromInteger(keys[i]);
+    leaf->RemoveEntry(index_key, comparator);
+  }
+  ASSERT_EQ(keys.size() / 2, leaf->GetSize());
+  for (size_t i = 1; i < keys.size(); i += 2) {
+    index_key.SetFromInteger(keys[i]);
+    result.clear();
+    ASSERT_TRUE(leaf->GetValue(index_key, &result, comparator));
+    EXPECT_EQ(keys[i], result[0].GetPageId());
+  }
+}
+
+// The search of a full leaf before the keys were stored apart: a linear scan over the entries with the comparator.
+TEST(BPlusTreeKeySearchTest, DISABLED_KeySearchBenchmark) {
+  auto key_schema = ParseCreateStatement("a bigint");
+  GenericComparator<8> comparator(key_schema.get());
+  const int size = (BUSTUB_PAGE_SIZE - LEAF_PAGE_HEADER_SIZE) / sizeof(std::pair<GenericKey<8>, RID>);
+  const size_t num_lookups = 1 << 22;
+  std::mt19937_64 rng(0);
+
+  std::vector<std::pair<GenericKey<8>, RID>> entries(size);
+  std::vector<GenericKey<8>> keys(size);
+  for (int i = 0; i < size; i++) {
+    keys[i].SetFromInteger(i * 3);
+    entries[i].first = keys[i];
+  }
+  std::vector<GenericKey<8>> lookups(num_lookups);
+  for (auto &lookup : lookups) {
+    lookup.SetFromInteger(static_cast<int64_t>(rng() % (size * 3)));
+  }
+
+  auto measure = [&](const char *name, const auto &search) {
+    auto start = std::chrono::steady_clock::now();
+    int64_t sum = 0;
+    for (const auto &lookup : lookups) {
+      sum += search(lookup);
+    }
+    auto seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::cout << name << ": " << num_lookups << " searches over " << size << " keys in " << seconds << " s"
+              << std::endl;
+    return sum;
+  };
+  auto linear = measure("linear scan", [&](const GenericKey<8> &key) {
+    int i = 0;
+    while (i < size && comparator(key, entries[i].first) > 0) {
+      i++;
+    }
+    return i;
+  });
+  auto original_isa = GetKeySearchIsa();
+  for (auto isa : {KeySearchIsa::SCALAR, KeySearchIsa::SSE42, KeySearchIsa::AVX2}) {
+    SetKeySearchIsa(isa);
+    const char *names[] = {"scalar", "sse4.2", "avx2"};
+    EXPECT_EQ(linear, measure(names[static_cast<int>(GetKeySearchIsa())], [&](const GenericKey<8> &key) {
+                return KeySearch<GenericKey<8>, GenericComparator<8>>::LowerBound(keys.data(), size, key, comparator);
+              }));
+  }
+  SetKeySearchIsa(original_isa);
+}
+
+}  // namespace bustub
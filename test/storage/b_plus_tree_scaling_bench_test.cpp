@@ -0,0 +1,125 @@
+/**
+ * b_plus_tree_scaling_bench_test.cpp
+ *
+ * Measures how B+ tree point-lookup throughput scales with the number of threads, comparing a single
+ * BufferPoolManagerInstance (one global latch) against a ParallelBufferPoolManager with the same total number of
+ * frames. Disabled by default; run it with --gtest_also_run_disabled_tests.
+ */
+
+#include <chrono>  // NOLINT
+#include <cstdio>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <sstream>
+#include <string>
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "buffer/buffer_pool_manager_instance.h"
+#include "buffer/parallel_buffer_pool_manager.h"
+#include "gtest/gtest.h"
+#include "storage/disk/disk_manager_memory.h"
+#include "storage/index/b_plus_tree.h"
+#include "test_util.h"  // NOLINT
+
+namespace bustub {
+
+using ScalingBenchTree = BPlusTree<GenericKey<8>, RID, GenericComparator<8>>;
+
+// Build a tree holding keys [1, total_keys] on top of the given buffer pool.
+void ScalingBenchPopulate(ScalingBenchTree *tree, int64_t total_keys) {
+  auto *transaction = new Transaction(0);
+  GenericKey<8> index_key;
+  RID rid;
+  for (int64_t key = 1; key <= total_keys; ++key) {
+    rid.Set(static_cast<int32_t>(key >> 32), static_cast<int32_t>(key & 0xFFFFFFFF));
+    index_key.SetFromInteger(key);
+    tree->Insert(index_key, rid, transaction);
+  }
+  delete transaction;
+}
+
+// Run lookups_per_thread random point lookups on each of num_threads threads, return lookups per second.
+auto ScalingBenchLookups(ScalingBenchTree *tree, size_t num_threads, int64_t total_keys, size_t lookups_per_thread)
+    -> double {
+  std::vector<std::thread> threads;
+  auto start = std::chrono::steady_clock::now();
+  for (size_t tid = 0; tid < num_threads; ++tid) {
+    threads.emplace_back([tree, tid, total_keys, lookups_per_thread] {
+      auto *transaction = new Transaction(static_cast<txn_id_t>(tid + 1));
+      std::mt19937_64 rng(tid);
+      std::uniform_int_distribution<int64_t> dist(1, total_keys);
+      GenericKey<8> index_key;
+      std::vector<RID> result;
+      for (size_t i = 0; i < lookups_per_thread; ++i) {
+        index_key.SetFromInteger(dist(rng));
+        result.clear();
+        EXPECT_TRUE(tree->GetValue(index_key, &result, transaction));
+      }
+      delete transaction;
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  auto elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+  return static_cast<double>(num_threads * lookups_per_thread) / elapsed;
+}
+
+auto ScalingBenchRun(BufferPoolManager *bpm, const std::vector<size_t> &thread_counts, int64_t total_keys,
+                     size_t lookups_per_thread) -> std::vector<double> {
+  auto key_schema = ParseCreateStatement("a bigint");
+  GenericComparator<8> comparator(key_schema.get());
+  ScalingBenchTree tree("foo_pk", bpm, comparator);
+  page_id_t page_id;
+  auto *header_page = bpm->NewPage(&page_id);
+  EXPECT_NE(nullptr, header_page);
+  EXPECT_EQ(HEADER_PAGE_ID, page_id);
+
+  ScalingBenchPopulate(&tree, total_keys);
+  std::vector<double> throughput;
+  for (auto num_threads : thread_counts) {
+    throughput.push_back(ScalingBenchLookups(&tree, num_threads, total_keys, lookups_per_thread));
+  }
+  bpm->UnpinPage(HEADER_PAGE_ID, true);
+  return throughput;
+}
+
+/*
+ * Benchmark: point lookups against a tree that does not fit in the buffer pool, with an increasing number of threads.
+ * Both pools have the same number of frames; the parallel one splits them over several independently latched
+ * instances. Reports lookups per second for every thread count.
+ */
+TEST(BPlusTreeTest, DISABLED_ParallelBufferPoolScalingBenchmark) {  // NOLINT
+  const std::vector<size_t> thread_counts{1, 2, 4, 8, 16};
+  const int64_t total_keys = 50000;
+  const size_t lookups_per_thread = 1000;
+  const size_t total_frames = 128;
+  const size_t num_instances = 8;
+
+  auto *single_disk = new DiskManagerUnlimitedMemory();
+  auto *single_bpm = new BufferPoolManagerInstance(total_frames, single_disk);
+  auto single = ScalingBenchRun(single_bpm, thread_counts, total_keys, lookups_per_thread);
+  delete single_bpm;
+  delete single_disk;
+
+  auto *parallel_disk = new DiskManagerUnlimitedMemory();
+  auto *parallel_bpm = new ParallelBufferPoolManager(num_instances, total_frames / num_instances, parallel_disk);
+  auto parallel = ScalingBenchRun(parallel_bpm, thread_counts, total_keys, lookups_per_thread);
+  delete parallel_bpm;
+  delete parallel_disk;
+
+  std::stringstream ss;
+  ss << "[BENCHMARK: BPlusTreeTest.ParallelBufferPoolScalingBenchmark] lookups/s" << std::endl;
+  ss << std::setw(8) << "threads" << std::setw(16) << "1 instance" << std::setw(16)
+     << (std::to_string(num_instances) + " instances") << std::endl;
+  for (size_t i = 0; i < thread_counts.size(); ++i) {
+    ss << std::setw(8) << thread_counts[i] << std::setw(16) << std::fixed << std::setprecision(0) << single[i]
+       << std::setw(16) << parallel[i] << std::endl;
+  }
+  std::cout << ss.str();
+}
+
+}  // namespace bustub
@@ -0,0 +1,163 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// compressed_page_cache_test.cpp
+//
+// Identification: test/storage/compressed_page_cache_test.cpp
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <cstdio>
+#include <cstring>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "storage/disk/compressed_page_cache.h"
+
+namespace bustub {
+
+namespace {
+
+/** A page like a table page: a header, a slot array and tuples packed at the end, zeros in between. */
+void MakeTablePage(int seed, char *page) {
+  memset(page, 0, BUSTUB_PAGE_SIZE);
+  snprintf(page, 32, "header %d", seed);
+  int offset = BUSTUB_PAGE_SIZE;
+  for (int i = 0; i < 40; ++i) {
+    const std::string tuple = "tuple " + std::to_string(seed * 100 + i) + " of a table with some text in it";
+    offset -= static_cast<int>(tuple.size());
+    memcpy(page + offset, tuple.data(), tuple.size());
+    memcpy(page + 32 + i * sizeof(int), &offset, sizeof(int));
+  }
+}
+
+void ExpectRoundTrip(const char *data, size_t size) {
+  std::vector<char> compressed(size + size / 255 + 16);
+  const size_t compressed_size = CompressedPageCache::Compress(data, size, compressed.data(), compressed.size());
+  ASSERT_NE(0, compressed_size);
+  std::vector<char> decompressed(size);
+  ASSERT_TRUE(CompressedPageCache::Decompress(compressed.data(), compressed_size, decompressed.data(), size));
+  EXPECT_EQ(0, memcmp(data, decompressed.data(), size));
+}
+
+}  // namespace
+
+// NOLINTNEXTLINE
+TEST(CompressedPageCacheTest, CompressTest) {
+  char page[BUSTUB_PAGE_SIZE];
+  char compressed[BUSTUB_PAGE_SIZE * 2];
+
+  // an empty page is a single run
+  memset(page, 0, sizeof(page));
+  ExpectRoundTrip(page, sizeof(page));
+  EXPECT_LT(CompressedPageCache::Compress(page, sizeof(page), compressed, sizeof(compressed)), 32);
+
+  MakeTablePage(7, page);
+  ExpectRoundTrip(page, sizeof(page));
+  EXPECT_LT(CompressedPageCache::Compress(page, sizeof(page), compressed, sizeof(compressed)), BUSTUB_PAGE_SIZE / 2);
+
+  // random bytes do not compress, but still round-trip
+  std::mt19937 generator(15445);
+  for (auto &byte : page) {
+    byte = static_cast<char>(generator());
+  }
+  ExpectRoundTrip(page, sizeof(page));
+  EXPECT_EQ(0, CompressedPageCache::Compress(page, sizeof(page), compressed, CompressedPageCache::MAX_COMPRESSED_SIZE));
+
+  // short and odd-sized blocks, repeats at every distance
+  ExpectRoundTrip(page, 0);
+  ExpectRoundTrip(page, 3);
+  for (size_t period = 1; period < 300; period += 37) {
+    for (size_t i = period; i < sizeof(page); ++i) {
+      page[i] = page[i - period];
+    }
+    ExpectRoundTrip(page, sizeof(page) - period);
+  }
+
+  // corrupt input is rejected, not read or written out of bounds
+  MakeTablePage(8, page);
+  const size_t size = CompressedPageCache::Compress(page, sizeof(page), compressed, sizeof(compressed));
+  char decompressed[BUSTUB_PAGE_SIZE];
+  EXPECT_FALSE(CompressedPageCache::Decompress(compressed, size / 2, decompressed, sizeof(decompressed)));
+  EXPECT_FALSE(CompressedPageCache::Decompress(compressed, size, decompressed, sizeof(decompressed) - 1));
+}
+
+// NOLINTNEXTLINE
+TEST(CompressedPageCacheTest, PutTakeTest) {
+  CompressedPageCache cache(1 << 20);
+  char page[BUSTUB_PAGE_SIZE];
+  char read[BUSTUB_PAGE_SIZE];
+  for (int i = 0; i < 10; ++i) {
+    MakeTablePage(i, page);
+    EXPECT_TRUE(cache.Put(i, page));
+  }
+  // a newer version replaces the cached one
+  MakeTablePage(42, page);
+  EXPECT_TRUE(cache.Put(3, page));
+  auto stats = cache.GetStats();
+  EXPECT_EQ(10, stats.pages_);
+  EXPECT_EQ(11, stats.stores_);
+  EXPECT_GT(stats.CompressionRatio(), 2);
+
+  ASSERT_TRUE(cache.Take(3, read));
+  EXPECT_EQ(0, memcmp(page, read, BUSTUB_PAGE_SIZE));
+  // taking a page removes it
+  EXPECT_FALSE(cache.Take(3, read));
+  cache.Remove(5);
+  EXPECT_FALSE(cache.Take(5, read));
+  MakeTablePage(0, page);
+  ASSERT_TRUE(cache.Take(0, read));
+  EXPECT_EQ(0, memcmp(page, read, BUSTUB_PAGE_SIZE));
+
+  stats = cache.GetStats();
+  EXPECT_EQ(7, stats.pages_);
+  EXPECT_EQ(2, stats.hits_);
+  EXPECT_EQ(2, stats.misses_);
+  EXPECT_DOUBLE_EQ(0.5, stats.HitRatio());
+
+  // an incompressible page is rejected, and drops the version cached before
+  std::mt19937 generator(15445);
+  for (auto &byte : page) {
+    byte = static_cast<char>(generator());
+  }
+  EXPECT_FALSE(cache.Put(1, page));
+  EXPECT_FALSE(cache.Take(1, read));
+  EXPECT_EQ(1, cache.GetStats().rejects_);
+}
+
+// NOLINTNEXTLINE
+TEST(CompressedPageCacheTest, CapacityTest) {
+  char page[BUSTUB_PAGE_SIZE];
+  char read[BUSTUB_PAGE_SIZE];
+  MakeTablePage(0, page);
+  const size_t entry_bytes =
+      CompressedPageCache::Compress(page, BUSTUB_PAGE_SIZE, read, sizeof(read)) + CompressedPageCache::ENTRY_OVERHEAD;
+
+  // room for about four pages like this one
+  CompressedPageCache cache(entry_bytes * 4 + entry_bytes / 2);
+  for (int i = 0; i < 10; ++i) {
+    MakeTablePage(0, page);
+    EXPECT_TRUE(cache.Put(i, page));
+    EXPECT_LE(cache.GetStats().used_bytes_, cache.GetStats().capacity_bytes_);
+  }
+  // the least recently stored pages went first
+  auto stats = cache.GetStats();
+  EXPECT_EQ(4, stats.pages_);
+  EXPECT_EQ(6, stats.evictions_);
+  EXPECT_FALSE(cache.Take(5, read));
+  EXPECT_TRUE(cache.Take(6, read));
+
+  cache.SetCapacity(entry_bytes);
+  EXPECT_EQ(1, cache.GetStats().pages_);
+  EXPECT_TRUE(cache.Take(9, read));
+  cache.SetCapacity(0);
+  EXPECT_FALSE(cache.Put(1, page));
+  EXPECT_EQ(0, cache.GetStats().used_bytes_);
+}
+
+}  // namespace bustub
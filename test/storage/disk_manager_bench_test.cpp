@@ -0,0 +1,233 @@
+/**
+ * disk_manager_bench_test.cpp
+ *
+ * Compares the page I/O throughput of DiskManager (one stream shared under a latch) with DiskManagerPosix (pread and
+ * pwrite without a latch), buffered and with O_DIRECT, for an increasing number of threads, flushing a set of dirty
+ * pages page by page with flushing it as one coalesced batch, and flushes and scans on a tablespace of one or more
+ * striped files.
+ */
+
+#include <algorithm>
+#include <chrono>  // NOLINT
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <sstream>
+#include <string>
+#include <thread>  // NOLINT
+#include <utility>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "storage/disk/disk_manager.h"
+#include "storage/disk/disk_manager_posix.h"
+#include "storage/disk/disk_manager_striped.h"
+
+namespace bustub {
+
+// Run ops_per_thread random page I/Os on each of num_threads threads, every write_every-th one a write (0: reads
+// only), return I/Os per second.
+auto DiskBenchRun(DiskManager *disk_manager, size_t num_threads, page_id_t num_pages, size_t ops_per_thread,
+                  size_t write_every) -> double {
+  std::vector<std::thread> threads;
+  auto start = std::chrono::steady_clock::now();
+  for (size_t tid = 0; tid < num_threads; ++tid) {
+    threads.emplace_back([disk_manager, tid, num_pages, ops_per_thread, write_every] {
+      // page-aligned like a buffer pool frame, so that direct I/O needs no bounce buffer
+      auto *buffer = static_cast<char *>(std::aligned_alloc(DiskManagerPosix::DIRECT_IO_ALIGNMENT, BUSTUB_PAGE_SIZE));
+      std::mt19937 rng(tid);
+      std::uniform_int_distribution<page_id_t> dist(0, num_pages - 1);
+      for (size_t i = 0; i < ops_per_thread; ++i) {
+        page_id_t page_id = dist(rng);
+        if (write_every != 0 && i % write_every == 0) {
+          std::snprintf(buffer, BUSTUB_PAGE_SIZE, "page %d", page_id);
+          disk_manager->WritePage(page_id, buffer);
+        } else {
+          disk_manager->ReadPage(page_id, buffer);
+        }
+      }
+      std::free(buffer);
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  auto elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+  return static_cast<double>(num_threads * ops_per_thread) / elapsed;
+}
+
+/*
+ * Benchmark: random page reads, and a mix with one write every four I/Os, against a file of num_pages pages. Reports
+ * page I/Os per second for every disk manager and thread count.
+ */
+TEST(DiskManagerTest, DISABLED_PositionalIoBenchmark) {  // NOLINT
+  const std::vector<size_t> thread_counts{1, 4, 8};
+  const page_id_t num_pages = 1024;
+  const size_t ops_per_thread = 2000;
+  const std::string db_file = "disk_manager_bench.db";
+  const std::string log_file = "disk_manager_bench.log";
+
+  struct Backend {
+    std::string name_;
+    std::function<std::unique_ptr<DiskManager>()> make_;
+  };
+  const std::vector<Backend> backends{
+      {"fstream", [&] { return std::make_unique<DiskManager>(db_file); }},
+      {"pread", [&] { return std::make_unique<DiskManagerPosix>(db_file); }},
+      {"O_DIRECT", [&] { return std::make_unique<DiskManagerPosix>(db_file, true); }},
+  };
+
+  std::stringstream ss;
+  ss << "[BENCHMARK: DiskManagerTest.PositionalIoBenchmark] page I/Os per second" << std::endl;
+  ss << std::setw(10) << "backend" << std::setw(8) << "threads" << std::setw(12) << "reads" << std::setw(12)
+     << "25% writes" << std::endl;
+  for (const auto &backend : backends) {
+    remove(db_file.c_str());
+    remove(log_file.c_str());
+    auto disk_manager = backend.make_();
+    char page[BUSTUB_PAGE_SIZE] = {0};
+    for (page_id_t page_id = 0; page_id < num_pages; ++page_id) {
+      disk_manager->WritePage(page_id, page);
+    }
+    for (auto num_threads : thread_counts) {
+      double reads = DiskBenchRun(disk_manager.get(), num_threads, num_pages, ops_per_thread, 0);
+      double mixed = DiskBenchRun(disk_manager.get(), num_threads, num_pages, ops_per_thread, 4);
+      ss << std::setw(10) << backend.name_ << std::setw(8) << num_threads << std::setw(12) << std::fixed
+         << std::setprecision(0) << reads << std::setw(12) << mixed << std::endl;
+    }
+    disk_manager->ShutDown();
+  }
+  remove(db_file.c_str());
+  remove(log_file.c_str());
+  std::cout << ss.str();
+}
+
+/*
+ * Benchmark: a checkpoint of a file of num_pages pages, every other one of them dirty. "per page" writes the dirty
+ * pages one by one in frame order, which is random page order; "coalesced" submits them as one batch, which
+ * DiskManagerPosix sorts and merges into vectored writes of adjacent pages. Reports pages flushed per second.
+ */
+TEST(DiskManagerTest, DISABLED_CoalescedFlushBenchmark) {  // NOLINT
+  const page_id_t num_pages = 8192;
+  const int rounds = 3;
+  const std::string db_file = "disk_manager_bench.db";
+  const std::string log_file = "disk_manager_bench.log";
+
+  // half of the pages, in runs of 1 to 8 adjacent pages
+  std::vector<page_id_t> dirty_pages;
+  std::mt19937 rng(15445);
+  for (page_id_t page_id = 0; page_id < num_pages;) {
+    const page_id_t run = std::uniform_int_distribution<page_id_t>(1, 8)(rng);
+    for (page_id_t i = page_id; i < std::min(page_id + run, num_pages); ++i) {
+      dirty_pages.push_back(i);
+    }
+    page_id += 2 * run;
+  }
+  std::shuffle(dirty_pages.begin(), dirty_pages.end(), rng);
+  auto *frames = static_cast<char *>(
+      std::aligned_alloc(DiskManagerPosix::DIRECT_IO_ALIGNMENT, dirty_pages.size() * BUSTUB_PAGE_SIZE));
+  for (size_t i = 0; i < dirty_pages.size(); ++i) {
+    std::snprintf(frames + i * BUSTUB_PAGE_SIZE, BUSTUB_PAGE_SIZE, "page %d", dirty_pages[i]);
+  }
+
+  std::stringstream ss;
+  ss << "[BENCHMARK: DiskManagerTest.CoalescedFlushBenchmark] " << dirty_pages.size() << " of " << num_pages
+     << " pages dirty, pages flushed per second" << std::endl;
+  ss << std::setw(10) << "backend" << std::setw(12) << "per page" << std::setw(12) << "coalesced" << std::endl;
+  for (bool direct_io : {false, true}) {
+    remove(db_file.c_str());
+    remove(log_file.c_str());
+    DiskManagerPosix disk_manager(db_file, direct_io);
+    char page[BUSTUB_PAGE_SIZE] = {0};
+    for (page_id_t page_id = 0; page_id < num_pages; ++page_id) {
+      disk_manager.WritePage(page_id, page);
+    }
+    auto start = std::chrono::steady_clock::now();
+    for (int round = 0; round < rounds; ++round) {
+      for (size_t i = 0; i < dirty_pages.size(); ++i) {
+        disk_manager.WritePage(dirty_pages[i], frames + i * BUSTUB_PAGE_SIZE);
+      }
+    }
+    auto per_page = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    start = std::chrono::steady_clock::now();
+    for (int round = 0; round < rounds; ++round) {
+      std::vector<DiskRequest> requests;
+      for (size_t i = 0; i < dirty_pages.size(); ++i) {
+        requests.push_back({true, dirty_pages[i], frames + i * BUSTUB_PAGE_SIZE, nullptr});
+      }
+      disk_manager.SubmitRequestsAndWait(std::move(requests));
+    }
+    auto coalesced = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    const auto flushed = static_cast<double>(rounds * dirty_pages.size());
+    ss << std::setw(10) << (disk_manager.IsDirectIo() ? "O_DIRECT" : "pwrite") << std::setw(12) << std::fixed
+       << std::setprecision(0) << flushed / per_page << std::setw(12) << flushed / coalesced << std::endl;
+    disk_manager.ShutDown();
+  }
+  std::free(frames);
+  remove(db_file.c_str());
+  remove(log_file.c_str());
+  std::cout << ss.str();
+}
+
+/*
+ * Benchmark: a flush of num_pages pages as one batch, and a scan of them in batches of scan_batch pages, on a
+ * tablespace of 1, 2 and 4 data files with O_DIRECT. Every file has its own queue, so the files of a batch are written
+ * and read in parallel; the gain depends on how many devices the files are spread over, here they share one. Reports
+ * pages per second.
+ */
+TEST(DiskManagerTest, DISABLED_StripedIoBenchmark) {  // NOLINT
+  const page_id_t num_pages = 8192;
+  const size_t stripe_pages = 64;
+  const size_t scan_batch = 256;
+  const std::string db_file = "disk_manager_bench.db";
+  const std::string log_file = "disk_manager_bench.log";
+  auto *frames =
+      static_cast<char *>(std::aligned_alloc(DiskManagerPosix::DIRECT_IO_ALIGNMENT, num_pages * BUSTUB_PAGE_SIZE));
+  for (page_id_t page_id = 0; page_id < num_pages; ++page_id) {
+    std::snprintf(frames + page_id * BUSTUB_PAGE_SIZE, BUSTUB_PAGE_SIZE, "page %d", page_id);
+  }
+
+  std::stringstream ss;
+  ss << "[BENCHMARK: DiskManagerTest.StripedIoBenchmark] " << num_pages << " pages in stripes of " << stripe_pages
+     << ", pages per second" << std::endl;
+  ss << std::setw(8) << "files" << std::setw(12) << "flush" << std::setw(12) << "scan" << std::endl;
+  for (size_t num_files : {1, 2, 4}) {
+    auto remove_files = [&] {
+      for (size_t i = 0; i < num_files; ++i) {
+        remove(DiskManagerStriped::DataFileName(db_file, i).c_str());
+      }
+      remove(log_file.c_str());
+    };
+    remove_files();
+    DiskManagerStriped disk_manager(db_file, num_files, stripe_pages, true);
+    auto start = std::chrono::steady_clock::now();
+    std::vector<DiskRequest> requests;
+    for (page_id_t page_id = 0; page_id < num_pages; ++page_id) {
+      requests.push_back({true, page_id, frames + page_id * BUSTUB_PAGE_SIZE, nullptr});
+    }
+    disk_manager.SubmitRequestsAndWait(std::move(requests));
+    auto flush = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    start = std::chrono::steady_clock::now();
+    for (page_id_t first = 0; first < num_pages; first += static_cast<page_id_t>(scan_batch)) {
+      requests.clear();
+      for (page_id_t page_id = first; page_id < first + static_cast<page_id_t>(scan_batch); ++page_id) {
+        requests.push_back({false, page_id, frames + page_id * BUSTUB_PAGE_SIZE, nullptr});
+      }
+      disk_manager.SubmitRequestsAndWait(std::move(requests));
+    }
+    auto scan = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    EXPECT_EQ("page 42", std::string(frames + 42 * BUSTUB_PAGE_SIZE));
+    ss << std::setw(8) << num_files << std::setw(12) << std::fixed << std::setprecision(0) << num_pages / flush
+       << std::setw(12) << num_pages / scan << std::endl;
+    disk_manager.ShutDown();
+    remove_files();
+  }
+  std::free(frames);
+  std::cout << ss.str();
+}
+
+}  // namespace bustub
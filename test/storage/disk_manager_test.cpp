@@ -10,11 +10,30 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>  // NOLINT
+#include <cstdio>
+#include <cstdlib>
 #include <cstring>
+#include <fstream>
+#include <future>  // NOLINT
+#include <random>
+#include <string>
+#include <thread>  // NOLINT
+#include <utility>
+#include <vector>
 
 #include "common/exception.h"
 #include "gtest/gtest.h"
 #include "storage/disk/disk_manager.h"
+#include "storage/disk/disk_manager_memory.h"
+#include "storage/disk/disk_manager_mmap.h"
+#include "storage/disk/disk_manager_posix.h"
+#include "storage/disk/disk_manager_simulated.h"
+#include "storage/disk/disk_manager_striped.h"
 
 namespace bustub {
 
@@ -75,4 +94,380 @@ TEST_F(DiskManagerTest, ReadWriteLogTest) {
 // NOLINTNEXTLINE
 TEST_F(DiskManagerTest, ThrowBadFileTest) { EXPECT_THROW(DiskManager("dev/null\\/foo/bar/baz/test.db"), Exception); }
 
+// NOLINTNEXTLINE
+TEST_F(DiskManagerTest, PosixReadWritePageTest) {
+  for (bool direct_io : {false, true}) {
+    SCOPED_TRACE(direct_io ? "direct I/O" : "buffered I/O");
+    remove("test.db");
+    char buf[BUSTUB_PAGE_SIZE] = {0};
+    char data[BUSTUB_PAGE_SIZE] = {0};
+    DiskManagerPosix dm("test.db", direct_io);
+    std::strncpy(data, "A test string.", sizeof(data));
+
+    // reads past the end of the file come back zeroed
+    std::memset(buf, 1, sizeof(buf));
+    dm.ReadPage(0, buf);
+    EXPECT_EQ(0, buf[0]);
+    EXPECT_EQ(0, buf[BUSTUB_PAGE_SIZE - 1]);
+
+    // the stack buffers are not aligned for direct I/O, so they go through the bounce buffer
+    dm.WritePage(0, data);
+    dm.ReadPage(0, buf);
+    EXPECT_EQ(std::memcmp(buf, data, sizeof(buf)), 0);
+    dm.WritePage(5, data);
+    EXPECT_EQ(6 * BUSTUB_PAGE_SIZE, dm.GetDbFileSize());
+    std::memset(buf, 0, sizeof(buf));
+    dm.ReadPage(5, buf);
+    EXPECT_EQ(std::memcmp(buf, data, sizeof(buf)), 0);
+    EXPECT_EQ(2, dm.GetNumWrites());
+
+    // aligned buffers are used as they are
+    auto *aligned = static_cast<char *>(std::aligned_alloc(DiskManagerPosix::DIRECT_IO_ALIGNMENT, BUSTUB_PAGE_SIZE));
+    dm.ReadPage(5, aligned);
+    EXPECT_EQ(std::memcmp(aligned, data, sizeof(buf)), 0);
+    std::free(aligned);
+    dm.ShutDown();
+
+    // the file size is picked up when the file is opened again
+    DiskManagerPosix reopened("test.db", direct_io);
+    EXPECT_EQ(6 * BUSTUB_PAGE_SIZE, reopened.GetDbFileSize());
+    reopened.ReadPage(5, buf);
+    EXPECT_EQ(std::memcmp(buf, data, sizeof(buf)), 0);
+    reopened.ShutDown();
+  }
+}
+
+// NOLINTNEXTLINE
+TEST_F(DiskManagerTest, PosixConcurrentReadWriteTest) {
+  const int num_threads = 8;
+  const int pages_per_thread = 64;
+  DiskManagerPosix dm("test.db");
+
+  // every thread writes and reads back its own pages, interleaved with the other threads
+  std::vector<std::thread> threads;
+  for (int tid = 0; tid < num_threads; ++tid) {
+    threads.emplace_back([&dm, tid] {
+      char data[BUSTUB_PAGE_SIZE] = {0};
+      char buf[BUSTUB_PAGE_SIZE] = {0};
+      for (int i = 0; i < pages_per_thread; ++i) {
+        page_id_t page_id = i * num_threads + tid;
+        std::snprintf(data, sizeof(data), "page %d", page_id);
+        dm.WritePage(page_id, data);
+      }
+      for (int i = 0; i < pages_per_thread; ++i) {
+        page_id_t page_id = i * num_threads + tid;
+        dm.ReadPage(page_id, buf);
+        EXPECT_EQ("page " + std::to_string(page_id), std::string(buf));
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  EXPECT_EQ(num_threads * pages_per_thread, dm.GetNumWrites());
+  EXPECT_EQ(num_threads * pages_per_thread * BUSTUB_PAGE_SIZE, dm.GetDbFileSize());
+  dm.ShutDown();
+}
+
+// NOLINTNEXTLINE
+TEST_F(DiskManagerTest, AsyncReadWriteTest) {
+  const int num_pages = 200;
+  for (auto backend : {AsyncIoBackend::IO_URING, AsyncIoBackend::THREAD_POOL}) {
+    for (bool direct_io : {false, true}) {
+      SCOPED_TRACE(AsyncIoBackendToString(backend) + (direct_io ? ", direct I/O" : ", buffered I/O"));
+      remove("test.db");
+      DiskManagerPosix dm("test.db", direct_io, backend);
+      // io_uring falls back to the thread pool where the kernel does not allow it
+      if (backend == AsyncIoBackend::THREAD_POOL) {
+        EXPECT_EQ(AsyncIoBackend::THREAD_POOL, dm.GetAsyncIoBackend());
+      }
+
+      // one batch, more pages than the queue depth, unaligned buffers
+      std::vector<std::string> pages(num_pages, std::string(BUSTUB_PAGE_SIZE + 1, '\0'));
+      std::vector<DiskRequest> requests;
+      std::atomic<int> completed{0};
+      for (int i = 0; i < num_pages; ++i) {
+        std::snprintf(pages[i].data() + 1, BUSTUB_PAGE_SIZE, "page %d", i);
+        requests.push_back({true, i, pages[i].data() + 1, [&completed](bool ok) {
+                              EXPECT_TRUE(ok);
+                              completed++;
+                            }});
+      }
+      dm.SubmitRequests(std::move(requests));
+      while (completed < num_pages) {
+        std::this_thread::yield();
+      }
+      EXPECT_EQ(num_pages * BUSTUB_PAGE_SIZE, dm.GetDbFileSize());
+
+      char buf[BUSTUB_PAGE_SIZE];
+      for (int i = 0; i < num_pages; i += 17) {
+        ASSERT_TRUE(dm.ReadPageAsync(i, buf).get());
+        EXPECT_EQ("page " + std::to_string(i), std::string(buf));
+      }
+      std::strncpy(buf, "rewritten", sizeof(buf));
+      ASSERT_TRUE(dm.WritePageAsync(3, buf).get());
+      std::memset(buf, 0, sizeof(buf));
+      dm.ReadPage(3, buf);
+      EXPECT_EQ("rewritten", std::string(buf));
+
+      // reads past the end of the file complete with zeros
+      std::memset(buf, 1, sizeof(buf));
+      ASSERT_TRUE(dm.ReadPageAsync(num_pages + 10, buf).get());
+      EXPECT_EQ(0, buf[BUSTUB_PAGE_SIZE - 1]);
+      dm.ShutDown();
+    }
+  }
+}
+
+// NOLINTNEXTLINE
+TEST_F(DiskManagerTest, CoalescedWriteTest) {
+  // pages 0-99 without page 50, shuffled, plus page 200 on its own
+  std::vector<page_id_t> page_ids;
+  for (page_id_t i = 0; i < 100; ++i) {
+    if (i != 50) {
+      page_ids.push_back(i);
+    }
+  }
+  page_ids.push_back(200);
+  std::shuffle(page_ids.begin(), page_ids.end(), std::mt19937(15445));
+  for (auto backend : {AsyncIoBackend::IO_URING, AsyncIoBackend::THREAD_POOL}) {
+    for (bool direct_io : {false, true}) {
+      SCOPED_TRACE(AsyncIoBackendToString(backend) + (direct_io ? ", direct I/O" : ", buffered I/O"));
+      remove("test.db");
+      DiskManagerPosix dm("test.db", direct_io, backend);
+      auto *buffers = static_cast<char *>(std::aligned_alloc(DiskManagerPosix::DIRECT_IO_ALIGNMENT,
+                                                             page_ids.size() * BUSTUB_PAGE_SIZE));
+      std::vector<DiskRequest> requests;
+      for (size_t i = 0; i < page_ids.size(); ++i) {
+        char *data = buffers + i * BUSTUB_PAGE_SIZE;
+        std::memset(data, 0, BUSTUB_PAGE_SIZE);
+        std::snprintf(data, BUSTUB_PAGE_SIZE, "page %d", page_ids[i]);
+        requests.push_back({true, page_ids[i], data, [](bool ok) { EXPECT_TRUE(ok); }});
+      }
+      dm.SubmitRequestsAndWait(std::move(requests));
+      // 0-49, 51-99 and 200; neither run is longer than a coalesced write may be
+      EXPECT_EQ(3, dm.GetNumFileWrites());
+      EXPECT_EQ(static_cast<int>(page_ids.size()), dm.GetNumWrites());
+      EXPECT_EQ(201 * BUSTUB_PAGE_SIZE, dm.GetDbFileSize());
+
+      char buf[BUSTUB_PAGE_SIZE];
+      for (auto page_id : page_ids) {
+        dm.ReadPage(page_id, buf);
+        EXPECT_EQ("page " + std::to_string(page_id), std::string(buf));
+      }
+      dm.ReadPage(50, buf);
+      EXPECT_EQ(0, buf[0]);
+
+      // a long run is split into writes of at most MAX_COALESCED_PAGES pages
+      const size_t run_length = 2 * DiskManagerPosix::MAX_COALESCED_PAGES + 1;
+      requests.clear();
+      for (size_t i = 0; i < run_length; ++i) {
+        requests.push_back({true, static_cast<page_id_t>(300 + i), buffers, nullptr});
+      }
+      dm.SubmitRequestsAndWait(std::move(requests));
+      EXPECT_EQ(6, dm.GetNumFileWrites());
+      std::free(buffers);
+      dm.ShutDown();
+    }
+  }
+}
+
+// NOLINTNEXTLINE
+TEST_F(DiskManagerTest, DefaultAsyncReadWriteTest) {
+  char buf[BUSTUB_PAGE_SIZE] = {0};
+  char data[BUSTUB_PAGE_SIZE] = {0};
+  DiskManager dm("test.db");
+  std::strncpy(data, "A test string.", sizeof(data));
+
+  // the stream backend runs requests synchronously, the futures are ready right away
+  auto write = dm.WritePageAsync(0, data);
+  EXPECT_EQ(std::future_status::ready, write.wait_for(std::chrono::seconds(0)));
+  EXPECT_TRUE(write.get());
+  EXPECT_TRUE(dm.ReadPageAsync(0, buf).get());
+  EXPECT_EQ(std::memcmp(buf, data, sizeof(buf)), 0);
+  dm.ShutDown();
+}
+
+// NOLINTNEXTLINE
+TEST_F(DiskManagerTest, MmapReadPageTest) {
+  const int num_pages = 10;
+  {
+    DiskManagerPosix dm("test.db");
+    char data[BUSTUB_PAGE_SIZE] = {0};
+    for (int i = 0; i < num_pages; ++i) {
+      std::snprintf(data, sizeof(data), "page %d", i);
+      dm.WritePage(i, data);
+    }
+    dm.ShutDown();
+  }
+  // half a page more, like a copy taken while the last page was being written
+  truncate("test.db", num_pages * BUSTUB_PAGE_SIZE + BUSTUB_PAGE_SIZE / 2);
+
+  DiskManagerMmap dm("test.db");
+  EXPECT_EQ(num_pages * BUSTUB_PAGE_SIZE + BUSTUB_PAGE_SIZE / 2, dm.GetDbFileSize());
+  char buf[BUSTUB_PAGE_SIZE];
+  for (int i = 0; i < num_pages; ++i) {
+    dm.ReadPage(i, buf);
+    EXPECT_EQ("page " + std::to_string(i), std::string(buf));
+    // the mapped page is the same data, without a copy
+    const char *mapped = dm.GetMappedPage(i);
+    ASSERT_NE(nullptr, mapped);
+    EXPECT_EQ(0, std::memcmp(buf, mapped, BUSTUB_PAGE_SIZE));
+  }
+  // partial and missing pages read as zeros and are not mapped
+  std::memset(buf, 1, sizeof(buf));
+  dm.ReadPage(num_pages, buf);
+  EXPECT_EQ(0, buf[BUSTUB_PAGE_SIZE - 1]);
+  EXPECT_EQ(nullptr, dm.GetMappedPage(num_pages));
+  std::memset(buf, 1, sizeof(buf));
+  dm.ReadPage(num_pages + 5, buf);
+  EXPECT_EQ(0, buf[0]);
+  EXPECT_EQ(nullptr, dm.GetMappedPage(num_pages + 5));
+
+  EXPECT_THROW(dm.WritePage(0, buf), Exception);
+  EXPECT_TRUE(dm.ReadPageAsync(3, buf).get());
+  EXPECT_EQ("page 3", std::string(buf));
+  dm.ShutDown();
+
+  // an empty file maps nothing
+  remove("test.db");
+  { std::ofstream create("test.db"); }
+  DiskManagerMmap empty("test.db");
+  EXPECT_EQ(nullptr, empty.GetMappedPage(0));
+  empty.ReadPage(0, buf);
+  EXPECT_EQ(0, buf[0]);
+  EXPECT_THROW(DiskManagerMmap("missing.db"), Exception);
+}
+
+// NOLINTNEXTLINE
+TEST_F(DiskManagerTest, SimulatedDeviceTest) {
+  using std::chrono::microseconds;
+  using std::chrono::nanoseconds;
+  DiskManagerUnlimitedMemory memory;
+  char data[BUSTUB_PAGE_SIZE] = {0};
+  char buf[BUSTUB_PAGE_SIZE] = {0};
+
+  // virtual time: a request takes its latency plus its transfer, one after the other
+  auto ssd = SimulatedDeviceProfile::Ssd();
+  const nanoseconds transfer(BUSTUB_PAGE_SIZE * 1000000000L / ssd.bandwidth_bytes_per_second_);
+  DiskManagerSimulated device(&memory, ssd, false);
+  std::strcpy(data, "A test string.");
+  device.WritePage(0, data);
+  EXPECT_EQ(microseconds(ssd.write_latency_us_) + transfer, device.GetSimulatedTime());
+  device.ReadPage(0, buf);
+  EXPECT_EQ(0, std::memcmp(buf, data, sizeof(buf)));
+  EXPECT_EQ(microseconds(ssd.write_latency_us_ + ssd.read_latency_us_) + 2 * transfer, device.GetSimulatedTime());
+
+  // a batch keeps the queue full: twice the queue depth takes two latencies, plus the transfers that do not overlap
+  const auto batch_start = device.GetSimulatedTime();
+  std::vector<std::vector<char>> pages(2 * ssd.queue_depth_, std::vector<char>(BUSTUB_PAGE_SIZE));
+  std::vector<DiskRequest> requests;
+  std::vector<page_id_t> completed;
+  for (size_t i = 0; i < pages.size(); ++i) {
+    const auto page_id = static_cast<page_id_t>(i);
+    requests.push_back(
+        {false, page_id, pages[i].data(), [&completed, page_id](bool ok) { completed.push_back(page_id); }});
+  }
+  device.SubmitRequests(std::move(requests));
+  EXPECT_EQ(pages.size(), completed.size());
+  const auto batch_time = device.GetSimulatedTime() - batch_start;
+  EXPECT_GE(batch_time, 2 * microseconds(ssd.read_latency_us_));
+  EXPECT_LE(batch_time, 2 * microseconds(ssd.read_latency_us_) + static_cast<int64_t>(pages.size()) * transfer);
+  EXPECT_EQ(2 + pages.size(), device.GetStats().reads_ + device.GetStats().writes_);
+
+  // a disk only pays the seek for requests that do not continue the previous one
+  auto hdd = SimulatedDeviceProfile::Hdd();
+  DiskManagerSimulated sequential(&memory, hdd, false);
+  DiskManagerSimulated random(&memory, hdd, false);
+  for (page_id_t i = 0; i < 50; ++i) {
+    sequential.ReadPage(i, buf);
+    random.ReadPage((i * 7) % 50, buf);
+  }
+  EXPECT_EQ(1, sequential.GetStats().seeks_);
+  EXPECT_EQ(50, random.GetStats().seeks_);
+  EXPECT_GT(random.GetSimulatedTime(), 10 * sequential.GetSimulatedTime());
+
+  // real time: the caller waits for the simulated completion
+  DiskManagerSimulated slow(&memory, {2000, 2000, 0, 1, 0});
+  const auto start = std::chrono::steady_clock::now();
+  slow.ReadPage(0, buf);
+  EXPECT_GE(std::chrono::steady_clock::now() - start, microseconds(2000));
+  EXPECT_EQ(0, std::memcmp(buf, data, sizeof(buf)));
+}
+
+// NOLINTNEXTLINE
+TEST_F(DiskManagerTest, StripedTest) {
+  const size_t num_files = 3;
+  const size_t stripe_pages = 2;
+  const page_id_t num_pages = 20;
+  auto remove_files = [] {
+    for (size_t i = 0; i < num_files; ++i) {
+      remove(DiskManagerStriped::DataFileName("test.db", i).c_str());
+    }
+    remove("test.fsm");
+  };
+  remove_files();
+  EXPECT_EQ("test.2.db", DiskManagerStriped::DataFileName("test.db", 2));
+
+  char data[BUSTUB_PAGE_SIZE] = {0};
+  char buf[BUSTUB_PAGE_SIZE] = {0};
+  {
+    DiskManagerStriped dm("test.db", num_files, stripe_pages);
+    // pages 0 1 | 2 3 | 4 5 | 6 7 go to files 0, 1, 2, 0
+    EXPECT_EQ(std::make_pair(size_t{0}, page_id_t{1}), dm.Locate(1));
+    EXPECT_EQ(std::make_pair(size_t{1}, page_id_t{0}), dm.Locate(2));
+    EXPECT_EQ(std::make_pair(size_t{2}, page_id_t{1}), dm.Locate(5));
+    EXPECT_EQ(std::make_pair(size_t{0}, page_id_t{2}), dm.Locate(6));
+    for (page_id_t i = 0; i < num_pages; i += 2) {
+      std::snprintf(data, sizeof(data), "page %d", i);
+      dm.WritePage(i, data);
+    }
+    // a batch over all the files
+    std::vector<std::vector<char>> pages(num_pages / 2, std::vector<char>(BUSTUB_PAGE_SIZE));
+    std::vector<DiskRequest> requests;
+    for (page_id_t i = 1; i < num_pages; i += 2) {
+      std::snprintf(pages[i / 2].data(), BUSTUB_PAGE_SIZE, "page %d", i);
+      requests.push_back({true, i, pages[i / 2].data(), nullptr});
+    }
+    dm.SubmitRequestsAndWait(std::move(requests));
+    // every file holds its share of the pages, and nothing else
+    for (size_t i = 0; i < num_files; ++i) {
+      EXPECT_GE(dm.GetFile(i)->GetDbFileSize(), 6 * BUSTUB_PAGE_SIZE);
+      EXPECT_LE(dm.GetFile(i)->GetDbFileSize(), 8 * BUSTUB_PAGE_SIZE);
+    }
+    dm.ShutDown();
+  }
+
+  DiskManagerStriped dm("test.db", num_files, stripe_pages);
+  std::vector<std::vector<char>> pages(num_pages, std::vector<char>(BUSTUB_PAGE_SIZE));
+  std::vector<DiskRequest> requests;
+  for (page_id_t i = 0; i < num_pages; ++i) {
+    dm.ReadPage(i, buf);
+    EXPECT_EQ("page " + std::to_string(i), std::string(buf));
+    requests.push_back({false, i, pages[i].data(), nullptr});
+  }
+  dm.SubmitRequestsAndWait(std::move(requests));
+  for (page_id_t i = 0; i < num_pages; ++i) {
+    EXPECT_EQ("page " + std::to_string(i), std::string(pages[i].data()));
+  }
+
+  // truncating the tablespace to 9 pages leaves 0 1 6 7 in file 0, 2 3 8 in file 1 and 4 5 in file 2
+  dm.EnableFreeSpaceMap();
+  auto *fsm = dm.GetFreeSpaceMap();
+  for (page_id_t i = 0; i < num_pages; ++i) {
+    fsm->Allocate(0, 1);
+  }
+  for (page_id_t i = 9; i < num_pages; ++i) {
+    fsm->Free(i);
+  }
+  EXPECT_EQ(num_pages - 9, dm.TruncateFreePages());
+  EXPECT_EQ(4 * BUSTUB_PAGE_SIZE, dm.GetFile(0)->GetDbFileSize());
+  EXPECT_EQ(3 * BUSTUB_PAGE_SIZE, dm.GetFile(1)->GetDbFileSize());
+  EXPECT_EQ(2 * BUSTUB_PAGE_SIZE, dm.GetFile(2)->GetDbFileSize());
+  dm.ReadPage(8, buf);
+  EXPECT_EQ("page 8", std::string(buf));
+  dm.ShutDown();
+  remove_files();
+}
+
 }  // namespace bustub
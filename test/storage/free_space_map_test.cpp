@@ -0,0 +1,125 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// free_space_map_test.cpp
+//
+// Identification: test/storage/free_space_map_test.cpp
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "storage/disk/free_space_map.h"
+
+namespace bustub {
+
+class FreeSpaceMapTest : public ::testing::Test {
+ protected:
+  void SetUp() override { remove(file_name_.c_str()); }
+
+  void TearDown() override { remove(file_name_.c_str()); }
+
+  const std::string file_name_ = "test.fsm";
+};
+
+// NOLINTNEXTLINE
+TEST_F(FreeSpaceMapTest, AllocateFreeTest) {
+  FreeSpaceMap fsm(file_name_);
+  for (page_id_t i = 0; i < 10; ++i) {
+    EXPECT_EQ(i, fsm.Allocate(0, 1));
+  }
+  EXPECT_EQ(10, fsm.GetEnd());
+
+  // the lowest free page is reused first
+  fsm.Free(7);
+  fsm.Free(3);
+  fsm.Free(3);
+  fsm.Free(42);  // past the end, ignored
+  EXPECT_EQ(2, fsm.GetNumFreePages());
+  EXPECT_TRUE(fsm.IsFree(3));
+  EXPECT_EQ(3, fsm.Allocate(0, 1));
+  EXPECT_EQ(7, fsm.Allocate(0, 1));
+  EXPECT_EQ(10, fsm.Allocate(0, 1));
+  EXPECT_EQ(0, fsm.GetNumFreePages());
+
+  // the bitmap spans several pages
+  for (page_id_t i = 11; i < static_cast<page_id_t>(FreeSpaceMap::BITS_PER_PAGE) + 10; ++i) {
+    EXPECT_EQ(i, fsm.Allocate(0, 1));
+  }
+  fsm.Free(static_cast<page_id_t>(FreeSpaceMap::BITS_PER_PAGE) + 1);
+  EXPECT_EQ(static_cast<page_id_t>(FreeSpaceMap::BITS_PER_PAGE) + 1, fsm.Allocate(0, 1));
+}
+
+// NOLINTNEXTLINE
+TEST_F(FreeSpaceMapTest, StripedAllocateTest) {
+  FreeSpaceMap fsm(file_name_);
+  // stripe 1 of 3 skips page 0, which is left to stripe 0
+  EXPECT_EQ(1, fsm.Allocate(1, 3));
+  EXPECT_EQ(4, fsm.Allocate(1, 3));
+  EXPECT_EQ(5, fsm.GetEnd());
+  EXPECT_EQ(3, fsm.GetNumFreePages());
+  EXPECT_EQ(0, fsm.Allocate(0, 3));
+  EXPECT_EQ(3, fsm.Allocate(0, 3));
+  EXPECT_EQ(2, fsm.Allocate(2, 3));
+  EXPECT_EQ(5, fsm.Allocate(2, 3));
+
+  // freed pages go back to their own stripe only
+  fsm.Free(1);
+  EXPECT_EQ(6, fsm.Allocate(0, 3));
+  EXPECT_EQ(1, fsm.Allocate(1, 3));
+}
+
+// NOLINTNEXTLINE
+TEST_F(FreeSpaceMapTest, PersistTest) {
+  {
+    FreeSpaceMap fsm(file_name_);
+    for (page_id_t i = 0; i < 100; ++i) {
+      fsm.Allocate(0, 1);
+    }
+    fsm.Free(10);
+    fsm.Free(20);
+  }
+  {
+    // closed cleanly, the free pages are known
+    FreeSpaceMap fsm(file_name_);
+    EXPECT_EQ(100, fsm.GetEnd());
+    EXPECT_EQ(2, fsm.GetNumFreePages());
+    EXPECT_EQ(10, fsm.Allocate(0, 1));
+    fsm.Flush();
+    // a crash: the second map opens the file before the first one is closed
+    FreeSpaceMap crashed(file_name_);
+    // every page counts as allocated, and the end of the file is at or past every allocation
+    EXPECT_EQ(0, crashed.GetNumFreePages());
+    EXPECT_GE(crashed.GetEnd(), 100);
+    EXPECT_GE(crashed.Allocate(0, 1), 100);
+  }
+}
+
+// NOLINTNEXTLINE
+TEST_F(FreeSpaceMapTest, TruncateFreeTailTest) {
+  FreeSpaceMap fsm(file_name_);
+  for (page_id_t i = 0; i < 10; ++i) {
+    fsm.Allocate(0, 1);
+  }
+  fsm.Free(9);
+  fsm.Free(8);
+  fsm.Free(6);
+  fsm.Free(2);
+  page_id_t truncated_to = -1;
+  EXPECT_EQ(2, fsm.TruncateFreeTail([&truncated_to](page_id_t end) { truncated_to = end; }));
+  EXPECT_EQ(8, truncated_to);
+  EXPECT_EQ(8, fsm.GetEnd());
+  EXPECT_EQ(2, fsm.GetNumFreePages());
+  EXPECT_EQ(0, fsm.TruncateFreeTail([](page_id_t end) { FAIL(); }));
+  EXPECT_EQ(2, fsm.Allocate(0, 1));
+  EXPECT_EQ(6, fsm.Allocate(0, 1));
+  EXPECT_EQ(8, fsm.Allocate(0, 1));
+}
+
+}  // namespace bustub
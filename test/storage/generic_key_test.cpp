@@ -0,0 +1,185 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// generic_key_test.cpp
+//
+// Identification: test/storage/generic_key_test.cpp
+//
+// Copyright (c) 2015-2022, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <algorithm>
+#include <chrono>  // NOLINT
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "storage/index/generic_key.h"
+#include "test_util.h"  // NOLINT
+#include "type/value_factory.h"
+
+namespace bustub {
+
+// The order of two rows of values, column by column, with NULL first.
+auto CompareRows(const std::vector<Value> &lhs, const std::vector<Value> &rhs) -> int {
+  for (size_t i = 0; i < lhs.size(); i++) {
+    if (lhs[i].IsNull() || rhs[i].IsNull()) {
+      if (lhs[i].IsNull() != rhs[i].IsNull()) {
+        return lhs[i].IsNull() ? -1 : 1;
+      }
+      continue;
+    }
+    if (lhs[i].CompareLessThan(rhs[i]) == CmpBool::CmpTrue) {
+      return -1;
+    }
+    if (lhs[i].CompareGreaterThan(rhs[i]) == CmpBool::CmpTrue) {
+      return 1;
+    }
+  }
+  return 0;
+}
+
+TEST(GenericKeyTest, OrderTest) {
+  auto key_schema = ParseCreateStatement("a int,b bigint,c double,d varchar(8),e smallint,f tinyint");
+  GenericComparator<64> comparator(key_schema.get());
+  std::mt19937 rng(0);
+
+  // few distinct values per column, so that later columns decide the order too
+  auto random_row = [&]() {
+    std::vector<Value> row;
+    auto pick = [&](int n) { return static_cast<int>(rng() % n) - n / 2; };
+    row.emplace_back(rng() % 10 == 0 ? ValueFactory::GetNullValueByType(TypeId::INTEGER)
+                                     : ValueFactory::GetIntegerValue(pick(7) * 1000003));
+    row.emplace_back(ValueFactory::GetBigIntValue(static_cast<int64_t>(pick(5)) << 40));
+    row.emplace_back(ValueFactory::GetDecimalValue(pick(9) * 0.75));
+    std::string str;
+    for (int i = static_cast<int>(rng() % 4); i > 0; i--) {
+      str.push_back(static_cast<char>('a' + rng() % 3));
+    }
+    row.emplace_back(rng() % 10 == 0 ? ValueFactory::GetNullValueByType(TypeId::VARCHAR)
+                                     : ValueFactory::GetVarcharValue(str));
+    row.emplace_back(ValueFactory::GetSmallIntValue(static_cast<int16_t>(pick(5) * 300)));
+    row.emplace_back(ValueFactory::GetTinyIntValue(static_cast<int8_t>(pick(255))));
+    return row;
+  };
+
+  std::vector<std::vector<Value>> rows;
+  std::vector<GenericKey<64>> keys(500);
+  for (auto &key : keys) {
+    rows.push_back(random_row());
+    key.SetFromKey(Tuple(rows.back(), key_schema.get()), key_schema.get());
+  }
+  for (size_t i = 0; i < keys.size(); i++) {
+    for (size_t j = 0; j < keys.size(); j++) {
+      ASSERT_EQ(CompareRows(rows[i], rows[j]), comparator(keys[i], keys[j])) << i << " " << j;
+    }
+    // the values can be read back
+    for (uint32_t column = 0; column < key_schema->GetColumnCount(); column++) {
+      auto value = keys[i].ToValue(key_schema.get(), column);
+      EXPECT_EQ(rows[i][column].IsNull(), value.IsNull());
+      if (!value.IsNull()) {
+        EXPECT_EQ(CmpBool::CmpTrue, value.CompareEquals(rows[i][column]));
+      }
+    }
+  }
+}
+
+TEST(GenericKeyTest, VarcharTest) {
+  auto key_schema = ParseCreateStatement("a varchar(16),b int");
+  GenericComparator<16> comparator(key_schema.get());
+  auto make_key = [&](const std::string &str, int32_t i) {
+    GenericKey<16> key;
+    std::vector<Value> values{ValueFactory::GetVarcharValue(str), ValueFactory::GetIntegerValue(i)};
+    key.SetFromKey(Tuple(values, key_schema.get()), key_schema.get());
+    return key;
+  };
+
+  // a prefix sorts first, whatever follows it in the key
+  EXPECT_EQ(-1, comparator(make_key("ab", 100), make_key("abc", -100)));
+  EXPECT_EQ(-1, comparator(make_key("", 100), make_key("a", -100)));
+  // 0 bytes are escaped, and still sort below every other character
+  std::string with_zero("a\0b", 3);
+  EXPECT_EQ(-1, comparator(make_key("a", 1), make_key(with_zero, 1)));
+  EXPECT_EQ(-1, comparator(make_key(with_zero, 1), make_key("a\x01", 1)));
+  EXPECT_EQ(with_zero, make_key(with_zero, 7).ToValue(key_schema.get(), 0).ToString());
+  EXPECT_EQ(7, make_key(with_zero, 7).ToValue(key_schema.get(), 1).GetAs<int32_t>());
+
+  // what does not fit is cut off
+  EXPECT_EQ(0, comparator(make_key("0123456789abcdef", 1), make_key("0123456789abcdeg", 2)));
+  EXPECT_EQ("0123456789abcde", make_key("0123456789abcdef", 1).ToValue(key_schema.get(), 0).ToString());
+}
+
+// The comparator before keys were normalized: it deserializes every column of the raw tuple bytes into a Value.
+class ValueComparator {
+ public:
+  explicit ValueComparator(Schema *key_schema) : key_schema_(key_schema) {}
+
+  auto operator()(const GenericKey<8> &lhs, const GenericKey<8> &rhs) const -> int {
+    for (uint32_t i = 0; i < key_schema_->GetColumnCount(); i++) {
+      auto offset = key_schema_->GetColumn(i).GetOffset();
+      auto type = key_schema_->GetColumn(i).GetType();
+      Value lhs_value = Value::DeserializeFrom(lhs.data_ + offset, type);
+      Value rhs_value = Value::DeserializeFrom(rhs.data_ + offset, type);
+      if (lhs_value.CompareLessThan(rhs_value) == CmpBool::CmpTrue) {
+        return -1;
+      }
+      if (lhs_value.CompareGreaterThan(rhs_value) == CmpBool::CmpTrue) {
+        return 1;
+      }
+    }
+    return 0;
+  }
+
+ private:
+  Schema *key_schema_;
+};
+
+TEST(GenericKeyTest, DISABLED_ComparatorBenchmark) {
+  auto key_schema = ParseCreateStatement("a int,b int");
+  const size_t num_keys = 1 << 16;
+  const size_t num_lookups = 1 << 20;
+  std::mt19937 rng(0);
+
+  // the same sorted keys, as raw tuple bytes and normalized
+  std::vector<std::pair<int32_t, int32_t>> rows(num_keys);
+  for (auto &row : rows) {
+    row = {static_cast<int32_t>(rng() % 1000) - 500, static_cast<int32_t>(rng())};
+  }
+  std::sort(rows.begin(), rows.end());
+  std::vector<GenericKey<8>> raw_keys(num_keys);
+  std::vector<GenericKey<8>> normalized_keys(num_keys);
+  for (size_t i = 0; i < num_keys; i++) {
+    std::vector<Value> values{ValueFactory::GetIntegerValue(rows[i].first),
+                              ValueFactory::GetIntegerValue(rows[i].second)};
+    Tuple tuple(values, key_schema.get());
+    memcpy(raw_keys[i].data_, tuple.GetData(), 8);
+    normalized_keys[i].SetFromKey(tuple, key_schema.get());
+  }
+  std::vector<size_t> lookups(num_lookups);
+  for (auto &lookup : lookups) {
+    lookup = rng() % num_keys;
+  }
+
+  auto search = [&](const std::vector<GenericKey<8>> &keys, const auto &comparator) {
+    auto start = std::chrono::steady_clock::now();
+    size_t found = 0;
+    for (auto lookup : lookups) {
+      auto iter = std::lower_bound(keys.begin(), keys.end(), keys[lookup], [&](const auto &lhs, const auto &rhs) {
+        return comparator(lhs, rhs) < 0;
+      });
+      found += comparator(*iter, keys[lookup]) == 0 ? 1 : 0;
+    }
+    EXPECT_EQ(num_lookups, found);
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+  };
+  auto value_seconds = search(raw_keys, ValueComparator(key_schema.get()));
+  auto memcmp_seconds = search(normalized_keys, GenericComparator<8>(key_schema.get()));
+  std::cout << num_lookups << " binary searches over " << num_keys << " keys: Value comparator " << value_seconds
+            << " s, normalized keys " << memcmp_seconds << " s" << std::endl;
+}
+
+}  // namespace bustub
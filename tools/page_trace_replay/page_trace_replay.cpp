@@ -0,0 +1,137 @@
+#include <algorithm>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+#include "argparse/argparse.hpp"
+#include "buffer/page_trace.h"
+#include "buffer/replacer.h"
+#include "buffer/replacer_simulator.h"
+#include "common/exception.h"
+#include "common/util/string_util.h"
+#include "fmt/core.h"
+
+using bustub::ReplacerPolicy;
+
+static const ReplacerPolicy ALL_POLICIES[] = {ReplacerPolicy::LRU_K, ReplacerPolicy::LRU, ReplacerPolicy::CLOCK,
+                                              ReplacerPolicy::TWO_Q, ReplacerPolicy::ARC};
+
+auto ParsePolicy(const std::string &str) -> ReplacerPolicy {
+  for (auto policy : ALL_POLICIES) {
+    if (bustub::StringUtil::Upper(str) == bustub::ReplacerPolicyToString(policy)) {
+      return policy;
+    }
+  }
+  throw bustub::Exception(fmt::format("unknown replacer: {}", str));
+}
+
+/** @throws std::invalid_argument holding str if str is not a whole unsigned number that fits in a size_t */
+auto ParseSize(const std::string &str) -> size_t {
+  size_t parsed = 0;
+  size_t value = 0;
+  try {
+    value = std::stoul(str, &parsed);
+  } catch (const std::logic_error &e) {
+    throw std::invalid_argument(str);
+  }
+  if (parsed != str.size()) {
+    throw std::invalid_argument(str);
+  }
+  return value;
+}
+
+/** Pool sizes 16, 32, ... up to the first one that holds every page of the trace. */
+auto DefaultPoolSizes(size_t num_distinct_pages) -> std::vector<size_t> {
+  std::vector<size_t> pool_sizes;
+  for (size_t pool_size = 16;; pool_size *= 2) {
+    pool_sizes.push_back(pool_size);
+    if (pool_size >= num_distinct_pages) {
+      return pool_sizes;
+    }
+  }
+}
+
+// NOLINTNEXTLINE
+auto main(int argc, char **argv) -> int {
+  argparse::ArgumentParser program("bustub-page-trace-replay");
+  program.add_argument("trace").help("trace file written by BufferPoolManagerInstance::SetTraceRecorder");
+  program.add_argument("--replacers")
+      .help("comma-separated replacement policies: LRU-K, LRU, CLOCK, 2Q, ARC")
+      .default_value(std::string("LRU-K,LRU,CLOCK,2Q,ARC"));
+  program.add_argument("--pool-sizes")
+      .help("comma-separated pool sizes (default: powers of two up to the working set)");
+  program.add_argument("--k").help("lookback constant of LRU-K").default_value(std::string("2"));
+
+  try {
+    program.parse_args(argc, argv);
+  } catch (const std::runtime_error &err) {
+    std::cerr << err.what() << std::endl;
+    std::cerr << program;
+    return 1;
+  }
+
+  size_t k = 0;
+  std::vector<size_t> pool_sizes;
+  try {
+    k = ParseSize(program.get("--k"));
+    if (program.present("--pool-sizes")) {
+      for (const auto &size : bustub::StringUtil::Split(program.get("--pool-sizes"), ',')) {
+        pool_sizes.push_back(ParseSize(size));
+      }
+    }
+  } catch (const std::logic_error &err) {
+    std::cerr << "invalid number: " << err.what() << std::endl;
+    std::cerr << program;
+    return 1;
+  }
+
+  std::vector<bustub::PageTraceRecord> records;
+  std::vector<ReplacerPolicy> policies;
+  try {
+    records = bustub::ReadPageTrace(program.get("trace"));
+    for (const auto &name : bustub::StringUtil::Split(program.get("--replacers"), ',')) {
+      policies.push_back(ParsePolicy(name));
+    }
+  } catch (const bustub::Exception &err) {
+    std::cerr << err.what() << std::endl;
+    return 1;
+  }
+
+  auto references = bustub::PageTraceReferences(records);
+  std::unordered_set<bustub::page_id_t> distinct_pages(references.begin(), references.end());
+  std::unordered_set<uint16_t> threads;
+  size_t recorded_hits = 0;
+  for (const auto &record : records) {
+    threads.insert(record.thread_id_);
+    if (record.event_ == bustub::PageTraceEvent::FETCH && (record.flags_ & bustub::PAGE_TRACE_HIT) != 0) {
+      recorded_hits++;
+    }
+  }
+  fmt::print("{} events from {} threads, {} references to {} distinct pages, {} recorded fetch hits\n",
+             records.size(), threads.size(), references.size(), distinct_pages.size(), recorded_hits);
+  if (references.empty()) {
+    return 0;
+  }
+
+  if (!program.present("--pool-sizes")) {
+    pool_sizes = DefaultPoolSizes(distinct_pages.size());
+  }
+
+  // one row per pool size, one miss ratio column per policy
+  fmt::print("{:>10}", "pool_size");
+  for (auto policy : policies) {
+    fmt::print("{:>10}", bustub::ReplacerPolicyToString(policy));
+  }
+  fmt::print("\n");
+  for (auto pool_size : pool_sizes) {
+    fmt::print("{:>10}", pool_size);
+    for (auto policy : policies) {
+      auto result = bustub::SimulateReplacer(policy, pool_size, references, k);
+      fmt::print("{:>9.2f}%", 100 * (1 - result.HitRatio()));
+    }
+    fmt::print("\n");
+  }
+  return 0;
+}